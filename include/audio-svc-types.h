@@ -202,6 +202,13 @@ typedef enum{
 	AUDIO_SVC_TRACK_DATA_ALBUM_RATING,			/**< Rating of Album*/
 	AUDIO_SVC_TRACK_DATA_FAVOURATE	,			/**< Favourate of media file*/
 }audio_svc_track_data_type_e;
+
+/**
+ * Field mask of track for list queries. Only the columns of the fields in the mask are selected.
+ * ex) AUDIO_SVC_TRACK_FIELD(AUDIO_SVC_TRACK_DATA_AUDIO_ID) | AUDIO_SVC_TRACK_FIELD(AUDIO_SVC_TRACK_DATA_TITLE)
+ */
+#define AUDIO_SVC_TRACK_FIELD(field)		(1U << (field))
+#define AUDIO_SVC_TRACK_FIELD_ALL			(~0U)
 /**
 	@}
  */
@@ -1391,6 +1391,48 @@ void insert_item_to_db(MediaSvcHandle *db_handle)
  */
 int audio_svc_insert_item(MediaSvcHandle *handle, audio_svc_storage_type_e storage_type, const char *path, audio_svc_category_type_e category);
 
+/**
+ *    audio_svc_insert_item_with_media:\n
+ * 	Same as audio_svc_insert_item, but also inserts the track into media table of media-svc.
+ * 	The file is parsed only once, and the result fills both tables.
+ *   Media table uses its own batch, so call media_svc_insert_item_begin and media_svc_insert_item_end
+ *   with audio_svc_insert_item_start and audio_svc_insert_item_end.
+ *
+ *	@param[in]		storage_type	Information for storage type
+ *	@param[in]		path         		Information for file path
+ *	@param[in]		category			Information for file category, defined by file manager.
+ *	@param[in]		mime_type		Mime type of the file
+ *	@return		This function returns zero(AUDIO_SVC_ERROR_NONE) on success, or negative value with error code.\n
+ *				Please refer 'audio-svc-error.h' to know the exact meaning of the error.
+ *	@see		audio_svc_insert_item, media_svc_insert_item_bulk
+ *	@remark	None
+ *	@pre   		music table and media table are already created
+ *	@post 		None
+ * 	@par example
+ * 	@code
+
+ #include <audio-svc.h>
+
+void insert_item_to_db(MediaSvcHandle *db_handle)
+{
+	int ret = AUDIO_SVC_ERROR_NONE;
+	const char *path = "/opt/media/Sounds/Music/Layla.mp3";
+
+	ret = audio_svc_insert_item_with_media(db_handle, AUDIO_SVC_STORAGE_PHONE, path, AUDIO_SVC_CATEGORY_MUSIC, "audio/mpeg");
+
+	if (ret < 0)
+	{
+		printf( "unable to insert item, error code->%d", ret);
+		return;
+	}
+
+	return;
+}
+
+ * 	@endcode
+ */
+int audio_svc_insert_item_with_media(MediaSvcHandle *handle, audio_svc_storage_type_e storage_type, const char *path, audio_svc_category_type_e category, const char *mime_type);
+
 
 /**
  *    audio_svc_insert_item_immediately:\n
@@ -1750,6 +1792,48 @@ void check_item_Exist(MediaSvcHandle *db_handle)
 
 int audio_svc_check_item_exist(MediaSvcHandle *handle, const char *path);
 
+/**
+ * 	audio_svc_check_items_exist:\n
+ * 	This function checks whether each of many items(contents) is exist or not in DB.
+ * 	All paths are checked with one prepared query in one read transaction, so a scanner should use this
+ * 	instead of calling audio_svc_check_item_exist for each file.
+ *
+ * 	@param[in]	path_list		array of the file paths.
+ * 	@param[in]	count			number of the paths.
+ * 	@param[out]	exist_list		array of count entries. Each one is set to 1 if the path is exist, or 0 if not.
+ * 	@return		This function returns zero(AUDIO_SVC_ERROR_NONE) on success, or negative value with error code.
+ *				Please refer 'audio-svc-error.h' to know the exact meaning of the error.
+ *	@pre		None
+ *	@post		None
+ *	@see		audio_svc_check_item_exist
+ *	@remark	None
+ * 	@par example
+ * 	@code
+
+  #include <audio-svc.h>
+
+void check_items_exist(MediaSvcHandle *db_handle)
+{
+	int ret = AUDIO_SVC_ERROR_NONE;
+	const char *path_list[2] = { "/opt/media/Sounds/Music/The Last Laugh.mp3", "/opt/media/Sounds/Music/Over the horizon.mp3" };
+	int exist_list[2] = { 0, };
+
+	//check items exist
+	ret = audio_svc_check_items_exist(db_handle, path_list, 2, exist_list);
+	if (ret < 0)
+	{
+		printf("failed to check items");
+		return;
+	}
+
+	return;
+}
+
+ * 	@endcode
+ */
+
+int audio_svc_check_items_exist(MediaSvcHandle *handle, const char **path_list, int count, int *exist_list);
+
 
 /**
  * 	audio_svc_get_path_by_audio_id:\n
@@ -3551,6 +3635,64 @@ int audio_svc_list_by_search(MediaSvcHandle *handle, AudioHandleType *record,
 							audio_svc_serch_field_e first_field_name,
 							...);
 
+/**
+ * 	audio_svc_list_by_search_with_fields:\n
+ * 	This function searches tracks like audio_svc_list_by_search(), but selects only the columns of the fields in @p field_mask.
+ *	Other fields of the result items are left empty. A list screen usually needs a few fields, so the query reads and copies much less.
+ *
+ * 	@param[in]	record			The handle for search
+ * 	@param[in]	field_mask		mask of fields to get, made by AUDIO_SVC_TRACK_FIELD() of audio_svc_track_data_type_e.
+ *			 	AUDIO_SVC_TRACK_FIELD_ALL gets all fields same as audio_svc_list_by_search().
+ * 	@param[in]	order_field		field to order
+ *			 	Please refer 'audio-svc-types.h', and see the enum audio_svc_search_order_e
+ * 	@param[in]	offset		offset of list to be searched
+ * 	@param[in]	count		count of list to be searched
+ * 	@param[in]	first_field_name	the variable arguements list of field to search
+ *			 	Please refer 'audio-svc-types.h', and see the enum audio_svc_serch_field_e
+ * 	@return		This function returns zero(AUDIO_SVC_ERROR_NONE) on success, or negative value with error code.
+ *			 	Please refer 'audio-svc-error.h' to know the exact meaning of the error.
+ *	@pre		None.
+ *	@post		None.
+ *	@see		audio_svc_list_by_search.
+ *	@remark	None.
+ * 	@par example
+ * 	@code
+
+ #include <audio-svc.h>
+
+void test_audio_svc_list_by_search_with_fields(MediaSvcHandle *db_handle)
+{
+		int offset = 0, count = 10;
+		const char *str = "Sa";
+		AudioHandleType *audio_handle = NULL;
+		unsigned int fields = AUDIO_SVC_TRACK_FIELD(AUDIO_SVC_TRACK_DATA_AUDIO_ID) |
+							AUDIO_SVC_TRACK_FIELD(AUDIO_SVC_TRACK_DATA_TITLE) |
+							AUDIO_SVC_TRACK_FIELD(AUDIO_SVC_TRACK_DATA_ARTIST);
+
+		err = audio_svc_search_item_new(&audio_handle, count);
+		if (err < 0) {
+			printf("audio_svc_search_item_new failed:%d\n", err);
+			return err;
+		}
+
+		err = audio_svc_list_by_search_with_fields(db_handle, audio_handle, fields, AUDIO_SVC_ORDER_BY_TITLE_ASC, offset, count, AUDIO_SVC_SEARCH_TITLE, str, strlen(str), -1);
+		if (err != AUDIO_SVC_ERROR_NONE) {
+			printf("Fail to get items : %d", err);
+		}
+
+		audio_svc_search_item_free(audio_handle);
+}
+
+ * 	@endcode
+ */
+int audio_svc_list_by_search_with_fields(MediaSvcHandle *handle, AudioHandleType *record,
+							unsigned int field_mask,
+							audio_svc_search_order_e order_field,
+							int offset,
+							int count,
+							audio_svc_serch_field_e first_field_name,
+							...);
+
 
 /** @} */
 
@@ -24,12 +24,16 @@
 #ifndef _MEDIA_SVC_TYPES_H_
 #define _MEDIA_SVC_TYPES_H_
 
+#include <time.h>
+
 #ifndef DEPRECATED_API
 #  define DEPRECATED_API __attribute__ ((deprecated))
 #endif
 
 typedef void MediaSvcHandle;		/**< Handle */
 
+#define MEDIA_SVC_BATCH_ADAPTIVE	0	/**< data_cnt of *_begin functions, to commit by time and size instead of item count */
+
 /**
  * Type definition for storage type
  */
@@ -50,4 +54,95 @@ typedef enum{
 	MEDIA_SVC_MEDIA_TYPE_OTHER	= 4,	/**< Invalid Content*/
 }media_svc_media_type_e;
 
+/**
+ * Type definition for busy wait strategy, used when the database is locked by others
+ */
+typedef enum{
+	MEDIA_SVC_BUSY_STRATEGY_BACKOFF	= 0,	/**< Wait from 100 usec, doubling each retry up to 50 msec. Default*/
+	MEDIA_SVC_BUSY_STRATEGY_FIXED	= 1,	/**< Wait 50 msec each retry*/
+	MEDIA_SVC_BUSY_STRATEGY_MAX,			/**< Invalid strategy*/
+}media_svc_busy_strategy_e;
+
+/**
+ * Lock contention counters of a handle
+ */
+typedef struct{
+	unsigned int			wait_count;			/**< Number of times the handle waited for a lock*/
+	unsigned int			retry_count;			/**< Number of retries in all waits*/
+	unsigned int			timeout_count;		/**< Number of waits given up*/
+	unsigned long long	total_wait_usec;		/**< Total time spent in waits, in usec*/
+	unsigned long long	longest_wait_usec;	/**< Longest wait, in usec*/
+}media_svc_lock_stats_s;
+
+/**
+ * Counters of count result cache of a handle
+ */
+typedef struct{
+	unsigned int			hit_count;			/**< Number of counts answered from the cache*/
+	unsigned int			miss_count;			/**< Number of counts queried from database*/
+	unsigned int			invalidate_count;		/**< Number of times cached counts are dropped by a change of data*/
+}media_svc_count_cache_stats_s;
+
+/**
+ * Type definition for state of a file, compared with its item in database
+ */
+typedef enum{
+	MEDIA_SVC_ITEM_STATE_NEW			= 0,	/**< No item of the path. Insert it*/
+	MEDIA_SVC_ITEM_STATE_UNCHANGED		= 1,	/**< Item has the same size and modified time*/
+	MEDIA_SVC_ITEM_STATE_MODIFIED		= 2,	/**< Item is out of date. Refresh it*/
+}media_svc_item_state_e;
+
+/**
+ * File to check with database, and the result of the check
+ */
+typedef struct{
+	const char				*path;			/**< [in] Path of the file*/
+	unsigned long long		size;			/**< [in] Size of the file*/
+	time_t					modified_time;	/**< [in] Modified time of the file*/
+	media_svc_item_state_e	state;			/**< [out] State of the file*/
+}media_svc_item_check_s;
+
+#define MEDIA_SVC_CHANGE_UUID_LEN		37		/**< Length of media uuid of a change, with null*/
+#define MEDIA_SVC_CHANGE_LOG_MAX		10000	/**< Number of latest changes kept in change log*/
+
+/**
+ * Type definition for a change of media, logged in change log
+ */
+typedef enum{
+	MEDIA_SVC_CHANGE_INSERT		= 0,	/**< Media is inserted*/
+	MEDIA_SVC_CHANGE_UPDATE		= 1,	/**< Media is updated, moved, or its validity is changed*/
+	MEDIA_SVC_CHANGE_DELETE		= 2,	/**< Media is deleted*/
+	MEDIA_SVC_CHANGE_STORAGE	= 3,	/**< Validity or mount state of all media of the storage is changed. media_uuid is empty*/
+}media_svc_change_type_e;
+
+/**
+ * Type definition for the table a change is logged from. Each one has its own ID space of media_uuid
+ */
+typedef enum{
+	MEDIA_SVC_CHANGE_SOURCE_MEDIA	= 0,	/**< media table. media_uuid is media_uuid of media table. Changes of a storage are of this source*/
+	MEDIA_SVC_CHANGE_SOURCE_AUDIO	= 1,	/**< Legacy table of audio module. media_uuid is audio_uuid*/
+	MEDIA_SVC_CHANGE_SOURCE_VISUAL	= 2,	/**< Legacy table of visual module. media_uuid is visual_uuid*/
+}media_svc_change_source_e;
+
+/**
+ * A change of media, for media_svc_get_changes.
+ * A file in media table and in a legacy table, such as the one inserted by audio_svc_insert_item_with_media, is logged once per table.
+ * Consumers take the changes of the source of their list, and skip the others.
+ */
+typedef struct{
+	long long					version;						/**< Version of database after the change*/
+	media_svc_change_type_e		change_type;					/**< Type of the change*/
+	media_svc_change_source_e	source;							/**< Table of the change, which media_uuid belongs to*/
+	media_svc_storage_type_e	storage_type;					/**< Storage of the media*/
+	char						media_uuid[MEDIA_SVC_CHANGE_UUID_LEN];	/**< Unique ID of the media in the ID space of source*/
+}media_svc_change_s;
+
+/**
+ * Item to move, for media_svc_move_items
+ */
+typedef struct{
+	const char	*src_path;		/**< Path of the item*/
+	const char	*dest_path;		/**< New path of the item*/
+}media_svc_move_item_s;
+
 #endif /*_MEDIA_SVC_TYPES_H_*/
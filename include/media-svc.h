@@ -136,6 +136,238 @@ void disconnect_media_db()
 int media_svc_disconnect(MediaSvcHandle *handle);
 
 
+/**
+ *	media_svc_pool_get_reader:
+ *	Get a read connection from the connection pool of this process.
+ *	The media database is in WAL mode, so a read connection sees the last committed data and is not blocked by a write transaction.
+ *	Use it only for queries, and return it with media_svc_pool_put_reader. Do not call media_svc_disconnect with it.
+ *
+ *  @param 		handle [out]		Handle to access database.
+ *	@return		This function returns zero(MEDIA_INFO_ERROR_NONE) on success, or negative value with error code.
+ *	@see		media_svc_pool_put_reader
+ */
+int media_svc_pool_get_reader(MediaSvcHandle **handle);
+
+/**
+ *	media_svc_pool_put_reader:
+ *	Return a read connection to the connection pool.
+ *
+ *  @param 		handle [in]		Handle got by media_svc_pool_get_reader.
+ *	@return		This function returns zero(MEDIA_INFO_ERROR_NONE) on success, or negative value with error code.
+ *	@see		media_svc_pool_get_reader
+ */
+int media_svc_pool_put_reader(MediaSvcHandle *handle);
+
+/**
+ *	media_svc_pool_get_writer:
+ *	Get the write connection of this process. There is only one, so this waits until the current user returns it.
+ *	Return it with media_svc_pool_put_writer. Do not call media_svc_disconnect with it.
+ *
+ *  @param 		handle [out]		Handle to access database.
+ *	@return		This function returns zero(MEDIA_INFO_ERROR_NONE) on success, or negative value with error code.
+ *	@see		media_svc_pool_put_writer
+ */
+int media_svc_pool_get_writer(MediaSvcHandle **handle);
+
+/**
+ *	media_svc_pool_put_writer:
+ *	Return the write connection. An open transaction on it is rolled back.
+ *
+ *  @param 		handle [in]		Handle got by media_svc_pool_get_writer.
+ *	@return		This function returns zero(MEDIA_INFO_ERROR_NONE) on success, or negative value with error code.
+ *	@see		media_svc_pool_get_writer
+ */
+int media_svc_pool_put_writer(MediaSvcHandle *handle);
+
+/**
+ *	media_svc_pool_destroy:
+ *	Close all idle connections in the connection pool.
+ *
+ *	@return		This function returns zero(MEDIA_INFO_ERROR_NONE) on success, or negative value with error code.
+ */
+int media_svc_pool_destroy(void);
+
+/**
+ *	media_svc_set_busy_strategy:
+ *	Set how the handle waits when the database is locked by other connection.
+ *	Either strategy gives up a wait after 5 seconds, and the query fails with busy error.
+ *
+ *  @param 		handle [in]		Handle to access database.
+ *  @param 		strategy [in]		Busy wait strategy. Default is MEDIA_SVC_BUSY_STRATEGY_BACKOFF.
+ *	@return		This function returns zero(MEDIA_INFO_ERROR_NONE) on success, or negative value with error code.
+ */
+int media_svc_set_busy_strategy(MediaSvcHandle *handle, media_svc_busy_strategy_e strategy);
+
+/**
+ *	media_svc_get_lock_stats:
+ *	Get lock contention counters of the handle, counted since connect or last media_svc_reset_lock_stats.
+ *
+ *  @param 		handle [in]		Handle to access database.
+ *  @param 		stats [out]		Lock contention counters.
+ *	@return		This function returns zero(MEDIA_INFO_ERROR_NONE) on success, or negative value with error code.
+ *	@see		media_svc_reset_lock_stats
+ */
+int media_svc_get_lock_stats(MediaSvcHandle *handle, media_svc_lock_stats_s *stats);
+
+/**
+ *	media_svc_reset_lock_stats:
+ *	Clear lock contention counters of the handle.
+ *
+ *  @param 		handle [in]		Handle to access database.
+ *	@return		This function returns zero(MEDIA_INFO_ERROR_NONE) on success, or negative value with error code.
+ *	@see		media_svc_get_lock_stats
+ */
+int media_svc_reset_lock_stats(MediaSvcHandle *handle);
+
+/**
+ *	media_svc_get_count_cache_stats:
+ *	Get counters of count result cache of the handle, counted since connect or last media_svc_reset_count_cache_stats.
+ *	Results of minfo_get_item_cnt, minfo_get_cluster_cnt, minfo_get_all_item_count, audio_svc_count_group_item and audio_svc_count_list_item are cached
+ *	until database is changed by this or any other connection.
+ *
+ *  @param 		handle [in]		Handle to access database.
+ *  @param 		stats [out]		Count result cache counters.
+ *	@return		This function returns zero(MEDIA_INFO_ERROR_NONE) on success, or negative value with error code.
+ *	@see		media_svc_reset_count_cache_stats
+ */
+int media_svc_get_count_cache_stats(MediaSvcHandle *handle, media_svc_count_cache_stats_s *stats);
+
+/**
+ *	media_svc_reset_count_cache_stats:
+ *	Clear counters of count result cache of the handle.
+ *
+ *  @param 		handle [in]		Handle to access database.
+ *	@return		This function returns zero(MEDIA_INFO_ERROR_NONE) on success, or negative value with error code.
+ *	@see		media_svc_get_count_cache_stats
+ */
+int media_svc_reset_count_cache_stats(MediaSvcHandle *handle);
+
+/**
+ *	media_svc_set_batch_lock_hold_time:
+ *	Set target of writer lock hold time for adaptive batch.
+ *	When media_svc_insert_item_begin, media_svc_move_item_begin or media_svc_set_item_validity_begin is called with MEDIA_SVC_BATCH_ADAPTIVE,
+ *	stacked items are committed when the transaction is expected to hold the lock about this long, based on measured query and commit time.
+ *	A batch is also committed when its first item is older than 1 second, or its queries are bigger than 1MB.
+ *	These are checked when an item is added, and the age of all batches is checked by *_end functions and media_svc_commit_old_batch.
+ *
+ *  @param 		handle [in]		Handle to access database.
+ *  @param 		max_lock_hold_msec [in]		Target lock hold time, in msec. Default is 100.
+ *	@return		This function returns zero(MEDIA_INFO_ERROR_NONE) on success, or negative value with error code.
+ */
+int media_svc_set_batch_lock_hold_time(MediaSvcHandle *handle, int max_lock_hold_msec);
+
+/**
+ *	media_svc_commit_old_batch:
+ *	Commit adaptive batches whose first item is older than 1 second.
+ *	Items stay in a batch until next item is added or *_end is called, so a caller which can stop adding items for a while
+ *	should call this from its timer, e.g. a g_timeout_add_seconds source of its main loop.
+ *
+ *  @param 		handle [in]		Handle to access database.
+ *	@return		This function returns zero(MEDIA_INFO_ERROR_NONE) on success, or negative value with error code.
+ *	@see		media_svc_set_batch_lock_hold_time
+ */
+int media_svc_commit_old_batch(MediaSvcHandle *handle);
+
+/**
+ *	media_svc_bulk_load_begin:
+ *	Start bulk load session for the first scan of a device.
+ *	Secondary indexes of media are dropped, so inserting items does not update them for each item.
+ *	Queries by those columns are slow until media_svc_bulk_load_end is called.
+ *	Items should be inserted with media_svc_insert_item_begin, using a big count or MEDIA_SVC_BATCH_ADAPTIVE.
+ *	If the process ends in the session, indexes are built again by next media_svc_create_table.
+ *
+ *  @param 		handle [in]		Handle to access database.
+ *	@return		This function returns zero(MEDIA_INFO_ERROR_NONE) on success, or negative value with error code.
+ *	@see		media_svc_bulk_load_end
+ */
+int media_svc_bulk_load_begin(MediaSvcHandle *handle);
+
+/**
+ *	media_svc_bulk_load_end:
+ *	End bulk load session. Indexes are built from the loaded items, and statistics for query planner are updated.
+ *	Stacked items should be committed by media_svc_insert_item_end before this.
+ *
+ *  @param 		handle [in]		Handle to access database.
+ *	@return		This function returns zero(MEDIA_INFO_ERROR_NONE) on success, or negative value with error code.
+ *	@see		media_svc_bulk_load_begin
+ */
+int media_svc_bulk_load_end(MediaSvcHandle *handle);
+
+/**
+ *	media_svc_scan_session_begin:
+ *	Start scan session. The session holds a write transaction on the handle,
+ *	and each API call until media_svc_scan_session_end runs in a savepoint of it instead of its own transaction.
+ *	media_svc_scan_session_enter should be called before each write call, and media_svc_scan_session_leave after it.
+ *	Leave commits the work once the session holds the lock longer than media_svc_set_batch_lock_hold_time,
+ *	so that other writers are not blocked for the whole scan nor while the scanner is idle, and enter opens next transaction.
+ *	If the handle is disconnected in the session, the session is ended.
+ *
+ *  @param 		handle [in]		Handle to access database.
+ *	@return		This function returns zero(MEDIA_INFO_ERROR_NONE) on success, or negative value with error code.
+ *	@see		media_svc_scan_session_end
+ */
+int media_svc_scan_session_begin(MediaSvcHandle *handle);
+
+/**
+ *	media_svc_scan_session_end:
+ *	End scan session, and commit its work.
+ *	If the commit fails, the session and its work are kept, and this can be called again.
+ *	If sqlite rolled back the transaction of the session by an error, the session is ended and MEDIA_INFO_ERROR_DATABASE_INTERNAL is returned.
+ *
+ *  @param 		handle [in]		Handle to access database.
+ *	@return		This function returns zero(MEDIA_INFO_ERROR_NONE) on success, or negative value with error code.
+ *	@see		media_svc_scan_session_begin
+ */
+int media_svc_scan_session_end(MediaSvcHandle *handle);
+
+/**
+ *	media_svc_scan_session_enter:
+ *	Called before a write call of the handle.
+ *	If the handle is in scan session, the transaction of the session is opened again when leave committed it.
+ *	Otherwise, if this thread requested a scan session by media_svc_scan_update_begin and no handle holds it yet, the session is begun.
+ *	If sqlite rolled back the transaction of the session by an error, MEDIA_INFO_ERROR_DATABASE_INTERNAL is returned once.
+ *	Items written in the session since its last commit are lost then, and caller should write them again.
+ *
+ *  @param 		handle [in]		Handle to access database.
+ *	@return		This function returns zero(MEDIA_INFO_ERROR_NONE) on success, or negative value with error code.
+ *	@see		media_svc_scan_session_leave, media_svc_scan_update_begin
+ */
+int media_svc_scan_session_enter(MediaSvcHandle *handle);
+
+/**
+ *	media_svc_scan_session_leave:
+ *	Called after a write call of the handle, whether it failed or not.
+ *	If the handle is in scan session and it holds the lock longer than target, its work is committed.
+ *
+ *  @param 		handle [in]		Handle to access database.
+ *	@return		This function returns zero(MEDIA_INFO_ERROR_NONE) on success, or negative value with error code.
+ *	@see		media_svc_scan_session_enter
+ */
+int media_svc_scan_session_leave(MediaSvcHandle *handle);
+
+/**
+ *	media_svc_scan_update_begin:
+ *	Request scan session for writes of the calling thread.
+ *	The first handle which calls media_svc_scan_session_enter on this thread holds the session until media_svc_scan_update_end.
+ *	Handles of other threads are not put in the session.
+ *
+ *	@return		This function returns zero(MEDIA_INFO_ERROR_NONE) on success, or negative value with error code.
+ *	@see		media_svc_scan_update_end
+ */
+int media_svc_scan_update_begin(void);
+
+/**
+ *	media_svc_scan_update_end:
+ *	End the scan session begun by the request of media_svc_scan_update_begin, and commit its work.
+ *	Sessions begun by media_svc_scan_session_begin are not ended.
+ *	A session whose commit fails is kept, and committed by this call again.
+ *
+ *	@return		This function returns zero(MEDIA_INFO_ERROR_NONE) on success, or negative value with error code.
+ *	@see		media_svc_scan_update_begin
+ */
+int media_svc_scan_update_end(void);
+
+
 /**
  *	media_svc_create_table:
  *	Create table of media database and set Index and Triggers.
@@ -147,6 +379,12 @@ int media_svc_disconnect(MediaSvcHandle *handle);
  *	@pre		call media_svc_connect to connect media database.
  *	@post		call media_svc_disconnect to disconnect media database.
  *	@remark	The database name is "/opt/dbspace/.media.db".
+ *			media, folder, playlist_map and tag_map are views, written by INSTEAD OF triggers to their *_data tables.
+ *			So sqlite3_last_insert_rowid() does not return the row inserted into them.
+ *			Read the id back by its unique key instead, e.g. media_id by media_uuid and folder_id by folder_uuid,
+ *			or give _id in the INSERT of playlist_map and tag_map.
+ *			It also migrates visual_media and visual_folder tables of visual module, which are read without checking their version.
+ *			So call it once after the visual tables are made, before reading the visual lists.
  * 	@par example
  * 	@code
 
@@ -188,6 +426,52 @@ int media_svc_create_table(MediaSvcHandle *handle);
 
 int media_svc_check_item_exist_by_path(MediaSvcHandle *handle, const char *path);
 
+/**
+ *	media_svc_check_items:
+ *	Check files of a scan with database at once, instead of media_svc_check_item_exist_by_path for each file.
+ *	State of each file is set to MEDIA_SVC_ITEM_STATE_NEW when it is not in database, MEDIA_SVC_ITEM_STATE_UNCHANGED when size and
+ *	modified time are the same as its item, or MEDIA_SVC_ITEM_STATE_MODIFIED when it should be updated by media_svc_refresh_item.
+ *
+ *  @param 		handle [in]		Handle to access database.
+ *  @param 		items [in/out]		Array of files. path, size and modified_time are set by caller, and state is set by this function.
+ *  @param 		count [in]		Number of files in the array.
+ *	@return		This function returns zero(MEDIA_INFO_ERROR_NONE) on success, or negative value with error code.
+ *	@see		media_svc_check_item_exist_by_path, media_svc_refresh_item
+ */
+int media_svc_check_items(MediaSvcHandle *handle, media_svc_item_check_s *items, int count);
+
+/**
+ *	media_svc_get_change_version:
+ *	Get the current version of database. Version is increased by each insert, update and delete of media, by any module,
+ *	including the ones of audio_media and visual_media tables of audio and visual modules.
+ *	Keep it with a loaded list, and get changes after it by media_svc_get_changes instead of reloading the list.
+ *
+ *  @param 		handle [in]		Handle to access database.
+ *  @param 		version [out]		Current version of database. 0 when no media has been changed.
+ *	@return		This function returns zero(MEDIA_INFO_ERROR_NONE) on success, or negative value with error code.
+ *	@see		media_svc_get_changes
+ */
+int media_svc_get_change_version(MediaSvcHandle *handle, long long *version);
+
+/**
+ *	media_svc_get_changes:
+ *	Get changes of media after the given version, oldest first. Apply them in order.
+ *	At most max_count changes are returned; call again with version of the last change until count is less than max_count.
+ *	Only the latest MEDIA_SVC_CHANGE_LOG_MAX changes are kept. When changes after the version are not kept any more,
+ *	MEDIA_INFO_ERROR_DATABASE_INVALID is returned, and the list should be reloaded with a new version.
+ *	media_uuid of a change is an ID of its source table. Skip changes of the sources other than the one of the list,
+ *	since a file in media table and in a legacy table is logged once per table.
+ *
+ *  @param 		handle [in]		Handle to access database.
+ *  @param 		since_version [in]		Version the caller has. Got by media_svc_get_change_version or from the last change.
+ *  @param 		changes [out]		Array of changes, allocated by caller.
+ *  @param 		max_count [in]		Number of changes the array can hold.
+ *  @param 		count [out]		Number of changes filled.
+ *	@return		This function returns zero(MEDIA_INFO_ERROR_NONE) on success, or negative value with error code.
+ *	@see		media_svc_get_change_version
+ */
+int media_svc_get_changes(MediaSvcHandle *handle, long long since_version, media_svc_change_s *changes, int max_count, int *count);
+
 int media_svc_insert_folder(MediaSvcHandle *handle, media_svc_storage_type_e storage_type, const char *path);
 
 int media_svc_insert_item_begin(MediaSvcHandle *handle, int data_cnt);
@@ -204,6 +488,21 @@ int media_svc_move_item_end(MediaSvcHandle *handle);
 
 int media_svc_move_item(MediaSvcHandle *handle, media_svc_storage_type_e src_storage, const char *src_path, media_svc_storage_type_e dest_storage, const char *dest_path);
 
+/**
+ *	media_svc_move_items:
+ *	Move many items to the same storage at once, such as an album moved between storages.
+ *	Items, their folders and thumbnails are updated in one transaction, and thumbnail files are moved after it.
+ *	Folders left empty by the move are removed.
+ *
+ *  @param 		handle [in]		Handle to access database.
+ *  @param 		dest_storage [in]		Storage type of the new paths.
+ *  @param 		items [in]		Array of (src_path, dest_path) of the items.
+ *  @param 		count [in]		Number of items in the array.
+ *	@return		This function returns zero(MEDIA_INFO_ERROR_NONE) on success, or negative value with error code.
+ *	@see		media_svc_move_item
+ */
+int media_svc_move_items(MediaSvcHandle *handle, media_svc_storage_type_e dest_storage, const media_svc_move_item_s *items, int count);
+
 int media_svc_set_item_validity_begin(MediaSvcHandle *handle, int data_cnt);
 
 int media_svc_set_item_validity_end(MediaSvcHandle *handle);
@@ -218,6 +517,31 @@ int media_svc_delete_invalid_items_in_storage(MediaSvcHandle *handle, media_svc_
 
 int media_svc_set_all_storage_items_validity(MediaSvcHandle *handle, media_svc_storage_type_e storage_type, int validity);
 
+/**
+ *	media_svc_mount_storage:
+ *	Show items of the external storage again, when the storage is mounted.
+ *	Items of the storage are kept in DB while it is unmounted. If the volume is the same as the last one, they are shown as they were, without scan.
+ *	If another volume is mounted, items of the last volume and their thumbnails are deleted.
+ *
+ *  @param 		handle [in]		Handle to access database.
+ *  @param 		storage_type [in]		Storage type. Only MEDIA_SVC_STORAGE_EXTERNAL is allowed.
+ *  @param 		volume_id [in]		ID which identifies the volume, such as the serial of the card.
+ *	@return		This function returns zero(MEDIA_INFO_ERROR_NONE) on success, or negative value with error code.
+ *	@see		media_svc_unmount_storage
+ */
+int media_svc_mount_storage(MediaSvcHandle *handle, media_svc_storage_type_e storage_type, const char *volume_id);
+
+/**
+ *	media_svc_unmount_storage:
+ *	Hide items of the external storage, when the storage is unmounted. Items and thumbnails are not deleted.
+ *
+ *  @param 		handle [in]		Handle to access database.
+ *  @param 		storage_type [in]		Storage type. Only MEDIA_SVC_STORAGE_EXTERNAL is allowed.
+ *	@return		This function returns zero(MEDIA_INFO_ERROR_NONE) on success, or negative value with error code.
+ *	@see		media_svc_mount_storage
+ */
+int media_svc_unmount_storage(MediaSvcHandle *handle, media_svc_storage_type_e storage_type);
+
 int media_svc_refresh_item(MediaSvcHandle *handle, media_svc_storage_type_e storage_type, const char *path, media_svc_media_type_e media_type);
 
 int media_svc_rename_folder(MediaSvcHandle *handle, const char *src_path, const char *dst_path);
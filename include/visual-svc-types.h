@@ -398,6 +398,21 @@ typedef struct _Mtag
 	void *_reserved;					/**< reserved */
 }Mtag;
 
+/**
+* @struct _Mlist
+* This structure defines _Mlist, same with Mlist.
+* Items of the list and all of their strings are allocated in one arena owned by the list,
+* so they are freed only by minfo_destroy_mtype_item on the list itself.
+*/
+typedef struct _Mlist
+{
+	int gtype;					/**< self-defination type */
+
+	int count;					/**< count of items */
+	void **items;				/**< Mitem or Mcluster instances, in the order of the query */
+	void *_reserved;			/**< reserved */
+}Mlist;
+
 
 typedef int (*minfo_cluster_ite_cb)( Mcluster *cluster, void *user_data );
 typedef int (*minfo_item_ite_cb)( Mitem *item, void *user_data );
@@ -114,6 +114,53 @@ extern "C" {
 int
 minfo_get_item_list(MediaSvcHandle *mb_svc_handle, const char *cluster_id, const minfo_item_filter filter, minfo_item_ite_cb func, void *user_data);
 
+/**
+ * minfo_get_item_mlist
+ * This function gets same items with minfo_get_item_list, but returns them as one Mlist instead of calling back for each item.
+ * All of Mitem instances and their strings, including meta data, are allocated from one arena of the list,
+ * so there is no malloc for each string, and the whole list is freed by one call.
+ *
+ * @param	mb_svc_handle	[in]	the handle of DB
+ * @param	cluster_id		[in]	the folder id in which media files are in. if the parameter is NULL, then query all folders.
+ * @param	filter			[in]	the filter to specify some filter conditions, same with minfo_get_item_list.
+ * @param	list			[out]	Mlist whose items are pointers to the structure type 'Mitem'
+ * @return	This function returns 0 on success, or negative value with error code.
+ * @remarks	free the list by minfo_destroy_mtype_item(list). items of the list must not be freed one by one,
+ *			and their strings must not be modified or kept after the list is freed.
+ * @see		minfo_get_item_list.
+ * @pre		None
+ * @post	None
+ * @par example
+ * @code
+
+    #include <media-svc.h>
+
+	void test_minfo_get_item_mlist(MediaSvcHandle *mb_svc_handle)
+	{
+		int ret = -1;
+		int i;
+		Mlist *list = NULL;
+
+		minfo_item_filter item_filter = {MINFO_ITEM_VIDEO,MINFO_MEDIA_SORT_BY_DATE_ASC,3,10,true,true};
+		ret = minfo_get_item_mlist(mb_svc_handle, NULL, item_filter, &list);
+		if(ret< 0) {
+			printf("minfo_get_item_mlist error\n");
+			return;
+		}
+
+		for (i = 0; i < list->count; i++) {
+			Mitem *item = (Mitem *)list->items[i];
+			printf("%s\n", item->file_url);
+		}
+
+		minfo_destroy_mtype_item(list);
+	}
+ * @endcode
+ */
+
+int
+minfo_get_item_mlist(MediaSvcHandle *mb_svc_handle, const char *cluster_id, const minfo_item_filter filter, Mlist **list);
+
 /**
  * minfo_get_all_item_list
  * This function gets mitem list, which include all or portion of a or many clusters or folders specified by 
@@ -441,6 +488,44 @@ minfo_get_cluster_cnt(MediaSvcHandle *mb_svc_handle, const minfo_cluster_filter
 int
 minfo_get_cluster_list(MediaSvcHandle *mb_svc_handle, const minfo_cluster_filter filter, minfo_cluster_ite_cb func, void *user_data);
 
+/**
+ * minfo_get_cluster_mlist
+ * This function gets same clusters with minfo_get_cluster_list, but returns them as one Mlist instead of calling back for each cluster.
+ * All of Mcluster instances and their strings are allocated from one arena of the list, and the whole list is freed by one call.
+ *
+ * @param	mb_svc_handle	[in]	the handle of DB
+ * @param	filter			[in]	filter to specify some filter conditions, same with minfo_get_cluster_list.
+ * @param	list			[out]	Mlist whose items are pointers to the structure type 'Mcluster'
+ * @return	This function returns 0 on success, or negative value with error code.
+ * @remarks	free the list by minfo_destroy_mtype_item(list). items of the list must not be freed one by one.
+ * @see		minfo_get_cluster_list.
+ * @pre		None
+ * @post	None
+ * @par example
+ * @code
+
+    #include <media-svc.h>
+
+	void test_minfo_get_cluster_mlist(MediaSvcHandle *mb_svc_handle)
+	{
+		int ret = -1;
+		Mlist *list = NULL;
+
+		minfo_cluster_filter cluster_filter ={MINFO_CLUSTER_TYPE_ALL,MINFO_CLUSTER_SORT_BY_NONE,0,10};
+
+		ret = minfo_get_cluster_mlist(mb_svc_handle, cluster_filter, &list);
+		if( ret < 0) {
+			 return;
+		}
+
+		minfo_destroy_mtype_item(list);
+	}
+ * @endcode
+ */
+
+int
+minfo_get_cluster_mlist(MediaSvcHandle *mb_svc_handle, const minfo_cluster_filter filter, Mlist **list);
+
 
 /**
  * minfo_get_meta_info
@@ -709,6 +794,52 @@ minfo_add_media_start(MediaSvcHandle *mb_svc_handle, int trans_count);
 int
 minfo_add_media_batch(MediaSvcHandle *mb_svc_handle, const char* file_url, minfo_file_type content_type);
 
+/**
+ * minfo_add_media_batch_with_media
+ * This function works like minfo_add_media_batch, and also inserts the file into media table of media service in the same batch.
+   The file is parsed only once for both tables.
+ *
+ * @param	mb_svc_handle	[in]	the handle of DB
+ * @param	file_url		[in]	the local file full path
+ * @param	content_type	[in]	the file type, MINFO_ITEM_IMAGE or MINFO_ITEM_VIDEO
+ * @param	mime_type		[in]	the mime type of the file
+ * @return	This function returns 0 on success, or negative value with error code.
+ * @remarks	storage type is decided by the path of the file.
+ * @see 	 minfo_add_media_start, minfo_add_media_batch, minfo_add_media_end
+ * @pre	None
+ * @post	None
+ * @par example
+ * @code
+
+    #include <media-svc.h>
+
+	void test_minfo_add_media_batch_with_media(MediaSvcHandle *mb_svc_handle)
+	{
+		int err = -1;
+
+		err = minfo_add_media_start(mb_svc_handle, 100);
+		if( err < 0) {
+			printf("minfo_add_media_start failed\n");
+			return;
+		}
+
+		err = minfo_add_media_batch_with_media(mb_svc_handle, "/opt/media/Images/test.jpg", MINFO_ITEM_IMAGE, "image/jpeg");
+		if( err < 0) {
+			printf("minfo_add_media_batch_with_media failed\n");
+		}
+
+		err = minfo_add_media_end(mb_svc_handle);
+		if( err < 0) {
+			printf("minfo_add_media_end failed\n");
+			return;
+		}
+	}
+ * @endcode
+ */
+
+int
+minfo_add_media_batch_with_media(MediaSvcHandle *mb_svc_handle, const char *file_url, minfo_file_type content_type, const char *mime_type);
+
 /**
  * minfo_add_media_end
  * This function inserts new media file information into media table,video_meta table/image_meta table.
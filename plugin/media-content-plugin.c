@@ -25,9 +25,7 @@
 #include "media-svc.h"
 #include "audio-svc.h"
 #include "visual-svc.h"
-
-#define MEDIA_SVC_PLUGIN_ERROR_NONE		0
-#define MEDIA_SVC_PLUGIN_ERROR			-1
+#include "media-svc-plugin-common.h"
 
 #define STRING_VALID(str)	\
 	((str != NULL && strlen(str) > 0) ? TRUE : FALSE)
@@ -35,213 +33,15 @@
 	(((storage == MEDIA_SVC_STORAGE_INTERNAL) || (storage == MEDIA_SVC_STORAGE_EXTERNAL)) ? TRUE : FALSE)
 
 
-typedef enum{
-	ERR_FILE_PATH = 1,
-	ERR_HANDLE,
-	ERR_MIME_TYPE,
-	ERR_NOT_MEDIAFILE,
-	ERR_STORAGE_TYPE,
-	ERR_CHECK_ITEM,
-	ERR_MAX,
-}media_svc_error_type_e;
-
-#define MS_CATEGORY_UNKNOWN	0x00000000	/**< Default */
-#define MS_CATEGORY_ETC		0x00000001	/**< ETC category */
-#define MS_CATEGORY_IMAGE		0x00000002	/**< Image category */
-#define MS_CATEGORY_VIDEO		0x00000004	/**< Video category */
-#define MS_CATEGORY_MUSIC		0x00000008	/**< Music category */
-#define MS_CATEGORY_SOUND	0x00000010	/**< Sound category */
-
-#define CONTENT_TYPE_NUM 4
-#define MUSIC_MIME_NUM 28
-#define SOUND_MIME_NUM 1
-#define MIME_TYPE_LENGTH 255
-#define MIME_LENGTH 50
-#define _3GP_FILE ".3gp"
-#define _MP4_FILE ".mp4"
-
-
-typedef struct {
-	char content_type[15];
-	int category_by_mime;
-} fex_content_table_t;
-
-static const fex_content_table_t content_category[CONTENT_TYPE_NUM] = {
-	{"audio", MS_CATEGORY_SOUND},
-	{"image", MS_CATEGORY_IMAGE},
-	{"video", MS_CATEGORY_VIDEO},
-	{"application", MS_CATEGORY_ETC},
-};
-
-static const char music_mime_table[MUSIC_MIME_NUM][MIME_LENGTH] = {
-	/*known mime types of normal files*/
-	"mpeg",
-	"ogg",
-	"x-ms-wma",
-	"x-flac",
-	"mp4",
-	/* known mime types of drm files*/
-	"mp3",
-	"x-mp3", /*alias of audio/mpeg*/
-	"x-mpeg", /*alias of audio/mpeg*/
-	"3gpp",
-	"x-ogg", /*alias of  audio/ogg*/
-	"vnd.ms-playready.media.pya:*.pya", /*playready*/
-	"wma",
-	"aac",
-	"x-m4a", /*alias of audio/mp4*/
-	/* below mimes are rare*/
-	"x-vorbis+ogg",
-	"x-flac+ogg",
-	"x-matroska",
-	"ac3",
-	"mp2",
-	"x-ape",
-	"x-ms-asx",
-	"vnd.rn-realaudio",
-
-	"x-vorbis", /*alias of audio/x-vorbis+ogg*/
-	"vorbis", /*alias of audio/x-vorbis+ogg*/
-	"x-oggflac",
-	"x-mp2", /*alias of audio/mp2*/
-	"x-pn-realaudio", /*alias of audio/vnd.rn-realaudio*/
-	"vnd.m-realaudio", /*alias of audio/vnd.rn-realaudio*/
-};
-
-static const char sound_mime_table[SOUND_MIME_NUM][MIME_LENGTH] = {
-	"x-smaf",
-};
-
-static int __get_content_type_from_mime(const char * path, const char * mimetype, int * category);
-static int __get_content_type(const char * file_path, const char * mime_type);
-static void __set_error_message(int err_type, char ** err_msg);
-
-static int __get_content_type_from_mime(const char * path, const char * mimetype, int * category)
-{
-	int i = 0;
-	int err = 0;
-
-	*category = MS_CATEGORY_UNKNOWN;
-
-	//MS_DBG("mime type : %s", mimetype);
-
-	/*categorize from mimetype */
-	for (i = 0; i < CONTENT_TYPE_NUM; i++) {
-		if (strstr(mimetype, content_category[i].content_type) != NULL) {
-			*category = (*category | content_category[i].category_by_mime);
-			break;
-		}
-	}
-
-	/*in application type, exitst sound file ex) x-smafs */
-	if (*category & MS_CATEGORY_ETC) {
-		int prefix_len = strlen(content_category[0].content_type);
-
-		for (i = 0; i < SOUND_MIME_NUM; i++) {
-			if (strstr(mimetype + prefix_len, sound_mime_table[i]) != NULL) {
-				*category ^= MS_CATEGORY_ETC;
-				*category |= MS_CATEGORY_SOUND;
-				break;
-			}
-		}
-	}
-
-	/*check music file in soun files. */
-	if (*category & MS_CATEGORY_SOUND) {
-		int prefix_len = strlen(content_category[0].content_type) + 1;
-
-		//MS_DBG("mime_type : %s", mimetype + prefix_len);
-
-		for (i = 0; i < MUSIC_MIME_NUM; i++) {
-			if (strcmp(mimetype + prefix_len, music_mime_table[i]) == 0) {
-				*category ^= MS_CATEGORY_SOUND;
-				*category |= MS_CATEGORY_MUSIC;
-				break;
-			}
-		}
-	} else if (*category & MS_CATEGORY_VIDEO) {
-		/*some video files don't have video stream. in this case it is categorize as music. */
-		char *ext;
-		/*"3gp" and "mp4" must check video stream and then categorize in directly. */
-		ext = strrchr(path, '.');
-		if (ext != NULL) {
-			if ((strncasecmp(ext, _3GP_FILE, 4) == 0) || (strncasecmp(ext, _MP4_FILE, 5) == 0)) {
-				int audio = 0;
-				int video = 0;
-
-				err = mm_file_get_stream_info(path, &audio, &video);
-				if (err == 0) {
-					if (audio > 0 && video == 0) {
-						*category ^= MS_CATEGORY_VIDEO;
-						*category |= MS_CATEGORY_MUSIC;
-					}
-				}
-			}
-		}
-	}
-
-	//MS_DBG("category_from_ext : %d", *category);
-
-	return err;
-}
-
-static int __get_content_type(const char * file_path, const char * mime_type)
-{
-	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
-	int category = 0;
-
-	ret = __get_content_type_from_mime(file_path, mime_type, &category);
-	if(ret < 0)
-		return ret;
-
-	if (category & MS_CATEGORY_SOUND)		return MEDIA_SVC_MEDIA_TYPE_SOUND;
-	else if (category & MS_CATEGORY_MUSIC)	return MEDIA_SVC_MEDIA_TYPE_MUSIC;
-	else if (category & MS_CATEGORY_IMAGE)	return MEDIA_SVC_MEDIA_TYPE_IMAGE;
-	else if (category & MS_CATEGORY_VIDEO)	return MEDIA_SVC_MEDIA_TYPE_VIDEO;
-	else	return MEDIA_SVC_MEDIA_TYPE_OTHER;
-}
-
-static void __set_error_message(int err_type, char ** err_msg)
-{
-	if (err_msg)
-		*err_msg = NULL;
-
-	if(err_type == ERR_FILE_PATH)
-		*err_msg = strdup("invalid file path");
-	if(err_type == ERR_HANDLE)
-		*err_msg = strdup("invalid handle");
-	else if(err_type == ERR_MIME_TYPE)
-		*err_msg = strdup("invalid mime type");
-	else if(err_type == ERR_NOT_MEDIAFILE)
-		*err_msg = strdup("not media content");
-	else if(err_type == ERR_STORAGE_TYPE)
-			*err_msg = strdup("invalid storage type");
-	else if(err_type == ERR_CHECK_ITEM)
-		*err_msg = strdup("item does not exist");
-	else if(err_type == MEDIA_INFO_ERROR_DATABASE_CONNECT)
-		*err_msg = strdup("DB connect error");
-	else if(err_type == MEDIA_INFO_ERROR_DATABASE_DISCONNECT)
-		*err_msg = strdup("DB disconnect error");
-	else if((err_type == AUDIO_SVC_ERROR_INVALID_PARAMETER) || (err_type == MB_SVC_ERROR_INVALID_PARAMETER) || (err_type == MEDIA_INFO_ERROR_INVALID_PARAMETER))
-		*err_msg = strdup("invalid parameter");
-	else if((err_type == AUDIO_SVC_ERROR_DB_INTERNAL) ||(err_type == MB_SVC_ERROR_DB_INTERNAL) ||(err_type == MEDIA_INFO_ERROR_DATABASE_INTERNAL))
-		*err_msg = strdup("DB internal error");
-	else if((err_type == AUDIO_SVC_ERROR_INTERNAL) ||(err_type == MB_SVC_ERROR_INTERNAL) || (err_type == MEDIA_INFO_ERROR_INTERNAL))
-		*err_msg = strdup("media service internal error");
-	else
-		*err_msg = strdup("error unknown");
-
-}
-
 int check_item(const char *file_path, const char * mime_type, char ** err_msg)
 {
 	if (!STRING_VALID(file_path)) {
-		__set_error_message(ERR_FILE_PATH, err_msg);
+		_media_svc_plugin_set_error_message(ERR_FILE_PATH, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
 	if (!STRING_VALID(mime_type)) {
-		__set_error_message(ERR_MIME_TYPE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_MIME_TYPE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
@@ -253,7 +53,7 @@ int connect(void ** handle, char ** err_msg)
 	int ret = media_svc_connect(handle);
 
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
@@ -265,13 +65,13 @@ int disconnect(void * handle, char ** err_msg)
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
 	ret = media_svc_disconnect(handle);
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
@@ -283,17 +83,17 @@ int check_item_exist(void* handle, const char *file_path, int storage_type, char
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
 	if (!STRING_VALID(file_path)) {
-		__set_error_message(ERR_FILE_PATH, err_msg);
+		_media_svc_plugin_set_error_message(ERR_FILE_PATH, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
 	if(!STORAGE_VALID(storage_type)) {
-		__set_error_message(ERR_STORAGE_TYPE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_STORAGE_TYPE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
@@ -301,7 +101,7 @@ int check_item_exist(void* handle, const char *file_path, int storage_type, char
 	if(ret == MEDIA_INFO_ERROR_NONE)
 		return MEDIA_SVC_PLUGIN_ERROR_NONE;	//exist
 
-	__set_error_message(ERR_CHECK_ITEM, err_msg);
+	_media_svc_plugin_set_error_message(ERR_CHECK_ITEM, err_msg);
 
 	return MEDIA_SVC_PLUGIN_ERROR;		//not exist
 }
@@ -311,17 +111,23 @@ int insert_item_begin(void * handle, int item_cnt, char ** err_msg)
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
-	ret = media_svc_insert_item_begin(handle, item_cnt);
+	ret = media_svc_scan_session_enter(handle);
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
-	return MEDIA_SVC_PLUGIN_ERROR_NONE;
+	ret = media_svc_insert_item_begin(handle, item_cnt);
+	if(ret < 0) {
+		_media_svc_plugin_set_error_message(ret, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
+	}
+
+	return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR_NONE);
 }
 
 int insert_item_end(void * handle, char ** err_msg)
@@ -329,13 +135,13 @@ int insert_item_end(void * handle, char ** err_msg)
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
 	ret = media_svc_insert_item_end(handle);
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
@@ -347,34 +153,40 @@ int insert_item(void * handle, const char *file_path, int storage_type, const ch
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
-	if (!STRING_VALID(file_path)) {
-		__set_error_message(ERR_FILE_PATH, err_msg);
+	ret = media_svc_scan_session_enter(handle);
+	if(ret < 0) {
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
+	if (!STRING_VALID(file_path)) {
+		_media_svc_plugin_set_error_message(ERR_FILE_PATH, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
+	}
+
 	if (!STRING_VALID(mime_type)) {
-		__set_error_message(ERR_MIME_TYPE, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ERR_MIME_TYPE, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 
 	if(!STORAGE_VALID(storage_type)) {
-		__set_error_message(ERR_STORAGE_TYPE, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ERR_STORAGE_TYPE, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 
-	media_svc_media_type_e content_type = __get_content_type(file_path, mime_type);
+	media_svc_media_type_e content_type = _media_svc_plugin_get_content_type(file_path, mime_type);
 
 	ret = media_svc_insert_item_bulk(handle, storage_type, file_path, mime_type, content_type);
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ret, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 
-	return MEDIA_SVC_PLUGIN_ERROR_NONE;
+	return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR_NONE);
 }
 
 int insert_item_immediately(void * handle, const char *file_path, int storage_type, const char * mime_type, char ** err_msg)
@@ -382,35 +194,41 @@ int insert_item_immediately(void * handle, const char *file_path, int storage_ty
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
-	if (!STRING_VALID(file_path)) {
-		__set_error_message(ERR_FILE_PATH, err_msg);
+	ret = media_svc_scan_session_enter(handle);
+	if(ret < 0) {
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
+	if (!STRING_VALID(file_path)) {
+		_media_svc_plugin_set_error_message(ERR_FILE_PATH, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
+	}
+
 	if (!STRING_VALID(mime_type)) {
-		__set_error_message(ERR_MIME_TYPE, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ERR_MIME_TYPE, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 
 	if(!STORAGE_VALID(storage_type)) {
-		__set_error_message(ERR_STORAGE_TYPE, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ERR_STORAGE_TYPE, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 
-	media_svc_media_type_e content_type = __get_content_type(file_path, mime_type);
+	media_svc_media_type_e content_type = _media_svc_plugin_get_content_type(file_path, mime_type);
 
 	ret = media_svc_insert_item_immediately(handle, storage_type, file_path, mime_type, content_type);
 
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ret, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 
-	return MEDIA_SVC_PLUGIN_ERROR_NONE;
+	return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR_NONE);
 }
 
 int move_item_begin(void * handle, int item_cnt, char ** err_msg)
@@ -418,17 +236,23 @@ int move_item_begin(void * handle, int item_cnt, char ** err_msg)
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
-	ret = media_svc_move_item_begin(handle, item_cnt);
+	ret = media_svc_scan_session_enter(handle);
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
-	return MEDIA_SVC_PLUGIN_ERROR_NONE;
+	ret = media_svc_move_item_begin(handle, item_cnt);
+	if(ret < 0) {
+		_media_svc_plugin_set_error_message(ret, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
+	}
+
+	return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR_NONE);
 }
 
 int move_item_end(void * handle, char ** err_msg)
@@ -436,13 +260,13 @@ int move_item_end(void * handle, char ** err_msg)
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
 	ret = media_svc_move_item_end(handle);
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
@@ -454,32 +278,38 @@ int move_item(void * handle, const char *src_path, int src_storage_type, const c
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
-	if ((!STRING_VALID(src_path)) || (!STRING_VALID(dest_path))) {
-		__set_error_message(ERR_FILE_PATH, err_msg);
+	ret = media_svc_scan_session_enter(handle);
+	if(ret < 0) {
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
+	if ((!STRING_VALID(src_path)) || (!STRING_VALID(dest_path))) {
+		_media_svc_plugin_set_error_message(ERR_FILE_PATH, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
+	}
+
 	if (!STRING_VALID(mime_type)) {
-		__set_error_message(ERR_MIME_TYPE, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ERR_MIME_TYPE, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 
 	if((!STORAGE_VALID(src_storage_type)) || (!STORAGE_VALID(dest_storage_type))) {
-		__set_error_message(ERR_STORAGE_TYPE, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ERR_STORAGE_TYPE, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 
 	ret = media_svc_move_item(handle, src_storage_type, src_path, dest_storage_type, dest_path);
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ret, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 
-	return MEDIA_SVC_PLUGIN_ERROR_NONE;
+	return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR_NONE);
 }
 
 int set_all_storage_items_validity(void * handle, int storage_type, int validity, char ** err_msg)
@@ -487,22 +317,28 @@ int set_all_storage_items_validity(void * handle, int storage_type, int validity
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
-	if(!STORAGE_VALID(storage_type)) {
-		__set_error_message(ERR_STORAGE_TYPE, err_msg);
+	ret = media_svc_scan_session_enter(handle);
+	if(ret < 0) {
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
+	if(!STORAGE_VALID(storage_type)) {
+		_media_svc_plugin_set_error_message(ERR_STORAGE_TYPE, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
+	}
+
 	ret = media_svc_set_all_storage_items_validity(handle, storage_type, validity);
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ret, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 
-	return MEDIA_SVC_PLUGIN_ERROR_NONE;
+	return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR_NONE);
 }
 
 int set_item_validity_begin(void * handle, int item_cnt, char ** err_msg)
@@ -510,17 +346,23 @@ int set_item_validity_begin(void * handle, int item_cnt, char ** err_msg)
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
-	ret = media_svc_set_item_validity_begin(handle, item_cnt);
+	ret = media_svc_scan_session_enter(handle);
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
-	return MEDIA_SVC_PLUGIN_ERROR_NONE;
+	ret = media_svc_set_item_validity_begin(handle, item_cnt);
+	if(ret < 0) {
+		_media_svc_plugin_set_error_message(ret, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
+	}
+
+	return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR_NONE);
 }
 
 int set_item_validity_end(void * handle, char ** err_msg)
@@ -528,13 +370,13 @@ int set_item_validity_end(void * handle, char ** err_msg)
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
 	ret = media_svc_set_item_validity_end(handle);
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
@@ -546,33 +388,39 @@ int set_item_validity(void * handle, const char *file_path, int storage_type, co
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
-	if (!STRING_VALID(file_path)) {
-		__set_error_message(ERR_FILE_PATH, err_msg);
+	ret = media_svc_scan_session_enter(handle);
+	if(ret < 0) {
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
+	if (!STRING_VALID(file_path)) {
+		_media_svc_plugin_set_error_message(ERR_FILE_PATH, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
+	}
+
 	if (!STRING_VALID(mime_type)) {
-		__set_error_message(ERR_MIME_TYPE, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ERR_MIME_TYPE, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 
 	if(!STORAGE_VALID(storage_type)) {
-		__set_error_message(ERR_STORAGE_TYPE, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ERR_STORAGE_TYPE, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 
 	ret = media_svc_set_item_validity(handle, file_path, validity);
 
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ret, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 
-	return MEDIA_SVC_PLUGIN_ERROR_NONE;
+	return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR_NONE);
 }
 
 int delete_item(void * handle, const char *file_path, int storage_type, char ** err_msg)
@@ -580,18 +428,24 @@ int delete_item(void * handle, const char *file_path, int storage_type, char **
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
-	if (!STRING_VALID(file_path)) {
-		__set_error_message(ERR_FILE_PATH, err_msg);
+	ret = media_svc_scan_session_enter(handle);
+	if(ret < 0) {
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
+	if (!STRING_VALID(file_path)) {
+		_media_svc_plugin_set_error_message(ERR_FILE_PATH, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
+	}
+
 	if(!STORAGE_VALID(storage_type)) {
-		__set_error_message(ERR_STORAGE_TYPE, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ERR_STORAGE_TYPE, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 
 	ret = media_svc_check_item_exist_by_path(handle, file_path);
@@ -599,15 +453,15 @@ int delete_item(void * handle, const char *file_path, int storage_type, char **
 		ret = media_svc_delete_item_by_path(handle, file_path);
 
 		if(ret < 0) {
-			__set_error_message(ret, err_msg);
-			return MEDIA_SVC_PLUGIN_ERROR;
+			_media_svc_plugin_set_error_message(ret, err_msg);
+			return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 		}
 		else
-			return MEDIA_SVC_PLUGIN_ERROR_NONE;
+			return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR_NONE);
 	}
 
-	__set_error_message(ERR_CHECK_ITEM, err_msg);	//not exist in DB so can't delete item.
-	return MEDIA_SVC_PLUGIN_ERROR;
+	_media_svc_plugin_set_error_message(ERR_CHECK_ITEM, err_msg);	//not exist in DB so can't delete item.
+	return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 }
 
 int delete_all_items_in_storage(void * handle, int storage_type, char ** err_msg)
@@ -615,18 +469,18 @@ int delete_all_items_in_storage(void * handle, int storage_type, char ** err_msg
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
 	if(!STORAGE_VALID(storage_type)) {
-		__set_error_message(ERR_STORAGE_TYPE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_STORAGE_TYPE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
 	ret = media_svc_delete_all_items_in_storage(handle, storage_type);
 	if(ret < 0) {
-			__set_error_message(ret, err_msg);
+			_media_svc_plugin_set_error_message(ret, err_msg);
 			return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
@@ -638,18 +492,18 @@ int delete_all_invalid_items_in_storage(void * handle, int storage_type, char **
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
 	if(!STORAGE_VALID(storage_type)) {
-		__set_error_message(ERR_STORAGE_TYPE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_STORAGE_TYPE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
 	ret = media_svc_delete_invalid_items_in_storage(handle, storage_type);
 	if(ret < 0) {
-			__set_error_message(ret, err_msg);
+			_media_svc_plugin_set_error_message(ret, err_msg);
 			return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
@@ -661,7 +515,7 @@ int delete_all_items(void * handle, char ** err_msg)
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
@@ -681,31 +535,31 @@ int refresh_item(void * handle, const char *file_path, int storage_type, const c
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
 	if (!STRING_VALID(file_path)) {
-		__set_error_message(ERR_FILE_PATH, err_msg);
+		_media_svc_plugin_set_error_message(ERR_FILE_PATH, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
 	if (!STRING_VALID(mime_type)) {
-		__set_error_message(ERR_MIME_TYPE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_MIME_TYPE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
 	if(!STORAGE_VALID(storage_type)) {
-		__set_error_message(ERR_STORAGE_TYPE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_STORAGE_TYPE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
-	media_svc_media_type_e content_type = __get_content_type(file_path, mime_type);
+	media_svc_media_type_e content_type = _media_svc_plugin_get_content_type(file_path, mime_type);
 
 	ret = media_svc_refresh_item(handle, storage_type, file_path, content_type);
 
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
@@ -714,10 +568,40 @@ int refresh_item(void * handle, const char *file_path, int storage_type, const c
 
 int update_begin(void)
 {
+	int ret = media_svc_scan_update_begin();
+
+	if (ret < 0)
+		return MEDIA_SVC_PLUGIN_ERROR;
+
 	return MEDIA_SVC_PLUGIN_ERROR_NONE;
 }
 
 int update_end(void)
 {
+	int ret = media_svc_scan_update_end();
+
+	if (ret < 0)
+		return MEDIA_SVC_PLUGIN_ERROR;
+
 	return MEDIA_SVC_PLUGIN_ERROR_NONE;
 }
+
+int insert_items(void * handle, const char **file_paths, const int *storage_types, const char **mime_types, int item_cnt, int *status, char ** err_msg)
+{
+	return _media_svc_plugin_insert_items(insert_item, handle, file_paths, storage_types, mime_types, item_cnt, status, err_msg);
+}
+
+int move_items(void * handle, const char **src_paths, const int *src_storage_types, const char **dest_paths, const int *dest_storage_types, const char **mime_types, int item_cnt, int *status, char ** err_msg)
+{
+	return _media_svc_plugin_move_items(move_item, TRUE, handle, src_paths, src_storage_types, dest_paths, dest_storage_types, mime_types, item_cnt, status, err_msg);
+}
+
+int set_items_validity(void * handle, const char **file_paths, const int *storage_types, const char **mime_types, int validity, int item_cnt, int *status, char ** err_msg)
+{
+	return _media_svc_plugin_set_items_validity(set_item_validity, handle, file_paths, storage_types, mime_types, validity, item_cnt, status, err_msg);
+}
+
+int delete_items(void * handle, const char **file_paths, const int *storage_types, int item_cnt, int *status, char ** err_msg)
+{
+	return _media_svc_plugin_delete_items(delete_item, handle, file_paths, storage_types, item_cnt, status, err_msg);
+}
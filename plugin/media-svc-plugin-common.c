@@ -0,0 +1,433 @@
+/*
+ * libmedia-service
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Hyunjun Ko <zzoon.ko@samsung.com>, Haejeong Kim <backto.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "media-svc.h"
+#include "audio-svc.h"
+#include "visual-svc.h"
+#include "media-svc-plugin-common.h"
+#include "media-svc-util.h"
+#include "media-svc-debug.h"
+
+#define MS_CATEGORY_UNKNOWN	0x00000000	/**< Default */
+#define MS_CATEGORY_ETC		0x00000001	/**< ETC category */
+#define MS_CATEGORY_IMAGE		0x00000002	/**< Image category */
+#define MS_CATEGORY_VIDEO		0x00000004	/**< Video category */
+#define MS_CATEGORY_MUSIC		0x00000008	/**< Music category */
+#define MS_CATEGORY_SOUND	0x00000010	/**< Sound category */
+
+#define CONTENT_TYPE_NUM 4
+#define SOUND_MIME_NUM 1
+#define MIME_LENGTH 50
+#define _3GP_FILE ".3gp"
+#define _MP4_FILE ".mp4"
+
+typedef struct {
+	char content_type[15];
+	int category_by_mime;
+} fex_content_table_t;
+
+static const fex_content_table_t content_category[CONTENT_TYPE_NUM] = {
+	{"audio", MS_CATEGORY_SOUND},
+	{"image", MS_CATEGORY_IMAGE},
+	{"video", MS_CATEGORY_VIDEO},
+	{"application", MS_CATEGORY_ETC},
+};
+
+const char * const _media_svc_plugin_music_mime_list[] = {
+	/*known mime types of normal files*/
+	"mpeg",
+	"ogg",
+	"x-ms-wma",
+	"x-flac",
+	"mp4",
+	/* known mime types of drm files*/
+	"mp3",
+	"x-mp3", /*alias of audio/mpeg*/
+	"x-mpeg", /*alias of audio/mpeg*/
+	"3gpp",
+	"x-ogg", /*alias of  audio/ogg*/
+	"vnd.ms-playready.media.pya:*.pya", /*playready*/
+	"wma",
+	"aac",
+	"x-m4a", /*alias of audio/mp4*/
+	/* below mimes are rare*/
+	"x-vorbis+ogg",
+	"x-flac+ogg",
+	"x-matroska",
+	"ac3",
+	"mp2",
+	"x-ape",
+	"x-ms-asx",
+	"vnd.rn-realaudio",
+
+	"x-vorbis", /*alias of audio/x-vorbis+ogg*/
+	"vorbis", /*alias of audio/x-vorbis+ogg*/
+	"x-oggflac",
+	"x-mp2", /*alias of audio/mp2*/
+	"x-pn-realaudio", /*alias of audio/vnd.rn-realaudio*/
+	"vnd.m-realaudio", /*alias of audio/vnd.rn-realaudio*/
+	NULL
+};
+
+static const char sound_mime_table[SOUND_MIME_NUM][MIME_LENGTH] = {
+	"x-smaf",
+};
+
+/* slot table of music mime list by MUSIC_MIME_HASH(). every slot has at most one entry, so one strcmp() confirms a hit.
+ * test/plugin/music_mime_hash.c checks that it matches the list, update both when the list or the weights change. */
+const char * const _media_svc_plugin_music_mime_table[MUSIC_MIME_HASH_SIZE] = {
+	[0] = "vnd.m-realaudio",
+	[1] = "vnd.rn-realaudio",
+	[2] = "x-matroska",
+	[7] = "wma",
+	[13] = "x-ms-asx",
+	[14] = "mp4",
+	[15] = "ac3",
+	[16] = "mp3",
+	[18] = "mp2",
+	[20] = "x-mp3",
+	[22] = "x-mp2",
+	[25] = "x-pn-realaudio",
+	[28] = "x-vorbis",
+	[30] = "mpeg",
+	[36] = "x-ape",
+	[39] = "x-flac+ogg",
+	[44] = "vorbis",
+	[45] = "aac",
+	[46] = "x-ogg",
+	[47] = "x-vorbis+ogg",
+	[48] = "x-mpeg",
+	[49] = "3gpp",
+	[50] = "x-oggflac",
+	[52] = "x-flac",
+	[54] = "vnd.ms-playready.media.pya:*.pya",
+	[56] = "x-m4a",
+	[59] = "x-ms-wma",
+	[61] = "ogg",
+};
+
+#define STORAGE_VALID(storage)\
+	(((storage == MEDIA_SVC_STORAGE_INTERNAL) || (storage == MEDIA_SVC_STORAGE_EXTERNAL)) ? TRUE : FALSE)
+
+static int __get_content_type_from_mime(const char * path, const char * mimetype, int * category);
+static int __items_begin(void * handle, bool arrays_valid, int item_cnt, int *status, char ** err_msg);
+static void __keep_first_error(char ** err_msg, char ** item_msg);
+
+bool _media_svc_plugin_is_music_mime(const char *subtype)
+{
+	int len = strlen(subtype);
+	const char *entry = NULL;
+
+	if (len == 0)
+		return FALSE;
+
+	entry = _media_svc_plugin_music_mime_table[MUSIC_MIME_HASH(subtype, len)];
+
+	return (entry != NULL && strcmp(subtype, entry) == 0) ? TRUE : FALSE;
+}
+
+static int __get_content_type_from_mime(const char * path, const char * mimetype, int * category)
+{
+	int i = 0;
+	int err = 0;
+
+	*category = MS_CATEGORY_UNKNOWN;
+
+	//MS_DBG("mime type : %s", mimetype);
+
+	/*categorize from mimetype */
+	for (i = 0; i < CONTENT_TYPE_NUM; i++) {
+		if (strstr(mimetype, content_category[i].content_type) != NULL) {
+			*category = (*category | content_category[i].category_by_mime);
+			break;
+		}
+	}
+
+	/*in application type, exitst sound file ex) x-smafs */
+	if (*category & MS_CATEGORY_ETC) {
+		int prefix_len = strlen(content_category[0].content_type);
+
+		for (i = 0; i < SOUND_MIME_NUM; i++) {
+			if (strstr(mimetype + prefix_len, sound_mime_table[i]) != NULL) {
+				*category ^= MS_CATEGORY_ETC;
+				*category |= MS_CATEGORY_SOUND;
+				break;
+			}
+		}
+	}
+
+	/*check music file in soun files. */
+	if (*category & MS_CATEGORY_SOUND) {
+		int prefix_len = strlen(content_category[0].content_type) + 1;
+
+		//MS_DBG("mime_type : %s", mimetype + prefix_len);
+
+		if (strlen(mimetype) > prefix_len && _media_svc_plugin_is_music_mime(mimetype + prefix_len)) {
+			*category ^= MS_CATEGORY_SOUND;
+			*category |= MS_CATEGORY_MUSIC;
+		}
+	} else if (*category & MS_CATEGORY_VIDEO) {
+		/*some video files don't have video stream. in this case it is categorize as music. */
+		char *ext;
+		/*"3gp" and "mp4" must check video stream and then categorize in directly. */
+		ext = strrchr(path, '.');
+		if (ext != NULL) {
+			if ((strncasecmp(ext, _3GP_FILE, 4) == 0) || (strncasecmp(ext, _MP4_FILE, 5) == 0)) {
+				int audio = 0;
+				int video = 0;
+
+				/* stream info is kept by the library, so check and insert of the file demux it once */
+				err = _media_svc_get_stream_info(path, &audio, &video);
+				if (err == 0) {
+					if (audio > 0 && video == 0) {
+						*category ^= MS_CATEGORY_VIDEO;
+						*category |= MS_CATEGORY_MUSIC;
+					}
+				}
+			}
+		}
+	}
+
+	//MS_DBG("category_from_ext : %d", *category);
+
+	return err;
+}
+
+int _media_svc_plugin_get_content_type(const char * file_path, const char * mime_type)
+{
+	int ret = 0;
+	int category = 0;
+
+	ret = __get_content_type_from_mime(file_path, mime_type, &category);
+	if(ret < 0)
+		return ret;
+
+	if (category & MS_CATEGORY_SOUND)		return MEDIA_SVC_MEDIA_TYPE_SOUND;
+	else if (category & MS_CATEGORY_MUSIC)	return MEDIA_SVC_MEDIA_TYPE_MUSIC;
+	else if (category & MS_CATEGORY_IMAGE)	return MEDIA_SVC_MEDIA_TYPE_IMAGE;
+	else if (category & MS_CATEGORY_VIDEO)	return MEDIA_SVC_MEDIA_TYPE_VIDEO;
+	else	return MEDIA_SVC_MEDIA_TYPE_OTHER;
+}
+
+void _media_svc_plugin_set_error_message(int err_type, char ** err_msg)
+{
+	if (err_msg)
+		*err_msg = NULL;
+
+	if(err_type == ERR_FILE_PATH)
+		*err_msg = strdup("invalid file path");
+	if(err_type == ERR_HANDLE)
+		*err_msg = strdup("invalid handle");
+	else if(err_type == ERR_MIME_TYPE)
+		*err_msg = strdup("invalid mime type");
+	else if(err_type == ERR_NOT_MEDIAFILE)
+		*err_msg = strdup("not media content");
+	else if(err_type == ERR_STORAGE_TYPE)
+			*err_msg = strdup("invalid storage type");
+	else if(err_type == ERR_CHECK_ITEM)
+		*err_msg = strdup("item does not exist");
+	else if(err_type == MEDIA_INFO_ERROR_DATABASE_CONNECT)
+		*err_msg = strdup("DB connect error");
+	else if(err_type == MEDIA_INFO_ERROR_DATABASE_DISCONNECT)
+		*err_msg = strdup("DB disconnect error");
+	else if((err_type == AUDIO_SVC_ERROR_INVALID_PARAMETER) || (err_type == MB_SVC_ERROR_INVALID_PARAMETER) || (err_type == MEDIA_INFO_ERROR_INVALID_PARAMETER))
+		*err_msg = strdup("invalid parameter");
+	else if((err_type == AUDIO_SVC_ERROR_DB_INTERNAL) ||(err_type == MB_SVC_ERROR_DB_INTERNAL) ||(err_type == MEDIA_INFO_ERROR_DATABASE_INTERNAL))
+		*err_msg = strdup("DB internal error");
+	else if((err_type == AUDIO_SVC_ERROR_INTERNAL) ||(err_type == MB_SVC_ERROR_INTERNAL) || (err_type == MEDIA_INFO_ERROR_INTERNAL))
+		*err_msg = strdup("media service internal error");
+	else
+		*err_msg = strdup("error unknown");
+
+}
+
+/* Ends a write call begun by media_svc_scan_session_enter. Scan session commits its work here once it holds the lock longer than target,
+ * so that the lock is not held while the scanner is idle */
+int _media_svc_plugin_scan_leave(void *handle, int ret)
+{
+	media_svc_scan_session_leave(handle);
+
+	return ret;
+}
+
+static int __items_begin(void * handle, bool arrays_valid, int item_cnt, int *status, char ** err_msg)
+{
+	if(handle == NULL) {
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
+		return MEDIA_SVC_PLUGIN_ERROR;
+	}
+
+	if(!arrays_valid || (status == NULL) || (item_cnt <= 0)) {
+		_media_svc_plugin_set_error_message(MEDIA_INFO_ERROR_INVALID_PARAMETER, err_msg);
+		return MEDIA_SVC_PLUGIN_ERROR;
+	}
+
+	if (err_msg)
+		*err_msg = NULL;
+
+	return MEDIA_SVC_PLUGIN_ERROR_NONE;
+}
+
+/* err_msg of batched call is the message of the first failed item */
+static void __keep_first_error(char ** err_msg, char ** item_msg)
+{
+	if (err_msg != NULL && *err_msg == NULL)
+		*err_msg = *item_msg;
+	else
+		free(*item_msg);
+
+	*item_msg = NULL;
+}
+
+int _media_svc_plugin_insert_items(media_svc_plugin_insert_item_func insert_func, void * handle, const char **file_paths, const int *storage_types,
+	const char **mime_types, int item_cnt, int *status, char ** err_msg)
+{
+	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
+	char *item_msg = NULL;
+	int i = 0;
+
+	ret = __items_begin(handle, (file_paths != NULL) && (storage_types != NULL) && (mime_types != NULL), item_cnt, status, err_msg);
+	if (ret < 0)
+		return ret;
+
+	for (i = 0; i < item_cnt; i++) {
+		status[i] = insert_func(handle, file_paths[i], storage_types[i], mime_types[i], &item_msg);
+		if (status[i] < 0) {
+			__keep_first_error(err_msg, &item_msg);
+			ret = MEDIA_SVC_PLUGIN_ERROR;
+		}
+	}
+
+	return ret;
+}
+
+int _media_svc_plugin_move_items(media_svc_plugin_move_item_func move_func, bool move_batch, void * handle, const char **src_paths, const int *src_storage_types,
+	const char **dest_paths, const int *dest_storage_types, const char **mime_types, int item_cnt, int *status, char ** err_msg)
+{
+	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
+	char *item_msg = NULL;
+	int i = 0;
+	int j = 0;
+	int k = 0;
+	int batch_ret = MEDIA_INFO_ERROR_NONE;
+	media_svc_move_item_s *items = NULL;
+
+	ret = __items_begin(handle, (src_paths != NULL) && (src_storage_types != NULL) && (dest_paths != NULL) && (dest_storage_types != NULL)
+		&& (mime_types != NULL), item_cnt, status, err_msg);
+	if (ret < 0)
+		return ret;
+
+	if (move_batch) {
+		items = (media_svc_move_item_s *)calloc(item_cnt, sizeof(media_svc_move_item_s));
+		if (items == NULL) {
+			_media_svc_plugin_set_error_message(MEDIA_INFO_ERROR_INTERNAL, err_msg);
+			return MEDIA_SVC_PLUGIN_ERROR;
+		}
+
+		ret = media_svc_scan_session_enter(handle);
+		if (ret < 0) {
+			free(items);
+			_media_svc_plugin_set_error_message(ret, err_msg);
+			return MEDIA_SVC_PLUGIN_ERROR;
+		}
+	}
+
+	for (i = 0; i < item_cnt; i = j) {
+		/* items moved to one storage are moved by one call. if it fails, they are moved one by one to find failed items */
+		j = i + 1;
+		batch_ret = MEDIA_INFO_ERROR_INVALID_PARAMETER;
+
+		if (move_batch) {
+			for (j = i; (j < item_cnt) && (dest_storage_types[j] == dest_storage_types[i]); j++) {
+				items[j - i].src_path = src_paths[j];
+				items[j - i].dest_path = dest_paths[j];
+			}
+
+			if (STORAGE_VALID(dest_storage_types[i]))
+				batch_ret = media_svc_move_items(handle, dest_storage_types[i], items, j - i);
+		}
+
+		for (k = i; k < j; k++) {
+			if (batch_ret == MEDIA_INFO_ERROR_NONE)
+				status[k] = MEDIA_SVC_PLUGIN_ERROR_NONE;
+			else
+				status[k] = move_func(handle, src_paths[k], src_storage_types[k], dest_paths[k], dest_storage_types[k], mime_types[k], &item_msg);
+
+			if (status[k] < 0) {
+				__keep_first_error(err_msg, &item_msg);
+				ret = MEDIA_SVC_PLUGIN_ERROR;
+			}
+		}
+	}
+
+	free(items);
+
+	if (move_batch)
+		media_svc_scan_session_leave(handle);
+
+	return ret;
+}
+
+int _media_svc_plugin_set_items_validity(media_svc_plugin_set_item_validity_func validity_func, void * handle, const char **file_paths, const int *storage_types,
+	const char **mime_types, int validity, int item_cnt, int *status, char ** err_msg)
+{
+	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
+	char *item_msg = NULL;
+	int i = 0;
+
+	ret = __items_begin(handle, (file_paths != NULL) && (storage_types != NULL) && (mime_types != NULL), item_cnt, status, err_msg);
+	if (ret < 0)
+		return ret;
+
+	for (i = 0; i < item_cnt; i++) {
+		status[i] = validity_func(handle, file_paths[i], storage_types[i], mime_types[i], validity, &item_msg);
+		if (status[i] < 0) {
+			__keep_first_error(err_msg, &item_msg);
+			ret = MEDIA_SVC_PLUGIN_ERROR;
+		}
+	}
+
+	return ret;
+}
+
+int _media_svc_plugin_delete_items(media_svc_plugin_delete_item_func delete_func, void * handle, const char **file_paths, const int *storage_types,
+	int item_cnt, int *status, char ** err_msg)
+{
+	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
+	char *item_msg = NULL;
+	int i = 0;
+
+	ret = __items_begin(handle, (file_paths != NULL) && (storage_types != NULL), item_cnt, status, err_msg);
+	if (ret < 0)
+		return ret;
+
+	for (i = 0; i < item_cnt; i++) {
+		status[i] = delete_func(handle, file_paths[i], storage_types[i], &item_msg);
+		if (status[i] < 0) {
+			__keep_first_error(err_msg, &item_msg);
+			ret = MEDIA_SVC_PLUGIN_ERROR;
+		}
+	}
+
+	return ret;
+}
@@ -0,0 +1,84 @@
+/*
+ * libmedia-service
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Hyunjun Ko <zzoon.ko@samsung.com>, Haejeong Kim <backto.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _MEDIA_SVC_PLUGIN_COMMON_H_
+#define _MEDIA_SVC_PLUGIN_COMMON_H_
+
+#include <stdbool.h>
+#include "media-svc-types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MEDIA_SVC_PLUGIN_ERROR_NONE		0
+#define MEDIA_SVC_PLUGIN_ERROR			-1
+
+typedef enum{
+	ERR_FILE_PATH = 1,
+	ERR_HANDLE,
+	ERR_MIME_TYPE,
+	ERR_NOT_MEDIAFILE,
+	ERR_STORAGE_TYPE,
+	ERR_CHECK_ITEM,
+	ERR_MAX,
+}media_svc_error_type_e;
+
+/* per-item calls of a plugin, run by batched calls */
+typedef int (*media_svc_plugin_insert_item_func)(void *handle, const char *file_path, int storage_type, const char *mime_type, char **err_msg);
+typedef int (*media_svc_plugin_move_item_func)(void *handle, const char *src_path, int src_storage_type, const char *dest_path, int dest_storage_type, const char *mime_type, char **err_msg);
+typedef int (*media_svc_plugin_set_item_validity_func)(void *handle, const char *file_path, int storage_type, const char *mime_type, int validity, char **err_msg);
+typedef int (*media_svc_plugin_delete_item_func)(void *handle, const char *file_path, int storage_type, char **err_msg);
+
+/* hash of music mime subtype, after "audio/". It takes length, first, middle and last characters.
+ * weights are fixed so that no two known subtypes share a slot of _media_svc_plugin_music_mime_table. */
+#define MUSIC_MIME_HASH_SIZE		64
+#define MUSIC_MIME_HASH_FIRST		47
+#define MUSIC_MIME_HASH_LAST		62
+#define MUSIC_MIME_HASH(str, len)	\
+	(((len) + (unsigned char)(str)[0] * MUSIC_MIME_HASH_FIRST + (unsigned char)(str)[(len) - 1] * MUSIC_MIME_HASH_LAST + (unsigned char)(str)[(len) / 2]) & (MUSIC_MIME_HASH_SIZE - 1))
+
+/* known music mime subtypes, ended by NULL */
+extern const char * const _media_svc_plugin_music_mime_list[];
+/* the same subtypes at their MUSIC_MIME_HASH slots */
+extern const char * const _media_svc_plugin_music_mime_table[MUSIC_MIME_HASH_SIZE];
+
+bool _media_svc_plugin_is_music_mime(const char *subtype);
+int _media_svc_plugin_get_content_type(const char *file_path, const char *mime_type);
+void _media_svc_plugin_set_error_message(int err_type, char **err_msg);
+int _media_svc_plugin_scan_leave(void *handle, int ret);
+
+/* batched calls. status of each item is set by its per-item call, and err_msg is the message of the first failed item.
+ * if move_batch is TRUE, items moved to one storage are moved by one media_svc_move_items call first */
+int _media_svc_plugin_insert_items(media_svc_plugin_insert_item_func insert_func, void *handle, const char **file_paths, const int *storage_types,
+	const char **mime_types, int item_cnt, int *status, char **err_msg);
+int _media_svc_plugin_move_items(media_svc_plugin_move_item_func move_func, bool move_batch, void *handle, const char **src_paths, const int *src_storage_types,
+	const char **dest_paths, const int *dest_storage_types, const char **mime_types, int item_cnt, int *status, char **err_msg);
+int _media_svc_plugin_set_items_validity(media_svc_plugin_set_item_validity_func validity_func, void *handle, const char **file_paths, const int *storage_types,
+	const char **mime_types, int validity, int item_cnt, int *status, char **err_msg);
+int _media_svc_plugin_delete_items(media_svc_plugin_delete_item_func delete_func, void *handle, const char **file_paths, const int *storage_types,
+	int item_cnt, int *status, char **err_msg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*_MEDIA_SVC_PLUGIN_COMMON_H_*/
@@ -25,235 +25,35 @@
 #include "media-svc.h"
 #include "audio-svc.h"
 #include "visual-svc.h"
+#include "media-svc-plugin-common.h"
 
 //#define NEW_MEDIA_SVC
 
-#define MEDIA_SVC_PLUGIN_ERROR_NONE		0
-#define MEDIA_SVC_PLUGIN_ERROR			-1
-
 #define STRING_VALID(str)	\
 	((str != NULL && strlen(str) > 0) ? TRUE : FALSE)
 #define STORAGE_VALID(storage)\
 	(((storage == MEDIA_SVC_STORAGE_INTERNAL) || (storage == MEDIA_SVC_STORAGE_EXTERNAL)) ? TRUE : FALSE)
 
 
-typedef enum{
-	ERR_FILE_PATH = 1,
-	ERR_HANDLE,
-	ERR_MIME_TYPE,
-	ERR_NOT_MEDIAFILE,
-	ERR_STORAGE_TYPE,
-	ERR_CHECK_ITEM,
-	ERR_MAX,
-}media_svc_error_type_e;
-
-#define MS_CATEGORY_UNKNOWN	0x00000000	/**< Default */
-#define MS_CATEGORY_ETC		0x00000001	/**< ETC category */
-#define MS_CATEGORY_IMAGE		0x00000002	/**< Image category */
-#define MS_CATEGORY_VIDEO		0x00000004	/**< Video category */
-#define MS_CATEGORY_MUSIC		0x00000008	/**< Music category */
-#define MS_CATEGORY_SOUND	0x00000010	/**< Sound category */
-
-#define CONTENT_TYPE_NUM 4
-#define MUSIC_MIME_NUM 28
-#define SOUND_MIME_NUM 1
-#define MIME_TYPE_LENGTH 255
-#define MIME_LENGTH 50
-#define _3GP_FILE ".3gp"
-#define _MP4_FILE ".mp4"
-
-
-typedef struct {
-	char content_type[15];
-	int category_by_mime;
-} fex_content_table_t;
-
-static const fex_content_table_t content_category[CONTENT_TYPE_NUM] = {
-	{"audio", MS_CATEGORY_SOUND},
-	{"image", MS_CATEGORY_IMAGE},
-	{"video", MS_CATEGORY_VIDEO},
-	{"application", MS_CATEGORY_ETC},
-};
-
-static const char music_mime_table[MUSIC_MIME_NUM][MIME_LENGTH] = {
-	/*known mime types of normal files*/
-	"mpeg",
-	"ogg",
-	"x-ms-wma",
-	"x-flac",
-	"mp4",
-	/* known mime types of drm files*/
-	"mp3",
-	"x-mp3", /*alias of audio/mpeg*/
-	"x-mpeg", /*alias of audio/mpeg*/
-	"3gpp",
-	"x-ogg", /*alias of  audio/ogg*/
-	"vnd.ms-playready.media.pya:*.pya", /*playready*/
-	"wma",
-	"aac",
-	"x-m4a", /*alias of audio/mp4*/
-	/* below mimes are rare*/
-	"x-vorbis+ogg",
-	"x-flac+ogg",
-	"x-matroska",
-	"ac3",
-	"mp2",
-	"x-ape",
-	"x-ms-asx",
-	"vnd.rn-realaudio",
-
-	"x-vorbis", /*alias of audio/x-vorbis+ogg*/
-	"vorbis", /*alias of audio/x-vorbis+ogg*/
-	"x-oggflac",
-	"x-mp2", /*alias of audio/mp2*/
-	"x-pn-realaudio", /*alias of audio/vnd.rn-realaudio*/
-	"vnd.m-realaudio", /*alias of audio/vnd.rn-realaudio*/
-};
-
-static const char sound_mime_table[SOUND_MIME_NUM][MIME_LENGTH] = {
-	"x-smaf",
-};
-
-static int __get_content_type_from_mime(const char * path, const char * mimetype, int * category);
-static int __get_content_type(const char * file_path, const char * mime_type);
-static void __set_error_message(int err_type, char ** err_msg);
-
-static int __get_content_type_from_mime(const char * path, const char * mimetype, int * category)
-{
-	int i = 0;
-	int err = 0;
-
-	*category = MS_CATEGORY_UNKNOWN;
-
-	//MS_DBG("mime type : %s", mimetype);
-
-	/*categorize from mimetype */
-	for (i = 0; i < CONTENT_TYPE_NUM; i++) {
-		if (strstr(mimetype, content_category[i].content_type) != NULL) {
-			*category = (*category | content_category[i].category_by_mime);
-			break;
-		}
-	}
-
-	/*in application type, exitst sound file ex) x-smafs */
-	if (*category & MS_CATEGORY_ETC) {
-		int prefix_len = strlen(content_category[0].content_type);
-
-		for (i = 0; i < SOUND_MIME_NUM; i++) {
-			if (strstr(mimetype + prefix_len, sound_mime_table[i]) != NULL) {
-				*category ^= MS_CATEGORY_ETC;
-				*category |= MS_CATEGORY_SOUND;
-				break;
-			}
-		}
-	}
-
-	/*check music file in soun files. */
-	if (*category & MS_CATEGORY_SOUND) {
-		int prefix_len = strlen(content_category[0].content_type) + 1;
-
-		//MS_DBG("mime_type : %s", mimetype + prefix_len);
-
-		for (i = 0; i < MUSIC_MIME_NUM; i++) {
-			if (strcmp(mimetype + prefix_len, music_mime_table[i]) == 0) {
-				*category ^= MS_CATEGORY_SOUND;
-				*category |= MS_CATEGORY_MUSIC;
-				break;
-			}
-		}
-	} else if (*category & MS_CATEGORY_VIDEO) {
-		/*some video files don't have video stream. in this case it is categorize as music. */
-		char *ext;
-		/*"3gp" and "mp4" must check video stream and then categorize in directly. */
-		ext = strrchr(path, '.');
-		if (ext != NULL) {
-			if ((strncasecmp(ext, _3GP_FILE, 4) == 0) || (strncasecmp(ext, _MP4_FILE, 5) == 0)) {
-				int audio = 0;
-				int video = 0;
-
-				err = mm_file_get_stream_info(path, &audio, &video);
-				if (err == 0) {
-					if (audio > 0 && video == 0) {
-						*category ^= MS_CATEGORY_VIDEO;
-						*category |= MS_CATEGORY_MUSIC;
-					}
-				}
-			}
-		}
-	}
-
-	//MS_DBG("category_from_ext : %d", *category);
-
-	return err;
-}
-
-static int __get_content_type(const char * file_path, const char * mime_type)
-{
-	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
-	int category = 0;
-
-	ret = __get_content_type_from_mime(file_path, mime_type, &category);
-	if(ret < 0)
-		return ret;
-
-	if (category & MS_CATEGORY_SOUND)		return MEDIA_SVC_MEDIA_TYPE_SOUND;
-	else if (category & MS_CATEGORY_MUSIC)	return MEDIA_SVC_MEDIA_TYPE_MUSIC;
-	else if (category & MS_CATEGORY_IMAGE)	return MEDIA_SVC_MEDIA_TYPE_IMAGE;
-	else if (category & MS_CATEGORY_VIDEO)	return MEDIA_SVC_MEDIA_TYPE_VIDEO;
-	else	return MEDIA_SVC_MEDIA_TYPE_OTHER;
-}
-
-static void __set_error_message(int err_type, char ** err_msg)
-{
-	if (err_msg)
-		*err_msg = NULL;
-
-	if(err_type == ERR_FILE_PATH)
-		*err_msg = strdup("invalid file path");
-	if(err_type == ERR_HANDLE)
-		*err_msg = strdup("invalid handle");
-	else if(err_type == ERR_MIME_TYPE)
-		*err_msg = strdup("invalid mime type");
-	else if(err_type == ERR_NOT_MEDIAFILE)
-		*err_msg = strdup("not media content");
-	else if(err_type == ERR_STORAGE_TYPE)
-			*err_msg = strdup("invalid storage type");
-	else if(err_type == ERR_CHECK_ITEM)
-		*err_msg = strdup("item does not exist");
-	else if(err_type == MEDIA_INFO_ERROR_DATABASE_CONNECT)
-		*err_msg = strdup("DB connect error");
-	else if(err_type == MEDIA_INFO_ERROR_DATABASE_DISCONNECT)
-		*err_msg = strdup("DB disconnect error");
-	else if((err_type == AUDIO_SVC_ERROR_INVALID_PARAMETER) || (err_type == MB_SVC_ERROR_INVALID_PARAMETER) || (err_type == MEDIA_INFO_ERROR_INVALID_PARAMETER))
-		*err_msg = strdup("invalid parameter");
-	else if((err_type == AUDIO_SVC_ERROR_DB_INTERNAL) ||(err_type == MB_SVC_ERROR_DB_INTERNAL) ||(err_type == MEDIA_INFO_ERROR_DATABASE_INTERNAL))
-		*err_msg = strdup("DB internal error");
-	else if((err_type == AUDIO_SVC_ERROR_INTERNAL) ||(err_type == MB_SVC_ERROR_INTERNAL) || (err_type == MEDIA_INFO_ERROR_INTERNAL))
-		*err_msg = strdup("media service internal error");
-	else
-		*err_msg = strdup("error unknown");
-
-}
-
 int check_item(const char *file_path, const char * mime_type, char ** err_msg)
 {
 	int content_type = 0;
 
 	if (!STRING_VALID(file_path)) {
-		__set_error_message(ERR_FILE_PATH, err_msg);
+		_media_svc_plugin_set_error_message(ERR_FILE_PATH, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
 	if (!STRING_VALID(mime_type)) {
-		__set_error_message(ERR_MIME_TYPE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_MIME_TYPE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
-	content_type = __get_content_type(file_path, mime_type);
+	content_type = _media_svc_plugin_get_content_type(file_path, mime_type);
 
 #ifndef NEW_MEDIA_SVC
 	if(content_type == MEDIA_SVC_MEDIA_TYPE_OTHER) {
-		__set_error_message(ERR_NOT_MEDIAFILE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_NOT_MEDIAFILE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;		//not media file
 	}
 	else
@@ -266,7 +66,7 @@ int connect(void ** handle, char ** err_msg)
 	int ret = media_svc_connect(handle);
 
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
@@ -278,13 +78,13 @@ int disconnect(void * handle, char ** err_msg)
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
 	ret = media_svc_disconnect(handle);
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
@@ -296,17 +96,17 @@ int check_item_exist(void* handle, const char *file_path, int storage_type, char
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
 	if (!STRING_VALID(file_path)) {
-		__set_error_message(ERR_FILE_PATH, err_msg);
+		_media_svc_plugin_set_error_message(ERR_FILE_PATH, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
 	if(!STORAGE_VALID(storage_type)) {
-		__set_error_message(ERR_STORAGE_TYPE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_STORAGE_TYPE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
@@ -334,7 +134,7 @@ int check_item_exist(void* handle, const char *file_path, int storage_type, char
 	}
 #endif
 
-	__set_error_message(ERR_CHECK_ITEM, err_msg);
+	_media_svc_plugin_set_error_message(ERR_CHECK_ITEM, err_msg);
 
 	return MEDIA_SVC_PLUGIN_ERROR;		//not exist
 }
@@ -344,31 +144,37 @@ int insert_item_begin(void * handle, int item_cnt, char ** err_msg)
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
-	ret = audio_svc_insert_item_start(handle, item_cnt);
+	ret = media_svc_scan_session_enter(handle);
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
+	ret = audio_svc_insert_item_start(handle, item_cnt);
+	if(ret < 0) {
+		_media_svc_plugin_set_error_message(ret, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
+	}
+
 	ret = minfo_add_media_start(handle, item_cnt);
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ret, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 
 #ifdef NEW_MEDIA_SVC
 	ret = media_svc_insert_item_begin(handle, item_cnt);
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ret, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 #endif
 
-	return MEDIA_SVC_PLUGIN_ERROR_NONE;
+	return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR_NONE);
 }
 
 int insert_item_end(void * handle, char ** err_msg)
@@ -376,26 +182,26 @@ int insert_item_end(void * handle, char ** err_msg)
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
 	ret = audio_svc_insert_item_end(handle);
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
 	ret = minfo_add_media_end(handle);
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
 #ifdef NEW_MEDIA_SVC
 	ret = media_svc_insert_item_end(handle);
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 #endif
@@ -408,27 +214,53 @@ int insert_item(void * handle, const char *file_path, int storage_type, const ch
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
-	if (!STRING_VALID(file_path)) {
-		__set_error_message(ERR_FILE_PATH, err_msg);
+	ret = media_svc_scan_session_enter(handle);
+	if(ret < 0) {
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
+	if (!STRING_VALID(file_path)) {
+		_media_svc_plugin_set_error_message(ERR_FILE_PATH, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
+	}
+
 	if (!STRING_VALID(mime_type)) {
-		__set_error_message(ERR_MIME_TYPE, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ERR_MIME_TYPE, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 
 	if(!STORAGE_VALID(storage_type)) {
-		__set_error_message(ERR_STORAGE_TYPE, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ERR_STORAGE_TYPE, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 
-	media_svc_media_type_e content_type = __get_content_type(file_path, mime_type);
+	media_svc_media_type_e content_type = _media_svc_plugin_get_content_type(file_path, mime_type);
 
+#ifdef NEW_MEDIA_SVC
+	/* one extraction fills both the legacy tables and media table */
+	if(content_type == MEDIA_SVC_MEDIA_TYPE_SOUND || content_type == MEDIA_SVC_MEDIA_TYPE_MUSIC)	{
+
+		ret = audio_svc_insert_item_with_media(handle,
+				(storage_type == MEDIA_SVC_STORAGE_INTERNAL) ? AUDIO_SVC_STORAGE_PHONE : AUDIO_SVC_STORAGE_MMC,
+				file_path,
+				(content_type == MEDIA_SVC_MEDIA_TYPE_SOUND) ? AUDIO_SVC_CATEGORY_SOUND : AUDIO_SVC_CATEGORY_MUSIC,
+				mime_type);
+
+	} else if (content_type == MEDIA_SVC_MEDIA_TYPE_IMAGE || content_type == MEDIA_SVC_MEDIA_TYPE_VIDEO) {
+
+		ret = minfo_add_media_batch_with_media(handle, file_path,
+				(content_type == MEDIA_SVC_MEDIA_TYPE_IMAGE) ? MINFO_ITEM_IMAGE : MINFO_ITEM_VIDEO,
+				mime_type);
+
+	} else {
+		ret = media_svc_insert_item_bulk(handle, storage_type, file_path, mime_type, content_type);
+	}
+#else
 	if(content_type == MEDIA_SVC_MEDIA_TYPE_SOUND || content_type == MEDIA_SVC_MEDIA_TYPE_MUSIC)	{
 
 		if(storage_type == MEDIA_SVC_STORAGE_INTERNAL) {
@@ -455,22 +287,17 @@ int insert_item(void * handle, const char *file_path, int storage_type, const ch
 			ret = minfo_add_media_batch(handle, file_path, MINFO_ITEM_VIDEO);
 
 	} else {
-#ifndef NEW_MEDIA_SVC
-		__set_error_message(ERR_NOT_MEDIAFILE, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
-#endif
+		_media_svc_plugin_set_error_message(ERR_NOT_MEDIAFILE, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
-
-#ifdef NEW_MEDIA_SVC
-	ret = media_svc_insert_item_bulk(handle, storage_type, file_path, mime_type, content_type);
 #endif
 
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ret, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 
-	return MEDIA_SVC_PLUGIN_ERROR_NONE;
+	return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR_NONE);
 }
 
 int insert_item_immediately(void * handle, const char *file_path, int storage_type, const char * mime_type, char ** err_msg)
@@ -478,26 +305,32 @@ int insert_item_immediately(void * handle, const char *file_path, int storage_ty
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
-	if (!STRING_VALID(file_path)) {
-		__set_error_message(ERR_FILE_PATH, err_msg);
+	ret = media_svc_scan_session_enter(handle);
+	if(ret < 0) {
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
+	if (!STRING_VALID(file_path)) {
+		_media_svc_plugin_set_error_message(ERR_FILE_PATH, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
+	}
+
 	if (!STRING_VALID(mime_type)) {
-		__set_error_message(ERR_MIME_TYPE, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ERR_MIME_TYPE, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 
 	if(!STORAGE_VALID(storage_type)) {
-		__set_error_message(ERR_STORAGE_TYPE, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ERR_STORAGE_TYPE, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 
-	media_svc_media_type_e content_type = __get_content_type(file_path, mime_type);
+	media_svc_media_type_e content_type = _media_svc_plugin_get_content_type(file_path, mime_type);
 
 	if(content_type == MEDIA_SVC_MEDIA_TYPE_SOUND || content_type == MEDIA_SVC_MEDIA_TYPE_MUSIC)	{
 
@@ -526,8 +359,8 @@ int insert_item_immediately(void * handle, const char *file_path, int storage_ty
 
 	} else {
 #ifndef NEW_MEDIA_SVC
-		__set_error_message(ERR_NOT_MEDIAFILE, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ERR_NOT_MEDIAFILE, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 #endif
 	}
 #ifdef NEW_MEDIA_SVC
@@ -535,11 +368,11 @@ int insert_item_immediately(void * handle, const char *file_path, int storage_ty
 #endif
 
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ret, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 
-	return MEDIA_SVC_PLUGIN_ERROR_NONE;
+	return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR_NONE);
 }
 
 
@@ -548,31 +381,37 @@ int move_item_begin(void * handle, int item_cnt, char ** err_msg)
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
-	ret = audio_svc_move_item_start(handle, item_cnt);
+	ret = media_svc_scan_session_enter(handle);
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
+	ret = audio_svc_move_item_start(handle, item_cnt);
+	if(ret < 0) {
+		_media_svc_plugin_set_error_message(ret, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
+	}
+
 	ret = minfo_move_media_start(handle, item_cnt);
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ret, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 
 #ifdef NEW_MEDIA_SVC
 	ret = media_svc_move_item_begin(handle, item_cnt);
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ret, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 #endif
 
-	return MEDIA_SVC_PLUGIN_ERROR_NONE;
+	return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR_NONE);
 }
 
 int move_item_end(void * handle, char ** err_msg)
@@ -580,26 +419,26 @@ int move_item_end(void * handle, char ** err_msg)
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
 	ret = audio_svc_move_item_end(handle);
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
 	ret = minfo_move_media_end(handle);
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
 #ifdef NEW_MEDIA_SVC
 	ret = media_svc_move_item_end(handle);
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 #endif
@@ -612,26 +451,32 @@ int move_item(void * handle, const char *src_path, int src_storage_type, const c
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
-	if ((!STRING_VALID(src_path)) || (!STRING_VALID(dest_path))) {
-		__set_error_message(ERR_FILE_PATH, err_msg);
+	ret = media_svc_scan_session_enter(handle);
+	if(ret < 0) {
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
+	if ((!STRING_VALID(src_path)) || (!STRING_VALID(dest_path))) {
+		_media_svc_plugin_set_error_message(ERR_FILE_PATH, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
+	}
+
 	if (!STRING_VALID(mime_type)) {
-		__set_error_message(ERR_MIME_TYPE, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ERR_MIME_TYPE, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 
 	if((!STORAGE_VALID(src_storage_type)) || (!STORAGE_VALID(dest_storage_type))) {
-		__set_error_message(ERR_STORAGE_TYPE, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ERR_STORAGE_TYPE, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 
-	media_svc_media_type_e content_type = __get_content_type(src_path, mime_type);
+	media_svc_media_type_e content_type = _media_svc_plugin_get_content_type(src_path, mime_type);
 
 	if(content_type == MEDIA_SVC_MEDIA_TYPE_SOUND || content_type == MEDIA_SVC_MEDIA_TYPE_MUSIC)	{
 
@@ -646,25 +491,25 @@ int move_item(void * handle, const char *src_path, int src_storage_type, const c
 
 	} else {
 #ifndef NEW_MEDIA_SVC
-		__set_error_message(ERR_NOT_MEDIAFILE, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ERR_NOT_MEDIAFILE, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 #endif
 	}
 
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ret, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 
 #ifdef NEW_MEDIA_SVC
 	ret = media_svc_move_item(handle, src_storage_type, src_path, dest_storage_type, dest_path);
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ret, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 #endif
 
-	return MEDIA_SVC_PLUGIN_ERROR_NONE;
+	return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR_NONE);
 }
 
 int set_all_storage_items_validity(void * handle, int storage_type, int validity, char ** err_msg)
@@ -672,52 +517,58 @@ int set_all_storage_items_validity(void * handle, int storage_type, int validity
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
-	if(!STORAGE_VALID(storage_type)) {
-		__set_error_message(ERR_STORAGE_TYPE, err_msg);
+	ret = media_svc_scan_session_enter(handle);
+	if(ret < 0) {
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
+	if(!STORAGE_VALID(storage_type)) {
+		_media_svc_plugin_set_error_message(ERR_STORAGE_TYPE, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
+	}
+
 	if(storage_type == MEDIA_SVC_STORAGE_INTERNAL) {
 		ret = audio_svc_set_db_valid(handle, AUDIO_SVC_STORAGE_PHONE, validity);
 		if(ret < 0) {
-			__set_error_message(ret, err_msg);
-			return MEDIA_SVC_PLUGIN_ERROR;
+			_media_svc_plugin_set_error_message(ret, err_msg);
+			return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 		}
 
 		ret = minfo_set_db_valid(handle, MINFO_PHONE, validity);
 		if(ret < 0) {
-			__set_error_message(ret, err_msg);
-			return MEDIA_SVC_PLUGIN_ERROR;
+			_media_svc_plugin_set_error_message(ret, err_msg);
+			return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 		}
 
 	} else if(storage_type == MEDIA_SVC_STORAGE_EXTERNAL) {
 
 		ret = audio_svc_set_db_valid(handle, AUDIO_SVC_STORAGE_MMC, validity);
 		if(ret < 0) {
-			__set_error_message(ret, err_msg);
-			return MEDIA_SVC_PLUGIN_ERROR;
+			_media_svc_plugin_set_error_message(ret, err_msg);
+			return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 		}
 
 		ret = minfo_set_db_valid(handle, MINFO_MMC, validity);
 		if(ret < 0) {
-			__set_error_message(ret, err_msg);
-			return MEDIA_SVC_PLUGIN_ERROR;
+			_media_svc_plugin_set_error_message(ret, err_msg);
+			return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 		}
 	}
 
 #ifdef NEW_MEDIA_SVC
 	ret = media_svc_set_all_storage_items_validity(handle, storage_type, validity);
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ret, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 #endif
 
-	return MEDIA_SVC_PLUGIN_ERROR_NONE;
+	return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR_NONE);
 }
 
 int set_item_validity_begin(void * handle, int item_cnt, char ** err_msg)
@@ -725,31 +576,37 @@ int set_item_validity_begin(void * handle, int item_cnt, char ** err_msg)
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
-	ret = audio_svc_set_item_valid_start(handle, item_cnt);
+	ret = media_svc_scan_session_enter(handle);
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
+	ret = audio_svc_set_item_valid_start(handle, item_cnt);
+	if(ret < 0) {
+		_media_svc_plugin_set_error_message(ret, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
+	}
+
 	ret = minfo_set_item_valid_start(handle, item_cnt);
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ret, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 
 #ifdef NEW_MEDIA_SVC
 	ret = media_svc_set_item_validity_begin(handle, item_cnt);
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ret, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 #endif
 
-	return MEDIA_SVC_PLUGIN_ERROR_NONE;
+	return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR_NONE);
 }
 
 int set_item_validity_end(void * handle, char ** err_msg)
@@ -757,26 +614,26 @@ int set_item_validity_end(void * handle, char ** err_msg)
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
 	ret = audio_svc_set_item_valid_end(handle);
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
 	ret = minfo_set_item_valid_end(handle);
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
 #ifdef NEW_MEDIA_SVC
 	ret = media_svc_set_item_validity_end(handle);
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 #endif
@@ -789,26 +646,32 @@ int set_item_validity(void * handle, const char *file_path, int storage_type, co
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
-	if (!STRING_VALID(file_path)) {
-		__set_error_message(ERR_FILE_PATH, err_msg);
+	ret = media_svc_scan_session_enter(handle);
+	if(ret < 0) {
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
+	if (!STRING_VALID(file_path)) {
+		_media_svc_plugin_set_error_message(ERR_FILE_PATH, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
+	}
+
 	if (!STRING_VALID(mime_type)) {
-		__set_error_message(ERR_MIME_TYPE, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ERR_MIME_TYPE, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 
 	if(!STORAGE_VALID(storage_type)) {
-		__set_error_message(ERR_STORAGE_TYPE, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ERR_STORAGE_TYPE, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 
-	media_svc_media_type_e content_type = __get_content_type(file_path, mime_type);
+	media_svc_media_type_e content_type = _media_svc_plugin_get_content_type(file_path, mime_type);
 
 	if(content_type == MEDIA_SVC_MEDIA_TYPE_SOUND || content_type == MEDIA_SVC_MEDIA_TYPE_MUSIC)	{
 
@@ -823,26 +686,26 @@ int set_item_validity(void * handle, const char *file_path, int storage_type, co
 
 	} else {
 #ifndef NEW_MEDIA_SVC
-		__set_error_message(ERR_NOT_MEDIAFILE, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ERR_NOT_MEDIAFILE, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 #endif
 	}
 
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ret, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 
 #ifdef NEW_MEDIA_SVC
 	ret = media_svc_set_item_validity(handle, file_path, validity);
 
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ret, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 #endif
 
-	return MEDIA_SVC_PLUGIN_ERROR_NONE;
+	return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR_NONE);
 }
 
 int delete_item(void * handle, const char *file_path, int storage_type, char ** err_msg)
@@ -850,18 +713,24 @@ int delete_item(void * handle, const char *file_path, int storage_type, char **
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
-	if (!STRING_VALID(file_path)) {
-		__set_error_message(ERR_FILE_PATH, err_msg);
+	ret = media_svc_scan_session_enter(handle);
+	if(ret < 0) {
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
+	if (!STRING_VALID(file_path)) {
+		_media_svc_plugin_set_error_message(ERR_FILE_PATH, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
+	}
+
 	if(!STORAGE_VALID(storage_type)) {
-		__set_error_message(ERR_STORAGE_TYPE, err_msg);
-		return MEDIA_SVC_PLUGIN_ERROR;
+		_media_svc_plugin_set_error_message(ERR_STORAGE_TYPE, err_msg);
+		return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 	}
 
 	ret = audio_svc_check_item_exist(handle, file_path);
@@ -869,11 +738,11 @@ int delete_item(void * handle, const char *file_path, int storage_type, char **
 		ret = audio_svc_delete_item_by_path(handle, file_path);
 
 		if(ret < 0) {
-			__set_error_message(ret, err_msg);
-			return MEDIA_SVC_PLUGIN_ERROR;
+			_media_svc_plugin_set_error_message(ret, err_msg);
+			return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 		}
 //		} else
-//			return MEDIA_SVC_PLUGIN_ERROR_NONE;
+//			return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR_NONE);
 	}
 
 	ret = minfo_check_item_exist(handle, file_path);
@@ -881,11 +750,11 @@ int delete_item(void * handle, const char *file_path, int storage_type, char **
 		ret = minfo_delete_media(handle, file_path);
 
 		if(ret < 0) {
-			__set_error_message(ret, err_msg);
-			return MEDIA_SVC_PLUGIN_ERROR;
+			_media_svc_plugin_set_error_message(ret, err_msg);
+			return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 		}
 //		else
-//			return MEDIA_SVC_PLUGIN_ERROR_NONE;
+//			return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR_NONE);
 	} 
 
 #ifdef NEW_MEDIA_SVC
@@ -894,16 +763,16 @@ int delete_item(void * handle, const char *file_path, int storage_type, char **
 		ret = media_svc_delete_item_by_path(handle, file_path);
 
 		if(ret < 0) {
-			__set_error_message(ret, err_msg);
-			return MEDIA_SVC_PLUGIN_ERROR;
+			_media_svc_plugin_set_error_message(ret, err_msg);
+			return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 		}
 		else
-			return MEDIA_SVC_PLUGIN_ERROR_NONE;
+			return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR_NONE);
 	}
 #endif
 
-	__set_error_message(ERR_CHECK_ITEM, err_msg);	//not exist in DB so can't delete item.
-	return MEDIA_SVC_PLUGIN_ERROR;
+	_media_svc_plugin_set_error_message(ERR_CHECK_ITEM, err_msg);	//not exist in DB so can't delete item.
+	return _media_svc_plugin_scan_leave(handle, MEDIA_SVC_PLUGIN_ERROR);
 }
 
 int delete_all_items_in_storage(void * handle, int storage_type, char ** err_msg)
@@ -911,12 +780,12 @@ int delete_all_items_in_storage(void * handle, int storage_type, char ** err_msg
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
 	if(!STORAGE_VALID(storage_type)) {
-		__set_error_message(ERR_STORAGE_TYPE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_STORAGE_TYPE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
@@ -924,13 +793,13 @@ int delete_all_items_in_storage(void * handle, int storage_type, char ** err_msg
 
 		ret = audio_svc_delete_all(handle, AUDIO_SVC_STORAGE_PHONE);
 		if(ret < 0) {
-			__set_error_message(ret, err_msg);
+			_media_svc_plugin_set_error_message(ret, err_msg);
 			return MEDIA_SVC_PLUGIN_ERROR;
 		}
 
 		ret = minfo_delete_all_media_records(handle, MINFO_PHONE);
 		if(ret < 0) {
-			__set_error_message(ret, err_msg);
+			_media_svc_plugin_set_error_message(ret, err_msg);
 			return MEDIA_SVC_PLUGIN_ERROR;
 		}
 
@@ -938,12 +807,12 @@ int delete_all_items_in_storage(void * handle, int storage_type, char ** err_msg
 
 		ret = audio_svc_delete_all(handle,AUDIO_SVC_STORAGE_MMC);
 		if(ret < 0) {
-			__set_error_message(ret, err_msg);
+			_media_svc_plugin_set_error_message(ret, err_msg);
 			return MEDIA_SVC_PLUGIN_ERROR;
 		}
 		ret = minfo_delete_all_media_records(handle, MINFO_MMC);
 		if(ret < 0) {
-			__set_error_message(ret, err_msg);
+			_media_svc_plugin_set_error_message(ret, err_msg);
 			return MEDIA_SVC_PLUGIN_ERROR;
 		}
 	}
@@ -951,7 +820,7 @@ int delete_all_items_in_storage(void * handle, int storage_type, char ** err_msg
 #ifdef NEW_MEDIA_SVC
 	ret = media_svc_delete_all_items_in_storage(handle, storage_type);
 	if(ret < 0) {
-			__set_error_message(ret, err_msg);
+			_media_svc_plugin_set_error_message(ret, err_msg);
 			return MEDIA_SVC_PLUGIN_ERROR;
 	}
 #endif
@@ -964,12 +833,12 @@ int delete_all_invalid_items_in_storage(void * handle, int storage_type, char **
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
 	if(!STORAGE_VALID(storage_type)) {
-		__set_error_message(ERR_STORAGE_TYPE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_STORAGE_TYPE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
@@ -977,13 +846,13 @@ int delete_all_invalid_items_in_storage(void * handle, int storage_type, char **
 
 		ret =  audio_svc_delete_invalid_items(handle,AUDIO_SVC_STORAGE_PHONE);
 		if(ret < 0) {
-			__set_error_message(ret, err_msg);
+			_media_svc_plugin_set_error_message(ret, err_msg);
 			return MEDIA_SVC_PLUGIN_ERROR;
 		}
 
 		ret = minfo_delete_invalid_media_records(handle, MINFO_PHONE);
 		if(ret < 0) {
-			__set_error_message(ret, err_msg);
+			_media_svc_plugin_set_error_message(ret, err_msg);
 			return MEDIA_SVC_PLUGIN_ERROR;
 		}
 
@@ -991,20 +860,20 @@ int delete_all_invalid_items_in_storage(void * handle, int storage_type, char **
 
 		ret =  audio_svc_delete_invalid_items(handle,AUDIO_SVC_STORAGE_MMC);
 		if(ret < 0) {
-			__set_error_message(ret, err_msg);
+			_media_svc_plugin_set_error_message(ret, err_msg);
 			return MEDIA_SVC_PLUGIN_ERROR;
 		}
 
 		ret = minfo_delete_invalid_media_records(handle, MINFO_MMC);
 		if(ret < 0) {
-			__set_error_message(ret, err_msg);
+			_media_svc_plugin_set_error_message(ret, err_msg);
 			return MEDIA_SVC_PLUGIN_ERROR;
 		}
 	}
 #ifdef NEW_MEDIA_SVC
 	ret = media_svc_delete_invalid_items_in_storage(handle, storage_type);
 	if(ret < 0) {
-			__set_error_message(ret, err_msg);
+			_media_svc_plugin_set_error_message(ret, err_msg);
 			return MEDIA_SVC_PLUGIN_ERROR;
 	}
 #endif
@@ -1017,7 +886,7 @@ int delete_all_items(void * handle, char ** err_msg)
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
@@ -1038,31 +907,31 @@ int refresh_item(void * handle, const char *file_path, int storage_type, const c
 	int ret = MEDIA_SVC_PLUGIN_ERROR_NONE;
 
 	if(handle == NULL) {
-		__set_error_message(ERR_HANDLE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_HANDLE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
 	if (!STRING_VALID(file_path)) {
-		__set_error_message(ERR_FILE_PATH, err_msg);
+		_media_svc_plugin_set_error_message(ERR_FILE_PATH, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
 	if (!STRING_VALID(mime_type)) {
-		__set_error_message(ERR_MIME_TYPE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_MIME_TYPE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
 	if(!STORAGE_VALID(storage_type)) {
-		__set_error_message(ERR_STORAGE_TYPE, err_msg);
+		_media_svc_plugin_set_error_message(ERR_STORAGE_TYPE, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 
-	media_svc_media_type_e content_type = __get_content_type(file_path, mime_type);
+	media_svc_media_type_e content_type = _media_svc_plugin_get_content_type(file_path, mime_type);
 
 	ret = media_svc_refresh_item(handle, storage_type, file_path, content_type);
 
 	if(ret < 0) {
-		__set_error_message(ret, err_msg);
+		_media_svc_plugin_set_error_message(ret, err_msg);
 		return MEDIA_SVC_PLUGIN_ERROR;
 	}
 #endif
@@ -1071,10 +940,40 @@ int refresh_item(void * handle, const char *file_path, int storage_type, const c
 
 int update_begin(void)
 {
+	int ret = media_svc_scan_update_begin();
+
+	if (ret < 0)
+		return MEDIA_SVC_PLUGIN_ERROR;
+
 	return MEDIA_SVC_PLUGIN_ERROR_NONE;
 }
 
 int update_end(void)
 {
+	int ret = media_svc_scan_update_end();
+
+	if (ret < 0)
+		return MEDIA_SVC_PLUGIN_ERROR;
+
 	return MEDIA_SVC_PLUGIN_ERROR_NONE;
 }
+
+int insert_items(void * handle, const char **file_paths, const int *storage_types, const char **mime_types, int item_cnt, int *status, char ** err_msg)
+{
+	return _media_svc_plugin_insert_items(insert_item, handle, file_paths, storage_types, mime_types, item_cnt, status, err_msg);
+}
+
+int move_items(void * handle, const char **src_paths, const int *src_storage_types, const char **dest_paths, const int *dest_storage_types, const char **mime_types, int item_cnt, int *status, char ** err_msg)
+{
+	return _media_svc_plugin_move_items(move_item, FALSE, handle, src_paths, src_storage_types, dest_paths, dest_storage_types, mime_types, item_cnt, status, err_msg);
+}
+
+int set_items_validity(void * handle, const char **file_paths, const int *storage_types, const char **mime_types, int validity, int item_cnt, int *status, char ** err_msg)
+{
+	return _media_svc_plugin_set_items_validity(set_item_validity, handle, file_paths, storage_types, mime_types, validity, item_cnt, status, err_msg);
+}
+
+int delete_items(void * handle, const char **file_paths, const int *storage_types, int item_cnt, int *status, char ** err_msg)
+{
+	return _media_svc_plugin_delete_items(delete_item, handle, file_paths, storage_types, item_cnt, status, err_msg);
+}
@@ -38,6 +38,7 @@
 #include "audio-svc-error.h"
 #include "audio-svc-db-utils.h"
 #include "media-svc-util.h"
+#include "media-svc-db-utils.h"
 
 int _audio_svc_sql_busy_handler(void *pData, int count)
 {
@@ -122,13 +123,29 @@ int _audio_svc_sql_prepare_to_step(sqlite3 *handle, const char *sql_str, sqlite3
 	return AUDIO_SVC_ERROR_NONE;
 }
 
+/* Range of list queries is bound, not printed, so the statement is shared by every page. "limit ?,?" is the tail of the query */
+int _audio_svc_sql_bind_limit(sqlite3_stmt *stmt, int offset, int rows)
+{
+	int idx = sqlite3_bind_parameter_count(stmt) - 1;
+	int err = SQLITE_OK;
+
+	if (idx < 1)
+		return SQLITE_RANGE;
+
+	err = sqlite3_bind_int(stmt, idx, offset);
+	if (err != SQLITE_OK)
+		return err;
+
+	return sqlite3_bind_int(stmt, idx + 1, rows);
+}
+
 int _audio_svc_sql_begin_trans(sqlite3 *handle)
 {
 	char *err_msg = NULL;
 
 	audio_svc_debug("========_audio_svc_sql_begin_trans");
 
-	if (SQLITE_OK != sqlite3_exec(handle, "BEGIN IMMEDIATE;", NULL, NULL, &err_msg)) {
+	if (SQLITE_OK != _media_svc_sql_trans(handle, MEDIA_SVC_TRANS_BEGIN, &err_msg)) {
 		audio_svc_error("Error:failed to begin transaction: error=%s", err_msg);
 		sqlite3_free(err_msg);
 		return AUDIO_SVC_ERROR_DB_INTERNAL;
@@ -145,7 +162,7 @@ int _audio_svc_sql_end_trans(sqlite3 *handle)
 
 	audio_svc_debug("========_audio_svc_sql_end_trans");
 
-	if (SQLITE_OK != sqlite3_exec(handle, "COMMIT;", NULL, NULL, &err_msg)) {
+	if (SQLITE_OK != _media_svc_sql_trans(handle, MEDIA_SVC_TRANS_COMMIT, &err_msg)) {
 		audio_svc_error("Error:failed to end transaction: error=%s", err_msg);
 		sqlite3_free(err_msg);
 		return AUDIO_SVC_ERROR_DB_INTERNAL;
@@ -162,7 +179,7 @@ int _audio_svc_sql_rollback_trans(sqlite3 *handle)
 
 	audio_svc_debug("========_audio_svc_sql_rollback_trans");
 
-	if (SQLITE_OK != sqlite3_exec(handle, "ROLLBACK;", NULL, NULL, &err_msg)) {
+	if (SQLITE_OK != _media_svc_sql_trans(handle, MEDIA_SVC_TRANS_ROLLBACK, &err_msg)) {
 		audio_svc_error("Error:failed to rollback transaction: error=%s", err_msg);
 		sqlite3_free(err_msg);
 		return AUDIO_SVC_ERROR_DB_INTERNAL;
@@ -36,6 +36,8 @@
 #include "audio-svc-types-priv.h"
 #include "audio-svc-utils.h"
 #include "audio-svc-db-utils.h"
+#include "media-svc-error.h"
+#include "media-svc-thumb-journal.h"
 
 
 typedef enum {
@@ -78,33 +80,210 @@ typedef enum {
 #define AUDIO_SVC_ORDER_BY_ARTIST		"ORDER BY artist COLLATE NOCASE"
 #define AUDIO_SVC_COLLATE_NOCASE		"COLLATE NOCASE"
 
-static __thread GList *g_audio_svc_item_valid_query_list = NULL;
-static __thread GList *g_audio_svc_move_item_query_list = NULL;
-static __thread GList *g_audio_svc_insert_item_query_list = NULL;
 
 
+/* columns of audio_media for each field of track, in the order of selection by field mask */
+static const struct {
+	audio_svc_track_data_type_e field;
+	const char *column;
+} audio_svc_track_columns[] = {
+	{AUDIO_SVC_TRACK_DATA_STORAGE, "storage_type"},
+	{AUDIO_SVC_TRACK_DATA_AUDIO_ID, "audio_uuid"},
+	{AUDIO_SVC_TRACK_DATA_PATHNAME, "path"},
+	{AUDIO_SVC_TRACK_DATA_THUMBNAIL_PATH, "thumbnail_path"},
+	{AUDIO_SVC_TRACK_DATA_PLAYED_COUNT, "played_count"},
+	{AUDIO_SVC_TRACK_DATA_PLAYED_TIME, "last_played_time"},
+	{AUDIO_SVC_TRACK_DATA_ADDED_TIME, "added_time"},
+	{AUDIO_SVC_TRACK_DATA_RATING, "rating"},
+	{AUDIO_SVC_TRACK_DATA_CATEGORY, "category"},
+	{AUDIO_SVC_TRACK_DATA_TITLE, "title"},
+	{AUDIO_SVC_TRACK_DATA_ARTIST, "artist"},
+	{AUDIO_SVC_TRACK_DATA_ALBUM, "album"},
+	{AUDIO_SVC_TRACK_DATA_GENRE, "genre"},
+	{AUDIO_SVC_TRACK_DATA_AUTHOR, "author"},
+	{AUDIO_SVC_TRACK_DATA_COPYRIGHT, "copyright"},
+	{AUDIO_SVC_TRACK_DATA_DESCRIPTION, "description"},
+	{AUDIO_SVC_TRACK_DATA_FORMAT, "format"},
+	{AUDIO_SVC_TRACK_DATA_DURATION, "duration"},
+	{AUDIO_SVC_TRACK_DATA_BITRATE, "bitrate"},
+	{AUDIO_SVC_TRACK_DATA_YEAR, "year"},
+	{AUDIO_SVC_TRACK_DATA_TRACK_NUM, "track_num"},
+	{AUDIO_SVC_TRACK_DATA_ALBUM_RATING, "album_rating"},
+	{AUDIO_SVC_TRACK_DATA_FAVOURATE, "favourite"},
+};
+
+#define AUDIO_SVC_TRACK_COLUMNS_NUM		((int)(sizeof(audio_svc_track_columns) / sizeof(audio_svc_track_columns[0])))
+
 static int __audio_svc_create_music_db_table(sqlite3 *handle);
 static void __audio_svc_get_next_record(audio_svc_audio_item_s *item, sqlite3_stmt *stmt);
-static int __audio_svc_count_invalid_records_with_thumbnail(sqlite3 *handle, audio_svc_storage_type_e storage_type);
+static void __audio_svc_get_next_record_by_fields(audio_svc_audio_item_s *item, sqlite3_stmt *stmt, unsigned int field_mask);
 static int __audio_svc_count_records_with_thumbnail(sqlite3 *handle, audio_svc_storage_type_e storage_type);
-static int __audio_svc_get_invalid_records_with_thumbnail(sqlite3 *handle, audio_svc_storage_type_e storage_type, int count, mp_thumbnailpath_record_t * thumb_path);
 static int __audio_svc_get_records_with_thumbnail(sqlite3 *handle, audio_svc_storage_type_e storage_type, int count, mp_thumbnailpath_record_t * thumb_path);
 
 
-static int __audio_svc_create_music_db_table(sqlite3 *handle)
+/* columns of audio_media_data in the order of audio_media view, apart from dictionary ids */
+#define AUDIO_SVC_AUDIO_HEAD_COLUMNS	"audio_uuid, path, file_name, thumbnail_path, title"
+#define AUDIO_SVC_AUDIO_DICT_COLUMNS	"album_dict_id, artist_dict_id, genre_dict_id, author_dict_id, year_dict_id"
+#define AUDIO_SVC_AUDIO_TAIL_COLUMNS	"copyright, description, format, bitrate, track_num, duration, rating, played_count, \
+					last_played_time, added_time, rated_time, album_rating, modified_date, size, category, valid, \
+					folder_uuid, storage_type, favourite, content_type"
+#define AUDIO_SVC_AUDIO_A_TAIL_COLUMNS	"a.copyright, a.description, a.format, a.bitrate, a.track_num, a.duration, a.rating, \
+					a.played_count, a.last_played_time, a.added_time, a.rated_time, a.album_rating, a.modified_date, \
+					a.size, a.category, a.valid, a.folder_uuid, a.storage_type, a.favourite, a.content_type"
+/* rows of old audio_media table which can be moved to audio_media_data */
+#define AUDIO_SVC_AUDIO_KEPT		"audio_uuid IS NOT NULL AND folder_uuid IS NOT NULL"
+
+static int __audio_svc_create_query(sqlite3 *handle, char *sql)
 {
 	int err = -1;
 
-	char *sql = sqlite3_mprintf("create table if not exists %s (\
-				audio_uuid		text primary key, \
+	if (sql == NULL) {
+		_audio_svc_sql_rollback_trans(handle);
+		return AUDIO_SVC_ERROR_OUT_OF_MEMORY;
+	}
+
+	err = _audio_svc_sql_query(handle, sql);
+	sqlite3_free(sql);
+	if (err != SQLITE_OK) {
+		audio_svc_error("It failed to create db table (%d)", err);
+		_audio_svc_sql_rollback_trans(handle);
+		if (err == AUDIO_SVC_ERROR_DB_CONNECT) {
+			return err;
+		}
+		return AUDIO_SVC_ERROR_DB_CREATE_TABLE;
+	}
+
+	return AUDIO_SVC_ERROR_NONE;
+}
+
+/* TRUE when audio_media of old version is a table, not a view */
+static bool __audio_svc_is_music_table(sqlite3 *handle)
+{
+	sqlite3_stmt *stmt = NULL;
+	bool is_table = FALSE;
+
+	if (sqlite3_prepare_v2(handle, "SELECT 1 FROM sqlite_master WHERE type='table' AND name='"AUDIO_SVC_DB_TABLE_AUDIO"'",
+				-1, &stmt, NULL) != SQLITE_OK) {
+		return FALSE;
+	}
+
+	is_table = (sqlite3_step(stmt) == SQLITE_ROW);
+	SQLITE3_FINALIZE(stmt);
+
+	return is_table;
+}
+
+static int __audio_svc_count_music_table(sqlite3 *handle)
+{
+	sqlite3_stmt *stmt = NULL;
+	int count = 0;
+
+	if (sqlite3_prepare_v2(handle, "SELECT count(*) FROM "AUDIO_SVC_DB_TABLE_AUDIO, -1, &stmt, NULL) != SQLITE_OK) {
+		return 0;
+	}
+
+	if (sqlite3_step(stmt) == SQLITE_ROW)
+		count = sqlite3_column_int(stmt, 0);
+	SQLITE3_FINALIZE(stmt);
+
+	return count;
+}
+
+/* Moves the rows of audio_media table of old version to audio_media_data table. Old triggers are dropped with the table.
+ * A row without audio_uuid or folder_uuid can not be kept in audio_media_data, so it is dropped instead of failing the migration */
+static int __audio_svc_migrate_music_table(sqlite3 *handle)
+{
+	int ret = AUDIO_SVC_ERROR_NONE;
+	char *sql = NULL;
+	sqlite3_stmt *stmt = NULL;
+	const char *file_name = "NULL";
+	int count = 0;
+
+	audio_svc_debug("%s table of old version. migrate it to %s", AUDIO_SVC_DB_TABLE_AUDIO, AUDIO_SVC_DB_TABLE_AUDIO_DATA);
+
+	/* audio_media of some old version has no file_name */
+	if (sqlite3_prepare_v2(handle, "SELECT file_name FROM "AUDIO_SVC_DB_TABLE_AUDIO, -1, &stmt, NULL) == SQLITE_OK) {
+		file_name = "a.file_name";
+	}
+	SQLITE3_FINALIZE(stmt);
+
+	count = __audio_svc_count_music_table(handle);
+
+	sql = sqlite3_mprintf("INSERT OR IGNORE INTO %s (kind, value) SELECT %d, album FROM %s WHERE album IS NOT NULL AND "AUDIO_SVC_AUDIO_KEPT"; \
+				INSERT OR IGNORE INTO %s (kind, value) SELECT %d, artist FROM %s WHERE artist IS NOT NULL AND "AUDIO_SVC_AUDIO_KEPT"; \
+				INSERT OR IGNORE INTO %s (kind, value) SELECT %d, genre FROM %s WHERE genre IS NOT NULL AND "AUDIO_SVC_AUDIO_KEPT"; \
+				INSERT OR IGNORE INTO %s (kind, value) SELECT %d, author FROM %s WHERE author IS NOT NULL AND "AUDIO_SVC_AUDIO_KEPT"; \
+				INSERT OR IGNORE INTO %s (kind, value) SELECT %d, year FROM %s WHERE year IS NOT NULL AND year!=-1 AND "AUDIO_SVC_AUDIO_KEPT";",
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, MEDIA_SVC_META_DICT_ALBUM, AUDIO_SVC_DB_TABLE_AUDIO,
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, MEDIA_SVC_META_DICT_ARTIST, AUDIO_SVC_DB_TABLE_AUDIO,
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, MEDIA_SVC_META_DICT_GENRE, AUDIO_SVC_DB_TABLE_AUDIO,
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, MEDIA_SVC_META_DICT_COMPOSER, AUDIO_SVC_DB_TABLE_AUDIO,
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, MEDIA_SVC_META_DICT_YEAR, AUDIO_SVC_DB_TABLE_AUDIO);
+	ret = __audio_svc_create_query(handle, sql);
+	audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
+
+	sql = sqlite3_mprintf("INSERT OR IGNORE INTO %s ("AUDIO_SVC_AUDIO_HEAD_COLUMNS", "AUDIO_SVC_AUDIO_DICT_COLUMNS", "AUDIO_SVC_AUDIO_TAIL_COLUMNS") \
+				SELECT a.audio_uuid, a.path, %s, a.thumbnail_path, a.title, \
+				(SELECT dict_id FROM %s WHERE kind=%d AND value=a.album), \
+				(SELECT dict_id FROM %s WHERE kind=%d AND value=a.artist), \
+				(SELECT dict_id FROM %s WHERE kind=%d AND value=a.genre), \
+				(SELECT dict_id FROM %s WHERE kind=%d AND value=a.author), \
+				(SELECT dict_id FROM %s WHERE kind=%d AND value=a.year), \
+				"AUDIO_SVC_AUDIO_A_TAIL_COLUMNS" FROM %s AS a WHERE "AUDIO_SVC_AUDIO_KEPT";",
+				AUDIO_SVC_DB_TABLE_AUDIO_DATA, file_name,
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, MEDIA_SVC_META_DICT_ALBUM,
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, MEDIA_SVC_META_DICT_ARTIST,
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, MEDIA_SVC_META_DICT_GENRE,
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, MEDIA_SVC_META_DICT_COMPOSER,
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, MEDIA_SVC_META_DICT_YEAR,
+				AUDIO_SVC_DB_TABLE_AUDIO);
+	ret = __audio_svc_create_query(handle, sql);
+	audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
+
+	count -= sqlite3_changes(handle);
+	if (count > 0) {
+		audio_svc_error("%d rows of %s are dropped in the migration", count, AUDIO_SVC_DB_TABLE_AUDIO);
+	}
+
+	sql = sqlite3_mprintf("DROP TABLE %s;", AUDIO_SVC_DB_TABLE_AUDIO);
+	ret = __audio_svc_create_query(handle, sql);
+	audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
+
+	return AUDIO_SVC_ERROR_NONE;
+}
+
+/* album, artist, genre, author and year are kept once in audio_meta_dict, and audio_media_data refers them by id.
+ * audio_media is a view of the columns of old audio_media table, so the queries of audio service are not changed */
+static int __audio_svc_create_music_db_table(sqlite3 *handle)
+{
+	int ret = AUDIO_SVC_ERROR_NONE;
+	char *sql = NULL;
+
+	ret = _audio_svc_sql_begin_trans(handle);
+	audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
+
+	sql = sqlite3_mprintf("create table if not exists %s (\
+				dict_id			INTEGER PRIMARY KEY, \
+				kind				INTEGER NOT NULL, \
+				value			TEXT NOT NULL, \
+				unique(kind, value) \
+				);",
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT);
+	ret = __audio_svc_create_query(handle, sql);
+	audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
+
+	sql = sqlite3_mprintf("create table if not exists %s (\
+				audio_id			INTEGER PRIMARY KEY, \
+				audio_uuid		text not null unique, \
 				path				text unique, \
+				file_name		text, \
 				thumbnail_path	text, \
 				title				text, \
-				album			text, \
-				artist			text, \
-				genre			text, \
-				author			text, \
-				year				integer default -1, \
+				album_dict_id	integer, \
+				artist_dict_id	integer, \
+				genre_dict_id	integer, \
+				author_dict_id	integer, \
+				year_dict_id		integer, \
 				copyright		text, \
 				description		text, \
 				format			text, \
@@ -124,17 +303,176 @@ static int __audio_svc_create_music_db_table(sqlite3 *handle)
 				folder_uuid			TEXT NOT NULL, \
 				storage_type		integer, \
 				favourite			integer default 0, \
-				content_type		integer default %d);",
-				AUDIO_SVC_DB_TABLE_AUDIO,
+				content_type		integer default %d); \
+				CREATE INDEX IF NOT EXISTS audio_album_dict_idx on %s (album_dict_id); \
+				CREATE INDEX IF NOT EXISTS audio_artist_dict_idx on %s (artist_dict_id); \
+				CREATE INDEX IF NOT EXISTS audio_genre_dict_idx on %s (genre_dict_id); \
+				CREATE INDEX IF NOT EXISTS audio_author_dict_idx on %s (author_dict_id); \
+				CREATE INDEX IF NOT EXISTS audio_year_dict_idx on %s (year_dict_id);",
+				AUDIO_SVC_DB_TABLE_AUDIO_DATA,
+				AUDIO_SVC_CONTENT_TYPE,
+				AUDIO_SVC_DB_TABLE_AUDIO_DATA, AUDIO_SVC_DB_TABLE_AUDIO_DATA, AUDIO_SVC_DB_TABLE_AUDIO_DATA,
+				AUDIO_SVC_DB_TABLE_AUDIO_DATA, AUDIO_SVC_DB_TABLE_AUDIO_DATA);
+	ret = __audio_svc_create_query(handle, sql);
+	audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
+
+	if (__audio_svc_is_music_table(handle)) {
+		ret = __audio_svc_migrate_music_table(handle);
+		audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
+	}
+
+	/* audio_media view keeps the columns of old audio_media table, and unknown year is still -1.
+	 * Dictionary ids and audio_id are appended */
+	sql = sqlite3_mprintf("CREATE VIEW IF NOT EXISTS %s AS SELECT a.audio_uuid, a.path, a.file_name, a.thumbnail_path, a.title, \
+				album_dict.value AS album, artist_dict.value AS artist, genre_dict.value AS genre, \
+				author_dict.value AS author, ifnull(CAST(year_dict.value AS INTEGER), -1) AS year, "AUDIO_SVC_AUDIO_A_TAIL_COLUMNS", \
+				a.album_dict_id, a.artist_dict_id, a.genre_dict_id, a.author_dict_id, a.year_dict_id, a.audio_id \
+				FROM %s AS a \
+				LEFT JOIN %s AS album_dict ON album_dict.dict_id=a.album_dict_id \
+				LEFT JOIN %s AS artist_dict ON artist_dict.dict_id=a.artist_dict_id \
+				LEFT JOIN %s AS genre_dict ON genre_dict.dict_id=a.genre_dict_id \
+				LEFT JOIN %s AS author_dict ON author_dict.dict_id=a.author_dict_id \
+				LEFT JOIN %s AS year_dict ON year_dict.dict_id=a.year_dict_id;",
+				AUDIO_SVC_DB_TABLE_AUDIO, AUDIO_SVC_DB_TABLE_AUDIO_DATA,
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, AUDIO_SVC_DB_TABLE_AUDIO_META_DICT,
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, AUDIO_SVC_DB_TABLE_AUDIO_META_DICT);
+	ret = __audio_svc_create_query(handle, sql);
+	audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
+
+	/* Unset column of insert gets default of audio_media_data */
+	sql = sqlite3_mprintf("CREATE TRIGGER IF NOT EXISTS audio_media_insert INSTEAD OF INSERT ON %s BEGIN \
+				INSERT OR IGNORE INTO %s (kind, value) SELECT kind, value FROM \
+				(SELECT %d AS kind, new.album AS value UNION ALL SELECT %d, new.artist UNION ALL SELECT %d, new.genre \
+				UNION ALL SELECT %d, new.author UNION ALL SELECT %d, nullif(new.year, -1)) WHERE value IS NOT NULL; \
+				INSERT INTO %s ("AUDIO_SVC_AUDIO_HEAD_COLUMNS", "AUDIO_SVC_AUDIO_DICT_COLUMNS", "AUDIO_SVC_AUDIO_TAIL_COLUMNS") \
+				VALUES (new.audio_uuid, new.path, new.file_name, new.thumbnail_path, new.title, \
+				(SELECT dict_id FROM %s WHERE kind=%d AND value=new.album), \
+				(SELECT dict_id FROM %s WHERE kind=%d AND value=new.artist), \
+				(SELECT dict_id FROM %s WHERE kind=%d AND value=new.genre), \
+				(SELECT dict_id FROM %s WHERE kind=%d AND value=new.author), \
+				(SELECT dict_id FROM %s WHERE kind=%d AND value=new.year), \
+				new.copyright, new.description, new.format, ifnull(new.bitrate, -1), ifnull(new.track_num, -1), \
+				ifnull(new.duration, -1), ifnull(new.rating, 0), ifnull(new.played_count, 0), \
+				ifnull(new.last_played_time, -1), new.added_time, new.rated_time, ifnull(new.album_rating, 0), \
+				ifnull(new.modified_date, 0), ifnull(new.size, 0), ifnull(new.category, 0), ifnull(new.valid, 0), \
+				new.folder_uuid, new.storage_type, ifnull(new.favourite, 0), ifnull(new.content_type, %d));END;",
+				AUDIO_SVC_DB_TABLE_AUDIO, AUDIO_SVC_DB_TABLE_AUDIO_META_DICT,
+				MEDIA_SVC_META_DICT_ALBUM, MEDIA_SVC_META_DICT_ARTIST, MEDIA_SVC_META_DICT_GENRE,
+				MEDIA_SVC_META_DICT_COMPOSER, MEDIA_SVC_META_DICT_YEAR,
+				AUDIO_SVC_DB_TABLE_AUDIO_DATA,
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, MEDIA_SVC_META_DICT_ALBUM,
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, MEDIA_SVC_META_DICT_ARTIST,
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, MEDIA_SVC_META_DICT_GENRE,
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, MEDIA_SVC_META_DICT_COMPOSER,
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, MEDIA_SVC_META_DICT_YEAR,
 				AUDIO_SVC_CONTENT_TYPE);
+	ret = __audio_svc_create_query(handle, sql);
+	audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
 
-	err = _audio_svc_sql_query(handle, sql);
-	sqlite3_free(sql);
-	if (err != SQLITE_OK) {
-		audio_svc_error("It failed to create db table (%d)", err);
-		if (err == AUDIO_SVC_ERROR_DB_CONNECT) {
-			return err;
-		}
+	sql = sqlite3_mprintf("CREATE TRIGGER IF NOT EXISTS audio_media_update INSTEAD OF UPDATE ON %s BEGIN \
+				INSERT OR IGNORE INTO %s (kind, value) SELECT kind, value FROM \
+				(SELECT %d AS kind, new.album AS value UNION ALL SELECT %d, new.artist UNION ALL SELECT %d, new.genre \
+				UNION ALL SELECT %d, new.author UNION ALL SELECT %d, nullif(new.year, -1)) WHERE value IS NOT NULL; \
+				UPDATE %s SET audio_uuid=new.audio_uuid, path=new.path, file_name=new.file_name, \
+				thumbnail_path=new.thumbnail_path, title=new.title, \
+				album_dict_id=(SELECT dict_id FROM %s WHERE kind=%d AND value=new.album), \
+				artist_dict_id=(SELECT dict_id FROM %s WHERE kind=%d AND value=new.artist), \
+				genre_dict_id=(SELECT dict_id FROM %s WHERE kind=%d AND value=new.genre), \
+				author_dict_id=(SELECT dict_id FROM %s WHERE kind=%d AND value=new.author), \
+				year_dict_id=(SELECT dict_id FROM %s WHERE kind=%d AND value=new.year), \
+				copyright=new.copyright, description=new.description, format=new.format, bitrate=new.bitrate, \
+				track_num=new.track_num, duration=new.duration, rating=new.rating, played_count=new.played_count, \
+				last_played_time=new.last_played_time, added_time=new.added_time, rated_time=new.rated_time, \
+				album_rating=new.album_rating, modified_date=new.modified_date, size=new.size, category=new.category, \
+				valid=new.valid, folder_uuid=new.folder_uuid, storage_type=new.storage_type, favourite=new.favourite, \
+				content_type=new.content_type \
+				WHERE audio_id=old.audio_id;END;",
+				AUDIO_SVC_DB_TABLE_AUDIO, AUDIO_SVC_DB_TABLE_AUDIO_META_DICT,
+				MEDIA_SVC_META_DICT_ALBUM, MEDIA_SVC_META_DICT_ARTIST, MEDIA_SVC_META_DICT_GENRE,
+				MEDIA_SVC_META_DICT_COMPOSER, MEDIA_SVC_META_DICT_YEAR,
+				AUDIO_SVC_DB_TABLE_AUDIO_DATA,
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, MEDIA_SVC_META_DICT_ALBUM,
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, MEDIA_SVC_META_DICT_ARTIST,
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, MEDIA_SVC_META_DICT_GENRE,
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, MEDIA_SVC_META_DICT_COMPOSER,
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, MEDIA_SVC_META_DICT_YEAR);
+	ret = __audio_svc_create_query(handle, sql);
+	audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
+
+	sql = sqlite3_mprintf("CREATE TRIGGER IF NOT EXISTS audio_media_delete INSTEAD OF DELETE ON %s BEGIN \
+				DELETE FROM %s WHERE audio_id=old.audio_id;END;",
+				AUDIO_SVC_DB_TABLE_AUDIO, AUDIO_SVC_DB_TABLE_AUDIO_DATA);
+	ret = __audio_svc_create_query(handle, sql);
+	audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
+
+	/* value which is not used by any audio any more is removed from audio_meta_dict */
+	sql = sqlite3_mprintf("CREATE TRIGGER IF NOT EXISTS audio_meta_dict_cleanup_delete AFTER DELETE ON %s BEGIN \
+				DELETE FROM %s WHERE dict_id=old.album_dict_id AND NOT EXISTS (SELECT 1 FROM %s WHERE album_dict_id=old.album_dict_id); \
+				DELETE FROM %s WHERE dict_id=old.artist_dict_id AND NOT EXISTS (SELECT 1 FROM %s WHERE artist_dict_id=old.artist_dict_id); \
+				DELETE FROM %s WHERE dict_id=old.genre_dict_id AND NOT EXISTS (SELECT 1 FROM %s WHERE genre_dict_id=old.genre_dict_id); \
+				DELETE FROM %s WHERE dict_id=old.author_dict_id AND NOT EXISTS (SELECT 1 FROM %s WHERE author_dict_id=old.author_dict_id); \
+				DELETE FROM %s WHERE dict_id=old.year_dict_id AND NOT EXISTS (SELECT 1 FROM %s WHERE year_dict_id=old.year_dict_id); \
+				END;",
+				AUDIO_SVC_DB_TABLE_AUDIO_DATA,
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, AUDIO_SVC_DB_TABLE_AUDIO_DATA,
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, AUDIO_SVC_DB_TABLE_AUDIO_DATA,
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, AUDIO_SVC_DB_TABLE_AUDIO_DATA,
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, AUDIO_SVC_DB_TABLE_AUDIO_DATA,
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, AUDIO_SVC_DB_TABLE_AUDIO_DATA);
+	ret = __audio_svc_create_query(handle, sql);
+	audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
+
+	sql = sqlite3_mprintf("CREATE TRIGGER IF NOT EXISTS audio_meta_dict_cleanup_update AFTER UPDATE OF \
+				"AUDIO_SVC_AUDIO_DICT_COLUMNS" ON %s BEGIN \
+				DELETE FROM %s WHERE dict_id=old.album_dict_id AND old.album_dict_id IS NOT new.album_dict_id \
+				AND NOT EXISTS (SELECT 1 FROM %s WHERE album_dict_id=old.album_dict_id); \
+				DELETE FROM %s WHERE dict_id=old.artist_dict_id AND old.artist_dict_id IS NOT new.artist_dict_id \
+				AND NOT EXISTS (SELECT 1 FROM %s WHERE artist_dict_id=old.artist_dict_id); \
+				DELETE FROM %s WHERE dict_id=old.genre_dict_id AND old.genre_dict_id IS NOT new.genre_dict_id \
+				AND NOT EXISTS (SELECT 1 FROM %s WHERE genre_dict_id=old.genre_dict_id); \
+				DELETE FROM %s WHERE dict_id=old.author_dict_id AND old.author_dict_id IS NOT new.author_dict_id \
+				AND NOT EXISTS (SELECT 1 FROM %s WHERE author_dict_id=old.author_dict_id); \
+				DELETE FROM %s WHERE dict_id=old.year_dict_id AND old.year_dict_id IS NOT new.year_dict_id \
+				AND NOT EXISTS (SELECT 1 FROM %s WHERE year_dict_id=old.year_dict_id); \
+				END;",
+				AUDIO_SVC_DB_TABLE_AUDIO_DATA,
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, AUDIO_SVC_DB_TABLE_AUDIO_DATA,
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, AUDIO_SVC_DB_TABLE_AUDIO_DATA,
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, AUDIO_SVC_DB_TABLE_AUDIO_DATA,
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, AUDIO_SVC_DB_TABLE_AUDIO_DATA,
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, AUDIO_SVC_DB_TABLE_AUDIO_DATA);
+	ret = __audio_svc_create_query(handle, sql);
+	audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
+
+	/* Renaming a value to another existing value merges them, as meta_dict of media does */
+	sql = sqlite3_mprintf("CREATE TRIGGER IF NOT EXISTS audio_meta_dict_merge BEFORE UPDATE OF kind, value ON %s \
+				WHEN EXISTS (SELECT 1 FROM %s WHERE kind=new.kind AND value=new.value AND dict_id!=old.dict_id) BEGIN \
+				UPDATE %s SET album_dict_id=(SELECT dict_id FROM %s WHERE kind=new.kind AND value=new.value) \
+				WHERE old.kind=%d AND album_dict_id=old.dict_id; \
+				UPDATE %s SET artist_dict_id=(SELECT dict_id FROM %s WHERE kind=new.kind AND value=new.value) \
+				WHERE old.kind=%d AND artist_dict_id=old.dict_id; \
+				UPDATE %s SET genre_dict_id=(SELECT dict_id FROM %s WHERE kind=new.kind AND value=new.value) \
+				WHERE old.kind=%d AND genre_dict_id=old.dict_id; \
+				UPDATE %s SET author_dict_id=(SELECT dict_id FROM %s WHERE kind=new.kind AND value=new.value) \
+				WHERE old.kind=%d AND author_dict_id=old.dict_id; \
+				UPDATE %s SET year_dict_id=(SELECT dict_id FROM %s WHERE kind=new.kind AND value=new.value) \
+				WHERE old.kind=%d AND year_dict_id=old.dict_id; \
+				DELETE FROM %s WHERE dict_id=old.dict_id; \
+				SELECT RAISE(IGNORE);END;",
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, AUDIO_SVC_DB_TABLE_AUDIO_META_DICT,
+				AUDIO_SVC_DB_TABLE_AUDIO_DATA, AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, MEDIA_SVC_META_DICT_ALBUM,
+				AUDIO_SVC_DB_TABLE_AUDIO_DATA, AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, MEDIA_SVC_META_DICT_ARTIST,
+				AUDIO_SVC_DB_TABLE_AUDIO_DATA, AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, MEDIA_SVC_META_DICT_GENRE,
+				AUDIO_SVC_DB_TABLE_AUDIO_DATA, AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, MEDIA_SVC_META_DICT_COMPOSER,
+				AUDIO_SVC_DB_TABLE_AUDIO_DATA, AUDIO_SVC_DB_TABLE_AUDIO_META_DICT, MEDIA_SVC_META_DICT_YEAR,
+				AUDIO_SVC_DB_TABLE_AUDIO_META_DICT);
+	ret = __audio_svc_create_query(handle, sql);
+	audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
+
+	ret = _audio_svc_sql_end_trans(handle);
+	if (ret != AUDIO_SVC_ERROR_NONE) {
+		audio_svc_error("It failed to create db table (%d)", ret);
+		_audio_svc_sql_rollback_trans(handle);
 		return AUDIO_SVC_ERROR_DB_CREATE_TABLE;
 	}
 
@@ -183,33 +521,116 @@ static void __audio_svc_get_next_record(audio_svc_audio_item_s *item,
 
 }
 
-static int
-__audio_svc_count_invalid_records_with_thumbnail(sqlite3 *handle, audio_svc_storage_type_e
-						 storage_type)
+static int __audio_svc_make_field_columns(unsigned int field_mask, char *columns, int size)
 {
-	int ret = AUDIO_SVC_ERROR_NONE;
-	int count = -1;
-	sqlite3_stmt *sql_stmt = NULL;
-	char *sql =
-	    sqlite3_mprintf
-	    ("select count(*) from %s where valid=0 and storage_type=%d and thumbnail_path is not null",
-	     AUDIO_SVC_DB_TABLE_AUDIO, storage_type);
+	int i = 0;
+	int len = 0;
 
-	ret = _audio_svc_sql_prepare_to_step(handle, sql, &sql_stmt);
+	columns[0] = '\0';
 
-	if (ret != AUDIO_SVC_ERROR_NONE) {
-		audio_svc_error
-		    ("error when __audio_svc_count_invalid_records_with_thumbnail. err = [%d]",
-		     ret);
-		return count;
-	}
+	for (i = 0; i < AUDIO_SVC_TRACK_COLUMNS_NUM; i++) {
+		if (!(field_mask & AUDIO_SVC_TRACK_FIELD(audio_svc_track_columns[i].field)))
+			continue;
 
-	count = sqlite3_column_int(sql_stmt, 0);
+		if (columns[0] != '\0')
+			g_strlcat(columns, ", ", size);
+		len = g_strlcat(columns, audio_svc_track_columns[i].column, size);
+	}
 
-	SQLITE3_FINALIZE(sql_stmt);
+	if (columns[0] == '\0' || len >= size)
+		return AUDIO_SVC_ERROR_INVALID_PARAMETER;
 
-	return count;
+	return AUDIO_SVC_ERROR_NONE;
+}
 
+/* reads columns selected by __audio_svc_make_field_columns() with same field_mask */
+static void __audio_svc_get_next_record_by_fields(audio_svc_audio_item_s *item,
+					sqlite3_stmt *stmt, unsigned int field_mask)
+{
+	int i = 0;
+	int col = 0;
+
+	memset(item, 0, sizeof(audio_svc_audio_item_s));
+
+	for (i = 0; i < AUDIO_SVC_TRACK_COLUMNS_NUM; i++) {
+		if (!(field_mask & AUDIO_SVC_TRACK_FIELD(audio_svc_track_columns[i].field)))
+			continue;
+
+		switch (audio_svc_track_columns[i].field) {
+		case AUDIO_SVC_TRACK_DATA_STORAGE:
+			item->storage_type = sqlite3_column_int(stmt, col);
+			break;
+		case AUDIO_SVC_TRACK_DATA_AUDIO_ID:
+			_strncpy_safe(item->audio_uuid, (const char *)sqlite3_column_text(stmt, col), sizeof(item->audio_uuid));
+			break;
+		case AUDIO_SVC_TRACK_DATA_PATHNAME:
+			_strncpy_safe(item->pathname, (const char *)sqlite3_column_text(stmt, col), sizeof(item->pathname));
+			break;
+		case AUDIO_SVC_TRACK_DATA_THUMBNAIL_PATH:
+			_strncpy_safe(item->thumbname, (const char *)sqlite3_column_text(stmt, col), sizeof(item->thumbname));
+			break;
+		case AUDIO_SVC_TRACK_DATA_PLAYED_COUNT:
+			item->played_count = sqlite3_column_int(stmt, col);
+			break;
+		case AUDIO_SVC_TRACK_DATA_PLAYED_TIME:
+			item->time_played = sqlite3_column_int(stmt, col);
+			break;
+		case AUDIO_SVC_TRACK_DATA_ADDED_TIME:
+			item->time_added = sqlite3_column_int(stmt, col);
+			break;
+		case AUDIO_SVC_TRACK_DATA_RATING:
+			item->rating = sqlite3_column_int(stmt, col);
+			break;
+		case AUDIO_SVC_TRACK_DATA_CATEGORY:
+			item->category = sqlite3_column_int(stmt, col);
+			break;
+		case AUDIO_SVC_TRACK_DATA_TITLE:
+			_strncpy_safe(item->audio.title, (const char *)sqlite3_column_text(stmt, col), sizeof(item->audio.title));
+			break;
+		case AUDIO_SVC_TRACK_DATA_ARTIST:
+			_strncpy_safe(item->audio.artist, (const char *)sqlite3_column_text(stmt, col), sizeof(item->audio.artist));
+			break;
+		case AUDIO_SVC_TRACK_DATA_ALBUM:
+			_strncpy_safe(item->audio.album, (const char *)sqlite3_column_text(stmt, col), sizeof(item->audio.album));
+			break;
+		case AUDIO_SVC_TRACK_DATA_GENRE:
+			_strncpy_safe(item->audio.genre, (const char *)sqlite3_column_text(stmt, col), sizeof(item->audio.genre));
+			break;
+		case AUDIO_SVC_TRACK_DATA_AUTHOR:
+			_strncpy_safe(item->audio.author, (const char *)sqlite3_column_text(stmt, col), sizeof(item->audio.author));
+			break;
+		case AUDIO_SVC_TRACK_DATA_COPYRIGHT:
+			_strncpy_safe(item->audio.copyright, (const char *)sqlite3_column_text(stmt, col), sizeof(item->audio.copyright));
+			break;
+		case AUDIO_SVC_TRACK_DATA_DESCRIPTION:
+			_strncpy_safe(item->audio.description, (const char *)sqlite3_column_text(stmt, col), sizeof(item->audio.description));
+			break;
+		case AUDIO_SVC_TRACK_DATA_FORMAT:
+			_strncpy_safe(item->audio.format, (const char *)sqlite3_column_text(stmt, col), sizeof(item->audio.format));
+			break;
+		case AUDIO_SVC_TRACK_DATA_DURATION:
+			item->audio.duration = sqlite3_column_int(stmt, col);
+			break;
+		case AUDIO_SVC_TRACK_DATA_BITRATE:
+			item->audio.bitrate = sqlite3_column_int(stmt, col);
+			break;
+		case AUDIO_SVC_TRACK_DATA_YEAR:
+			_strncpy_safe(item->audio.year, _year_2_str(sqlite3_column_int(stmt, col)), sizeof(item->audio.year));
+			break;
+		case AUDIO_SVC_TRACK_DATA_TRACK_NUM:
+			item->audio.track = sqlite3_column_int(stmt, col);
+			break;
+		case AUDIO_SVC_TRACK_DATA_ALBUM_RATING:
+			item->audio.album_rating = sqlite3_column_int(stmt, col);
+			break;
+		case AUDIO_SVC_TRACK_DATA_FAVOURATE:
+			item->favourate = sqlite3_column_int(stmt, col);
+			break;
+		default:
+			break;
+		}
+		col++;
+	}
 }
 
 static int __audio_svc_count_records_with_thumbnail(sqlite3 *handle, audio_svc_storage_type_e
@@ -240,44 +661,6 @@ static int __audio_svc_count_records_with_thumbnail(sqlite3 *handle, audio_svc_s
 
 }
 
-static int
-__audio_svc_get_invalid_records_with_thumbnail(sqlite3 *handle, audio_svc_storage_type_e
-					       storage_type, int count,
-					       mp_thumbnailpath_record_t *
-					       thumb_path)
-{
-	int err = -1;
-	int idx = 0;
-	sqlite3_stmt *sql_stmt = NULL;
-
-	char *sql =
-	    sqlite3_mprintf
-	    ("select thumbnail_path from %s where valid=0 and storage_type=%d and thumbnail_path is not null",
-	     AUDIO_SVC_DB_TABLE_AUDIO, storage_type);
-
-	audio_svc_debug("[SQL query] : %s", sql);
-
-	err = sqlite3_prepare_v2(handle, sql, -1, &sql_stmt, NULL);
-	sqlite3_free(sql);
-	if (err != SQLITE_OK) {
-		audio_svc_error("prepare error [%s]", sqlite3_errmsg(handle));
-		return AUDIO_SVC_ERROR_DB_INTERNAL;
-	}
-
-	while (sqlite3_step(sql_stmt) == SQLITE_ROW) {
-		_strncpy_safe(thumb_path[idx].thumbnail_path,
-			      (const char *)sqlite3_column_text(sql_stmt, 0),
-			      sizeof(thumb_path[idx]));
-		idx++;
-		audio_svc_debug("thumb_path[%d]=[%s]", idx,
-				thumb_path[idx].thumbnail_path);
-	}
-
-	SQLITE3_FINALIZE(sql_stmt);
-
-	return AUDIO_SVC_ERROR_NONE;
-}
-
 static int __audio_svc_get_records_with_thumbnail(sqlite3 *handle, audio_svc_storage_type_e
 						  storage_type, int count,
 						  mp_thumbnailpath_record_t *
@@ -461,7 +844,8 @@ int _audio_svc_insert_item_with_data(sqlite3 *handle, audio_svc_audio_item_s *it
 	int size = -1;
 	char folder_id[AUDIO_SVC_UUID_SIZE+1] = {0,};
 	int year = -1;
-	char *audio_id = NULL;
+	char audio_id[AUDIO_SVC_UUID_SIZE+1] = {0,};
+	media_svc_batch_s *batch = NULL;
 	char *g_audio_svc_music_fields = "audio_uuid, path, file_name, thumbnail_path, title, album, artist, genre, author, year,\
 	copyright, description, format, bitrate,track_num,duration, rating, played_count, last_played_time, added_time, modified_date, size, category, valid, folder_uuid, storage_type";
 	char * file_name = NULL;
@@ -471,15 +855,17 @@ int _audio_svc_insert_item_with_data(sqlite3 *handle, audio_svc_audio_item_s *it
 		return AUDIO_SVC_ERROR_INVALID_PARAMETER;
 	}
 
-	audio_id = _media_info_generate_uuid();
-	if(audio_id == NULL ) {
+	if(_media_svc_generate_uuid(audio_id, sizeof(audio_id)) != MEDIA_INFO_ERROR_NONE) {
 		audio_svc_error("Invalid UUID");
 		return AUDIO_SVC_ERROR_INTERNAL;
 	}
 	
-	/* set creation date */
+	/* set creation date. The file is already stat-ed while its metadata is extracted */
 	memset(&st, 0, sizeof(struct stat));
-	if (stat(item->pathname, &st) == 0) {
+	if (item->file_stat_done) {
+		modified_date = item->time_modified;
+		size = item->size;
+	} else if (stat(item->pathname, &st) == 0) {
 		modified_date = st.st_mtime;
 		size = st.st_size;
 	}
@@ -544,7 +930,12 @@ int _audio_svc_insert_item_with_data(sqlite3 *handle, audio_svc_audio_item_s *it
 			return AUDIO_SVC_ERROR_DB_INTERNAL;
 		}
 	} else {
-		_audio_svc_sql_query_add(&g_audio_svc_insert_item_query_list, &sql);
+		batch = _audio_svc_get_batch(handle, AUDIO_SVC_QUERY_INSERT_ITEM);
+		if (batch == NULL) {
+			sqlite3_free(sql);
+			return AUDIO_SVC_ERROR_INVALID_PARAMETER;
+		}
+		_audio_svc_sql_query_add(&batch->query_list, &sql);
 	}
 
 	//item->audio_uuid = sqlite3_last_insert_rowid(handle);
@@ -1308,7 +1699,7 @@ int _audio_svc_count_music_group_records(sqlite3 *handle, audio_svc_group_type_e
 
 	audio_svc_debug("[SQL query] : %s", query);
 
-	err = sqlite3_prepare_v2(handle, query, -1, &sql_stmt, NULL);
+	err = _media_svc_db_ctx_prepare_stmt(handle, query, &sql_stmt);
 	if (err != SQLITE_OK) {
 		audio_svc_error("prepare error [%s]", sqlite3_errmsg(handle));
 		return AUDIO_SVC_ERROR_DB_INTERNAL;
@@ -1327,7 +1718,7 @@ int _audio_svc_count_music_group_records(sqlite3 *handle, audio_svc_group_type_e
 				audio_svc_error
 				    ("limit_string(%s) binding is failed (%d)",
 				     limit_string1, err);
-				SQLITE3_FINALIZE(sql_stmt);
+				SQLITE3_RELEASE(sql_stmt);
 				return AUDIO_SVC_ERROR_DB_INTERNAL;
 			}
 			text_bind++;
@@ -1343,7 +1734,7 @@ int _audio_svc_count_music_group_records(sqlite3 *handle, audio_svc_group_type_e
 				audio_svc_error
 				    ("limit_string2(%s) binding is failed (%d)",
 				     limit_string2, err);
-				SQLITE3_FINALIZE(sql_stmt);
+				SQLITE3_RELEASE(sql_stmt);
 				return AUDIO_SVC_ERROR_DB_INTERNAL;
 			}
 			text_bind++;
@@ -1359,7 +1750,7 @@ int _audio_svc_count_music_group_records(sqlite3 *handle, audio_svc_group_type_e
 			audio_svc_error
 			    ("filter_query(%s) binding is failed (%d)",
 			     filter_query, err);
-			SQLITE3_FINALIZE(sql_stmt);
+			SQLITE3_RELEASE(sql_stmt);
 			return AUDIO_SVC_ERROR_DB_INTERNAL;
 		}
 		text_bind++;
@@ -1373,7 +1764,7 @@ int _audio_svc_count_music_group_records(sqlite3 *handle, audio_svc_group_type_e
 			audio_svc_error
 			    ("filter_query(%s) binding is failed (%d)",
 			     filter_query2, err);
-			SQLITE3_FINALIZE(sql_stmt);
+			SQLITE3_RELEASE(sql_stmt);
 			return AUDIO_SVC_ERROR_DB_INTERNAL;
 		}
 	}
@@ -1381,13 +1772,13 @@ int _audio_svc_count_music_group_records(sqlite3 *handle, audio_svc_group_type_e
 	err = sqlite3_step(sql_stmt);
 	if (err != SQLITE_ROW) {
 		audio_svc_error("end of row [%s]", sqlite3_errmsg(handle));
-		SQLITE3_FINALIZE(sql_stmt);
+		SQLITE3_RELEASE(sql_stmt);
 		return AUDIO_SVC_ERROR_DB_INTERNAL;
 	}
 
 	*count = sqlite3_column_int(sql_stmt, 0);
 
-	SQLITE3_FINALIZE(sql_stmt);
+	SQLITE3_RELEASE(sql_stmt);
 
 	return AUDIO_SVC_ERROR_NONE;
 
@@ -1444,7 +1835,7 @@ int _audio_svc_get_music_group_records(sqlite3 *handle, audio_svc_group_type_e g
 					  sizeof(query));
 			}
 
-			snprintf(tail_query, sizeof(tail_query), " group by album %s limit %d,%d", AUDIO_SVC_ORDER_BY_ALBUM, offset, rows);
+			snprintf(tail_query, sizeof(tail_query), " group by album %s limit ?,?", AUDIO_SVC_ORDER_BY_ALBUM);
 			g_strlcat(query, tail_query, sizeof(query));
 		}
 		break;
@@ -1465,7 +1856,7 @@ int _audio_svc_get_music_group_records(sqlite3 *handle, audio_svc_group_type_e g
 					  sizeof(query));
 			}
 
-			snprintf(tail_query, sizeof(tail_query), " group by artist %s limit %d,%d", AUDIO_SVC_ORDER_BY_ARTIST, offset, rows);
+			snprintf(tail_query, sizeof(tail_query), " group by artist %s limit ?,?", AUDIO_SVC_ORDER_BY_ARTIST);
 			g_strlcat(query, tail_query, sizeof(query));
 		}
 		break;
@@ -1492,7 +1883,7 @@ int _audio_svc_get_music_group_records(sqlite3 *handle, audio_svc_group_type_e g
 					  sizeof(query));
 			}
 
-			snprintf(tail_query, sizeof(tail_query), " group by album %s limit %d,%d", AUDIO_SVC_ORDER_BY_ALBUM, offset, rows);
+			snprintf(tail_query, sizeof(tail_query), " group by album %s limit ?,?", AUDIO_SVC_ORDER_BY_ALBUM);
 			g_strlcat(query, tail_query, sizeof(query));
 		}
 		break;
@@ -1513,7 +1904,7 @@ int _audio_svc_get_music_group_records(sqlite3 *handle, audio_svc_group_type_e g
 					  sizeof(query));
 			}
 
-			snprintf(tail_query, sizeof(tail_query), " group by genre %s limit %d,%d", AUDIO_SVC_ORDER_BY_GENRE, offset, rows);
+			snprintf(tail_query, sizeof(tail_query), " group by genre %s limit ?,?", AUDIO_SVC_ORDER_BY_GENRE);
 			g_strlcat(query, tail_query, sizeof(query));
 		}
 		break;
@@ -1538,8 +1929,8 @@ int _audio_svc_get_music_group_records(sqlite3 *handle, audio_svc_group_type_e g
 			}
 
 			snprintf(tail_query, sizeof(tail_query),
-				 " group by a.folder_uuid order by b.folder_name %s, b.path %s limit %d,%d",
-				 AUDIO_SVC_COLLATE_NOCASE, AUDIO_SVC_COLLATE_NOCASE, offset, rows);
+				 " group by a.folder_uuid order by b.folder_name %s, b.path %s limit ?,?",
+				 AUDIO_SVC_COLLATE_NOCASE, AUDIO_SVC_COLLATE_NOCASE);
 			g_strlcat(query, tail_query, sizeof(query));
 		}
 		break;
@@ -1561,8 +1952,7 @@ int _audio_svc_get_music_group_records(sqlite3 *handle, audio_svc_group_type_e g
 			}
 
 			snprintf(tail_query, sizeof(tail_query),
-				 " group by year order by year desc limit %d,%d",
-				 offset, rows);
+				 " group by year order by year desc limit ?,?");
 			g_strlcat(query, tail_query, sizeof(query));
 		}
 		break;
@@ -1583,7 +1973,7 @@ int _audio_svc_get_music_group_records(sqlite3 *handle, audio_svc_group_type_e g
 					  sizeof(query));
 			}
 
-			snprintf(tail_query, sizeof(tail_query), " group by author %s limit %d,%d", AUDIO_SVC_ORDER_BY_AUTHOR, offset, rows);
+			snprintf(tail_query, sizeof(tail_query), " group by author %s limit ?,?", AUDIO_SVC_ORDER_BY_AUTHOR);
 			g_strlcat(query, tail_query, sizeof(query));
 		}
 		break;
@@ -1610,7 +2000,7 @@ int _audio_svc_get_music_group_records(sqlite3 *handle, audio_svc_group_type_e g
 					  sizeof(query));
 			}
 
-			snprintf(tail_query, sizeof(tail_query), " group by artist %s limit %d,%d", AUDIO_SVC_ORDER_BY_ARTIST, offset, rows);
+			snprintf(tail_query, sizeof(tail_query), " group by artist %s limit ?,?", AUDIO_SVC_ORDER_BY_ARTIST);
 			g_strlcat(query, tail_query, sizeof(query));
 		}
 		break;
@@ -1637,7 +2027,7 @@ int _audio_svc_get_music_group_records(sqlite3 *handle, audio_svc_group_type_e g
 					  sizeof(query));
 			}
 
-			snprintf(tail_query, sizeof(tail_query), " group by album %s limit %d,%d", AUDIO_SVC_ORDER_BY_ALBUM, offset, rows);
+			snprintf(tail_query, sizeof(tail_query), " group by album %s limit ?,?", AUDIO_SVC_ORDER_BY_ALBUM);
 			g_strlcat(query, tail_query, sizeof(query));
 		}
 		break;
@@ -1679,7 +2069,7 @@ int _audio_svc_get_music_group_records(sqlite3 *handle, audio_svc_group_type_e g
 					  sizeof(query));
 			}
 
-			snprintf(tail_query, sizeof(tail_query), " group by album %s limit %d,%d", AUDIO_SVC_ORDER_BY_ALBUM, offset, rows);
+			snprintf(tail_query, sizeof(tail_query), " group by album %s limit ?,?", AUDIO_SVC_ORDER_BY_ALBUM);
 			g_strlcat(query, tail_query, sizeof(query));
 		}
 		break;
@@ -1688,7 +2078,7 @@ int _audio_svc_get_music_group_records(sqlite3 *handle, audio_svc_group_type_e g
 
 	audio_svc_debug("[SQL query] : %s", query);
 
-	err = sqlite3_prepare_v2(handle, query, -1, &sql_stmt, NULL);
+	err = _media_svc_db_ctx_prepare_stmt(handle, query, &sql_stmt);
 	if (err != SQLITE_OK) {
 		audio_svc_error("prepare error [%s]", sqlite3_errmsg(handle));
 		return AUDIO_SVC_ERROR_DB_INTERNAL;
@@ -1705,7 +2095,7 @@ int _audio_svc_get_music_group_records(sqlite3 *handle, audio_svc_group_type_e g
 			audio_svc_error
 			    ("limit_string1(%s) binding is failed (%d)",
 			     limit_string1, err);
-			SQLITE3_FINALIZE(sql_stmt);
+			SQLITE3_RELEASE(sql_stmt);
 			return AUDIO_SVC_ERROR_DB_INTERNAL;
 		}
 		text_bind++;
@@ -1721,7 +2111,7 @@ int _audio_svc_get_music_group_records(sqlite3 *handle, audio_svc_group_type_e g
 			audio_svc_error
 			    ("limit_string2(%s) binding is failed (%d)",
 			     limit_string2, err);
-			SQLITE3_FINALIZE(sql_stmt);
+			SQLITE3_RELEASE(sql_stmt);
 			return AUDIO_SVC_ERROR_DB_INTERNAL;
 		}
 		text_bind++;
@@ -1736,7 +2126,7 @@ int _audio_svc_get_music_group_records(sqlite3 *handle, audio_svc_group_type_e g
 			audio_svc_error
 			    ("filter_query(%s) binding is failed (%d)",
 			     filter_query, err);
-			SQLITE3_FINALIZE(sql_stmt);
+			SQLITE3_RELEASE(sql_stmt);
 			return AUDIO_SVC_ERROR_DB_INTERNAL;
 		}
 		text_bind++;
@@ -1750,12 +2140,19 @@ int _audio_svc_get_music_group_records(sqlite3 *handle, audio_svc_group_type_e g
 			audio_svc_error
 			    ("filter_query(%s) binding is failed (%d)",
 			     filter_query2, err);
-			SQLITE3_FINALIZE(sql_stmt);
+			SQLITE3_RELEASE(sql_stmt);
 			return AUDIO_SVC_ERROR_DB_INTERNAL;
 		}
 		text_bind++;
 	}
 
+	err = _audio_svc_sql_bind_limit(sql_stmt, offset, rows);
+	if (err != SQLITE_OK) {
+		audio_svc_error("limit binding is failed (%d)", err);
+		SQLITE3_RELEASE(sql_stmt);
+		return AUDIO_SVC_ERROR_DB_INTERNAL;
+	}
+
 	while (sqlite3_step(sql_stmt) == SQLITE_ROW) {
 		if (group_type == AUDIO_SVC_GROUP_BY_YEAR) {
 			int year = sqlite3_column_int(sql_stmt, 0);
@@ -1789,7 +2186,7 @@ int _audio_svc_get_music_group_records(sqlite3 *handle, audio_svc_group_type_e g
 		idx++;
 	}
 
-	SQLITE3_FINALIZE(sql_stmt);
+	SQLITE3_RELEASE(sql_stmt);
 
 	return AUDIO_SVC_ERROR_NONE;
 
@@ -2005,9 +2402,9 @@ int _audio_svc_count_music_track_records(sqlite3 *handle, audio_svc_track_type_e
 	case AUDIO_SVC_TRACK_BY_PLAYLIST:
 		{
 			snprintf(query, sizeof(query),
-				 "select count(*) from %s a, %s b where a.playlist_id=%d and b.audio_uuid=a.audio_uuid and b.valid=1 and b.category=%d",
+				 "select count(*) from %s a, %s b where a.playlist_id=? and b.audio_uuid=a.audio_uuid and b.valid=1 and b.category=%d",
 				 AUDIO_SVC_DB_TABLE_AUDIO_PLAYLISTS_MAP,
-				 AUDIO_SVC_DB_TABLE_AUDIO, (int)type_string,
+				 AUDIO_SVC_DB_TABLE_AUDIO,
 				 AUDIO_SVC_CATEGORY_MUSIC);
 
 			if (filter_mode) {
@@ -2035,12 +2432,21 @@ int _audio_svc_count_music_track_records(sqlite3 *handle, audio_svc_track_type_e
 	}
 	audio_svc_debug("[SQL query] : %s", query);
 
-	err = sqlite3_prepare_v2(handle, query, -1, &sql_stmt, NULL);
+	err = _media_svc_db_ctx_prepare_stmt(handle, query, &sql_stmt);
 	if (err != SQLITE_OK) {
 		audio_svc_error("prepare error [%s]", sqlite3_errmsg(handle));
 		return AUDIO_SVC_ERROR_DB_INTERNAL;
 	}
 
+	if (track_type == AUDIO_SVC_TRACK_BY_PLAYLIST) {
+		if (SQLITE_OK != (err = sqlite3_bind_int(sql_stmt, text_bind, (int)type_string))) {
+			audio_svc_error("playlist_id(%d) binding is failed (%d)", (int)type_string, err);
+			SQLITE3_RELEASE(sql_stmt);
+			return AUDIO_SVC_ERROR_DB_INTERNAL;
+		}
+		text_bind++;
+	}
+
 	if (filter_mode) {
 		if (SQLITE_OK !=
 		    (err =
@@ -2050,7 +2456,7 @@ int _audio_svc_count_music_track_records(sqlite3 *handle, audio_svc_track_type_e
 			audio_svc_error
 			    ("filter_query(%s) binding is failed (%d)",
 			     filter_query, err);
-			SQLITE3_FINALIZE(sql_stmt);
+			SQLITE3_RELEASE(sql_stmt);
 			return AUDIO_SVC_ERROR_DB_INTERNAL;
 		}
 		text_bind++;
@@ -2064,7 +2470,7 @@ int _audio_svc_count_music_track_records(sqlite3 *handle, audio_svc_track_type_e
 			audio_svc_error
 			    ("filter_query(%s) binding is failed (%d)",
 			     filter_query2, err);
-			SQLITE3_FINALIZE(sql_stmt);
+			SQLITE3_RELEASE(sql_stmt);
 			return AUDIO_SVC_ERROR_DB_INTERNAL;
 		}
 		text_bind++;
@@ -2083,7 +2489,7 @@ int _audio_svc_count_music_track_records(sqlite3 *handle, audio_svc_track_type_e
 					audio_svc_error
 					    ("cont_string1(%s) binding is failed (%d)",
 					     type_string, err);
-					SQLITE3_FINALIZE(sql_stmt);
+					SQLITE3_RELEASE(sql_stmt);
 					return AUDIO_SVC_ERROR_DB_INTERNAL;
 				}
 				text_bind++;
@@ -2104,7 +2510,7 @@ int _audio_svc_count_music_track_records(sqlite3 *handle, audio_svc_track_type_e
 						audio_svc_error
 						    ("cont_string1(%s) binding is failed (%d)",
 						     type_string, err);
-						SQLITE3_FINALIZE(sql_stmt);
+						SQLITE3_RELEASE(sql_stmt);
 						return
 						    AUDIO_SVC_ERROR_DB_INTERNAL;
 					}
@@ -2121,7 +2527,7 @@ int _audio_svc_count_music_track_records(sqlite3 *handle, audio_svc_track_type_e
 						audio_svc_error
 						    ("cont_string2(%s) binding is failed (%d)",
 						     type_string2, err);
-						SQLITE3_FINALIZE(sql_stmt);
+						SQLITE3_RELEASE(sql_stmt);
 						return
 						    AUDIO_SVC_ERROR_DB_INTERNAL;
 					}
@@ -2139,7 +2545,7 @@ int _audio_svc_count_music_track_records(sqlite3 *handle, audio_svc_track_type_e
 						audio_svc_error
 						    ("cont_string1(%s) binding is failed (%d)",
 						     type_string, err);
-						SQLITE3_FINALIZE(sql_stmt);
+						SQLITE3_RELEASE(sql_stmt);
 						return
 						    AUDIO_SVC_ERROR_DB_INTERNAL;
 					}
@@ -2154,7 +2560,7 @@ int _audio_svc_count_music_track_records(sqlite3 *handle, audio_svc_track_type_e
 					audio_svc_error
 					    ("cont_string1(%s) binding is failed (%d)",
 					     type_string, err);
-					SQLITE3_FINALIZE(sql_stmt);
+					SQLITE3_RELEASE(sql_stmt);
 					return AUDIO_SVC_ERROR_DB_INTERNAL;
 				}
 			}
@@ -2167,12 +2573,12 @@ int _audio_svc_count_music_track_records(sqlite3 *handle, audio_svc_track_type_e
 	err = sqlite3_step(sql_stmt);
 	if (err != SQLITE_ROW) {
 		audio_svc_error("end of row [%s]", sqlite3_errmsg(handle));
-		SQLITE3_FINALIZE(sql_stmt);
+		SQLITE3_RELEASE(sql_stmt);
 		return AUDIO_SVC_ERROR_DB_INTERNAL;
 	}
 	*count = sqlite3_column_int(sql_stmt, 0);
 
-	SQLITE3_FINALIZE(sql_stmt);
+	SQLITE3_RELEASE(sql_stmt);
 
 	return AUDIO_SVC_ERROR_NONE;
 
@@ -2225,7 +2631,7 @@ int _audio_svc_get_music_track_records(sqlite3 *handle, audio_svc_track_type_e t
 				 AUDIO_SVC_CATEGORY_MUSIC);
 			filter_condition(filter_mode, filter_mode2, query);
 			snprintf(tail_query, sizeof(tail_query),
-				 " %s limit %d,%d", AUDIO_SVC_ORDER_BY_TITLE, offset, rows);
+				 " %s limit ?,?", AUDIO_SVC_ORDER_BY_TITLE);
 			g_strlcat(query, tail_query, sizeof(query));
 		}
 		break;
@@ -2245,8 +2651,7 @@ int _audio_svc_get_music_track_records(sqlite3 *handle, audio_svc_track_type_e t
 			}
 			filter_condition(filter_mode, filter_mode2, query);
 			snprintf(tail_query, sizeof(tail_query),
-				 " order by track_num limit %d,%d", offset,
-				 rows);
+				 " order by track_num limit ?,?");
 			g_strlcat(query, tail_query, sizeof(query));
 		}
 		break;
@@ -2286,7 +2691,7 @@ int _audio_svc_get_music_track_records(sqlite3 *handle, audio_svc_track_type_e t
 			filter_condition(filter_mode, filter_mode2, query);
 
 			snprintf(tail_query, sizeof(tail_query),
-				 " %s limit %d,%d", AUDIO_SVC_ORDER_BY_TITLE, offset, rows);
+				 " %s limit ?,?", AUDIO_SVC_ORDER_BY_TITLE);
 			g_strlcat(query, tail_query, sizeof(query));
 		}
 		break;
@@ -2305,7 +2710,7 @@ int _audio_svc_get_music_track_records(sqlite3 *handle, audio_svc_track_type_e t
 					 AUDIO_SVC_CATEGORY_MUSIC);
 			}
 			filter_condition(filter_mode, filter_mode2, query);
-			snprintf(tail_query, sizeof(tail_query), " order by album %s, title %s limit %d,%d", AUDIO_SVC_COLLATE_NOCASE, AUDIO_SVC_COLLATE_NOCASE, offset, rows);
+			snprintf(tail_query, sizeof(tail_query), " order by album %s, title %s limit ?,?", AUDIO_SVC_COLLATE_NOCASE, AUDIO_SVC_COLLATE_NOCASE);
 			g_strlcat(query, tail_query, sizeof(query));
 		}
 		break;
@@ -2345,7 +2750,7 @@ int _audio_svc_get_music_track_records(sqlite3 *handle, audio_svc_track_type_e t
 			filter_condition(filter_mode, filter_mode2, query);
 
 			snprintf(tail_query, sizeof(tail_query),
-				 " %s limit %d,%d", AUDIO_SVC_ORDER_BY_TITLE, offset, rows);
+				 " %s limit ?,?", AUDIO_SVC_ORDER_BY_TITLE);
 			g_strlcat(query, tail_query, sizeof(query));
 		}
 		break;
@@ -2366,7 +2771,7 @@ int _audio_svc_get_music_track_records(sqlite3 *handle, audio_svc_track_type_e t
 			filter_condition(filter_mode, filter_mode2, query);
 
 			snprintf(tail_query, sizeof(tail_query),
-				 " %s limit %d,%d", AUDIO_SVC_ORDER_BY_TITLE, offset, rows);
+				 " %s limit ?,?", AUDIO_SVC_ORDER_BY_TITLE);
 			g_strlcat(query, tail_query, sizeof(query));
 		}
 		break;
@@ -2388,7 +2793,7 @@ int _audio_svc_get_music_track_records(sqlite3 *handle, audio_svc_track_type_e t
 			filter_condition(filter_mode, filter_mode2, query);
 
 			snprintf(tail_query, sizeof(tail_query),
-				 " %s limit %d,%d", AUDIO_SVC_ORDER_BY_TITLE, offset, rows);
+				 " %s limit ?,?", AUDIO_SVC_ORDER_BY_TITLE);
 			g_strlcat(query, tail_query, sizeof(query));
 		}
 		break;
@@ -2409,7 +2814,7 @@ int _audio_svc_get_music_track_records(sqlite3 *handle, audio_svc_track_type_e t
 			filter_condition(filter_mode, filter_mode2, query);
 
 			snprintf(tail_query, sizeof(tail_query),
-				 " %s limit %d,%d", AUDIO_SVC_ORDER_BY_TITLE, offset, rows);
+				 " %s limit ?,?", AUDIO_SVC_ORDER_BY_TITLE);
 			g_strlcat(query, tail_query, sizeof(query));
 		}
 		break;
@@ -2430,7 +2835,7 @@ int _audio_svc_get_music_track_records(sqlite3 *handle, audio_svc_track_type_e t
 			filter_condition(filter_mode, filter_mode2, query);
 
 			snprintf(tail_query, sizeof(tail_query),
-				 " %s limit %d,%d", AUDIO_SVC_ORDER_BY_TITLE, offset, rows);
+				 " %s limit ?,?", AUDIO_SVC_ORDER_BY_TITLE);
 			g_strlcat(query, tail_query, sizeof(query));
 		}
 		break;
@@ -2445,8 +2850,7 @@ int _audio_svc_get_music_track_records(sqlite3 *handle, audio_svc_track_type_e t
 			filter_condition(filter_mode, filter_mode2, query);
 
 			snprintf(tail_query, sizeof(tail_query),
-				 " order by rating desc, rated_time desc limit %d,%d",
-				 offset, rows);
+				 " order by rating desc, rated_time desc limit ?,?");
 			g_strlcat(query, tail_query, sizeof(query));
 		}
 		break;
@@ -2461,8 +2865,7 @@ int _audio_svc_get_music_track_records(sqlite3 *handle, audio_svc_track_type_e t
 			filter_condition(filter_mode, filter_mode2, query);
 
 			snprintf(tail_query, sizeof(tail_query),
-				 " order by last_played_time desc limit %d,%d",
-				 offset, rows);
+				 " order by last_played_time desc limit ?,?");
 			g_strlcat(query, tail_query, sizeof(query));
 		}
 		break;
@@ -2477,8 +2880,7 @@ int _audio_svc_get_music_track_records(sqlite3 *handle, audio_svc_track_type_e t
 			filter_condition(filter_mode, filter_mode2, query);
 
 			snprintf(tail_query, sizeof(tail_query),
-				 " order by added_time desc limit %d,%d",
-				 offset, rows);
+				 " order by added_time desc limit ?,?");
 			g_strlcat(query, tail_query, sizeof(query));
 		}
 		break;
@@ -2493,8 +2895,7 @@ int _audio_svc_get_music_track_records(sqlite3 *handle, audio_svc_track_type_e t
 			filter_condition(filter_mode, filter_mode2, query);
 
 			snprintf(tail_query, sizeof(tail_query),
-				 " order by played_count desc limit %d,%d",
-				 offset, rows);
+				 " order by played_count desc limit ?,?");
 			g_strlcat(query, tail_query, sizeof(query));
 		}
 		break;
@@ -2506,10 +2907,10 @@ int _audio_svc_get_music_track_records(sqlite3 *handle, audio_svc_track_type_e t
 			    "b.audio_uuid, b.path, b.thumbnail_path, b.title, b.artist, b.duration, b.rating, b.album";
 			len =
 			    snprintf(query, sizeof(query),
-				     "select %s from %s a, %s b where a.playlist_id=%d and b.audio_uuid=a.audio_uuid and b.valid=1 and b.category=%d ",
+				     "select %s from %s a, %s b where a.playlist_id=? and b.audio_uuid=a.audio_uuid and b.valid=1 and b.category=%d ",
 				     result_field_for_playlist,
 				     AUDIO_SVC_DB_TABLE_AUDIO_PLAYLISTS_MAP,
-				     AUDIO_SVC_DB_TABLE_AUDIO, (int)type_string,
+				     AUDIO_SVC_DB_TABLE_AUDIO,
 				     AUDIO_SVC_CATEGORY_MUSIC);
 
 			if (len < 1 || len >= sizeof(query)) {
@@ -2531,8 +2932,7 @@ int _audio_svc_get_music_track_records(sqlite3 *handle, audio_svc_track_type_e t
 				g_strlcat(query, tail_query, sizeof(query));
 			}
 			snprintf(tail_query, sizeof(tail_query),
-				 "  order by a.play_order limit %d,%d", offset,
-				 rows);
+				 "  order by a.play_order limit ?,?");
 
 			g_strlcat(query, tail_query, sizeof(query));
 		}
@@ -2546,12 +2946,21 @@ int _audio_svc_get_music_track_records(sqlite3 *handle, audio_svc_track_type_e t
 
 	audio_svc_debug("[SQL query] : %s", query);
 
-	err = sqlite3_prepare_v2(handle, query, -1, &sql_stmt, NULL);
+	err = _media_svc_db_ctx_prepare_stmt(handle, query, &sql_stmt);
 	if (err != SQLITE_OK) {
 		audio_svc_error("prepare error [%s]", sqlite3_errmsg(handle));
 		return AUDIO_SVC_ERROR_DB_INTERNAL;
 	}
 
+	if (track_type == AUDIO_SVC_TRACK_BY_PLAYLIST) {
+		if (SQLITE_OK != (err = sqlite3_bind_int(sql_stmt, text_bind, (int)type_string))) {
+			audio_svc_error("playlist_id(%d) binding is failed (%d)", (int)type_string, err);
+			SQLITE3_RELEASE(sql_stmt);
+			return AUDIO_SVC_ERROR_DB_INTERNAL;
+		}
+		text_bind++;
+	}
+
 	if ((track_type >= AUDIO_SVC_TRACK_BY_ALBUM)
 	    && (track_type <= AUDIO_SVC_TRACK_BY_COMPOSER)) {
 		if (type_string && strlen(type_string) > 0) {
@@ -2565,7 +2974,7 @@ int _audio_svc_get_music_track_records(sqlite3 *handle, audio_svc_track_type_e t
 					audio_svc_error
 					    ("cont_string1(%s) binding is failed (%d)",
 					     type_string, err);
-					SQLITE3_FINALIZE(sql_stmt);
+					SQLITE3_RELEASE(sql_stmt);
 					return AUDIO_SVC_ERROR_DB_INTERNAL;
 				}
 
@@ -2579,7 +2988,7 @@ int _audio_svc_get_music_track_records(sqlite3 *handle, audio_svc_track_type_e t
 					audio_svc_error
 					    ("cont_string1(%s) binding is failed (%d)",
 					     type_string, err);
-					SQLITE3_FINALIZE(sql_stmt);
+					SQLITE3_RELEASE(sql_stmt);
 					return AUDIO_SVC_ERROR_DB_INTERNAL;
 				}
 			}
@@ -2598,7 +3007,7 @@ int _audio_svc_get_music_track_records(sqlite3 *handle, audio_svc_track_type_e t
 				audio_svc_error
 				    ("cont_string2(%s) binding is failed (%d)",
 				     type_string2, err);
-				SQLITE3_FINALIZE(sql_stmt);
+				SQLITE3_RELEASE(sql_stmt);
 				return AUDIO_SVC_ERROR_DB_INTERNAL;
 			}
 			text_bind++;
@@ -2614,7 +3023,7 @@ int _audio_svc_get_music_track_records(sqlite3 *handle, audio_svc_track_type_e t
 			audio_svc_error
 			    ("filter_query(%s) binding is failed (%d)",
 			     filter_query, err);
-			SQLITE3_FINALIZE(sql_stmt);
+			SQLITE3_RELEASE(sql_stmt);
 			return AUDIO_SVC_ERROR_DB_INTERNAL;
 		}
 		text_bind++;
@@ -2628,35 +3037,50 @@ int _audio_svc_get_music_track_records(sqlite3 *handle, audio_svc_track_type_e t
 			audio_svc_error
 			    ("filter_query(%s) binding is failed (%d)",
 			     filter_query2, err);
-			SQLITE3_FINALIZE(sql_stmt);
+			SQLITE3_RELEASE(sql_stmt);
 			return AUDIO_SVC_ERROR_DB_INTERNAL;
 		}
 		text_bind++;
 	}
 
+	err = _audio_svc_sql_bind_limit(sql_stmt, offset, rows);
+	if (err != SQLITE_OK) {
+		audio_svc_error("limit binding is failed (%d)", err);
+		SQLITE3_RELEASE(sql_stmt);
+		return AUDIO_SVC_ERROR_DB_INTERNAL;
+	}
+
 	while (sqlite3_step(sql_stmt) == SQLITE_ROW) {
 		_strncpy_safe(track[idx].audio_uuid,
 			      (const char *)sqlite3_column_text(sql_stmt, AUDIO_SVC_LIST_ITEM_AUDIO_ID), sizeof(track[idx].audio_uuid));
-		_strncpy_safe(track[idx].pathname,
-			      (const char *)sqlite3_column_text(sql_stmt, AUDIO_SVC_LIST_ITEM_PATHNAME), sizeof(track[idx].pathname));
-		_strncpy_safe(track[idx].thumbnail_path,
-			      (const char *)sqlite3_column_text(sql_stmt, AUDIO_SVC_LIST_ITEM_THUMBNAIL_PATH), sizeof(track[idx].thumbnail_path));
-		_strncpy_safe(track[idx].title,
-			      (const char *)sqlite3_column_text(sql_stmt, AUDIO_SVC_LIST_ITEM_TITLE), sizeof(track[idx].title));
-		_strncpy_safe(track[idx].artist,
-			      (const char *)sqlite3_column_text(sql_stmt, AUDIO_SVC_LIST_ITEM_ARTIST), sizeof(track[idx].artist));
-		_strncpy_safe(track[idx].album,
-			      (const char *)sqlite3_column_text(sql_stmt, AUDIO_SVC_LIST_ITEM_ALBUM), sizeof(track[idx].artist));
+		err = _audio_svc_str_heap_add(track[idx].heap,
+			      (const char *)sqlite3_column_text(sql_stmt, AUDIO_SVC_LIST_ITEM_PATHNAME), &track[idx].pathname);
+		if (err == AUDIO_SVC_ERROR_NONE)
+			err = _audio_svc_str_heap_add(track[idx].heap,
+			      (const char *)sqlite3_column_text(sql_stmt, AUDIO_SVC_LIST_ITEM_THUMBNAIL_PATH), &track[idx].thumbnail_path);
+		if (err == AUDIO_SVC_ERROR_NONE)
+			err = _audio_svc_str_heap_add(track[idx].heap,
+			      (const char *)sqlite3_column_text(sql_stmt, AUDIO_SVC_LIST_ITEM_TITLE), &track[idx].title);
+		if (err == AUDIO_SVC_ERROR_NONE)
+			err = _audio_svc_str_heap_add(track[idx].heap,
+			      (const char *)sqlite3_column_text(sql_stmt, AUDIO_SVC_LIST_ITEM_ARTIST), &track[idx].artist);
+		if (err == AUDIO_SVC_ERROR_NONE)
+			err = _audio_svc_str_heap_add(track[idx].heap,
+			      (const char *)sqlite3_column_text(sql_stmt, AUDIO_SVC_LIST_ITEM_ALBUM), &track[idx].album);
+		if (err != AUDIO_SVC_ERROR_NONE) {
+			SQLITE3_RELEASE(sql_stmt);
+			return err;
+		}
 
 		track[idx].duration = sqlite3_column_int(sql_stmt, AUDIO_SVC_LIST_ITEM_DURATION);
 		track[idx].rating = sqlite3_column_int(sql_stmt, AUDIO_SVC_LIST_ITEM_RATING);
 		audio_svc_debug ("Index : %d : audio_uuid = %s, title = %s, pathname = %s, duration = %d",
-		     idx, track[idx].audio_uuid, track[idx].title, track[idx].pathname, track[idx].duration);
+		     idx, track[idx].audio_uuid, AUDIO_SVC_LIST_STR(track[idx], title), AUDIO_SVC_LIST_STR(track[idx], pathname), track[idx].duration);
 
 		idx++;
 	}
 
-	SQLITE3_FINALIZE(sql_stmt);
+	SQLITE3_RELEASE(sql_stmt);
 
 	return AUDIO_SVC_ERROR_NONE;
 
@@ -2766,8 +3190,8 @@ int _audio_svc_update_valid_of_music_records(sqlite3 *handle, audio_svc_storage_
 
 	int err = -1;
 	char *sql =
-	    sqlite3_mprintf("update %s set valid = %d where storage_type = %d",
-			    AUDIO_SVC_DB_TABLE_AUDIO, valid, storage_type);
+	    sqlite3_mprintf("update %s set valid = %d where storage_type = %d and valid != %d",
+			    AUDIO_SVC_DB_TABLE_AUDIO, valid, storage_type, valid);
 	err = _audio_svc_sql_query(handle, sql);
 	sqlite3_free(sql);
 	if (err != SQLITE_OK) {
@@ -2809,42 +3233,95 @@ int _audio_svc_count_record_with_path(sqlite3 *handle, const char *path)
 
 }
 
+/* Checks all paths with one prepared statement, in one read transaction */
+int _audio_svc_check_records_with_path(sqlite3 *handle, const char **path_list, int count, int *exist_list)
+{
+	int ret = AUDIO_SVC_ERROR_NONE;
+	int err = -1;
+	int i = 0;
+	bool own_trans = FALSE;
+	sqlite3_stmt *sql_stmt = NULL;
+	char *sql =
+	    sqlite3_mprintf("select 1 from %s where path=?",
+			    AUDIO_SVC_DB_TABLE_AUDIO);
+
+	audio_svc_retv_if(sql == NULL, AUDIO_SVC_ERROR_OUT_OF_MEMORY);
+
+	err = sqlite3_prepare_v2(handle, sql, -1, &sql_stmt, NULL);
+	sqlite3_free(sql);
+	if (err != SQLITE_OK) {
+		audio_svc_error("prepare error [%s]", sqlite3_errmsg(handle));
+		return AUDIO_SVC_ERROR_DB_INTERNAL;
+	}
+
+	if (sqlite3_get_autocommit(handle)) {
+		own_trans = (_audio_svc_sql_query(handle, "BEGIN DEFERRED;") == SQLITE_OK);
+	}
+
+	for (i = 0; i < count; i++) {
+		sqlite3_bind_text(sql_stmt, 1, path_list[i], -1, SQLITE_STATIC);
+
+		err = sqlite3_step(sql_stmt);
+		if (err == SQLITE_ROW) {
+			exist_list[i] = 1;
+		} else if (err == SQLITE_DONE) {
+			exist_list[i] = 0;
+		} else {
+			audio_svc_error("failed to check [%s] [%s]", path_list[i], sqlite3_errmsg(handle));
+			ret = AUDIO_SVC_ERROR_DB_INTERNAL;
+			break;
+		}
+
+		sqlite3_reset(sql_stmt);
+	}
+
+	SQLITE3_FINALIZE(sql_stmt);
+
+	if (own_trans) {
+		if (ret == AUDIO_SVC_ERROR_NONE && _audio_svc_sql_query(handle, "COMMIT;") != SQLITE_OK) {
+			audio_svc_error("failed to end read transaction [%s]", sqlite3_errmsg(handle));
+			ret = AUDIO_SVC_ERROR_DB_INTERNAL;
+		}
+
+		if (ret != AUDIO_SVC_ERROR_NONE)
+			_audio_svc_sql_query(handle, "ROLLBACK;");
+	}
+
+	return ret;
+}
+
 int _audio_svc_delete_invalid_music_records(sqlite3 *handle, audio_svc_storage_type_e
 					    storage_type)
 {
-	int idx = 0;
-	mp_thumbnailpath_record_t *thumbpath_record = NULL;
 	int err = -1;
-	int invalid_count = 0;
 	int ret = AUDIO_SVC_ERROR_NONE;
+	char *sql = NULL;
 
-	invalid_count = __audio_svc_count_invalid_records_with_thumbnail(handle, storage_type);
-	audio_svc_debug("invalid count: %d\n", invalid_count);
+	ret = _audio_svc_sql_begin_trans(handle);
+	audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
 
-	if (invalid_count > 0) {
-		thumbpath_record = (mp_thumbnailpath_record_t *)malloc(sizeof(mp_thumbnailpath_record_t) * invalid_count);
-		if (thumbpath_record == NULL) {
-			audio_svc_debug("fail to memory allocation");
-			return AUDIO_SVC_ERROR_OUT_OF_MEMORY;
-		}
-		memset(thumbpath_record, 0, sizeof(mp_thumbnailpath_record_t) * invalid_count);
+	/* Thumbnails are journaled with the delete, and removed by the thumbnail journal after commit */
+	sql = sqlite3_mprintf("insert into %s (src_path) select distinct thumbnail_path from %s \
+				where valid=0 and storage_type=%d and thumbnail_path is not null and thumbnail_path != ''",
+				MEDIA_SVC_DB_TABLE_THUMB_JOURNAL, AUDIO_SVC_DB_TABLE_AUDIO, storage_type);
+	err = _audio_svc_sql_query(handle, sql);
+	sqlite3_free(sql);
+	if (err != SQLITE_OK) {
+		audio_svc_error("To journal thumbnails of invalid items is failed(%d)", err);
+		_audio_svc_sql_rollback_trans(handle);
 
-		ret = __audio_svc_get_invalid_records_with_thumbnail(handle, storage_type, invalid_count, thumbpath_record);
-		if (ret != AUDIO_SVC_ERROR_NONE) {
-			audio_svc_error("error when get thumbnail record");
-			SAFE_FREE(thumbpath_record);
-			return ret;
+		if (err == AUDIO_SVC_ERROR_DB_CONNECT) {
+			return err;
 		}
-	} else {
-		audio_svc_debug("There is no item with thumbnail");
+		return AUDIO_SVC_ERROR_DB_INTERNAL;
 	}
 
-	char *sql = sqlite3_mprintf("delete from %s where valid = 0 and storage_type=%d", AUDIO_SVC_DB_TABLE_AUDIO, storage_type);
+	sql = sqlite3_mprintf("delete from %s where valid = 0 and storage_type=%d", AUDIO_SVC_DB_TABLE_AUDIO, storage_type);
 	err = _audio_svc_sql_query(handle, sql);
 	sqlite3_free(sql);
 	if (err != SQLITE_OK) {
 		audio_svc_error("To delete invalid items is failed(%d)", err);
-		SAFE_FREE(thumbpath_record);
+		_audio_svc_sql_rollback_trans(handle);
 
 		if (err == AUDIO_SVC_ERROR_DB_CONNECT) {
 			return err;
@@ -2852,34 +3329,16 @@ int _audio_svc_delete_invalid_music_records(sqlite3 *handle, audio_svc_storage_t
 		return AUDIO_SVC_ERROR_DB_INTERNAL;
 	}
 
-#if 0
-	for (idx = 0; idx < invalid_count; idx++) {
-		if (strlen(thumbpath_record[idx].thumbnail_path) > 0) {
-			ret =
-			    _audio_svc_check_and_remove_thumbnail
-			    (thumbpath_record[idx].thumbnail_path);
-			if (ret != AUDIO_SVC_ERROR_NONE) {
-				audio_svc_error
-				    ("error _audio_svc_check_and_remove_thumbnail");
-				SAFE_FREE(thumbpath_record);
-				return ret;
-			}
-		}
+	ret = _audio_svc_sql_end_trans(handle);
+	if (ret != AUDIO_SVC_ERROR_NONE) {
+		audio_svc_error("failed to commit. Now start to rollback");
+		_audio_svc_sql_rollback_trans(handle);
+		return ret;
 	}
 
-	SAFE_FREE(thumbpath_record);
-#endif
-	for (idx = 0; idx < invalid_count; idx++) {
-		if (strlen(thumbpath_record[idx].thumbnail_path) > 0) {
-			if (_audio_svc_remove_file(thumbpath_record[idx].thumbnail_path) == FALSE) {
-				audio_svc_error("fail to remove thumbnail file.");
-				SAFE_FREE(thumbpath_record);
-				return AUDIO_SVC_ERROR_INTERNAL;
-			}
-		}
-	}
-	SAFE_FREE(thumbpath_record);
-	
+	if (_media_svc_thumb_journal_process() != MEDIA_INFO_ERROR_NONE)
+		audio_svc_error("fail to start thumbnail journal. It is resumed by next pass");
+
 	return AUDIO_SVC_ERROR_NONE;
 }
 
@@ -2904,12 +3363,16 @@ int _audio_svc_update_valid_in_music_record(sqlite3 *handle, const char *path, i
 
 int _audio_svc_update_valid_in_music_record_query_add(sqlite3 *handle, const char *path, int valid)
 {
-	char *sql = sqlite3_mprintf("update %s set valid=%d where path= '%q'",
+	char *sql = NULL;
+	media_svc_batch_s *batch = _audio_svc_get_batch(handle, AUDIO_SVC_QUERY_SET_ITEM_VALID);
+	audio_svc_retv_if(batch == NULL, AUDIO_SVC_ERROR_INVALID_PARAMETER);
+
+	sql = sqlite3_mprintf("update %s set valid=%d where path= '%q'",
 				    AUDIO_SVC_DB_TABLE_AUDIO, valid, path);
 
 	audio_svc_debug("SQL = [%s]", sql);
 	
-	_audio_svc_sql_query_add(&g_audio_svc_item_valid_query_list, &sql);
+	_audio_svc_sql_query_add(&batch->query_list, &sql);
 
 	return AUDIO_SVC_ERROR_NONE;
 }
@@ -2917,37 +3380,54 @@ int _audio_svc_update_valid_in_music_record_query_add(sqlite3 *handle, const cha
 int _audio_svc_move_item_query_add(sqlite3 *handle, const char *src_path, const char *path, audio_svc_storage_type_e storage_type, const char *folder_id)
 {
 	char *sql = NULL;
+	media_svc_batch_s *batch = _audio_svc_get_batch(handle, AUDIO_SVC_QUERY_MOVE_ITEM);
+	audio_svc_retv_if(batch == NULL, AUDIO_SVC_ERROR_INVALID_PARAMETER);
+
 	sql = sqlite3_mprintf("update %s set path='%q', storage_type=%d where valid=1 and path='%q'",
 					AUDIO_SVC_DB_TABLE_AUDIO, path, storage_type, src_path);
 
 	audio_svc_debug("SQL = [%s]", sql);
-	_audio_svc_sql_query_add(&g_audio_svc_move_item_query_list, &sql);
+	_audio_svc_sql_query_add(&batch->query_list, &sql);
 
 	sql = sqlite3_mprintf("update %s set folder_uuid='%q' where path='%q'",
 					AUDIO_SVC_DB_TABLE_AUDIO, folder_id, path);
 
 	audio_svc_debug("SQL = [%s]", sql);
-	_audio_svc_sql_query_add(&g_audio_svc_move_item_query_list, &sql);
+	_audio_svc_sql_query_add(&batch->query_list, &sql);
 
 	return AUDIO_SVC_ERROR_NONE;
 }
 
-//call this API after beginning transaction. this API do sqlite_exec for the g_audio_svc_sqli_query_list.
+/* batch state of audio API is kept in the context of the handle, apart from media API */
+media_svc_batch_s *_audio_svc_get_batch(sqlite3 *handle, audio_svc_query_type_e query_type)
+{
+	media_svc_query_type_e media_query_type = MEDIA_SVC_QUERY_INSERT_ITEM;
+
+	if (query_type == AUDIO_SVC_QUERY_SET_ITEM_VALID)
+		media_query_type = MEDIA_SVC_QUERY_SET_ITEM_VALIDITY;
+	else if (query_type == AUDIO_SVC_QUERY_MOVE_ITEM)
+		media_query_type = MEDIA_SVC_QUERY_MOVE_ITEM;
+	else if (query_type == AUDIO_SVC_QUERY_INSERT_ITEM)
+		media_query_type = MEDIA_SVC_QUERY_INSERT_ITEM;
+	else
+		return NULL;
+
+	return _media_svc_db_ctx_get_batch(handle, MEDIA_SVC_BATCH_OWNER_AUDIO, media_query_type);
+}
+
+//call this API after beginning transaction. this API do sqlite_exec for the stacked query list of the handle.
 int _audio_svc_list_query_do(sqlite3 *handle, audio_svc_query_type_e query_type)
 {
 	int ret = AUDIO_SVC_ERROR_NONE;
+	media_svc_batch_s *batch = NULL;
+
+	batch = _audio_svc_get_batch(handle, query_type);
+	audio_svc_retv_if(batch == NULL, AUDIO_SVC_ERROR_INVALID_PARAMETER);
 	
 	ret = _audio_svc_sql_begin_trans(handle);
 	audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
 
-	if (query_type == AUDIO_SVC_QUERY_SET_ITEM_VALID)
-		ret = _audio_svc_sql_query_list(handle, &g_audio_svc_item_valid_query_list);
-	else if (query_type == AUDIO_SVC_QUERY_MOVE_ITEM)
-		ret = _audio_svc_sql_query_list(handle, &g_audio_svc_move_item_query_list);
-	else if (query_type == AUDIO_SVC_QUERY_INSERT_ITEM)
-		ret = _audio_svc_sql_query_list(handle, &g_audio_svc_insert_item_query_list);
-	else
-		ret = AUDIO_SVC_ERROR_INVALID_PARAMETER;
+	ret = _audio_svc_sql_query_list(handle, &batch->query_list);
 	
 	if (ret != AUDIO_SVC_ERROR_NONE) {
 		audio_svc_error("_audio_svc_list_query_do failed. start rollback");
@@ -3004,8 +3484,8 @@ int _audio_svc_get_and_append_folder_id_by_path(sqlite3 *handle, const char *pat
 	if(ret == AUDIO_SVC_ERROR_DB_NO_RECORD) {
 		char *folder_name = NULL;
 		int folder_modified_date = 0;
-		char *folder_uuid = _media_info_generate_uuid();
-		if(folder_uuid == NULL ) {
+		char folder_uuid[AUDIO_SVC_UUID_SIZE+1] = {0,};
+		if(_media_svc_generate_uuid(folder_uuid, sizeof(folder_uuid)) != MEDIA_INFO_ERROR_NONE) {
 			audio_svc_error("Invalid UUID");
 			SAFE_FREE(path_name);
 			return AUDIO_SVC_ERROR_INTERNAL;
@@ -3252,6 +3732,7 @@ int _audio_svc_check_and_remove_thumbnail(sqlite3 *handle, const char *thumbnail
 }
 
 int _audio_svc_list_search(sqlite3 *handle, audio_svc_audio_item_s *item,
+							unsigned int field_mask,
 							char *where_query,
 							audio_svc_search_order_e order_field,
 							int offset,
@@ -3263,10 +3744,21 @@ int _audio_svc_list_search(sqlite3 *handle, audio_svc_audio_item_s *item,
 	char query[AUDIO_SVC_QUERY_SIZE] = { 0 };
 	char condition_str[AUDIO_SVC_QUERY_SIZE] = { 0 };
 	char order_str[AUDIO_SVC_QUERY_SIZE] = { 0 };
+	char columns[AUDIO_SVC_QUERY_SIZE] = { 0 };
 
 	sqlite3_stmt *sql_stmt = NULL;
 
-	snprintf(query, sizeof(query), "SELECT * FROM audio_media WHERE %s", where_query);
+	if (field_mask == AUDIO_SVC_TRACK_FIELD_ALL) {
+		snprintf(query, sizeof(query), "SELECT * FROM audio_media WHERE %s", where_query);
+	} else {
+		/* only requested columns, so an index covering them can answer the query without the table */
+		err = __audio_svc_make_field_columns(field_mask, columns, sizeof(columns));
+		if (err != AUDIO_SVC_ERROR_NONE) {
+			audio_svc_error("invalid field mask 0x%x", field_mask);
+			return err;
+		}
+		snprintf(query, sizeof(query), "SELECT %s FROM audio_media WHERE %s", columns, where_query);
+	}
 
 	audio_svc_debug("");
 	if (_audio_svc_get_order_field_str(order_field, order_str, 
@@ -3303,7 +3795,10 @@ int _audio_svc_list_search(sqlite3 *handle, audio_svc_audio_item_s *item,
 	}
 
 	while (sqlite3_step(sql_stmt) == SQLITE_ROW) {
-		__audio_svc_get_next_record(item, sql_stmt);
+		if (field_mask == AUDIO_SVC_TRACK_FIELD_ALL)
+			__audio_svc_get_next_record(item, sql_stmt);
+		else
+			__audio_svc_get_next_record_by_fields(item, sql_stmt, field_mask);
 		item++;
 	}
 
@@ -86,11 +86,11 @@ static int __audio_svc_create_playlist_item_db_table(sqlite3 *handle)
 		}
 		return AUDIO_SVC_ERROR_DB_INTERNAL;
 	}
-	/* add trigger to remove item from audio_playlists_map when item remove */
+	/* add trigger to remove item from audio_playlists_map when item remove. audio_media is a view, so it is on audio_media_data */
 	sql =
 	    sqlite3_mprintf
 	    ("CREATE TRIGGER IF NOT EXISTS audio_playlists_map_cleanup_1 DELETE ON %s BEGIN DELETE FROM %s WHERE audio_uuid=old.audio_uuid;END;",
-	     AUDIO_SVC_DB_TABLE_AUDIO, AUDIO_SVC_DB_TABLE_AUDIO_PLAYLISTS_MAP);
+	     AUDIO_SVC_DB_TABLE_AUDIO_DATA, AUDIO_SVC_DB_TABLE_AUDIO_PLAYLISTS_MAP);
 	err = _audio_svc_sql_query(handle, sql);
 	sqlite3_free(sql);
 	if (err != SQLITE_OK) {
@@ -296,7 +296,7 @@ int _audio_svc_count_playlist_records(sqlite3 *handle, const char *filter_string
 		}
 	};
 
-	err = sqlite3_prepare_v2(handle, query, -1, &sql_stmt, NULL);
+	err = _media_svc_db_ctx_prepare_stmt(handle, query, &sql_stmt);
 	if (SQLITE_OK != err) {
 		audio_svc_error("prepare error [%s]", sqlite3_errmsg(handle));
 		return AUDIO_SVC_ERROR_DB_INTERNAL;
@@ -314,7 +314,7 @@ int _audio_svc_count_playlist_records(sqlite3 *handle, const char *filter_string
 			audio_svc_error
 			    ("filter_query(%s) binding is failed (%d)",
 			     filter_query, err);
-			SQLITE3_FINALIZE(sql_stmt);
+			SQLITE3_RELEASE(sql_stmt);
 			return AUDIO_SVC_ERROR_DB_INTERNAL;
 		}
 	}
@@ -331,7 +331,7 @@ int _audio_svc_count_playlist_records(sqlite3 *handle, const char *filter_string
 			audio_svc_error
 			    ("filter_query(%s) binding is failed (%d)",
 			     filter_query2, err);
-			SQLITE3_FINALIZE(sql_stmt);
+			SQLITE3_RELEASE(sql_stmt);
 			return AUDIO_SVC_ERROR_DB_INTERNAL;
 		}
 	}
@@ -341,13 +341,13 @@ int _audio_svc_count_playlist_records(sqlite3 *handle, const char *filter_string
 	err = sqlite3_step(sql_stmt);
 	if (err != SQLITE_ROW) {
 		audio_svc_error("end of row [%s]", sqlite3_errmsg(handle));
-		SQLITE3_FINALIZE(sql_stmt);
+		SQLITE3_RELEASE(sql_stmt);
 		return AUDIO_SVC_ERROR_DB_INTERNAL;
 	}
 
 	*count = sqlite3_column_int(sql_stmt, 0);
 
-	SQLITE3_FINALIZE(sql_stmt);
+	SQLITE3_RELEASE(sql_stmt);
 
 	return AUDIO_SVC_ERROR_NONE;
 }
@@ -394,11 +394,11 @@ int _audio_svc_get_playlist_records(sqlite3 *handle, int offset, int rows,
 			g_strlcat(query, filter_1, sizeof(query));
 		}
 	}
-	snprintf(tail_query, sizeof(tail_query), " %s limit %d,%d", AUDIO_SVC_ORDER_BY_PLAYLIST_NAME, offset, rows);
+	snprintf(tail_query, sizeof(tail_query), " %s limit ?,?", AUDIO_SVC_ORDER_BY_PLAYLIST_NAME);
 	g_strlcat(query, tail_query, sizeof(query));
 
 	audio_svc_debug("[SQL query] : %s", query);
-	err = sqlite3_prepare_v2(handle, query, -1, &sql_stmt, NULL);
+	err = _media_svc_db_ctx_prepare_stmt(handle, query, &sql_stmt);
 	if (SQLITE_OK != err) {
 		audio_svc_error("prepare error [%s]", sqlite3_errmsg(handle));
 		return AUDIO_SVC_ERROR_DB_INTERNAL;
@@ -416,7 +416,7 @@ int _audio_svc_get_playlist_records(sqlite3 *handle, int offset, int rows,
 			audio_svc_error
 			    ("filter_query(%s) binding is failed (%d)",
 			     filter_query, err);
-			SQLITE3_FINALIZE(sql_stmt);
+			SQLITE3_RELEASE(sql_stmt);
 			return AUDIO_SVC_ERROR_DB_INTERNAL;
 		}
 	}
@@ -432,11 +432,18 @@ int _audio_svc_get_playlist_records(sqlite3 *handle, int offset, int rows,
 			audio_svc_error
 			    ("filter_query(%s) binding is failed (%d)",
 			     filter_query2, err);
-			SQLITE3_FINALIZE(sql_stmt);
+			SQLITE3_RELEASE(sql_stmt);
 			return AUDIO_SVC_ERROR_DB_INTERNAL;
 		}
 	}
 
+	err = _audio_svc_sql_bind_limit(sql_stmt, offset, rows);
+	if (err != SQLITE_OK) {
+		audio_svc_error("limit binding is failed (%d)", err);
+		SQLITE3_RELEASE(sql_stmt);
+		return AUDIO_SVC_ERROR_DB_INTERNAL;
+	}
+
 	while (sqlite3_step(sql_stmt) == SQLITE_ROW) {
 		playlists[idx].playlist_id = sqlite3_column_int(sql_stmt, 0);
 		_strncpy_safe(playlists[idx].name,
@@ -445,7 +452,7 @@ int _audio_svc_get_playlist_records(sqlite3 *handle, int offset, int rows,
 		idx++;
 	}
 
-	SQLITE3_FINALIZE(sql_stmt);
+	SQLITE3_RELEASE(sql_stmt);
 
 	/* add query to get thumbnail_path of playlists */
 	for (idx_1 = 0; idx_1 < idx; idx_1++) {
@@ -476,7 +483,7 @@ int _audio_svc_get_playlist_records(sqlite3 *handle, int offset, int rows,
 		}
 		_strncpy_safe(playlists[idx_1].thumbnail_path, (const char *)sqlite3_column_text(sql_stmt, 0), sizeof(playlists[idx_1].thumbnail_path));
 		
-		SQLITE3_FINALIZE(sql_stmt);
+		SQLITE3_RELEASE(sql_stmt);
 	}
 
 	return AUDIO_SVC_ERROR_NONE;
@@ -513,9 +520,9 @@ int _audio_svc_count_playlist_item_records(sqlite3 *handle, int playlist_id,
 	}
 
 	snprintf(query, sizeof(query),
-		 "select count(*) from %s a, %s b where a.playlist_id=%d and b.audio_uuid=a.audio_uuid and b.valid=1 and b.category=%d",
+		 "select count(*) from %s a, %s b where a.playlist_id=? and b.audio_uuid=a.audio_uuid and b.valid=1 and b.category=%d",
 		 AUDIO_SVC_DB_TABLE_AUDIO_PLAYLISTS_MAP,
-		 AUDIO_SVC_DB_TABLE_AUDIO, playlist_id,
+		 AUDIO_SVC_DB_TABLE_AUDIO,
 		 AUDIO_SVC_CATEGORY_MUSIC);
 
 	if (filter_mode) {
@@ -525,12 +532,19 @@ int _audio_svc_count_playlist_item_records(sqlite3 *handle, int playlist_id,
 		g_strlcat(query, " and b.title like ?", sizeof(query));
 	}
 
-	err = sqlite3_prepare_v2(handle, query, -1, &sql_stmt, NULL);
+	err = _media_svc_db_ctx_prepare_stmt(handle, query, &sql_stmt);
 	if (err != SQLITE_OK) {
 		audio_svc_error("prepare error [%s]", sqlite3_errmsg(handle));
 		return AUDIO_SVC_ERROR_DB_INTERNAL;
 	}
 
+	if (SQLITE_OK != (err = sqlite3_bind_int(sql_stmt, text_bind, playlist_id))) {
+		audio_svc_error("playlist_id(%d) binding is failed (%d)", playlist_id, err);
+		SQLITE3_RELEASE(sql_stmt);
+		return AUDIO_SVC_ERROR_DB_INTERNAL;
+	}
+	text_bind++;
+
 	if (filter_mode) {
 		if (SQLITE_OK !=
 		    (err =
@@ -540,7 +554,7 @@ int _audio_svc_count_playlist_item_records(sqlite3 *handle, int playlist_id,
 			audio_svc_error
 			    ("filter_query(%s) binding is failed (%d)",
 			     filter_query, err);
-			SQLITE3_FINALIZE(sql_stmt);
+			SQLITE3_RELEASE(sql_stmt);
 			return AUDIO_SVC_ERROR_DB_INTERNAL;
 		}
 		text_bind++;
@@ -554,7 +568,7 @@ int _audio_svc_count_playlist_item_records(sqlite3 *handle, int playlist_id,
 			audio_svc_error
 			    ("filter_query(%s) binding is failed (%d)",
 			     filter_query2, err);
-			SQLITE3_FINALIZE(sql_stmt);
+			SQLITE3_RELEASE(sql_stmt);
 			return AUDIO_SVC_ERROR_DB_INTERNAL;
 		}
 		text_bind++;
@@ -565,12 +579,12 @@ int _audio_svc_count_playlist_item_records(sqlite3 *handle, int playlist_id,
 	err = sqlite3_step(sql_stmt);
 	if (err != SQLITE_ROW) {
 		audio_svc_error("end of row [%s]", sqlite3_errmsg(handle));
-		SQLITE3_FINALIZE(sql_stmt);
+		SQLITE3_RELEASE(sql_stmt);
 		return AUDIO_SVC_ERROR_DB_INTERNAL;
 	}
 	*count = sqlite3_column_int(sql_stmt, 0);
 
-	SQLITE3_FINALIZE(sql_stmt);
+	SQLITE3_RELEASE(sql_stmt);
 
 	return AUDIO_SVC_ERROR_NONE;
 }
@@ -611,10 +625,10 @@ int _audio_svc_get_playlist_item_records(sqlite3 *handle, int playlist_id,
 	    "a._id, b.audio_uuid, b.path, b.thumbnail_path, b.title, b.artist, b.duration, b.rating, a.play_order";
 	len =
 	    snprintf(query, sizeof(query),
-		     "select %s from %s a, %s b where a.playlist_id=%d and b.audio_uuid=a.audio_uuid and b.valid=1 and b.category=%d ",
+		     "select %s from %s a, %s b where a.playlist_id=? and b.audio_uuid=a.audio_uuid and b.valid=1 and b.category=%d ",
 		     result_field_for_playlist,
 		     AUDIO_SVC_DB_TABLE_AUDIO_PLAYLISTS_MAP,
-		     AUDIO_SVC_DB_TABLE_AUDIO, playlist_id,
+		     AUDIO_SVC_DB_TABLE_AUDIO,
 		     AUDIO_SVC_CATEGORY_MUSIC);
 
 	if (len < 1 || len >= sizeof(query)) {
@@ -633,18 +647,25 @@ int _audio_svc_get_playlist_item_records(sqlite3 *handle, int playlist_id,
 		g_strlcat(query, tail_query, sizeof(query));
 	}
 	snprintf(tail_query, sizeof(tail_query),
-		 "  order by a.play_order limit %d,%d", offset, rows);
+		 "  order by a.play_order limit ?,?");
 
 	g_strlcat(query, tail_query, sizeof(query));
 
 	audio_svc_debug("[SQL query] : %s", query);
 
-	err = sqlite3_prepare_v2(handle, query, -1, &sql_stmt, NULL);
+	err = _media_svc_db_ctx_prepare_stmt(handle, query, &sql_stmt);
 	if (err != SQLITE_OK) {
 		audio_svc_error("prepare error [%s]", sqlite3_errmsg(handle));
 		return AUDIO_SVC_ERROR_DB_INTERNAL;
 	}
 
+	if (SQLITE_OK != (err = sqlite3_bind_int(sql_stmt, text_bind, playlist_id))) {
+		audio_svc_error("playlist_id(%d) binding is failed (%d)", playlist_id, err);
+		SQLITE3_RELEASE(sql_stmt);
+		return AUDIO_SVC_ERROR_DB_INTERNAL;
+	}
+	text_bind++;
+
 	if (filter_mode) {
 		if (SQLITE_OK !=
 		    (err =
@@ -654,7 +675,7 @@ int _audio_svc_get_playlist_item_records(sqlite3 *handle, int playlist_id,
 			audio_svc_error
 			    ("filter_query(%s) binding is failed (%d)",
 			     filter_query, err);
-			SQLITE3_FINALIZE(sql_stmt);
+			SQLITE3_RELEASE(sql_stmt);
 			return AUDIO_SVC_ERROR_DB_INTERNAL;
 		}
 		text_bind++;
@@ -668,36 +689,50 @@ int _audio_svc_get_playlist_item_records(sqlite3 *handle, int playlist_id,
 			audio_svc_error
 			    ("filter_query(%s) binding is failed (%d)",
 			     filter_query2, err);
-			SQLITE3_FINALIZE(sql_stmt);
+			SQLITE3_RELEASE(sql_stmt);
 			return AUDIO_SVC_ERROR_DB_INTERNAL;
 		}
 		text_bind++;
 	}
 
+	err = _audio_svc_sql_bind_limit(sql_stmt, offset, rows);
+	if (err != SQLITE_OK) {
+		audio_svc_error("limit binding is failed (%d)", err);
+		SQLITE3_RELEASE(sql_stmt);
+		return AUDIO_SVC_ERROR_DB_INTERNAL;
+	}
+
 	while (sqlite3_step(sql_stmt) == SQLITE_ROW) {
 		track[idx].u_id =
 		    sqlite3_column_int(sql_stmt, AUDIO_SVC_PLAYLIST_ITEM_UID);
 		_strncpy_safe(track[idx].audio_uuid,
 			      (const char *)sqlite3_column_text(sql_stmt, AUDIO_SVC_PLAYLIST_ITEM_AUDIO_ID), sizeof(track[idx].audio_uuid));
-		_strncpy_safe(track[idx].pathname,
-			      (const char *)sqlite3_column_text(sql_stmt, AUDIO_SVC_PLAYLIST_ITEM_PATHNAME), sizeof(track[idx].pathname));
-		_strncpy_safe(track[idx].thumbnail_path,
-			      (const char *)sqlite3_column_text(sql_stmt, AUDIO_SVC_PLAYLIST_ITEM_THUMBNAIL_PATH), sizeof(track[idx].thumbnail_path));
-		_strncpy_safe(track[idx].title,
-			      (const char *)sqlite3_column_text(sql_stmt, AUDIO_SVC_PLAYLIST_ITEM_TITLE), sizeof(track[idx].title));
-		_strncpy_safe(track[idx].artist,
-			      (const char *)sqlite3_column_text(sql_stmt, AUDIO_SVC_PLAYLIST_ITEM_ARTIST), sizeof(track[idx].artist));
+		err = _audio_svc_str_heap_add(track[idx].heap,
+			      (const char *)sqlite3_column_text(sql_stmt, AUDIO_SVC_PLAYLIST_ITEM_PATHNAME), &track[idx].pathname);
+		if (err == AUDIO_SVC_ERROR_NONE)
+			err = _audio_svc_str_heap_add(track[idx].heap,
+			      (const char *)sqlite3_column_text(sql_stmt, AUDIO_SVC_PLAYLIST_ITEM_THUMBNAIL_PATH), &track[idx].thumbnail_path);
+		if (err == AUDIO_SVC_ERROR_NONE)
+			err = _audio_svc_str_heap_add(track[idx].heap,
+			      (const char *)sqlite3_column_text(sql_stmt, AUDIO_SVC_PLAYLIST_ITEM_TITLE), &track[idx].title);
+		if (err == AUDIO_SVC_ERROR_NONE)
+			err = _audio_svc_str_heap_add(track[idx].heap,
+			      (const char *)sqlite3_column_text(sql_stmt, AUDIO_SVC_PLAYLIST_ITEM_ARTIST), &track[idx].artist);
+		if (err != AUDIO_SVC_ERROR_NONE) {
+			SQLITE3_RELEASE(sql_stmt);
+			return err;
+		}
 		track[idx].duration = sqlite3_column_int(sql_stmt, AUDIO_SVC_PLAYLIST_ITEM_DURATION);
 		track[idx].rating = sqlite3_column_int(sql_stmt, AUDIO_SVC_PLAYLIST_ITEM_RATING);
 		track[idx].play_order = sqlite3_column_int(sql_stmt, AUDIO_SVC_PLAYLIST_ITEM_PLAY_ORDER);
 		
 		audio_svc_debug("u_id = %d, audio_uuid = %s, title = %s, pathname = %s, duration = %d, play_order = %d",
-		     track[idx].u_id, track[idx].audio_uuid, track[idx].title, track[idx].pathname, track[idx].duration, track[idx].play_order);
+		     track[idx].u_id, track[idx].audio_uuid, AUDIO_SVC_LIST_STR(track[idx], title), AUDIO_SVC_LIST_STR(track[idx], pathname), track[idx].duration, track[idx].play_order);
 
 		idx++;
 	}
 
-	SQLITE3_FINALIZE(sql_stmt);
+	SQLITE3_RELEASE(sql_stmt);
 
 	return AUDIO_SVC_ERROR_NONE;
 }
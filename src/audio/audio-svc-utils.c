@@ -135,7 +135,96 @@ static int __save_thumbnail(void *image, int size, char *thumb_path)
 	return AUDIO_SVC_ERROR_NONE;
 }
 
-int _audio_svc_extract_metadata_audio(audio_svc_storage_type_e storage_type, const char *path, audio_svc_audio_item_s *item)
+/* Fills metadata of DRM file which has no valid license, from the DRM header kept in the probe and file name.
+ * Returns FALSE if the license is valid, and then metadata is extracted from the file as usual */
+static bool __audio_svc_extract_drm_metadata(audio_svc_audio_item_s *item, media_svc_probe_s *probe)
+{
+	int extracted_field = AUDIO_SVC_EXTRACTED_FIELD_NONE;
+	char *title = NULL;
+	const drm_content_info_s *contentInfo = &probe->drm_content;
+
+	if (!_media_svc_probe_drm_locked(probe))
+		return FALSE;
+
+	if (probe->drm_file_type == DRM_TYPE_OMA_V1) {
+
+		if (strlen(contentInfo->title) > 0) {
+			_strncpy_safe(item->audio.title, contentInfo->title, sizeof(item->audio.title));
+			extracted_field |= AUDIO_SVC_EXTRACTED_FIELD_TITLE;
+		}
+
+		if (strlen(contentInfo->description) > 0) {
+			_strncpy_safe(item->audio.description, contentInfo->description, sizeof(item->audio.description));
+			extracted_field |= AUDIO_SVC_EXTRACTED_FIELD_DESC;
+		}
+	} else if (probe->drm_file_type == DRM_TYPE_OMA_V2) {
+		if (strlen(contentInfo->title) > 0) {
+			_strncpy_safe(item->audio.title, contentInfo->title, sizeof(item->audio.title));
+			extracted_field |= AUDIO_SVC_EXTRACTED_FIELD_TITLE;
+		}
+
+		if (strlen(contentInfo->description) > 0) {
+			_strncpy_safe(item->audio.description, contentInfo->description, sizeof(item->audio.description));
+			extracted_field |= AUDIO_SVC_EXTRACTED_FIELD_DESC;
+		}
+
+		if (strlen(contentInfo->copyright) > 0) {
+			_strncpy_safe(item->audio.copyright, contentInfo->copyright, sizeof(item->audio.copyright));
+			extracted_field |= AUDIO_SVC_EXTRACTED_FIELD_COPYRIGHT;
+		}
+		if (strlen(contentInfo->author) > 0) {
+			_strncpy_safe(item->audio.author, contentInfo->author, sizeof(item->audio.author));
+			extracted_field |= AUDIO_SVC_EXTRACTED_FIELD_AUTHOR;
+		}
+		if (strlen(contentInfo->author) > 0) {
+			_strncpy_safe(item->audio.artist, contentInfo->author, sizeof(item->audio.artist));
+			extracted_field |= AUDIO_SVC_EXTRACTED_FIELD_ARTIST;
+		}
+
+	}
+
+	if (!(extracted_field & AUDIO_SVC_EXTRACTED_FIELD_TITLE)) {
+		title = _audio_svc_get_title_from_filepath(item->pathname);
+		if (title) {
+			_strncpy_safe(item->audio.title, title, sizeof(item->audio.title));
+			SAFE_FREE(title);
+		} else {
+			audio_svc_error("Can't extract title from filepath");
+			_strncpy_safe(item->audio.title, AUDIO_SVC_TAG_UNKNOWN, sizeof(item->audio.title));
+		}
+	}
+
+	if (!(extracted_field & AUDIO_SVC_EXTRACTED_FIELD_DESC)) {
+		_strncpy_safe(item->audio.description, AUDIO_SVC_TAG_UNKNOWN, sizeof(item->audio.description));
+	}
+	if (!(extracted_field & AUDIO_SVC_EXTRACTED_FIELD_AUTHOR)) {
+		_strncpy_safe(item->audio.author, AUDIO_SVC_TAG_UNKNOWN, sizeof(item->audio.author));
+	}
+	if (!(extracted_field & AUDIO_SVC_EXTRACTED_FIELD_ARTIST)) {
+		_strncpy_safe(item->audio.description, AUDIO_SVC_TAG_UNKNOWN, sizeof(item->audio.description));
+	}
+	if (!(extracted_field & AUDIO_SVC_EXTRACTED_FIELD_COPYRIGHT)) {
+		_strncpy_safe(item->audio.copyright, AUDIO_SVC_TAG_UNKNOWN, sizeof(item->audio.copyright));
+	}
+
+	_strncpy_safe(item->audio.album, AUDIO_SVC_TAG_UNKNOWN, sizeof(item->audio.album));
+	_strncpy_safe(item->audio.genre, AUDIO_SVC_TAG_UNKNOWN, sizeof(item->audio.genre));
+	_strncpy_safe(item->audio.year, AUDIO_SVC_TAG_UNKNOWN, sizeof(item->audio.year));
+
+	return TRUE;
+}
+
+/* Keeps modified time and size from the probe, so inserting the item does not stat the file again */
+static void __audio_svc_set_file_stat(audio_svc_audio_item_s *item, media_svc_probe_s *probe)
+{
+	const struct stat *st = _media_svc_probe_stat(probe);
+
+	item->file_stat_done = TRUE;
+	item->time_modified = (st != NULL) ? st->st_mtime : -1;
+	item->size = (st != NULL) ? st->st_size : -1;
+}
+
+int _audio_svc_extract_metadata_audio(audio_svc_storage_type_e storage_type, const char *path, media_svc_probe_s *probe, audio_svc_audio_item_s *item)
 {
 	MMHandleType content = 0;
 	MMHandleType tag = 0;
@@ -157,113 +246,11 @@ int _audio_svc_extract_metadata_audio(audio_svc_storage_type_e storage_type, con
 	
 	_strncpy_safe(item->pathname, path, sizeof(item->pathname));
 	item->storage_type = storage_type;
+	__audio_svc_set_file_stat(item, probe);
 
-	drm_bool_type_e drm_type;
-
-	ret = drm_is_drm_file(item->pathname, &drm_type);
-	if (ret < 0) {
-		audio_svc_error("drm_is_drm_file falied : %d", ret);
-		drm_type = DRM_FALSE;
-	}
-
-	if (drm_type) {
-		bool invalid_file = FALSE;
-		drm_file_type_e drm_file_type;
-		drm_permission_type_e drm_perm_type = DRM_PERMISSION_TYPE_PLAY;
-		drm_content_info_s contentInfo;
-		drm_license_status_e license_status;
-		memset(&contentInfo, 0x00, sizeof(drm_content_info_s));
-
-		ret = drm_get_file_type(item->pathname, &drm_file_type);
-		if (ret < 0) {
-			audio_svc_error("drm_get_file_type falied : %d", ret);
-			drm_file_type = DRM_TYPE_UNDEFINED;
-			invalid_file = TRUE;
-		}
-
-		ret = drm_get_content_info(item->pathname, &contentInfo);
-		if (ret != DRM_RETURN_SUCCESS) {
-			audio_svc_error("drm_get_content_info() fails. : %d", ret);
-			invalid_file = TRUE;
-		}
-
-		ret = drm_get_license_status(item->pathname, drm_perm_type, &license_status);
-		if (ret != DRM_RETURN_SUCCESS) {
-			audio_svc_error("drm_get_license_status() fails. : %d", ret);
-			invalid_file = TRUE;
-		}
-
-		if ((!invalid_file) && (license_status != DRM_LICENSE_STATUS_VALID)) {
-			invalid_file = TRUE;
-			if (drm_file_type == DRM_TYPE_OMA_V1) {
-
-				if (strlen(contentInfo.title) > 0) {
-					_strncpy_safe(item->audio.title, contentInfo.title, sizeof(item->audio.title));
-					extracted_field |= AUDIO_SVC_EXTRACTED_FIELD_TITLE;
-				}
-
-				if (strlen(contentInfo.description) > 0) {
-					_strncpy_safe(item->audio.description, contentInfo.description, sizeof(item->audio.description));
-					extracted_field |= AUDIO_SVC_EXTRACTED_FIELD_DESC;
-				}
-			} else if (drm_file_type == DRM_TYPE_OMA_V2) {
-				if (strlen(contentInfo.title) > 0) {
-					_strncpy_safe(item->audio.title, contentInfo.title, sizeof(item->audio.title));
-					extracted_field |= AUDIO_SVC_EXTRACTED_FIELD_TITLE;
-				}
-
-				if (strlen(contentInfo.description) > 0) {
-					_strncpy_safe(item->audio.description, contentInfo.description, sizeof(item->audio.description));
-					extracted_field |= AUDIO_SVC_EXTRACTED_FIELD_DESC;
-				}
-
-				if (strlen(contentInfo.copyright) > 0) {
-					_strncpy_safe(item->audio.copyright, contentInfo.copyright, sizeof(item->audio.copyright));
-					extracted_field |= AUDIO_SVC_EXTRACTED_FIELD_COPYRIGHT;
-				}
-				if (strlen(contentInfo.author) > 0) {
-					_strncpy_safe(item->audio.author, contentInfo.author, sizeof(item->audio.author));
-					extracted_field |= AUDIO_SVC_EXTRACTED_FIELD_AUTHOR;
-				}
-				if (strlen(contentInfo.author) > 0) {
-					_strncpy_safe(item->audio.artist, contentInfo.author, sizeof(item->audio.artist));
-					extracted_field |= AUDIO_SVC_EXTRACTED_FIELD_ARTIST;
-				}
-
-			}
-		}
-
-		if (invalid_file) {
-			if (!(extracted_field & AUDIO_SVC_EXTRACTED_FIELD_TITLE)) {
-				title = _audio_svc_get_title_from_filepath(item->pathname);
-				if (title) {
-					_strncpy_safe(item->audio.title, title, sizeof(item->audio.title));
-					SAFE_FREE(title);
-				} else {
-					audio_svc_error("Can't extract title from filepath");
-					_strncpy_safe(item->audio.title, AUDIO_SVC_TAG_UNKNOWN, sizeof(item->audio.title));
-				}
-			}
-
-			if (!(extracted_field & AUDIO_SVC_EXTRACTED_FIELD_DESC)) {
-				_strncpy_safe(item->audio.description, AUDIO_SVC_TAG_UNKNOWN, sizeof(item->audio.description));
-			}
-			if (!(extracted_field & AUDIO_SVC_EXTRACTED_FIELD_AUTHOR)) {
-				_strncpy_safe(item->audio.author, AUDIO_SVC_TAG_UNKNOWN, sizeof(item->audio.author));
-			}
-			if (!(extracted_field & AUDIO_SVC_EXTRACTED_FIELD_ARTIST)) {
-				_strncpy_safe(item->audio.description, AUDIO_SVC_TAG_UNKNOWN, sizeof(item->audio.description));
-			}
-			if (!(extracted_field & AUDIO_SVC_EXTRACTED_FIELD_COPYRIGHT)) {
-				_strncpy_safe(item->audio.copyright, AUDIO_SVC_TAG_UNKNOWN, sizeof(item->audio.copyright));
-			}
-
-			_strncpy_safe(item->audio.album, AUDIO_SVC_TAG_UNKNOWN, sizeof(item->audio.album));
-			_strncpy_safe(item->audio.genre, AUDIO_SVC_TAG_UNKNOWN, sizeof(item->audio.genre));
-			_strncpy_safe(item->audio.year, AUDIO_SVC_TAG_UNKNOWN, sizeof(item->audio.year));
-
+	if (_media_svc_probe_is_drm(probe)) {
+		if (__audio_svc_extract_drm_metadata(item, probe))
 			return AUDIO_SVC_ERROR_NONE;
-		}
 
 #if 0
 
@@ -758,6 +745,85 @@ int _audio_svc_extract_metadata_audio(audio_svc_storage_type_e storage_type, con
 	return AUDIO_SVC_ERROR_NONE;
 }
 
+#define AUDIO_SVC_META_STR(str)		((str) ? (str) : AUDIO_SVC_TAG_UNKNOWN)
+
+int _audio_svc_extract_metadata_by_content_info(const media_svc_content_info_s *content_info, media_svc_probe_s *probe, audio_svc_audio_item_s *item)
+{
+	const media_svc_content_meta_s *meta = NULL;
+	char *title = NULL;
+
+	if (content_info == NULL || probe == NULL || item == NULL || !STRING_VALID(content_info->path)) {
+		audio_svc_error("invalid parameter");
+		return AUDIO_SVC_ERROR_INVALID_PARAMETER;
+	}
+
+	meta = &content_info->media_meta;
+
+	_strncpy_safe(item->pathname, content_info->path, sizeof(item->pathname));
+	item->storage_type = (content_info->storage_type == MEDIA_SVC_STORAGE_EXTERNAL) ? AUDIO_SVC_STORAGE_MMC : AUDIO_SVC_STORAGE_PHONE;
+	item->category = (content_info->media_type == MEDIA_SVC_MEDIA_TYPE_SOUND) ? AUDIO_SVC_CATEGORY_SOUND : AUDIO_SVC_CATEGORY_MUSIC;
+	item->time_added = content_info->added_time;
+	__audio_svc_set_file_stat(item, probe);
+
+	/* same as _audio_svc_extract_metadata_audio for DRM file without valid license */
+	if (content_info->is_drm && __audio_svc_extract_drm_metadata(item, probe))
+		return AUDIO_SVC_ERROR_NONE;
+
+	if (STRING_VALID(content_info->thumbnail_path))
+		_strncpy_safe(item->thumbname, content_info->thumbnail_path, sizeof(item->thumbname));
+
+	if (STRING_VALID(meta->title) && strcmp(meta->title, AUDIO_SVC_TAG_UNKNOWN)) {
+		_strncpy_safe(item->audio.title, meta->title, sizeof(item->audio.title));
+	} else {
+		title = _audio_svc_get_title_from_filepath(item->pathname);
+		if (title) {
+			_strncpy_safe(item->audio.title, title, sizeof(item->audio.title));
+			SAFE_FREE(title);
+		} else {
+			audio_svc_error("Can't extract title from filepath");
+			return AUDIO_SVC_ERROR_INTERNAL;
+		}
+	}
+	_strncpy_safe(item->audio.artist, AUDIO_SVC_META_STR(meta->artist), sizeof(item->audio.artist));
+	_strncpy_safe(item->audio.album, AUDIO_SVC_META_STR(meta->album), sizeof(item->audio.album));
+	_strncpy_safe(item->audio.genre, AUDIO_SVC_META_STR(meta->genre), sizeof(item->audio.genre));
+	_strncpy_safe(item->audio.author, AUDIO_SVC_META_STR(meta->composer), sizeof(item->audio.author));
+	_strncpy_safe(item->audio.year, AUDIO_SVC_META_STR(meta->year), sizeof(item->audio.year));
+
+	if (meta->copyright)
+		_strncpy_safe(item->audio.copyright, meta->copyright, sizeof(item->audio.copyright));
+	if (meta->description)
+		_strncpy_safe(item->audio.description, meta->description, sizeof(item->audio.description));
+
+	if (STRING_VALID(meta->track_num) && strcmp(meta->track_num, AUDIO_SVC_TAG_UNKNOWN))
+		item->audio.track = atoi(meta->track_num);
+	else
+		item->audio.track = -1;
+
+	if (meta->rating > 0)
+		snprintf(item->audio.parental_rating, sizeof(item->audio.parental_rating), "%d", meta->rating);
+
+	item->audio.duration = meta->duration;
+	item->audio.bitrate = meta->bitrate;
+
+	/* same format string as _audio_svc_extract_metadata_audio */
+	if (meta->bitrate > 0 && meta->samplerate > 0) {
+		snprintf(item->audio.format, sizeof(item->audio.format) - 1,
+				"%dkbps %.1fkHz %dch",
+				meta->bitrate / 1000, meta->samplerate / 1000.0, meta->channel);
+	} else if (meta->bitrate > 0) {
+		snprintf(item->audio.format, sizeof(item->audio.format) - 1,
+				"%dkbps %dch",
+				meta->bitrate / 1000, meta->channel);
+	} else if (meta->samplerate > 0) {
+		snprintf(item->audio.format, sizeof(item->audio.format) - 1,
+				"%.1fkHz %dch",
+				meta->samplerate / 1000.0, meta->channel);
+	}
+
+	return AUDIO_SVC_ERROR_NONE;
+}
+
 bool _audio_svc_possible_to_extract_title_from_file(const char *path)
 {
 	MMHandleType tag = 0;
@@ -1305,3 +1371,90 @@ int _audio_svc_get_file_dir_modified_date(const char *full_path)
 	 return statbuf.st_mtime;
 }
 
+
+static audio_svc_str_block_s *__audio_svc_str_block_new(int size)
+{
+	audio_svc_str_block_s *block = (audio_svc_str_block_s *)malloc(sizeof(audio_svc_str_block_s) + size);
+
+	if (block == NULL)
+		return NULL;
+
+	block->next = NULL;
+	block->data = (char *)(block + 1);
+	block->size = size;
+	block->used = 0;
+
+	return block;
+}
+
+/* Appends a copy of str to the heap. NULL or empty string is not stored and gets an empty string.
+ * When the current block is full, next block is used, or a new block twice as big is chained after it.
+ * Blocks are not moved, so strings stored before stay valid until the heap is reset or freed */
+int _audio_svc_str_heap_add(audio_svc_str_heap_s *heap, const char *str, const char **ptr)
+{
+	int len = 0;
+	int size = 0;
+	audio_svc_str_block_s *block = NULL;
+
+	*ptr = "";
+
+	if (!STRING_VALID(str))
+		return AUDIO_SVC_ERROR_NONE;
+
+	len = strlen(str) + 1;
+
+	if (heap->cur == NULL || heap->cur->size - heap->cur->used < len) {
+		if (heap->cur != NULL && heap->cur->next != NULL && heap->cur->next->size >= len) {
+			/* block kept by reset */
+			heap->cur = heap->cur->next;
+			heap->cur->used = 0;
+		} else {
+			size = (heap->cur != NULL) ? heap->cur->size * 2 : AUDIO_SVC_STR_HEAP_INIT_SIZE;
+			while (size < len)
+				size *= 2;
+
+			block = __audio_svc_str_block_new(size);
+			if (block == NULL) {
+				audio_svc_error("memory allocation failed");
+				return AUDIO_SVC_ERROR_OUT_OF_MEMORY;
+			}
+
+			if (heap->cur == NULL) {
+				heap->head = block;
+			} else {
+				block->next = heap->cur->next;
+				heap->cur->next = block;
+			}
+			heap->cur = block;
+		}
+	}
+
+	memcpy(heap->cur->data + heap->cur->used, str, len);
+	*ptr = heap->cur->data + heap->cur->used;
+	heap->cur->used += len;
+
+	return AUDIO_SVC_ERROR_NONE;
+}
+
+/* Blocks are kept for refill of the list */
+void _audio_svc_str_heap_reset(audio_svc_str_heap_s *heap)
+{
+	heap->cur = heap->head;
+	if (heap->cur != NULL)
+		heap->cur->used = 0;
+}
+
+void _audio_svc_str_heap_free(audio_svc_str_heap_s *heap)
+{
+	audio_svc_str_block_s *block = heap->head;
+	audio_svc_str_block_s *next = NULL;
+
+	while (block != NULL) {
+		next = block->next;
+		free(block);
+		block = next;
+	}
+
+	heap->head = NULL;
+	heap->cur = NULL;
+}
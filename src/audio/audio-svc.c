@@ -33,18 +33,12 @@
 #include "audio-svc-playlist-table.h"
 #include "audio-svc-types-priv.h"
 #include "audio-svc-db-utils.h"
+#include "media-svc-error.h"
+#include "media-svc-db-utils.h"
+#include "media-svc-media.h"
 
 #define AUDIO_SVC_DATABASE_NAME	"/opt/dbspace/.media.db"
 
-static __thread int g_audio_svc_item_valid_data_cnt = 1;
-static __thread int g_audio_svc_item_valid_cur_data_cnt = 0;
-
-static __thread int g_audio_svc_move_item_data_cnt = 1;
-static __thread int g_audio_svc_move_item_cur_data_cnt = 0;
-
-static __thread int g_audio_svc_insert_item_data_cnt = 1;
-static __thread int g_audio_svc_insert_item_cur_data_cnt = 0;
-
 int audio_svc_create_table(MediaSvcHandle *handle)
 {
 	int ret = AUDIO_SVC_ERROR_NONE;
@@ -64,6 +58,18 @@ int audio_svc_create_table(MediaSvcHandle *handle)
 	ret = _audio_svc_create_folder_table(db_handle);
 	audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
 
+	/* invalid item sweep journals thumbnails to be removed */
+	if (_media_svc_create_thumb_journal_table(db_handle) != MEDIA_INFO_ERROR_NONE) {
+		audio_svc_error("fail to create thumbnail journal table");
+		return AUDIO_SVC_ERROR_DB_INTERNAL;
+	}
+
+	/* changes of audio_media are logged with the ones of media_data */
+	if (_media_svc_create_legacy_change_log_table(db_handle, AUDIO_SVC_DB_TABLE_AUDIO_DATA) != MEDIA_INFO_ERROR_NONE) {
+		audio_svc_error("fail to create change log of %s", AUDIO_SVC_DB_TABLE_AUDIO_DATA);
+		return AUDIO_SVC_ERROR_DB_INTERNAL;
+	}
+
 	return AUDIO_SVC_ERROR_NONE;
 }
 
@@ -110,6 +116,8 @@ int audio_svc_delete_all(MediaSvcHandle *handle, audio_svc_storage_type_e storag
 
 int audio_svc_insert_item_start(MediaSvcHandle *handle, int data_cnt)
 {
+	media_svc_batch_s *batch = NULL;
+
 	audio_svc_debug("Transaction data count : [%d]", data_cnt);	
 
 	if(handle == NULL) {
@@ -122,8 +130,11 @@ int audio_svc_insert_item_start(MediaSvcHandle *handle, int data_cnt)
 		return AUDIO_SVC_ERROR_INVALID_PARAMETER;
 	}
 	
-	g_audio_svc_insert_item_data_cnt  = data_cnt;
-	g_audio_svc_insert_item_cur_data_cnt  = 0;
+	batch = _audio_svc_get_batch((sqlite3 *)handle, AUDIO_SVC_QUERY_INSERT_ITEM);
+	audio_svc_retv_if(batch == NULL, AUDIO_SVC_ERROR_INVALID_PARAMETER);
+
+	batch->data_cnt = data_cnt;
+	batch->cur_data_cnt = 0;
 
 	return AUDIO_SVC_ERROR_NONE;
 }
@@ -134,23 +145,66 @@ int audio_svc_insert_item_end(MediaSvcHandle *handle)
 
 	int ret = AUDIO_SVC_ERROR_NONE;
 	sqlite3 * db_handle = (sqlite3 *)handle;
+	media_svc_batch_s *batch = NULL;
 
 	if(db_handle == NULL) {
 		audio_svc_error("Handle is NULL");
 		return AUDIO_SVC_ERROR_INVALID_PARAMETER;
 	}
 
-	if (g_audio_svc_insert_item_cur_data_cnt  > 0) {
+	batch = _audio_svc_get_batch(db_handle, AUDIO_SVC_QUERY_INSERT_ITEM);
+	audio_svc_retv_if(batch == NULL, AUDIO_SVC_ERROR_INVALID_PARAMETER);
+
+	if (batch->cur_data_cnt > 0) {
 		
 		ret = _audio_svc_list_query_do(db_handle, AUDIO_SVC_QUERY_INSERT_ITEM);
 	}
 
-	g_audio_svc_insert_item_data_cnt  = 1;
-	g_audio_svc_insert_item_cur_data_cnt  = 0;
+	batch->data_cnt = 1;
+	batch->cur_data_cnt = 0;
 
 	return ret;
 }
 
+static int __audio_svc_insert_item_batch(sqlite3 *db_handle, audio_svc_audio_item_s *item)
+{
+	media_svc_batch_s *batch = NULL;
+	int ret = AUDIO_SVC_ERROR_NONE;
+
+	batch = _audio_svc_get_batch(db_handle, AUDIO_SVC_QUERY_INSERT_ITEM);
+	audio_svc_retv_if(batch == NULL, AUDIO_SVC_ERROR_INVALID_PARAMETER);
+
+	if (batch->data_cnt == 1) {
+
+		return _audio_svc_insert_item_with_data(db_handle, item, FALSE);
+
+	}
+	else if(batch->cur_data_cnt < (batch->data_cnt - 1)) {
+
+		ret = _audio_svc_insert_item_with_data(db_handle, item, TRUE);
+		audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
+		batch->cur_data_cnt++;
+
+	}
+	else if (batch->cur_data_cnt == (batch->data_cnt - 1)) {
+
+		ret = _audio_svc_insert_item_with_data(db_handle, item, TRUE);
+		audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
+
+		ret = _audio_svc_list_query_do(db_handle, AUDIO_SVC_QUERY_INSERT_ITEM);
+		audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
+		
+		batch->cur_data_cnt = 0;
+		
+	}
+	else {
+		audio_svc_debug("Error in audio_svc_insert_item");
+		return AUDIO_SVC_ERROR_INTERNAL;
+ 	}
+
+	return AUDIO_SVC_ERROR_NONE;
+}
+
 int audio_svc_insert_item(MediaSvcHandle *handle, audio_svc_storage_type_e storage_type,
 			  const char *path, audio_svc_category_type_e category)
 {
@@ -182,43 +236,79 @@ int audio_svc_insert_item(MediaSvcHandle *handle, audio_svc_storage_type_e stora
 	}
 
 	audio_svc_audio_item_s item;
+	media_svc_probe_s probe;
 	memset(&item, 0, sizeof(audio_svc_audio_item_s));
+	_media_svc_probe_init(&probe, path);
 
 	item.category = category;
 	item.time_added = time(NULL);
 
-	ret = _audio_svc_extract_metadata_audio(storage_type, path, &item);
+	ret = _audio_svc_extract_metadata_audio(storage_type, path, &probe, &item);
 	audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
 
-	if (g_audio_svc_insert_item_data_cnt == 1) {
+	return __audio_svc_insert_item_batch(db_handle, &item);
+}
 
-		return _audio_svc_insert_item_with_data(db_handle, &item, FALSE);
+int audio_svc_insert_item_with_media(MediaSvcHandle *handle, audio_svc_storage_type_e storage_type,
+			  const char *path, audio_svc_category_type_e category, const char *mime_type)
+{
+	int ret = AUDIO_SVC_ERROR_NONE;
+	sqlite3 * db_handle = (sqlite3 *)handle;
+	media_svc_content_info_s content_info;
+	media_svc_probe_s probe;
+	audio_svc_audio_item_s item;
 
+	if(db_handle == NULL) {
+		audio_svc_error("Handle is NULL");
+		return AUDIO_SVC_ERROR_INVALID_PARAMETER;
 	}
-	else if(g_audio_svc_insert_item_cur_data_cnt  < (g_audio_svc_insert_item_data_cnt  - 1)) {
-
-		ret = _audio_svc_insert_item_with_data(db_handle, &item, TRUE);
-		audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
-		g_audio_svc_insert_item_cur_data_cnt ++;
 
+	if (storage_type != AUDIO_SVC_STORAGE_PHONE
+	    && storage_type != AUDIO_SVC_STORAGE_MMC) {
+		audio_svc_error("storage type is incorrect(%d)", storage_type);
+		return AUDIO_SVC_ERROR_INVALID_PARAMETER;
 	}
-	else if (g_audio_svc_insert_item_cur_data_cnt  == (g_audio_svc_insert_item_data_cnt  - 1)) {
 
-		ret = _audio_svc_insert_item_with_data(db_handle, &item, TRUE);
-		audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
+	if (!STRING_VALID(path) || !STRING_VALID(mime_type)) {
+		audio_svc_error("path or mime_type is NULL");
+		return AUDIO_SVC_ERROR_INVALID_PARAMETER;
+	}
 
-		ret = _audio_svc_list_query_do(db_handle, AUDIO_SVC_QUERY_INSERT_ITEM);
-		audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
-		
-		g_audio_svc_insert_item_cur_data_cnt = 0;
-		
+	if ((category != AUDIO_SVC_CATEGORY_MUSIC)
+	    && (category != AUDIO_SVC_CATEGORY_SOUND)) {
+		audio_svc_error("invalid category condition");
+		return AUDIO_SVC_ERROR_INVALID_PARAMETER;
 	}
-	else {
-		audio_svc_debug("Error in audio_svc_insert_item");
+
+	audio_svc_debug("storage[%d], path[%s], category[%d]", storage_type, path, category);
+
+	memset(&content_info, 0, sizeof(media_svc_content_info_s));
+	memset(&item, 0, sizeof(audio_svc_audio_item_s));
+	_media_svc_probe_init(&probe, path);
+
+	/* Parse the file once. Both audio_media and media table are filled from this result, and the probe keeps its stat and DRM info */
+	ret = _media_svc_make_content_info(db_handle, &probe,
+				(storage_type == AUDIO_SVC_STORAGE_MMC) ? MEDIA_SVC_STORAGE_EXTERNAL : MEDIA_SVC_STORAGE_INTERNAL,
+				path, mime_type,
+				(category == AUDIO_SVC_CATEGORY_SOUND) ? MEDIA_SVC_MEDIA_TYPE_SOUND : MEDIA_SVC_MEDIA_TYPE_MUSIC,
+				&content_info);
+	if (ret != MEDIA_INFO_ERROR_NONE) {
+		audio_svc_error("fail to extract metadata [%d]", ret);
 		return AUDIO_SVC_ERROR_INTERNAL;
- 	}
+	}
 
-	return AUDIO_SVC_ERROR_NONE;
+	ret = _audio_svc_extract_metadata_by_content_info(&content_info, &probe, &item);
+	if (ret == AUDIO_SVC_ERROR_NONE)
+		ret = __audio_svc_insert_item_batch(db_handle, &item);
+
+	if (ret == AUDIO_SVC_ERROR_NONE && _media_svc_insert_content_info_bulk(db_handle, &content_info) != MEDIA_INFO_ERROR_NONE) {
+		audio_svc_error("fail to insert item into media table");
+		ret = AUDIO_SVC_ERROR_DB_INTERNAL;
+	}
+
+	_media_svc_destroy_content_info(&content_info);
+
+	return ret;
 }
 
 int audio_svc_insert_item_immediately(MediaSvcHandle *handle, audio_svc_storage_type_e storage_type,
@@ -252,12 +342,14 @@ int audio_svc_insert_item_immediately(MediaSvcHandle *handle, audio_svc_storage_
 	}
 
 	audio_svc_audio_item_s item;
+	media_svc_probe_s probe;
 	memset(&item, 0, sizeof(audio_svc_audio_item_s));
+	_media_svc_probe_init(&probe, path);
 
 	item.category = category;
 	item.time_added = time(NULL);
 
-	ret = _audio_svc_extract_metadata_audio(storage_type, path, &item);
+	ret = _audio_svc_extract_metadata_audio(storage_type, path, &probe, &item);
 	audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
 
 	return _audio_svc_insert_item_with_data(db_handle, &item, FALSE);
@@ -364,6 +456,8 @@ int audio_svc_delete_item_by_path(MediaSvcHandle *handle, const char *path)
 
 int audio_svc_move_item_start(MediaSvcHandle *handle, int data_cnt)
 {
+	media_svc_batch_s *batch = NULL;
+
 	audio_svc_debug("Transaction data count : [%d]", data_cnt);
 
 	if(handle == NULL) {
@@ -376,8 +470,11 @@ int audio_svc_move_item_start(MediaSvcHandle *handle, int data_cnt)
 		return AUDIO_SVC_ERROR_INVALID_PARAMETER;
 	}
 	
-	g_audio_svc_move_item_data_cnt  = data_cnt;
-	g_audio_svc_move_item_cur_data_cnt  = 0;
+	batch = _audio_svc_get_batch((sqlite3 *)handle, AUDIO_SVC_QUERY_MOVE_ITEM);
+	audio_svc_retv_if(batch == NULL, AUDIO_SVC_ERROR_INVALID_PARAMETER);
+
+	batch->data_cnt = data_cnt;
+	batch->cur_data_cnt = 0;
 
 	return AUDIO_SVC_ERROR_NONE;
 }
@@ -386,25 +483,29 @@ int audio_svc_move_item_end(MediaSvcHandle *handle)
 {
 	int ret = AUDIO_SVC_ERROR_NONE;
 	sqlite3 * db_handle = (sqlite3 *)handle;
+	media_svc_batch_s *batch = NULL;
 
 	if(db_handle == NULL) {
 		audio_svc_error("Handle is NULL");
 		return AUDIO_SVC_ERROR_INVALID_PARAMETER;
 	}
 
+	batch = _audio_svc_get_batch(db_handle, AUDIO_SVC_QUERY_MOVE_ITEM);
+	audio_svc_retv_if(batch == NULL, AUDIO_SVC_ERROR_INVALID_PARAMETER);
+
 	audio_svc_debug_func();
 
-	if (g_audio_svc_move_item_cur_data_cnt  > 0) {
+	if (batch->cur_data_cnt > 0) {
 
-		g_audio_svc_move_item_data_cnt  = 1;
-		g_audio_svc_move_item_cur_data_cnt  = 0;
+		batch->data_cnt = 1;
+		batch->cur_data_cnt = 0;
 
 		ret = _audio_svc_list_query_do(db_handle, AUDIO_SVC_QUERY_MOVE_ITEM);
 		audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
 	}
 
-	g_audio_svc_move_item_data_cnt  = 1;
-	g_audio_svc_move_item_cur_data_cnt  = 0;
+	batch->data_cnt = 1;
+	batch->cur_data_cnt = 0;
 
 	ret = _audio_svc_update_folder_table(db_handle);
 	audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
@@ -424,12 +525,16 @@ int audio_svc_move_item(MediaSvcHandle *handle, audio_svc_storage_type_e src_sto
 	int ret = AUDIO_SVC_ERROR_NONE;
 
 	sqlite3 * db_handle = (sqlite3 *)handle;
+	media_svc_batch_s *batch = NULL;
 
 	if(db_handle == NULL) {
 		audio_svc_error("Handle is NULL");
 		return AUDIO_SVC_ERROR_INVALID_PARAMETER;
 	}
 
+	batch = _audio_svc_get_batch(db_handle, AUDIO_SVC_QUERY_MOVE_ITEM);
+	audio_svc_retv_if(batch == NULL, AUDIO_SVC_ERROR_INVALID_PARAMETER);
+
 	if (!STRING_VALID(src_path)) {
 		audio_svc_error("src_path is null");
 		return AUDIO_SVC_ERROR_INVALID_PARAMETER;
@@ -452,10 +557,10 @@ int audio_svc_move_item(MediaSvcHandle *handle, audio_svc_storage_type_e src_sto
 		return AUDIO_SVC_ERROR_INVALID_PARAMETER;
 	}
 
-	audio_svc_debug("g_audio_svc_move_item_data_cnt =[%d], g_audio_svc_move_item_cur_data_cnt =[%d]", 
-				g_audio_svc_move_item_data_cnt , g_audio_svc_move_item_cur_data_cnt );
+	audio_svc_debug("data_cnt =[%d], cur_data_cnt =[%d]", 
+				batch->data_cnt, batch->cur_data_cnt );
 
-	if (g_audio_svc_move_item_data_cnt == 1) {
+	if (batch->data_cnt == 1) {
 		/* update path and storage type*/
 		ret = _audio_svc_update_path_and_storage_in_music_record(db_handle, src_path, dest_path, dest_storage);
 		audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
@@ -472,16 +577,16 @@ int audio_svc_move_item(MediaSvcHandle *handle, audio_svc_storage_type_e src_sto
 		ret = _audio_svc_check_and_update_folder_table(db_handle, src_path);
 		audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
 	}
-	else if (g_audio_svc_move_item_cur_data_cnt  < (g_audio_svc_move_item_data_cnt  - 1)) {
+	else if (batch->cur_data_cnt < (batch->data_cnt - 1)) {
 
 		ret = _audio_svc_get_and_append_folder_id_by_path(db_handle, dest_path, dest_storage, folder_id);
 		audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
 		
 		ret = _audio_svc_move_item_query_add(db_handle, src_path, dest_path, dest_storage, folder_id);
 
-		g_audio_svc_move_item_cur_data_cnt ++;
+		batch->cur_data_cnt++;
 	}
-	else if (g_audio_svc_move_item_cur_data_cnt  == (g_audio_svc_move_item_data_cnt  - 1)) {
+	else if (batch->cur_data_cnt == (batch->data_cnt - 1)) {
 
 		ret = _audio_svc_get_and_append_folder_id_by_path(db_handle, dest_path, dest_storage, folder_id);
 		audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
@@ -491,7 +596,7 @@ int audio_svc_move_item(MediaSvcHandle *handle, audio_svc_storage_type_e src_sto
 		ret = _audio_svc_list_query_do(db_handle, AUDIO_SVC_QUERY_MOVE_ITEM);
 		audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
 
-		g_audio_svc_move_item_cur_data_cnt = 0;
+		batch->cur_data_cnt = 0;
 	}
 	else {
 		audio_svc_debug("Error in audio_svc_move_item");
@@ -517,6 +622,7 @@ int audio_svc_refresh_metadata(MediaSvcHandle *handle, const char *audio_id)
 	}
 	
 	audio_svc_audio_item_s item;
+	media_svc_probe_s probe;
 	memset(&item, 0, sizeof(audio_svc_audio_item_s));
 
 	ret = _audio_svc_select_music_record_by_audio_id(db_handle, audio_id, &item);
@@ -527,7 +633,8 @@ int audio_svc_refresh_metadata(MediaSvcHandle *handle, const char *audio_id)
 		return AUDIO_SVC_ERROR_NONE;
 	}
 
-	ret = _audio_svc_extract_metadata_audio(item.storage_type, item.pathname, &item);
+	_media_svc_probe_init(&probe, item.pathname);
+	ret = _audio_svc_extract_metadata_audio(item.storage_type, item.pathname, &probe, &item);
 	audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
 
 	return _audio_svc_update_metadata_in_music_record(db_handle, audio_id, &item);
@@ -540,6 +647,8 @@ int audio_svc_count_group_item(MediaSvcHandle *handle, audio_svc_group_type_e gr
 			       const char *filter_string2, int *count)
 {
 	sqlite3 * db_handle = (sqlite3 *)handle;
+	char *cache_key = NULL;
+	int ret = AUDIO_SVC_ERROR_NONE;
 
 	if(db_handle == NULL) {
 		audio_svc_error("Handle is NULL");
@@ -573,10 +682,23 @@ int audio_svc_count_group_item(MediaSvcHandle *handle, audio_svc_group_type_e gr
 		return AUDIO_SVC_ERROR_INVALID_PARAMETER;
 	}
 
-	return _audio_svc_count_music_group_records(db_handle, group_type, limit_string1,
+	cache_key = sqlite3_mprintf("group_cnt %d %Q %Q %Q %Q", group_type,
+				limit_string1, limit_string2, filter_string, filter_string2);
+	if (_media_svc_db_ctx_get_count(db_handle, cache_key, count)) {
+		sqlite3_free(cache_key);
+		return AUDIO_SVC_ERROR_NONE;
+	}
+
+	ret = _audio_svc_count_music_group_records(db_handle, group_type, limit_string1,
 						    limit_string2,
 						    filter_string,
 						    filter_string2, count);
+	if (ret == AUDIO_SVC_ERROR_NONE)
+		_media_svc_db_ctx_set_count(db_handle, cache_key, *count);
+
+	sqlite3_free(cache_key);
+
+	return ret;
 }
 
 int audio_svc_get_group_item(MediaSvcHandle *handle, audio_svc_group_type_e group_type,
@@ -644,6 +766,8 @@ int audio_svc_count_list_item(MediaSvcHandle *handle, audio_svc_track_type_e ite
 			      const char *filter_string2, int *count)
 {
 	sqlite3 * db_handle = (sqlite3 *)handle;
+	char *cache_key = NULL;
+	int ret = AUDIO_SVC_ERROR_NONE;
 
 	if(db_handle == NULL) {
 		audio_svc_error("Handle is NULL");
@@ -674,9 +798,27 @@ int audio_svc_count_list_item(MediaSvcHandle *handle, audio_svc_track_type_e ite
 		return AUDIO_SVC_ERROR_INVALID_PARAMETER;
 	}
 
-	return _audio_svc_count_music_track_records(db_handle, item_type, type_string,
+	/* type_string of playlist is playlist id, not a string */
+	if (item_type == AUDIO_SVC_TRACK_BY_PLAYLIST)
+		cache_key = sqlite3_mprintf("list_cnt %d %d %Q %Q", item_type,
+					(int)type_string, filter_string, filter_string2);
+	else
+		cache_key = sqlite3_mprintf("list_cnt %d %Q %Q %Q %Q", item_type,
+					type_string, type_string2, filter_string, filter_string2);
+	if (_media_svc_db_ctx_get_count(db_handle, cache_key, count)) {
+		sqlite3_free(cache_key);
+		return AUDIO_SVC_ERROR_NONE;
+	}
+
+	ret = _audio_svc_count_music_track_records(db_handle, item_type, type_string,
 						    type_string2, filter_string,
 						    filter_string2, count);
+	if (ret == AUDIO_SVC_ERROR_NONE)
+		_media_svc_db_ctx_set_count(db_handle, cache_key, *count);
+
+	sqlite3_free(cache_key);
+
+	return ret;
 }
 
 int audio_svc_get_list_item(MediaSvcHandle *handle, audio_svc_track_type_e item_type,
@@ -686,6 +828,8 @@ int audio_svc_get_list_item(MediaSvcHandle *handle, audio_svc_track_type_e item_
 			    AudioHandleType *track)
 {
 	audio_svc_list_item_s *result_track = (audio_svc_list_item_s *) track;
+	audio_svc_str_heap_s *heap = NULL;
+	int i = 0;
 	sqlite3 * db_handle = (sqlite3 *)handle;
 
 	if(db_handle == NULL) {
@@ -724,7 +868,11 @@ int audio_svc_get_list_item(MediaSvcHandle *handle, audio_svc_track_type_e item_
 		return AUDIO_SVC_ERROR_INVALID_PARAMETER;
 	}
 
+	heap = result_track[0].heap;
+	_audio_svc_str_heap_reset(heap);
 	memset(result_track, 0, sizeof(audio_svc_list_item_s) * rows);
+	for (i = 0; i < rows; i++)
+		result_track[i].heap = heap;
 
 	return _audio_svc_get_music_track_records(db_handle, item_type, type_string,
 						  type_string2, filter_string,
@@ -920,6 +1068,8 @@ int audio_svc_get_playlist_item(MediaSvcHandle *handle, int playlist_id, const c
 	}
 
 	audio_svc_playlist_item_s *ret_playlist_item = (audio_svc_playlist_item_s *) playlist_item;
+	audio_svc_str_heap_s *heap = NULL;
+	int i = 0;
 
 	if (offset < 0 || rows <= 0) {
 		audio_svc_error("offset(%d) or row value(%d) is wrong", offset,
@@ -933,7 +1083,11 @@ int audio_svc_get_playlist_item(MediaSvcHandle *handle, int playlist_id, const c
 		return AUDIO_SVC_ERROR_INVALID_PARAMETER;
 	}
 
+	heap = ret_playlist_item[0].heap;
+	_audio_svc_str_heap_reset(heap);
 	memset(ret_playlist_item, 0, sizeof(audio_svc_playlist_item_s) * rows);
+	for (i = 0; i < rows; i++)
+		ret_playlist_item[i].heap = heap;
 
 	return _audio_svc_get_playlist_item_records(db_handle, playlist_id, filter_string,
 						    filter_string2, offset,
@@ -1259,6 +1413,8 @@ int audio_svc_delete_invalid_items(MediaSvcHandle *handle, audio_svc_storage_typ
 
 int audio_svc_set_item_valid_start(MediaSvcHandle *handle, int data_cnt)
 {
+	media_svc_batch_s *batch = NULL;
+
 	audio_svc_debug("Transaction data count : [%d]", data_cnt);
 
 	if(handle == NULL) {
@@ -1271,8 +1427,11 @@ int audio_svc_set_item_valid_start(MediaSvcHandle *handle, int data_cnt)
 		return AUDIO_SVC_ERROR_INVALID_PARAMETER;
 	}
 	
-	g_audio_svc_item_valid_data_cnt  = data_cnt;
-	g_audio_svc_item_valid_cur_data_cnt  = 0;
+	batch = _audio_svc_get_batch((sqlite3 *)handle, AUDIO_SVC_QUERY_SET_ITEM_VALID);
+	audio_svc_retv_if(batch == NULL, AUDIO_SVC_ERROR_INVALID_PARAMETER);
+
+	batch->data_cnt = data_cnt;
+	batch->cur_data_cnt = 0;
 
 	return AUDIO_SVC_ERROR_NONE;
 }
@@ -1283,20 +1442,24 @@ int audio_svc_set_item_valid_end(MediaSvcHandle *handle)
 
 	int ret = AUDIO_SVC_ERROR_NONE;
 	sqlite3 * db_handle = (sqlite3 *)handle;
+	media_svc_batch_s *batch = NULL;
 
 	if(db_handle == NULL) {
 		audio_svc_error("Handle is NULL");
 		return AUDIO_SVC_ERROR_INVALID_PARAMETER;
 	}
 
-	if (g_audio_svc_item_valid_cur_data_cnt  > 0) {
+	batch = _audio_svc_get_batch(db_handle, AUDIO_SVC_QUERY_SET_ITEM_VALID);
+	audio_svc_retv_if(batch == NULL, AUDIO_SVC_ERROR_INVALID_PARAMETER);
+
+	if (batch->cur_data_cnt > 0) {
 		
 		ret = _audio_svc_list_query_do(db_handle, AUDIO_SVC_QUERY_SET_ITEM_VALID);
 
 	}
 
-	g_audio_svc_item_valid_data_cnt  = 1;
-	g_audio_svc_item_valid_cur_data_cnt  = 0;
+	batch->data_cnt = 1;
+	batch->cur_data_cnt = 0;
 
 	return ret;
 }
@@ -1305,12 +1468,16 @@ int audio_svc_set_item_valid(MediaSvcHandle *handle, const char *path, int valid
 {
 	int ret = AUDIO_SVC_ERROR_NONE;
 	sqlite3 * db_handle = (sqlite3 *)handle;
+	media_svc_batch_s *batch = NULL;
 
 	if(db_handle == NULL) {
 		audio_svc_error("Handle is NULL");
 		return AUDIO_SVC_ERROR_INVALID_PARAMETER;
 	}
 
+	batch = _audio_svc_get_batch(db_handle, AUDIO_SVC_QUERY_SET_ITEM_VALID);
+	audio_svc_retv_if(batch == NULL, AUDIO_SVC_ERROR_INVALID_PARAMETER);
+
 	audio_svc_debug("path=[%s], valid=[%d]", path, valid);
 
 	if (!STRING_VALID(path)) {
@@ -1321,29 +1488,29 @@ int audio_svc_set_item_valid(MediaSvcHandle *handle, const char *path, int valid
 #if 0	//original code
 	return _audio_svc_update_valid_in_music_record(path, valid);
 
-#else	//stack up querys and commit it at once when query counts are same as g_audio_svc_item_valid_data_cnt
+#else	//stack up querys and commit it at once when query counts are same as data_cnt of the batch
 
-	audio_svc_debug("g_audio_svc_item_valid_data_cnt =[%d], g_audio_svc_item_valid_cur_data_cnt =[%d]", 
-			g_audio_svc_item_valid_data_cnt , g_audio_svc_item_valid_cur_data_cnt );
+	audio_svc_debug("data_cnt =[%d], cur_data_cnt =[%d]", 
+			batch->data_cnt, batch->cur_data_cnt );
 
-	if (g_audio_svc_item_valid_data_cnt  == 1) {
+	if (batch->data_cnt == 1) {
 		
 		return _audio_svc_update_valid_in_music_record(db_handle, path, valid);
 		
-	} else if (g_audio_svc_item_valid_cur_data_cnt  < (g_audio_svc_item_valid_data_cnt  - 1)) {
+	} else if (batch->cur_data_cnt < (batch->data_cnt - 1)) {
 
 		ret = _audio_svc_update_valid_in_music_record_query_add(db_handle, path, valid);
 
-		g_audio_svc_item_valid_cur_data_cnt ++;	
+		batch->cur_data_cnt++;
 		
-	} else if (g_audio_svc_item_valid_cur_data_cnt  == (g_audio_svc_item_valid_data_cnt  - 1)) {
+	} else if (batch->cur_data_cnt == (batch->data_cnt - 1)) {
 	
 		ret = _audio_svc_update_valid_in_music_record_query_add(db_handle, path, valid);
 
 		ret = _audio_svc_list_query_do(db_handle, AUDIO_SVC_QUERY_SET_ITEM_VALID);
 		audio_svc_retv_if(ret != AUDIO_SVC_ERROR_NONE, ret);
 
-		g_audio_svc_item_valid_cur_data_cnt  = 0;
+		batch->cur_data_cnt = 0;
 		
  	} else {
  	
@@ -1531,19 +1698,27 @@ int audio_svc_group_item_get(AudioHandleType *record, int index, AudioHandleType
 
 int audio_svc_list_item_new(AudioHandleType **record, int count)
 {
+	audio_svc_str_heap_s *heap = NULL;
+	int i = 0;
+
 	if (count < 1) {
 		audio_svc_error("Invalid arguments");
 		return AUDIO_SVC_ERROR_INVALID_PARAMETER;
 	}
 
 	audio_svc_debug("count is [%d]", count);
+	/* records are followed by the heap of their strings, which grows while the list is filled */
 	audio_svc_list_item_s *list_item =
 	    (audio_svc_list_item_s *) malloc(count *
-					     sizeof(audio_svc_list_item_s));
+					     sizeof(audio_svc_list_item_s) + sizeof(audio_svc_str_heap_s));
 	if (list_item == NULL) {
 		return AUDIO_SVC_ERROR_OUT_OF_MEMORY;
 	}
-	memset(list_item, 0, count * sizeof(audio_svc_list_item_s));
+	memset(list_item, 0, count * sizeof(audio_svc_list_item_s) + sizeof(audio_svc_str_heap_s));
+
+	heap = (audio_svc_str_heap_s *)(list_item + count);
+	for (i = 0; i < count; i++)
+		list_item[i].heap = heap;
 
 	*record = (AudioHandleType *) list_item;
 
@@ -1559,6 +1734,7 @@ int audio_svc_list_item_free(AudioHandleType *record)
 		return AUDIO_SVC_ERROR_INVALID_PARAMETER;
 	}
 	audio_svc_debug_func();
+	_audio_svc_str_heap_free(item->heap);
 	SAFE_FREE(item);
 
 	return AUDIO_SVC_ERROR_NONE;
@@ -1611,13 +1787,13 @@ int audio_svc_list_item_get_val(AudioHandleType *record, int index,
 			{
 				char **val = va_arg((var_args), char **);
 				int *size = va_arg((var_args), int *);
-				if (strlen(item[index].pathname) == 0) {
+				if (strlen(AUDIO_SVC_LIST_STR(item[index], pathname)) == 0) {
 					audio_svc_debug("path is NULL");
 					*size = 0;
 					ret = AUDIO_SVC_ERROR_DB_NO_RECORD;
 				} else {
-					*val = item[index].pathname;
-					*size = strlen(item[index].pathname);
+					*val = AUDIO_SVC_LIST_STR(item[index], pathname);
+					*size = strlen(AUDIO_SVC_LIST_STR(item[index], pathname));
 				}
 
 				break;
@@ -1638,13 +1814,13 @@ int audio_svc_list_item_get_val(AudioHandleType *record, int index,
 			{
 				char **val = va_arg((var_args), char **);
 				int *size = va_arg((var_args), int *);
-				if (strlen(item[index].thumbnail_path) == 0) {
+				if (strlen(AUDIO_SVC_LIST_STR(item[index], thumbnail_path)) == 0) {
 					audio_svc_debug("thumb path is NULL");
 					*size = 0;
 				} else {
-					*val = item[index].thumbnail_path;
+					*val = AUDIO_SVC_LIST_STR(item[index], thumbnail_path);
 					*size =
-					    strlen(item[index].thumbnail_path);
+					    strlen(AUDIO_SVC_LIST_STR(item[index], thumbnail_path));
 				}
 
 				break;
@@ -1653,12 +1829,12 @@ int audio_svc_list_item_get_val(AudioHandleType *record, int index,
 			{
 				char **val = va_arg((var_args), char **);
 				int *size = va_arg((var_args), int *);
-				if (strlen(item[index].title) == 0) {
+				if (strlen(AUDIO_SVC_LIST_STR(item[index], title)) == 0) {
 					audio_svc_debug("title is NULL");
 					*size = 0;
 				} else {
-					*val = item[index].title;
-					*size = strlen(item[index].title);
+					*val = AUDIO_SVC_LIST_STR(item[index], title);
+					*size = strlen(AUDIO_SVC_LIST_STR(item[index], title));
 				}
 				break;
 			}
@@ -1666,12 +1842,12 @@ int audio_svc_list_item_get_val(AudioHandleType *record, int index,
 			{
 				char **val = va_arg((var_args), char **);
 				int *size = va_arg((var_args), int *);
-				if (strlen(item[index].artist) == 0) {
+				if (strlen(AUDIO_SVC_LIST_STR(item[index], artist)) == 0) {
 					audio_svc_debug("artist is NULL");
 					*size = 0;
 				} else {
-					*val = item[index].artist;
-					*size = strlen(item[index].artist);
+					*val = AUDIO_SVC_LIST_STR(item[index], artist);
+					*size = strlen(AUDIO_SVC_LIST_STR(item[index], artist));
 				}
 
 				break;
@@ -1680,12 +1856,12 @@ int audio_svc_list_item_get_val(AudioHandleType *record, int index,
 			{
 				char **val = va_arg((var_args), char **);
 				int *size = va_arg((var_args), int *);
-				if (strlen(item[index].album) == 0) {
+				if (strlen(AUDIO_SVC_LIST_STR(item[index], album)) == 0) {
 					audio_svc_debug("album is NULL");
 					*size = 0;
 				} else {
-					*val = item[index].album;
-					*size = strlen(item[index].album);
+					*val = AUDIO_SVC_LIST_STR(item[index], album);
+					*size = strlen(AUDIO_SVC_LIST_STR(item[index], album));
 				}
 
 				break;
@@ -1917,20 +2093,28 @@ int audio_svc_playlist_get_item(AudioHandleType *record, int index, AudioHandleT
 
 int audio_svc_playlist_item_new(AudioHandleType **record, int count)
 {
+	audio_svc_str_heap_s *heap = NULL;
+	int i = 0;
+
 	if (count < 1) {
 		audio_svc_error("Invalid arguments");
 		return AUDIO_SVC_ERROR_INVALID_PARAMETER;
 	}
 	audio_svc_debug("");
 
+	/* records are followed by the heap of their strings, which grows while the list is filled */
 	audio_svc_playlist_item_s *plst_item =
 	    (audio_svc_playlist_item_s *) malloc(count *
 						 sizeof
-						 (audio_svc_playlist_item_s));
+						 (audio_svc_playlist_item_s) + sizeof(audio_svc_str_heap_s));
 	if (plst_item == NULL) {
 		return AUDIO_SVC_ERROR_OUT_OF_MEMORY;
 	}
-	memset(plst_item, 0, count * sizeof(audio_svc_playlist_item_s));
+	memset(plst_item, 0, count * sizeof(audio_svc_playlist_item_s) + sizeof(audio_svc_str_heap_s));
+
+	heap = (audio_svc_str_heap_s *)(plst_item + count);
+	for (i = 0; i < count; i++)
+		plst_item[i].heap = heap;
 
 	*record = (AudioHandleType *) plst_item;
 
@@ -1946,6 +2130,7 @@ int audio_svc_playlist_item_free(AudioHandleType *record)
 		return AUDIO_SVC_ERROR_INVALID_PARAMETER;
 	}
 	audio_svc_debug_func();
+	_audio_svc_str_heap_free(item->heap);
 	SAFE_FREE(item);
 
 	return AUDIO_SVC_ERROR_NONE;
@@ -2005,13 +2190,13 @@ int audio_svc_playlist_item_get_val(AudioHandleType *record, int index,
 			{
 				char **val = va_arg((var_args), char **);
 				int *size = va_arg((var_args), int *);
-				if (strlen(item[index].pathname) == 0) {
+				if (strlen(AUDIO_SVC_LIST_STR(item[index], pathname)) == 0) {
 					audio_svc_debug("path is NULL");
 					*size = 0;
 					ret = AUDIO_SVC_ERROR_DB_NO_RECORD;
 				} else {
-					*val = item[index].pathname;
-					*size = strlen(item[index].pathname);
+					*val = AUDIO_SVC_LIST_STR(item[index], pathname);
+					*size = strlen(AUDIO_SVC_LIST_STR(item[index], pathname));
 				}
 
 				break;
@@ -2032,13 +2217,13 @@ int audio_svc_playlist_item_get_val(AudioHandleType *record, int index,
 			{
 				char **val = va_arg((var_args), char **);
 				int *size = va_arg((var_args), int *);
-				if (strlen(item[index].thumbnail_path) == 0) {
+				if (strlen(AUDIO_SVC_LIST_STR(item[index], thumbnail_path)) == 0) {
 					audio_svc_debug("thumb path is NULL");
 					*size = 0;
 				} else {
-					*val = item[index].thumbnail_path;
+					*val = AUDIO_SVC_LIST_STR(item[index], thumbnail_path);
 					*size =
-					    strlen(item[index].thumbnail_path);
+					    strlen(AUDIO_SVC_LIST_STR(item[index], thumbnail_path));
 				}
 
 				break;
@@ -2047,12 +2232,12 @@ int audio_svc_playlist_item_get_val(AudioHandleType *record, int index,
 			{
 				char **val = va_arg((var_args), char **);
 				int *size = va_arg((var_args), int *);
-				if (strlen(item[index].title) == 0) {
+				if (strlen(AUDIO_SVC_LIST_STR(item[index], title)) == 0) {
 					audio_svc_debug("title is NULL");
 					*size = 0;
 				} else {
-					*val = item[index].title;
-					*size = strlen(item[index].title);
+					*val = AUDIO_SVC_LIST_STR(item[index], title);
+					*size = strlen(AUDIO_SVC_LIST_STR(item[index], title));
 				}
 				break;
 			}
@@ -2061,12 +2246,12 @@ int audio_svc_playlist_item_get_val(AudioHandleType *record, int index,
 			{
 				char **val = va_arg((var_args), char **);
 				int *size = va_arg((var_args), int *);
-				if (strlen(item[index].artist) == 0) {
+				if (strlen(AUDIO_SVC_LIST_STR(item[index], artist)) == 0) {
 					audio_svc_debug("artist is NULL");
 					*size = 0;
 				} else {
-					*val = item[index].artist;
-					*size = strlen(item[index].artist);
+					*val = AUDIO_SVC_LIST_STR(item[index], artist);
+					*size = strlen(AUDIO_SVC_LIST_STR(item[index], artist));
 				}
 
 				break;
@@ -2699,15 +2884,32 @@ int audio_svc_check_item_exist(MediaSvcHandle *handle, const char *path)
 
 }
 
-int audio_svc_list_by_search(MediaSvcHandle *handle, AudioHandleType *record,
+int audio_svc_check_items_exist(MediaSvcHandle *handle, const char **path_list, int count, int *exist_list)
+{
+	sqlite3 * db_handle = (sqlite3 *)handle;
+
+	if(db_handle == NULL) {
+		audio_svc_error("Handle is NULL");
+		return AUDIO_SVC_ERROR_INVALID_PARAMETER;
+	}
+
+	if (path_list == NULL || exist_list == NULL || count <= 0) {
+		audio_svc_error("invalid parameter");
+		return AUDIO_SVC_ERROR_INVALID_PARAMETER;
+	}
+
+	return _audio_svc_check_records_with_path(db_handle, path_list, count, exist_list);
+}
+
+static int __audio_svc_list_by_search(MediaSvcHandle *handle, AudioHandleType *record,
+							unsigned int field_mask,
 							audio_svc_search_order_e order_field,
 							int offset,
 							int count,
 							audio_svc_serch_field_e first_field_name,
-							...)
+							va_list var_args)
 {
 	int ret = AUDIO_SVC_ERROR_NONE;
-	va_list var_args;
 	int field_name = -1;
 	int len = 0;
 	char query_where[AUDIO_SVC_QUERY_SIZE] = { 0 };
@@ -2739,6 +2941,11 @@ int audio_svc_list_by_search(MediaSvcHandle *handle, AudioHandleType *record,
 		return AUDIO_SVC_ERROR_INVALID_PARAMETER;
 	}
 
+	if (field_mask == 0) {
+		audio_svc_error("Invalid arguments");
+		return AUDIO_SVC_ERROR_INVALID_PARAMETER;
+	}
+
 	if (first_field_name < AUDIO_SVC_SEARCH_TITLE || 
 			first_field_name > AUDIO_SVC_SEARCH_AUTHOR) {
 		audio_svc_error("Invalid arguments");
@@ -2749,7 +2956,6 @@ int audio_svc_list_by_search(MediaSvcHandle *handle, AudioHandleType *record,
 	snprintf(query_where, sizeof(query_where), "valid=1 and ( 0 ");
 
 	field_name = first_field_name;
-	va_start(var_args, first_field_name);
 
 	while (field_name >= 0) {
 		audio_svc_debug("field name = %d", field_name);
@@ -2939,20 +3145,53 @@ int audio_svc_list_by_search(MediaSvcHandle *handle, AudioHandleType *record,
 
 		if (ret != AUDIO_SVC_ERROR_NONE) {
 			audio_svc_error("invalid parameter");
-			va_end(var_args);
 			return ret;
 		}
 		/* next field */
 		field_name = va_arg(var_args, int);
 	}
 
-	va_end(var_args);
 	len = g_strlcat(query_where, ") ", sizeof(query_where));
 	if (len >= sizeof(query_where)) {
 		audio_svc_error("strlcat returns failure ( %d )", len);
 		return AUDIO_SVC_ERROR_INTERNAL;
 	}
 
-	return _audio_svc_list_search(db_handle, item, query_where, order_field, offset, count);
+	return _audio_svc_list_search(db_handle, item, field_mask, query_where, order_field, offset, count);
+}
+
+int audio_svc_list_by_search(MediaSvcHandle *handle, AudioHandleType *record,
+							audio_svc_search_order_e order_field,
+							int offset,
+							int count,
+							audio_svc_serch_field_e first_field_name,
+							...)
+{
+	int ret = AUDIO_SVC_ERROR_NONE;
+	va_list var_args;
+
+	va_start(var_args, first_field_name);
+	ret = __audio_svc_list_by_search(handle, record, AUDIO_SVC_TRACK_FIELD_ALL, order_field, offset, count, first_field_name, var_args);
+	va_end(var_args);
+
+	return ret;
+}
+
+int audio_svc_list_by_search_with_fields(MediaSvcHandle *handle, AudioHandleType *record,
+							unsigned int field_mask,
+							audio_svc_search_order_e order_field,
+							int offset,
+							int count,
+							audio_svc_serch_field_e first_field_name,
+							...)
+{
+	int ret = AUDIO_SVC_ERROR_NONE;
+	va_list var_args;
+
+	va_start(var_args, first_field_name);
+	ret = __audio_svc_list_by_search(handle, record, field_mask, order_field, offset, count, first_field_name, var_args);
+	va_end(var_args);
+
+	return ret;
 }
 
@@ -0,0 +1,402 @@
+/*
+ * libmedia-service
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Hyunjun Ko <zzoon.ko@samsung.com>, Haejeong Kim <backto.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <pthread.h>
+#include <glib.h>
+#include "media-svc-db-ctx.h"
+#include "media-svc-debug.h"
+#include "media-svc-util.h"
+
+static void __media_svc_db_ctx_free_query_list(GList **query_list)
+{
+	GList *iter = NULL;
+
+	for (iter = *query_list; iter != NULL; iter = g_list_next(iter))
+		sqlite3_free(iter->data);
+
+	g_list_free(*query_list);
+	*query_list = NULL;
+}
+
+static pthread_mutex_t g_db_ctx_mutex = PTHREAD_MUTEX_INITIALIZER;
+static GHashTable *g_db_ctx_table = NULL;
+
+typedef struct {
+	sqlite3_stmt *stmt;
+	bool in_use;
+	unsigned int last_used;		/* stmt_cache_tick when it is prepared or reused last */
+} media_svc_cached_stmt_s;
+
+static void __media_svc_db_ctx_free_cached_stmt(gpointer data)
+{
+	media_svc_cached_stmt_s *cached = (media_svc_cached_stmt_s *)data;
+
+	if (cached == NULL)
+		return;
+
+	sqlite3_finalize(cached->stmt);
+	free(cached);
+}
+
+static void __media_svc_db_ctx_rollback_cb(void *data)
+{
+	media_svc_db_ctx_s *ctx = (media_svc_db_ctx_s *)data;
+
+	ctx->rollback_serial++;
+}
+
+static media_svc_db_ctx_s *__media_svc_db_ctx_lookup(sqlite3 *db_handle)
+{
+	media_svc_db_ctx_s *ctx = NULL;
+
+	pthread_mutex_lock(&g_db_ctx_mutex);
+	if (g_db_ctx_table != NULL)
+		ctx = (media_svc_db_ctx_s *)g_hash_table_lookup(g_db_ctx_table, db_handle);
+	pthread_mutex_unlock(&g_db_ctx_mutex);
+
+	return ctx;
+}
+
+media_svc_db_ctx_s *_media_svc_db_ctx_create(sqlite3 *db_handle)
+{
+	media_svc_db_ctx_s *ctx = NULL;
+	int i = 0;
+	int j = 0;
+
+	media_svc_retvm_if(db_handle == NULL, NULL, "db_handle is NULL");
+
+	ctx = (media_svc_db_ctx_s *)calloc(1, sizeof(media_svc_db_ctx_s));
+	media_svc_retvm_if(ctx == NULL, NULL, "fail to memory allocation");
+
+	ctx->busy_strategy = MEDIA_SVC_BUSY_STRATEGY_BACKOFF;
+	ctx->max_lock_hold_usec = MEDIA_SVC_BATCH_LOCK_HOLD_MSEC * 1000;
+	ctx->query_usec = MEDIA_SVC_BATCH_QUERY_USEC;
+	ctx->commit_usec = MEDIA_SVC_BATCH_COMMIT_USEC;
+	pthread_mutex_init(&ctx->stats_mutex, NULL);
+
+	for (i = 0; i < MEDIA_SVC_BATCH_OWNER_MAX; i++)
+		for (j = 0; j < MEDIA_SVC_BATCH_QUERY_MAX; j++)
+			ctx->batch[i][j].data_cnt = 1;
+
+	pthread_mutex_lock(&g_db_ctx_mutex);
+	if (g_db_ctx_table == NULL)
+		g_db_ctx_table = g_hash_table_new(g_direct_hash, g_direct_equal);
+
+	g_hash_table_insert(g_db_ctx_table, db_handle, ctx);
+	pthread_mutex_unlock(&g_db_ctx_mutex);
+
+	sqlite3_rollback_hook(db_handle, __media_svc_db_ctx_rollback_cb, ctx);
+
+	return ctx;
+}
+
+media_svc_db_ctx_s *_media_svc_db_ctx_get(sqlite3 *db_handle)
+{
+	media_svc_db_ctx_s *ctx = __media_svc_db_ctx_lookup(db_handle);
+
+	if (ctx == NULL)
+		media_svc_error("handle [%p] is not connected by media_svc_connect", db_handle);
+
+	return ctx;
+}
+
+void _media_svc_db_ctx_destroy(sqlite3 *db_handle)
+{
+	media_svc_db_ctx_s *ctx = NULL;
+	int i = 0;
+	int j = 0;
+
+	pthread_mutex_lock(&g_db_ctx_mutex);
+	if (g_db_ctx_table != NULL) {
+		ctx = (media_svc_db_ctx_s *)g_hash_table_lookup(g_db_ctx_table, db_handle);
+		g_hash_table_remove(g_db_ctx_table, db_handle);
+	}
+	pthread_mutex_unlock(&g_db_ctx_mutex);
+
+	if (ctx == NULL)
+		return;
+
+	/* Closing the connection rolls back an open transaction, after ctx is freed */
+	sqlite3_rollback_hook(db_handle, NULL, NULL);
+
+	/* Queries stacked without *_end are dropped with the connection */
+	for (i = 0; i < MEDIA_SVC_BATCH_OWNER_MAX; i++) {
+		for (j = 0; j < MEDIA_SVC_BATCH_QUERY_MAX; j++) {
+			if (ctx->batch[i][j].query_list != NULL) {
+				media_svc_error("drop [%d] stacked queries of owner [%d] type [%d]",
+						g_list_length(ctx->batch[i][j].query_list), i, j);
+				__media_svc_db_ctx_free_query_list(&ctx->batch[i][j].query_list);
+			}
+		}
+	}
+
+	_media_svc_arena_destroy(&ctx->content_arena);
+
+	if (ctx->count_cache != NULL)
+		g_hash_table_destroy(ctx->count_cache);
+
+	if (ctx->stmt_cache != NULL)
+		g_hash_table_destroy(ctx->stmt_cache);
+
+	pthread_mutex_destroy(&ctx->stats_mutex);
+
+	free(ctx);
+}
+
+media_svc_batch_s *_media_svc_db_ctx_get_batch(sqlite3 *db_handle, media_svc_batch_owner_e owner, media_svc_query_type_e query_type)
+{
+	media_svc_db_ctx_s *ctx = NULL;
+
+	media_svc_retvm_if(owner < 0 || owner >= MEDIA_SVC_BATCH_OWNER_MAX, NULL, "invalid owner [%d]", owner);
+	media_svc_retvm_if(query_type < 0 || query_type >= MEDIA_SVC_BATCH_QUERY_MAX, NULL, "invalid query type [%d]", query_type);
+
+	ctx = _media_svc_db_ctx_get(db_handle);
+	if (ctx == NULL)
+		return NULL;
+
+	/* A handle is used by one thread at a time, so batch state is not locked */
+	return &ctx->batch[owner][query_type];
+}
+
+void _media_svc_db_ctx_reset_batch(media_svc_batch_s *batch)
+{
+	if (batch == NULL)
+		return;
+
+	batch->data_cnt = 1;
+	batch->cur_data_cnt = 0;
+	batch->adaptive = FALSE;
+}
+
+/* A content info is made and destroyed in one API call, so one arena of a handle is reused by all of them */
+media_svc_arena_s *_media_svc_db_ctx_get_arena(sqlite3 *db_handle)
+{
+	media_svc_db_ctx_s *ctx = _media_svc_db_ctx_get(db_handle);
+
+	if (ctx == NULL)
+		return NULL;
+
+	return &ctx->content_arena;
+}
+
+/* Finalizes the least recently used statement which is not stepped now, to make room for a new one.
+ * Returns FALSE when all cached statements are in use */
+static bool __media_svc_db_ctx_evict_stmt(media_svc_db_ctx_s *ctx)
+{
+	GHashTableIter iter;
+	gpointer key = NULL;
+	gpointer value = NULL;
+	gpointer lru_key = NULL;
+	media_svc_cached_stmt_s *cached = NULL;
+	unsigned int lru_age = 0;
+
+	g_hash_table_iter_init(&iter, ctx->stmt_cache);
+	while (g_hash_table_iter_next(&iter, &key, &value)) {
+		cached = (media_svc_cached_stmt_s *)value;
+		if (cached->in_use)
+			continue;
+
+		/* tick wraps, so age is compared instead of tick */
+		if (lru_key == NULL || ctx->stmt_cache_tick - cached->last_used > lru_age) {
+			lru_key = key;
+			lru_age = ctx->stmt_cache_tick - cached->last_used;
+		}
+	}
+
+	if (lru_key == NULL)
+		return FALSE;
+
+	g_hash_table_remove(ctx->stmt_cache, lru_key);
+
+	return TRUE;
+}
+
+/* Statements are keyed by their sql, so the sql must not have literals inlined.
+ * A cached statement still stepped by an iterator is not shared; a fresh one is prepared instead. */
+int _media_svc_db_ctx_prepare_stmt(sqlite3 *db_handle, const char *sql, sqlite3_stmt **stmt)
+{
+	media_svc_db_ctx_s *ctx = NULL;
+	media_svc_cached_stmt_s *cached = NULL;
+	int err = SQLITE_OK;
+
+	if (db_handle == NULL || sql == NULL || stmt == NULL)
+		return SQLITE_MISUSE;
+
+	*stmt = NULL;
+
+	ctx = __media_svc_db_ctx_lookup(db_handle);
+	if (ctx == NULL)
+		return sqlite3_prepare_v2(db_handle, sql, -1, stmt, NULL);
+
+	if (ctx->stmt_cache == NULL)
+		ctx->stmt_cache = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, __media_svc_db_ctx_free_cached_stmt);
+
+	ctx->stmt_cache_tick++;
+
+	cached = (media_svc_cached_stmt_s *)g_hash_table_lookup(ctx->stmt_cache, sql);
+	if (cached != NULL && !cached->in_use) {
+		cached->in_use = TRUE;
+		cached->last_used = ctx->stmt_cache_tick;
+		*stmt = cached->stmt;
+		return SQLITE_OK;
+	}
+
+	err = sqlite3_prepare_v2(db_handle, sql, -1, stmt, NULL);
+	if (err != SQLITE_OK)
+		return err;
+
+	if (cached != NULL)
+		return SQLITE_OK;
+
+	if (g_hash_table_size(ctx->stmt_cache) >= MEDIA_SVC_STMT_CACHE_MAX
+		&& !__media_svc_db_ctx_evict_stmt(ctx))
+		return SQLITE_OK;
+
+	cached = (media_svc_cached_stmt_s *)calloc(1, sizeof(media_svc_cached_stmt_s));
+	if (cached != NULL) {
+		cached->stmt = *stmt;
+		cached->in_use = TRUE;
+		cached->last_used = ctx->stmt_cache_tick;
+		g_hash_table_insert(ctx->stmt_cache, g_strdup(sql), cached);
+	}
+
+	return SQLITE_OK;
+}
+
+/* Returns what sqlite3_finalize would, so callers checking the finalize result keep working */
+int _media_svc_db_ctx_release_stmt(sqlite3_stmt *stmt)
+{
+	media_svc_db_ctx_s *ctx = NULL;
+	media_svc_cached_stmt_s *cached = NULL;
+	int err = SQLITE_OK;
+
+	if (stmt == NULL)
+		return SQLITE_OK;
+
+	ctx = __media_svc_db_ctx_lookup(sqlite3_db_handle(stmt));
+	if (ctx != NULL && ctx->stmt_cache != NULL)
+		cached = (media_svc_cached_stmt_s *)g_hash_table_lookup(ctx->stmt_cache, sqlite3_sql(stmt));
+
+	if (cached != NULL && cached->stmt == stmt) {
+		err = sqlite3_reset(stmt);
+		sqlite3_clear_bindings(stmt);
+		cached->in_use = FALSE;
+		return err;
+	}
+
+	return sqlite3_finalize(stmt);
+}
+
+static int __media_svc_db_ctx_get_data_version(sqlite3 *db_handle, int *data_version)
+{
+	sqlite3_stmt *stmt = NULL;
+	int err = SQLITE_OK;
+
+	err = _media_svc_db_ctx_prepare_stmt(db_handle, "PRAGMA data_version", &stmt);
+	if (err != SQLITE_OK)
+		return err;
+
+	err = sqlite3_step(stmt);
+	if (err == SQLITE_ROW) {
+		*data_version = sqlite3_column_int(stmt, 0);
+		err = SQLITE_OK;
+	}
+
+	_media_svc_db_ctx_release_stmt(stmt);
+
+	return err;
+}
+
+/* Cached counts are valid while no connection has changed the database.
+ * data_version tells commits of other connections, and total changes and rollbacks tell changes of this one.
+ * Returns FALSE when count of the key should be queried from database */
+bool _media_svc_db_ctx_get_count(sqlite3 *db_handle, const char *key, int *count)
+{
+	media_svc_db_ctx_s *ctx = NULL;
+	gpointer value = NULL;
+	int data_version = 0;
+	int total_changes = 0;
+
+	if (key == NULL || count == NULL)
+		return FALSE;
+
+	ctx = __media_svc_db_ctx_lookup(db_handle);
+	if (ctx == NULL)
+		return FALSE;
+
+	if (__media_svc_db_ctx_get_data_version(db_handle, &data_version) != SQLITE_OK) {
+		pthread_mutex_lock(&ctx->stats_mutex);
+		ctx->count_stats.miss_count++;
+		pthread_mutex_unlock(&ctx->stats_mutex);
+		return FALSE;
+	}
+
+	total_changes = sqlite3_total_changes(db_handle);
+
+	if (ctx->count_cache == NULL) {
+		ctx->count_cache = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	} else if (ctx->count_data_version != data_version
+		|| ctx->count_total_changes != total_changes
+		|| ctx->count_rollback_serial != ctx->rollback_serial) {
+		if (g_hash_table_size(ctx->count_cache) > 0) {
+			g_hash_table_remove_all(ctx->count_cache);
+			pthread_mutex_lock(&ctx->stats_mutex);
+			ctx->count_stats.invalidate_count++;
+			pthread_mutex_unlock(&ctx->stats_mutex);
+		}
+	}
+
+	ctx->count_data_version = data_version;
+	ctx->count_total_changes = total_changes;
+	ctx->count_rollback_serial = ctx->rollback_serial;
+
+	if (!g_hash_table_lookup_extended(ctx->count_cache, key, NULL, &value)) {
+		pthread_mutex_lock(&ctx->stats_mutex);
+		ctx->count_stats.miss_count++;
+		pthread_mutex_unlock(&ctx->stats_mutex);
+		return FALSE;
+	}
+
+	pthread_mutex_lock(&ctx->stats_mutex);
+	ctx->count_stats.hit_count++;
+	pthread_mutex_unlock(&ctx->stats_mutex);
+	*count = GPOINTER_TO_INT(value);
+
+	return TRUE;
+}
+
+/* Stores count queried after _media_svc_db_ctx_get_count of the key missed */
+void _media_svc_db_ctx_set_count(sqlite3 *db_handle, const char *key, int count)
+{
+	media_svc_db_ctx_s *ctx = NULL;
+
+	if (key == NULL)
+		return;
+
+	ctx = __media_svc_db_ctx_lookup(db_handle);
+	if (ctx == NULL || ctx->count_cache == NULL)
+		return;
+
+	if (g_hash_table_size(ctx->count_cache) >= MEDIA_SVC_COUNT_CACHE_MAX)
+		g_hash_table_remove_all(ctx->count_cache);
+
+	g_hash_table_replace(ctx->count_cache, g_strdup(key), GINT_TO_POINTER(count));
+}
@@ -0,0 +1,170 @@
+/*
+ * libmedia-service
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Hyunjun Ko <zzoon.ko@samsung.com>, Haejeong Kim <backto.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <pthread.h>
+#include <glib.h>
+#include "media-svc-db-pool.h"
+#include "media-svc-error.h"
+#include "media-svc-debug.h"
+#include "media-svc-util.h"
+#include "media-svc-db-utils.h"
+
+/*
+ * Connection pool of a process.
+ * Read connections are handed out from idle list, or newly opened when the list is empty.
+ * With WAL journal, readers see the last committed snapshot and are not blocked by the writer.
+ * Only one write connection exists, and it is handed out to one user at a time.
+ */
+static pthread_mutex_t g_db_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_db_pool_writer_cond = PTHREAD_COND_INITIALIZER;
+static GSList *g_db_pool_idle_readers = NULL;
+static int g_db_pool_idle_reader_cnt = 0;
+static sqlite3 *g_db_pool_writer = NULL;
+static bool g_db_pool_writer_busy = FALSE;
+
+int _media_svc_db_pool_get_reader(sqlite3 **db_handle)
+{
+	int ret = MEDIA_INFO_ERROR_NONE;
+	sqlite3 *reader = NULL;
+
+	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "db_handle is NULL");
+
+	pthread_mutex_lock(&g_db_pool_mutex);
+	if (g_db_pool_idle_readers != NULL) {
+		reader = (sqlite3 *)g_db_pool_idle_readers->data;
+		g_db_pool_idle_readers = g_slist_delete_link(g_db_pool_idle_readers, g_db_pool_idle_readers);
+		g_db_pool_idle_reader_cnt--;
+	}
+	pthread_mutex_unlock(&g_db_pool_mutex);
+
+	if (reader == NULL) {
+		ret = _media_svc_connect_db_with_handle(&reader);
+		media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+		/* Guard against writes through a read connection */
+		_media_svc_sql_query(reader, "PRAGMA query_only=1;");
+	}
+
+	*db_handle = reader;
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+int _media_svc_db_pool_put_reader(sqlite3 *db_handle)
+{
+	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "db_handle is NULL");
+
+	/* A read transaction left open would pin the WAL snapshot */
+	if (!sqlite3_get_autocommit(db_handle)) {
+		media_svc_error("read connection is returned in transaction");
+		_media_svc_sql_rollback_trans(db_handle);
+	}
+
+	pthread_mutex_lock(&g_db_pool_mutex);
+	if (g_db_pool_idle_reader_cnt < MEDIA_SVC_DB_POOL_READER_MAX) {
+		g_db_pool_idle_readers = g_slist_prepend(g_db_pool_idle_readers, db_handle);
+		g_db_pool_idle_reader_cnt++;
+		db_handle = NULL;
+	}
+	pthread_mutex_unlock(&g_db_pool_mutex);
+
+	if (db_handle != NULL)
+		return _media_svc_disconnect_db_with_handle(db_handle);
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+int _media_svc_db_pool_get_writer(sqlite3 **db_handle)
+{
+	int ret = MEDIA_INFO_ERROR_NONE;
+
+	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "db_handle is NULL");
+
+	pthread_mutex_lock(&g_db_pool_mutex);
+	while (g_db_pool_writer_busy)
+		pthread_cond_wait(&g_db_pool_writer_cond, &g_db_pool_mutex);
+
+	if (g_db_pool_writer == NULL) {
+		ret = _media_svc_connect_db_with_handle(&g_db_pool_writer);
+		if (ret != MEDIA_INFO_ERROR_NONE) {
+			pthread_mutex_unlock(&g_db_pool_mutex);
+			return ret;
+		}
+	}
+
+	g_db_pool_writer_busy = TRUE;
+	*db_handle = g_db_pool_writer;
+	pthread_mutex_unlock(&g_db_pool_mutex);
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+int _media_svc_db_pool_put_writer(sqlite3 *db_handle)
+{
+	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "db_handle is NULL");
+
+	pthread_mutex_lock(&g_db_pool_mutex);
+	if (db_handle != g_db_pool_writer || !g_db_pool_writer_busy) {
+		pthread_mutex_unlock(&g_db_pool_mutex);
+		media_svc_error("handle is not the write connection in use");
+		return MEDIA_INFO_ERROR_INVALID_PARAMETER;
+	}
+
+	if (!sqlite3_get_autocommit(db_handle)) {
+		media_svc_error("write connection is returned in transaction. Now start to rollback");
+		_media_svc_sql_rollback_trans(db_handle);
+	}
+
+	g_db_pool_writer_busy = FALSE;
+	pthread_cond_signal(&g_db_pool_writer_cond);
+	pthread_mutex_unlock(&g_db_pool_mutex);
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+int _media_svc_db_pool_destroy(void)
+{
+	GSList *readers = NULL;
+	GSList *iter = NULL;
+	sqlite3 *writer = NULL;
+
+	pthread_mutex_lock(&g_db_pool_mutex);
+	readers = g_db_pool_idle_readers;
+	g_db_pool_idle_readers = NULL;
+	g_db_pool_idle_reader_cnt = 0;
+
+	if (g_db_pool_writer_busy) {
+		media_svc_error("write connection is in use. It is kept");
+	} else {
+		writer = g_db_pool_writer;
+		g_db_pool_writer = NULL;
+	}
+	pthread_mutex_unlock(&g_db_pool_mutex);
+
+	for (iter = readers; iter != NULL; iter = iter->next)
+		_media_svc_disconnect_db_with_handle((sqlite3 *)iter->data);
+	g_slist_free(readers);
+
+	if (writer != NULL)
+		_media_svc_disconnect_db_with_handle(writer);
+
+	return MEDIA_INFO_ERROR_NONE;
+}
@@ -20,26 +20,121 @@
  */
 
 #include <unistd.h>
+#include <string.h>
+#include <time.h>
 #include <db-util.h>
 #include "media-svc-env.h"
 #include "media-svc-debug.h"
 #include "media-svc-error.h"
 #include "media-svc-db-utils.h"
+#include "media-svc-db-ctx.h"
+#include "media-svc-thumb-journal.h"
+
+#define MEDIA_SVC_SCAN_SESSION_COMMIT_RETRY	3
+
+static pthread_mutex_t g_scan_session_mutex = PTHREAD_MUTEX_INITIALIZER;
+static bool g_scan_requested = FALSE;	/* media_svc_scan_update_begin takes no handle, so the session is begun by the first write of its thread */
+static pthread_t g_scan_thread;			/* thread which called media_svc_scan_update_begin */
+static sqlite3 *g_scan_handle = NULL;	/* handle holding the requested session */
 
 static int __media_svc_busy_handler(void *pData, int count);
+static int __media_svc_busy_delay_backoff(int count, int waited_usec);
+static int __media_svc_busy_delay_fixed(int count, int waited_usec);
+static void __media_svc_db_configure(sqlite3 *db_handle);
+static void __media_svc_scan_session_forget(sqlite3 *handle);
+
+/* Busy strategies, indexed by media_svc_busy_strategy_e. Each returns usec to wait before next retry, or -1 to give up */
+static int (*g_media_svc_busy_delay[MEDIA_SVC_BUSY_STRATEGY_MAX])(int count, int waited_usec) = {
+	__media_svc_busy_delay_backoff,
+	__media_svc_busy_delay_fixed,
+};
+
+static int __media_svc_busy_delay_backoff(int count, int waited_usec)
+{
+	int delay = MEDIA_SVC_DB_BUSY_MAX_USEC;
+
+	if (waited_usec >= MEDIA_SVC_DB_BUSY_TIMEOUT_USEC)
+		return -1;
+
+	if (count < 16 && (MEDIA_SVC_DB_BUSY_MIN_USEC << count) < MEDIA_SVC_DB_BUSY_MAX_USEC)
+		delay = MEDIA_SVC_DB_BUSY_MIN_USEC << count;
+
+	return delay;
+}
+
+static int __media_svc_busy_delay_fixed(int count, int waited_usec)
+{
+	if (count * MEDIA_SVC_DB_BUSY_MAX_USEC >= MEDIA_SVC_DB_BUSY_TIMEOUT_USEC)
+		return -1;
+
+	return MEDIA_SVC_DB_BUSY_MAX_USEC;
+}
 
 static int __media_svc_busy_handler(void *pData, int count)
 {
-	usleep(50000);
+	media_svc_db_ctx_s *ctx = (media_svc_db_ctx_s *)pData;
+	struct timespec start, end;
+	media_svc_busy_strategy_e strategy;
+	int delay = 0;
+	int waited = 0;
+
+	pthread_mutex_lock(&ctx->stats_mutex);
+	strategy = ctx->busy_strategy;
+	if (count == 0) {
+		ctx->busy_wait_usec = 0;
+		ctx->lock_stats.wait_count++;
+	}
+	pthread_mutex_unlock(&ctx->stats_mutex);
+
+	delay = g_media_svc_busy_delay[strategy](count, ctx->busy_wait_usec);
+	if (delay < 0) {
+		media_svc_error("give up lock wait after %d retries, %d usec", count, ctx->busy_wait_usec);
+		pthread_mutex_lock(&ctx->stats_mutex);
+		ctx->lock_stats.timeout_count++;
+		pthread_mutex_unlock(&ctx->stats_mutex);
+		return 0;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	usleep(delay);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	waited = (end.tv_sec - start.tv_sec) * 1000000 + (end.tv_nsec - start.tv_nsec) / 1000;
+
+	ctx->busy_wait_usec += waited;
+	pthread_mutex_lock(&ctx->stats_mutex);
+	ctx->lock_stats.retry_count++;
+	ctx->lock_stats.total_wait_usec += waited;
+	if (ctx->busy_wait_usec > ctx->lock_stats.longest_wait_usec)
+		ctx->lock_stats.longest_wait_usec = ctx->busy_wait_usec;
+	pthread_mutex_unlock(&ctx->stats_mutex);
+
+	return 1;
+}
+
+/* Journal mode is kept in DB file, the others are per connection. Failure here is not fatal */
+static void __media_svc_db_configure(sqlite3 *db_handle)
+{
+	char *sql = sqlite3_mprintf("PRAGMA journal_mode=WAL; \
+				PRAGMA synchronous=NORMAL; \
+				PRAGMA cache_size=%d; \
+				PRAGMA temp_store=MEMORY; \
+				PRAGMA wal_autocheckpoint=%d;",
+				MEDIA_SVC_DB_CACHE_SIZE, MEDIA_SVC_DB_WAL_AUTOCHECKPOINT);
+
+	if (sql == NULL)
+		return;
 
-	media_svc_debug("media_svc_busy_handler called : %d", count);
+	if (_media_svc_sql_query(db_handle, sql) != SQLITE_OK)
+		media_svc_error("failed to configure db connection");
 
-	return 100 - count;
+	sqlite3_free(sql);
 }
 
 int _media_svc_connect_db_with_handle(sqlite3 **db_handle)
 {
 	int ret = MEDIA_INFO_ERROR_NONE;
+	media_svc_db_ctx_s *ctx = NULL;
 
 	media_svc_debug_func();
 
@@ -54,7 +149,15 @@ int _media_svc_connect_db_with_handle(sqlite3 **db_handle)
 	}
 
 	/*Register busy handler*/
-	ret = sqlite3_busy_handler(*db_handle, __media_svc_busy_handler, NULL);
+	ctx = _media_svc_db_ctx_create(*db_handle);
+	if (ctx == NULL) {
+		db_util_close(*db_handle);
+		*db_handle = NULL;
+
+		return MEDIA_INFO_ERROR_OUT_OF_MEMORY;
+	}
+
+	ret = sqlite3_busy_handler(*db_handle, __media_svc_busy_handler, ctx);
 
 	if (SQLITE_OK != ret) {
 
@@ -62,21 +165,41 @@ int _media_svc_connect_db_with_handle(sqlite3 **db_handle)
 			media_svc_error("[error when register busy handler] %s\n", sqlite3_errmsg(*db_handle));
 		}
 
+		_media_svc_db_ctx_destroy(*db_handle);
 		db_util_close(*db_handle);
 		*db_handle = NULL;
 
 		return MEDIA_INFO_ERROR_DATABASE_CONNECT;
 	}
 
+	__media_svc_db_configure(*db_handle);
+
 	return MEDIA_INFO_ERROR_NONE;
 }
 
 int _media_svc_disconnect_db_with_handle(sqlite3 *db_handle)
 {
 	int ret = MEDIA_INFO_ERROR_NONE;
+	media_svc_db_ctx_s *ctx = NULL;
 
 	media_svc_debug_func();
 
+	/* Indexes are also built by next media_svc_create_table, if this fails */
+	ctx = _media_svc_db_ctx_get(db_handle);
+	if (ctx != NULL && ctx->bulk_load) {
+		media_svc_error("bulk load is not ended. end it before disconnect");
+		_media_svc_bulk_load_end(db_handle);
+	}
+
+	/* Work of released calls is kept */
+	if (ctx != NULL && ctx->scan_session) {
+		media_svc_error("scan session is not ended. end it before disconnect");
+		_media_svc_scan_session_end(db_handle);
+	}
+	__media_svc_scan_session_forget(db_handle);
+
+	_media_svc_db_ctx_destroy(db_handle);
+
 	ret = db_util_close(db_handle);
 
 	if (SQLITE_OK != ret) {
@@ -89,6 +212,297 @@ int _media_svc_disconnect_db_with_handle(sqlite3 *db_handle)
 	return MEDIA_INFO_ERROR_NONE;
 }
 
+/* columns of media_data, apart from media_id and dictionary ids */
+#define MEDIA_SVC_MEDIA_HEAD_COLUMNS	"media_uuid, path, file_name, media_type, mime_type, size, added_time, modified_time, \
+					folder_id, thumbnail_path, title, album_id"
+#define MEDIA_SVC_MEDIA_TAIL_COLUMNS	"recorded_date, copyright, track_num, description, bitrate, samplerate, channel, duration, \
+					longitude, latitude, altitude, width, height, datetaken, orientation, played_count, last_played_time, \
+					last_played_position, rating, favourite, author, provider, content_name, category, location_tag, \
+					age_rating, keyword, is_drm, storage_type, validity"
+#define MEDIA_SVC_MEDIA_DICT_COLUMNS	"album_dict_id, artist_dict_id, genre_dict_id, composer_dict_id, year_dict_id"
+/* columns of media_data of which update is logged in change log. validity is logged only when it is changed */
+#define MEDIA_SVC_MEDIA_LOGGED_COLUMNS	MEDIA_SVC_MEDIA_HEAD_COLUMNS", "MEDIA_SVC_MEDIA_DICT_COLUMNS", \
+					recorded_date, copyright, track_num, description, bitrate, samplerate, channel, duration, \
+					longitude, latitude, altitude, width, height, datetaken, orientation, played_count, last_played_time, \
+					last_played_position, rating, favourite, author, provider, content_name, category, location_tag, \
+					age_rating, keyword, is_drm, storage_type"
+/* directory of path, without the last slash */
+#define MEDIA_SVC_SQL_DIRNAME(path)	"substr("path", 1, length(rtrim("path", replace("path", '/', ''))) - 1)"
+/* same columns of media table "m" when it is joined with folder table, apart from validity */
+#define MEDIA_SVC_MEDIA_M_TAIL_COLUMNS	"m.recorded_date, m.copyright, m.track_num, m.description, m.bitrate, m.samplerate, \
+					m.channel, m.duration, m.longitude, m.latitude, m.altitude, m.width, m.height, m.datetaken, m.orientation, \
+					m.played_count, m.last_played_time, m.last_played_position, m.rating, m.favourite, m.author, m.provider, \
+					m.content_name, m.category, m.location_tag, m.age_rating, m.keyword, m.is_drm, m.storage_type"
+
+/* secondary indexes of media_data. They are dropped while bulk load, and built again at the end */
+static const char *g_media_svc_media_index[][2] = {
+	{"media_media_type_idx", "media_type"},
+	{"media_title_idx", "title"},
+	{"media_modified_time_idx", "modified_time"},
+	{"media_provider_idx", "provider"},
+	{"media_folder_id_idx", "folder_id"},
+	{"media_album_dict_idx", "album_dict_id"},
+	{"media_artist_dict_idx", "artist_dict_id"},
+	{"media_genre_dict_idx", "genre_dict_id"},
+	{"media_composer_dict_idx", "composer_dict_id"},
+	{"media_year_dict_idx", "year_dict_id"},
+	{"media_scan_gen_idx", "storage_type, scan_gen"},
+};
+
+int _media_svc_create_media_index(sqlite3 *db_handle)
+{
+	int ret = MEDIA_INFO_ERROR_NONE;
+	int i = 0;
+	char *sql = NULL;
+
+	for (i = 0; i < (int)(sizeof(g_media_svc_media_index) / sizeof(g_media_svc_media_index[0])); i++) {
+		sql = sqlite3_mprintf("CREATE INDEX IF NOT EXISTS %s on %s (%s);",
+					g_media_svc_media_index[i][0], MEDIA_SVC_DB_TABLE_MEDIA_DATA, g_media_svc_media_index[i][1]);
+		media_svc_retv_if(sql == NULL, MEDIA_INFO_ERROR_OUT_OF_MEMORY);
+
+		ret = _media_svc_sql_query(db_handle, sql);
+		sqlite3_free(sql);
+		if (ret != SQLITE_OK) {
+			media_svc_error("It failed to create index (%d)", ret);
+			return MEDIA_INFO_ERROR_DATABASE_TABLE_OPEN;
+		}
+	}
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+int _media_svc_drop_media_index(sqlite3 *db_handle)
+{
+	int ret = MEDIA_INFO_ERROR_NONE;
+	int i = 0;
+	char *sql = NULL;
+
+	for (i = 0; i < (int)(sizeof(g_media_svc_media_index) / sizeof(g_media_svc_media_index[0])); i++) {
+		sql = sqlite3_mprintf("DROP INDEX IF EXISTS %s;", g_media_svc_media_index[i][0]);
+		media_svc_retv_if(sql == NULL, MEDIA_INFO_ERROR_OUT_OF_MEMORY);
+
+		ret = _media_svc_sql_query(db_handle, sql);
+		sqlite3_free(sql);
+		if (ret != SQLITE_OK) {
+			media_svc_error("It failed to drop index (%d)", ret);
+			return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
+		}
+	}
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+int _media_svc_bulk_load_begin(sqlite3 *db_handle)
+{
+	int ret = MEDIA_INFO_ERROR_NONE;
+	media_svc_db_ctx_s *ctx = _media_svc_db_ctx_get(db_handle);
+
+	media_svc_retvm_if(ctx == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is not connected");
+	media_svc_retvm_if(ctx->bulk_load, MEDIA_INFO_ERROR_INVALID_PARAMETER, "bulk load is already started");
+
+	ret = _media_svc_sql_begin_trans(db_handle);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	ret = _media_svc_drop_media_index(db_handle);
+	if (ret != MEDIA_INFO_ERROR_NONE) {
+		_media_svc_sql_rollback_trans(db_handle);
+		return ret;
+	}
+
+	ret = _media_svc_sql_end_trans(db_handle);
+	if (ret != MEDIA_INFO_ERROR_NONE) {
+		_media_svc_sql_rollback_trans(db_handle);
+		return ret;
+	}
+
+	ctx->bulk_load = TRUE;
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+int _media_svc_bulk_load_end(sqlite3 *db_handle)
+{
+	int ret = MEDIA_INFO_ERROR_NONE;
+	media_svc_db_ctx_s *ctx = _media_svc_db_ctx_get(db_handle);
+
+	media_svc_retvm_if(ctx == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is not connected");
+	media_svc_retvm_if(!ctx->bulk_load, MEDIA_INFO_ERROR_INVALID_PARAMETER, "bulk load is not started");
+
+	/* Each index is built by one sort of the loaded rows */
+	ret = _media_svc_sql_begin_trans(db_handle);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	ret = _media_svc_create_media_index(db_handle);
+	if (ret != MEDIA_INFO_ERROR_NONE) {
+		_media_svc_sql_rollback_trans(db_handle);
+		return ret;
+	}
+
+	ret = _media_svc_sql_end_trans(db_handle);
+	if (ret != MEDIA_INFO_ERROR_NONE) {
+		_media_svc_sql_rollback_trans(db_handle);
+		return ret;
+	}
+
+	ctx->bulk_load = FALSE;
+
+	/* Statistics of the new rows for query planner. Failure is not fatal */
+	if (_media_svc_sql_query(db_handle, "ANALYZE "MEDIA_SVC_DB_TABLE_MEDIA_DATA";") != SQLITE_OK)
+		media_svc_error("failed to analyze %s", MEDIA_SVC_DB_TABLE_MEDIA_DATA);
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+/* Runs a query of table creation. Transaction is rolled back on failure */
+static int __media_svc_create_query(sqlite3 *db_handle, char *sql)
+{
+	int ret = MEDIA_INFO_ERROR_NONE;
+
+	if (sql == NULL) {
+		_media_svc_sql_rollback_trans(db_handle);
+		return MEDIA_INFO_ERROR_OUT_OF_MEMORY;
+	}
+
+	ret = _media_svc_sql_query(db_handle, sql);
+	sqlite3_free(sql);
+	if (ret != SQLITE_OK) {
+		media_svc_error("It failed to create db table (%d)", ret);
+		_media_svc_sql_rollback_trans(db_handle);
+		return MEDIA_INFO_ERROR_DATABASE_TABLE_OPEN;
+	}
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+static int __media_svc_create_end_trans(sqlite3 *db_handle)
+{
+	int ret = _media_svc_sql_end_trans(db_handle);
+	if (ret != MEDIA_INFO_ERROR_NONE) {
+		media_svc_error("failed to commit table creation");
+		_media_svc_sql_rollback_trans(db_handle);
+		return MEDIA_INFO_ERROR_DATABASE_TABLE_OPEN;
+	}
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+/* TRUE when name is a table of old version, not a view */
+static bool __media_svc_is_table(sqlite3 *db_handle, const char *name)
+{
+	int ret = MEDIA_INFO_ERROR_NONE;
+	bool is_table = FALSE;
+	sqlite3_stmt *sql_stmt = NULL;
+	char *sql = sqlite3_mprintf("SELECT type FROM sqlite_master WHERE name='%q'", name);
+
+	ret = _media_svc_sql_prepare_to_step(db_handle, sql, &sql_stmt);
+	if (ret != MEDIA_INFO_ERROR_NONE)
+		return FALSE;
+
+	is_table = (g_strcmp0((const char *)sqlite3_column_text(sql_stmt, 0), "table") == 0);
+
+	SQLITE3_FINALIZE(sql_stmt);
+
+	return is_table;
+}
+
+static int __media_svc_count_rows(sqlite3 *db_handle, const char *table)
+{
+	int count = 0;
+	sqlite3_stmt *sql_stmt = NULL;
+	char *sql = sqlite3_mprintf("SELECT count(*) FROM %s", table);
+
+	if (_media_svc_sql_prepare_to_step(db_handle, sql, &sql_stmt) != MEDIA_INFO_ERROR_NONE)
+		return 0;
+
+	count = sqlite3_column_int(sql_stmt, 0);
+
+	SQLITE3_FINALIZE(sql_stmt);
+
+	return count;
+}
+
+/* Rows of old table which the last INSERT of the migration did not move, because they refer unknown media or folder.
+ * They are dropped instead of rolling back the migration, which would leave the database unusable */
+static void __media_svc_log_dropped_rows(sqlite3 *db_handle, const char *table, int count)
+{
+	int dropped = count - sqlite3_changes(db_handle);
+
+	if (dropped > 0)
+		media_svc_error("%d rows of %s are dropped in the migration", dropped, table);
+}
+
+/* Moves the rows of media table of old version to media_data table. Old triggers are dropped with the table */
+static int __media_svc_migrate_media_table(sqlite3 *db_handle)
+{
+	int ret = MEDIA_INFO_ERROR_NONE;
+	char *sql = NULL;
+	int count = 0;
+
+	media_svc_debug("media table of old version. migrate it to %s", MEDIA_SVC_DB_TABLE_MEDIA_DATA);
+
+	count = __media_svc_count_rows(db_handle, MEDIA_SVC_DB_TABLE_MEDIA);
+
+	sql = sqlite3_mprintf("INSERT OR IGNORE INTO %s (kind, value) SELECT %d, album FROM %s WHERE album IS NOT NULL; \
+				INSERT OR IGNORE INTO %s (kind, value) SELECT %d, artist FROM %s WHERE artist IS NOT NULL; \
+				INSERT OR IGNORE INTO %s (kind, value) SELECT %d, genre FROM %s WHERE genre IS NOT NULL; \
+				INSERT OR IGNORE INTO %s (kind, value) SELECT %d, composer FROM %s WHERE composer IS NOT NULL; \
+				INSERT OR IGNORE INTO %s (kind, value) SELECT %d, year FROM %s WHERE year IS NOT NULL;",
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_META_DICT_ALBUM, MEDIA_SVC_DB_TABLE_MEDIA,
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_META_DICT_ARTIST, MEDIA_SVC_DB_TABLE_MEDIA,
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_META_DICT_GENRE, MEDIA_SVC_DB_TABLE_MEDIA,
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_META_DICT_COMPOSER, MEDIA_SVC_DB_TABLE_MEDIA,
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_META_DICT_YEAR, MEDIA_SVC_DB_TABLE_MEDIA);
+	ret = __media_svc_create_query(db_handle, sql);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	/* Folder of media whose folder_uuid is not in folder table is made again from the directory of the media.
+	 * A folder of the same path is used if there is one. Media which still has no folder, as its path has no directory, is dropped */
+	sql = sqlite3_mprintf("INSERT OR IGNORE INTO %s (folder_uuid, path, name, modified_time, storage_type) \
+				SELECT folder_uuid, dir, replace(dir, rtrim(dir, replace(dir, '/', '')), ''), 0, storage_type FROM \
+				(SELECT m.folder_uuid, "MEDIA_SVC_SQL_DIRNAME("m.path")" AS dir, m.storage_type FROM %s AS m \
+				WHERE NOT EXISTS (SELECT 1 FROM %s WHERE folder_uuid=m.folder_uuid)) WHERE dir!='' GROUP BY folder_uuid;",
+				MEDIA_SVC_DB_TABLE_FOLDER_DATA, MEDIA_SVC_DB_TABLE_MEDIA, MEDIA_SVC_DB_TABLE_FOLDER_DATA);
+	ret = __media_svc_create_query(db_handle, sql);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	sql = sqlite3_mprintf("INSERT OR IGNORE INTO %s ("MEDIA_SVC_MEDIA_HEAD_COLUMNS", "MEDIA_SVC_MEDIA_DICT_COLUMNS", "MEDIA_SVC_MEDIA_TAIL_COLUMNS") \
+				SELECT m.media_uuid, m.path, m.file_name, m.media_type, m.mime_type, m.size, m.added_time, m.modified_time, \
+				ifnull(f.folder_id, (SELECT folder_id FROM %s WHERE path="MEDIA_SVC_SQL_DIRNAME("m.path")")), \
+				m.thumbnail_path, m.title, m.album_id, \
+				(SELECT dict_id FROM %s WHERE kind=%d AND value=m.album), \
+				(SELECT dict_id FROM %s WHERE kind=%d AND value=m.artist), \
+				(SELECT dict_id FROM %s WHERE kind=%d AND value=m.genre), \
+				(SELECT dict_id FROM %s WHERE kind=%d AND value=m.composer), \
+				(SELECT dict_id FROM %s WHERE kind=%d AND value=m.year), \
+				"MEDIA_SVC_MEDIA_M_TAIL_COLUMNS", m.validity FROM %s AS m LEFT JOIN %s AS f ON f.folder_uuid=m.folder_uuid;",
+				MEDIA_SVC_DB_TABLE_MEDIA_DATA, MEDIA_SVC_DB_TABLE_FOLDER_DATA,
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_META_DICT_ALBUM,
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_META_DICT_ARTIST,
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_META_DICT_GENRE,
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_META_DICT_COMPOSER,
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_META_DICT_YEAR,
+				MEDIA_SVC_DB_TABLE_MEDIA, MEDIA_SVC_DB_TABLE_FOLDER_DATA);
+	ret = __media_svc_create_query(db_handle, sql);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	__media_svc_log_dropped_rows(db_handle, MEDIA_SVC_DB_TABLE_MEDIA, count);
+
+	/* values which only dropped media had are not kept */
+	sql = sqlite3_mprintf("DELETE FROM %s WHERE dict_id NOT IN (SELECT album_dict_id FROM %s WHERE album_dict_id IS NOT NULL \
+				UNION SELECT artist_dict_id FROM %s WHERE artist_dict_id IS NOT NULL \
+				UNION SELECT genre_dict_id FROM %s WHERE genre_dict_id IS NOT NULL \
+				UNION SELECT composer_dict_id FROM %s WHERE composer_dict_id IS NOT NULL \
+				UNION SELECT year_dict_id FROM %s WHERE year_dict_id IS NOT NULL); \
+				DROP TABLE %s;",
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_DB_TABLE_MEDIA_DATA, MEDIA_SVC_DB_TABLE_MEDIA_DATA,
+				MEDIA_SVC_DB_TABLE_MEDIA_DATA, MEDIA_SVC_DB_TABLE_MEDIA_DATA, MEDIA_SVC_DB_TABLE_MEDIA_DATA,
+				MEDIA_SVC_DB_TABLE_MEDIA);
+	ret = __media_svc_create_query(db_handle, sql);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
 int _media_svc_create_media_table(sqlite3 *db_handle)
 {
 	int ret = MEDIA_INFO_ERROR_NONE;
@@ -96,8 +510,24 @@ int _media_svc_create_media_table(sqlite3 *db_handle)
 
 	media_svc_debug_func();
 
+	ret = _media_svc_sql_begin_trans(db_handle);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	/* album, artist, genre, composer and year are interned in meta_dict, and media_data keeps their id */
 	sql = sqlite3_mprintf("CREATE TABLE IF NOT EXISTS %s (\
-				media_uuid			TEXT PRIMARY KEY, \
+				dict_id				INTEGER PRIMARY KEY, \
+				kind					INTEGER NOT NULL, \
+				value				TEXT NOT NULL, \
+				unique(kind, value) \
+				);",
+				MEDIA_SVC_DB_TABLE_META_DICT);
+	ret = __media_svc_create_query(db_handle, sql);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	/* media_id and folder_id are used for join. media_uuid is kept as the id for applications */
+	sql = sqlite3_mprintf("CREATE TABLE IF NOT EXISTS %s (\
+				media_id				INTEGER PRIMARY KEY, \
+				media_uuid			TEXT NOT NULL UNIQUE, \
 				path					TEXT NOT NULL UNIQUE, \
 				file_name			TEXT NOT NULL, \
 				media_type			INTEGER,\
@@ -105,15 +535,15 @@ int _media_svc_create_media_table(sqlite3 *db_handle)
 				size					INTEGER DEFAULT 0, \
 				added_time			INTEGER DEFAULT 0,\
 				modified_time			INTEGER DEFAULT 0, \
-				folder_uuid			TEXT NOT NULL, \
+				folder_id			INTEGER NOT NULL, \
 				thumbnail_path		TEXT, \
 				title					TEXT, \
 				album_id				INTEGER DEFAULT 0, \
-				album				TEXT, \
-				artist				TEXT, \
-				genre				TEXT, \
-				composer			TEXT, \
-				year					TEXT, \
+				album_dict_id		INTEGER, \
+				artist_dict_id		INTEGER, \
+				genre_dict_id		INTEGER, \
+				composer_dict_id	INTEGER, \
+				year_dict_id			INTEGER, \
 				recorded_date		TEXT, \
 				copyright			TEXT, \
 				track_num			TEXT, \
@@ -144,29 +574,232 @@ int _media_svc_create_media_table(sqlite3 *db_handle)
 				is_drm				INTEGER DEFAULT 0, \
 				storage_type			INTEGER, \
 				validity				INTEGER DEFAULT 1, \
+				scan_gen				INTEGER DEFAULT 0, \
 				unique(path, file_name) \
 				);",
-				MEDIA_SVC_DB_TABLE_MEDIA);
+				MEDIA_SVC_DB_TABLE_MEDIA_DATA);
+	ret = __media_svc_create_query(db_handle, sql);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 
-	media_svc_retv_if(sql == NULL, MEDIA_INFO_ERROR_OUT_OF_MEMORY);
-
-	ret = _media_svc_sql_query(db_handle, sql);
-	sqlite3_free(sql);
-	if (ret != SQLITE_OK) {
-		media_svc_error("It failed to create db table (%d)", ret);
-		return MEDIA_INFO_ERROR_DATABASE_TABLE_OPEN;
+	if (__media_svc_is_table(db_handle, MEDIA_SVC_DB_TABLE_MEDIA)) {
+		ret = __media_svc_migrate_media_table(db_handle);
+		media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 	}
 
 	/* Create Index*/
-	sql = sqlite3_mprintf("	CREATE INDEX IF NOT EXISTS media_media_type_idx on %s (media_type); \
-						CREATE INDEX IF NOT EXISTS media_title_idx on %s (title); \
-						CREATE INDEX IF NOT EXISTS media_modified_time_idx on %s (modified_time); \
-						CREATE INDEX IF NOT EXISTS media_provider_idx on %s (provider); \
-						",
-						MEDIA_SVC_DB_TABLE_MEDIA,
-						MEDIA_SVC_DB_TABLE_MEDIA,
-						MEDIA_SVC_DB_TABLE_MEDIA,
-						MEDIA_SVC_DB_TABLE_MEDIA);
+	ret = _media_svc_create_media_index(db_handle);
+	if (ret != MEDIA_INFO_ERROR_NONE) {
+		_media_svc_sql_rollback_trans(db_handle);
+		return ret;
+	}
+
+	/* media view keeps the columns of old media table. Dictionary ids, media_id and folder_id are appended.
+	 * Media of unmounted storage is kept in media_data, but it is not shown.
+	 * Media stamped by older scan generation than valid_gen of its storage is shown as invalid */
+	sql = sqlite3_mprintf("CREATE VIEW IF NOT EXISTS %s AS SELECT m.media_uuid, m.path, m.file_name, m.media_type, m.mime_type, \
+				m.size, m.added_time, m.modified_time, f.folder_uuid AS folder_uuid, m.thumbnail_path, m.title, m.album_id, \
+				album_dict.value AS album, artist_dict.value AS artist, genre_dict.value AS genre, \
+				composer_dict.value AS composer, year_dict.value AS year, "MEDIA_SVC_MEDIA_M_TAIL_COLUMNS", \
+				(m.validity=1 AND m.scan_gen>=s.valid_gen) AS validity, \
+				m.album_dict_id, m.artist_dict_id, m.genre_dict_id, m.composer_dict_id, m.year_dict_id, m.media_id, m.folder_id \
+				FROM %s AS m INNER JOIN %s AS f ON f.folder_id=m.folder_id \
+				INNER JOIN %s AS s ON s.storage_type=m.storage_type AND s.mounted=1 \
+				LEFT JOIN %s AS album_dict ON album_dict.dict_id=m.album_dict_id \
+				LEFT JOIN %s AS artist_dict ON artist_dict.dict_id=m.artist_dict_id \
+				LEFT JOIN %s AS genre_dict ON genre_dict.dict_id=m.genre_dict_id \
+				LEFT JOIN %s AS composer_dict ON composer_dict.dict_id=m.composer_dict_id \
+				LEFT JOIN %s AS year_dict ON year_dict.dict_id=m.year_dict_id;",
+				MEDIA_SVC_DB_TABLE_MEDIA, MEDIA_SVC_DB_TABLE_MEDIA_DATA, MEDIA_SVC_DB_TABLE_FOLDER_DATA, MEDIA_SVC_DB_TABLE_STORAGE,
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_DB_TABLE_META_DICT,
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_DB_TABLE_META_DICT);
+	ret = __media_svc_create_query(db_handle, sql);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	/* Create Trigger to keep writing to media view of other modules. Unset column of insert gets default of media_data */
+	sql = sqlite3_mprintf("CREATE TRIGGER IF NOT EXISTS media_insert INSTEAD OF INSERT ON %s BEGIN \
+				INSERT OR IGNORE INTO %s (kind, value) SELECT kind, value FROM \
+				(SELECT %d AS kind, new.album AS value UNION ALL SELECT %d, new.artist UNION ALL SELECT %d, new.genre \
+				UNION ALL SELECT %d, new.composer UNION ALL SELECT %d, new.year) WHERE value IS NOT NULL; \
+				INSERT INTO %s ("MEDIA_SVC_MEDIA_HEAD_COLUMNS", "MEDIA_SVC_MEDIA_DICT_COLUMNS", "MEDIA_SVC_MEDIA_TAIL_COLUMNS", scan_gen) \
+				VALUES (new.media_uuid, new.path, new.file_name, new.media_type, new.mime_type, ifnull(new.size, 0), \
+				ifnull(new.added_time, 0), ifnull(new.modified_time, 0), \
+				(SELECT folder_id FROM %s WHERE folder_uuid=new.folder_uuid), new.thumbnail_path, new.title, \
+				ifnull(new.album_id, 0), \
+				(SELECT dict_id FROM %s WHERE kind=%d AND value=new.album), \
+				(SELECT dict_id FROM %s WHERE kind=%d AND value=new.artist), \
+				(SELECT dict_id FROM %s WHERE kind=%d AND value=new.genre), \
+				(SELECT dict_id FROM %s WHERE kind=%d AND value=new.composer), \
+				(SELECT dict_id FROM %s WHERE kind=%d AND value=new.year), \
+				new.recorded_date, new.copyright, new.track_num, new.description, ifnull(new.bitrate, -1), \
+				ifnull(new.samplerate, -1), ifnull(new.channel, -1), ifnull(new.duration, -1), ifnull(new.longitude, 0), \
+				ifnull(new.latitude, 0), ifnull(new.altitude, 0), ifnull(new.width, -1), ifnull(new.height, -1), new.datetaken, \
+				ifnull(new.orientation, -1), ifnull(new.played_count, 0), ifnull(new.last_played_time, 0), \
+				ifnull(new.last_played_position, 0), ifnull(new.rating, 0), ifnull(new.favourite, 0), new.author, new.provider, \
+				new.content_name, new.category, new.location_tag, new.age_rating, new.keyword, ifnull(new.is_drm, 0), \
+				new.storage_type, ifnull(new.validity, 1), \
+				ifnull((SELECT scan_gen FROM %s WHERE storage_type=new.storage_type), 0));END;",
+				MEDIA_SVC_DB_TABLE_MEDIA, MEDIA_SVC_DB_TABLE_META_DICT,
+				MEDIA_SVC_META_DICT_ALBUM, MEDIA_SVC_META_DICT_ARTIST, MEDIA_SVC_META_DICT_GENRE,
+				MEDIA_SVC_META_DICT_COMPOSER, MEDIA_SVC_META_DICT_YEAR,
+				MEDIA_SVC_DB_TABLE_MEDIA_DATA, MEDIA_SVC_DB_TABLE_FOLDER_DATA,
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_META_DICT_ALBUM,
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_META_DICT_ARTIST,
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_META_DICT_GENRE,
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_META_DICT_COMPOSER,
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_META_DICT_YEAR,
+				MEDIA_SVC_DB_TABLE_STORAGE);
+	ret = __media_svc_create_query(db_handle, sql);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	sql = sqlite3_mprintf("CREATE TRIGGER IF NOT EXISTS media_update INSTEAD OF UPDATE ON %s BEGIN \
+				INSERT OR IGNORE INTO %s (kind, value) SELECT kind, value FROM \
+				(SELECT %d AS kind, new.album AS value UNION ALL SELECT %d, new.artist UNION ALL SELECT %d, new.genre \
+				UNION ALL SELECT %d, new.composer UNION ALL SELECT %d, new.year) WHERE value IS NOT NULL; \
+				UPDATE %s SET media_uuid=new.media_uuid, path=new.path, file_name=new.file_name, media_type=new.media_type, \
+				mime_type=new.mime_type, size=new.size, added_time=new.added_time, modified_time=new.modified_time, \
+				folder_id=(SELECT folder_id FROM %s WHERE folder_uuid=new.folder_uuid), \
+				thumbnail_path=new.thumbnail_path, title=new.title, album_id=new.album_id, \
+				album_dict_id=(SELECT dict_id FROM %s WHERE kind=%d AND value=new.album), \
+				artist_dict_id=(SELECT dict_id FROM %s WHERE kind=%d AND value=new.artist), \
+				genre_dict_id=(SELECT dict_id FROM %s WHERE kind=%d AND value=new.genre), \
+				composer_dict_id=(SELECT dict_id FROM %s WHERE kind=%d AND value=new.composer), \
+				year_dict_id=(SELECT dict_id FROM %s WHERE kind=%d AND value=new.year), \
+				recorded_date=new.recorded_date, copyright=new.copyright, track_num=new.track_num, description=new.description, \
+				bitrate=new.bitrate, samplerate=new.samplerate, channel=new.channel, duration=new.duration, \
+				longitude=new.longitude, latitude=new.latitude, altitude=new.altitude, width=new.width, height=new.height, \
+				datetaken=new.datetaken, orientation=new.orientation, played_count=new.played_count, \
+				last_played_time=new.last_played_time, last_played_position=new.last_played_position, rating=new.rating, \
+				favourite=new.favourite, author=new.author, provider=new.provider, content_name=new.content_name, \
+				category=new.category, location_tag=new.location_tag, age_rating=new.age_rating, keyword=new.keyword, \
+				is_drm=new.is_drm, storage_type=new.storage_type \
+				WHERE media_id=old.media_id;END;",
+				MEDIA_SVC_DB_TABLE_MEDIA, MEDIA_SVC_DB_TABLE_META_DICT,
+				MEDIA_SVC_META_DICT_ALBUM, MEDIA_SVC_META_DICT_ARTIST, MEDIA_SVC_META_DICT_GENRE,
+				MEDIA_SVC_META_DICT_COMPOSER, MEDIA_SVC_META_DICT_YEAR,
+				MEDIA_SVC_DB_TABLE_MEDIA_DATA, MEDIA_SVC_DB_TABLE_FOLDER_DATA,
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_META_DICT_ALBUM,
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_META_DICT_ARTIST,
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_META_DICT_GENRE,
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_META_DICT_COMPOSER,
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_META_DICT_YEAR);
+	ret = __media_svc_create_query(db_handle, sql);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	/* validity of media view is computed from the scan generation, so it is written only when caller changes it.
+	 * Otherwise an update of other columns would store the computed 0 of older generation.
+	 * Media set valid is stamped with the current generation of its storage */
+	sql = sqlite3_mprintf("CREATE TRIGGER IF NOT EXISTS media_update_validity INSTEAD OF UPDATE ON %s \
+				WHEN new.validity IS NOT old.validity BEGIN \
+				UPDATE %s SET validity=new.validity, scan_gen=CASE WHEN new.validity=1 \
+				THEN ifnull((SELECT scan_gen FROM %s WHERE storage_type=new.storage_type), scan_gen) ELSE scan_gen END \
+				WHERE media_id=old.media_id;END;",
+				MEDIA_SVC_DB_TABLE_MEDIA, MEDIA_SVC_DB_TABLE_MEDIA_DATA, MEDIA_SVC_DB_TABLE_STORAGE);
+	ret = __media_svc_create_query(db_handle, sql);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	sql = sqlite3_mprintf("CREATE TRIGGER IF NOT EXISTS media_delete INSTEAD OF DELETE ON %s BEGIN \
+				DELETE FROM %s WHERE media_id=old.media_id;END;",
+				MEDIA_SVC_DB_TABLE_MEDIA, MEDIA_SVC_DB_TABLE_MEDIA_DATA);
+	ret = __media_svc_create_query(db_handle, sql);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	/* Create Trigger to remove folder which have no content from folder when media remove from media_data table*/
+	sql = sqlite3_mprintf("CREATE TRIGGER IF NOT EXISTS folder_cleanup \
+				DELETE ON %s BEGIN DELETE FROM %s \
+				WHERE (SELECT count(*) FROM %s WHERE folder_id=old.folder_id)=1 AND folder_id=old.folder_id;END;",
+				MEDIA_SVC_DB_TABLE_MEDIA_DATA, MEDIA_SVC_DB_TABLE_FOLDER_DATA, MEDIA_SVC_DB_TABLE_MEDIA_DATA);
+	ret = __media_svc_create_query(db_handle, sql);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	/* Create Trigger to remove value which is not used by any media from meta_dict. It runs after the row is changed to see other rows */
+	sql = sqlite3_mprintf("CREATE TRIGGER IF NOT EXISTS meta_dict_cleanup_delete AFTER DELETE ON %s BEGIN \
+				DELETE FROM %s WHERE dict_id=old.album_dict_id AND NOT EXISTS (SELECT 1 FROM %s WHERE album_dict_id=old.album_dict_id); \
+				DELETE FROM %s WHERE dict_id=old.artist_dict_id AND NOT EXISTS (SELECT 1 FROM %s WHERE artist_dict_id=old.artist_dict_id); \
+				DELETE FROM %s WHERE dict_id=old.genre_dict_id AND NOT EXISTS (SELECT 1 FROM %s WHERE genre_dict_id=old.genre_dict_id); \
+				DELETE FROM %s WHERE dict_id=old.composer_dict_id AND NOT EXISTS (SELECT 1 FROM %s WHERE composer_dict_id=old.composer_dict_id); \
+				DELETE FROM %s WHERE dict_id=old.year_dict_id AND NOT EXISTS (SELECT 1 FROM %s WHERE year_dict_id=old.year_dict_id); \
+				END;",
+				MEDIA_SVC_DB_TABLE_MEDIA_DATA,
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_DB_TABLE_MEDIA_DATA,
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_DB_TABLE_MEDIA_DATA,
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_DB_TABLE_MEDIA_DATA,
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_DB_TABLE_MEDIA_DATA,
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_DB_TABLE_MEDIA_DATA);
+	ret = __media_svc_create_query(db_handle, sql);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	sql = sqlite3_mprintf("CREATE TRIGGER IF NOT EXISTS meta_dict_cleanup_update AFTER UPDATE OF \
+				album_dict_id, artist_dict_id, genre_dict_id, composer_dict_id, year_dict_id ON %s BEGIN \
+				DELETE FROM %s WHERE dict_id=old.album_dict_id AND old.album_dict_id IS NOT new.album_dict_id \
+				AND NOT EXISTS (SELECT 1 FROM %s WHERE album_dict_id=old.album_dict_id); \
+				DELETE FROM %s WHERE dict_id=old.artist_dict_id AND old.artist_dict_id IS NOT new.artist_dict_id \
+				AND NOT EXISTS (SELECT 1 FROM %s WHERE artist_dict_id=old.artist_dict_id); \
+				DELETE FROM %s WHERE dict_id=old.genre_dict_id AND old.genre_dict_id IS NOT new.genre_dict_id \
+				AND NOT EXISTS (SELECT 1 FROM %s WHERE genre_dict_id=old.genre_dict_id); \
+				DELETE FROM %s WHERE dict_id=old.composer_dict_id AND old.composer_dict_id IS NOT new.composer_dict_id \
+				AND NOT EXISTS (SELECT 1 FROM %s WHERE composer_dict_id=old.composer_dict_id); \
+				DELETE FROM %s WHERE dict_id=old.year_dict_id AND old.year_dict_id IS NOT new.year_dict_id \
+				AND NOT EXISTS (SELECT 1 FROM %s WHERE year_dict_id=old.year_dict_id); \
+				END;",
+				MEDIA_SVC_DB_TABLE_MEDIA_DATA,
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_DB_TABLE_MEDIA_DATA,
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_DB_TABLE_MEDIA_DATA,
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_DB_TABLE_MEDIA_DATA,
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_DB_TABLE_MEDIA_DATA,
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_DB_TABLE_MEDIA_DATA);
+	ret = __media_svc_create_query(db_handle, sql);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	/* Renaming a value to another existing value merges them. Media of the renamed value is moved to the existing one,
+	 * and the renamed row is removed instead of failing on unique(kind, value) */
+	sql = sqlite3_mprintf("CREATE TRIGGER IF NOT EXISTS meta_dict_merge BEFORE UPDATE OF kind, value ON %s \
+				WHEN EXISTS (SELECT 1 FROM %s WHERE kind=new.kind AND value=new.value AND dict_id!=old.dict_id) BEGIN \
+				UPDATE %s SET album_dict_id=(SELECT dict_id FROM %s WHERE kind=new.kind AND value=new.value) \
+				WHERE old.kind=%d AND album_dict_id=old.dict_id; \
+				UPDATE %s SET artist_dict_id=(SELECT dict_id FROM %s WHERE kind=new.kind AND value=new.value) \
+				WHERE old.kind=%d AND artist_dict_id=old.dict_id; \
+				UPDATE %s SET genre_dict_id=(SELECT dict_id FROM %s WHERE kind=new.kind AND value=new.value) \
+				WHERE old.kind=%d AND genre_dict_id=old.dict_id; \
+				UPDATE %s SET composer_dict_id=(SELECT dict_id FROM %s WHERE kind=new.kind AND value=new.value) \
+				WHERE old.kind=%d AND composer_dict_id=old.dict_id; \
+				UPDATE %s SET year_dict_id=(SELECT dict_id FROM %s WHERE kind=new.kind AND value=new.value) \
+				WHERE old.kind=%d AND year_dict_id=old.dict_id; \
+				DELETE FROM %s WHERE dict_id=old.dict_id; \
+				SELECT RAISE(IGNORE);END;",
+				MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_DB_TABLE_META_DICT,
+				MEDIA_SVC_DB_TABLE_MEDIA_DATA, MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_META_DICT_ALBUM,
+				MEDIA_SVC_DB_TABLE_MEDIA_DATA, MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_META_DICT_ARTIST,
+				MEDIA_SVC_DB_TABLE_MEDIA_DATA, MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_META_DICT_GENRE,
+				MEDIA_SVC_DB_TABLE_MEDIA_DATA, MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_META_DICT_COMPOSER,
+				MEDIA_SVC_DB_TABLE_MEDIA_DATA, MEDIA_SVC_DB_TABLE_META_DICT, MEDIA_SVC_META_DICT_YEAR,
+				MEDIA_SVC_DB_TABLE_META_DICT);
+	ret = __media_svc_create_query(db_handle, sql);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	return __media_svc_create_end_trans(db_handle);
+}
+
+int _media_svc_create_storage_table(sqlite3 *db_handle)
+{
+	int ret = MEDIA_INFO_ERROR_NONE;
+	char * sql = NULL;
+
+	media_svc_debug_func();
+
+	/* Media and folder of each storage type are shown while it is mounted. Storage is mounted until it is unmounted explicitly.
+	 * scan_gen is stamped to media which is added or found by the scan, and media of older generation than valid_gen is invalid */
+	sql = sqlite3_mprintf("CREATE TABLE IF NOT EXISTS %s (\
+				storage_type		INTEGER PRIMARY KEY, \
+				volume_id		TEXT, \
+				mounted			INTEGER DEFAULT 1, \
+				scan_gen			INTEGER DEFAULT 0, \
+				valid_gen		INTEGER DEFAULT 0 \
+				); \
+				INSERT OR IGNORE INTO %s (storage_type) VALUES (%d); \
+				INSERT OR IGNORE INTO %s (storage_type) VALUES (%d);",
+				MEDIA_SVC_DB_TABLE_STORAGE,
+				MEDIA_SVC_DB_TABLE_STORAGE, MEDIA_SVC_STORAGE_INTERNAL,
+				MEDIA_SVC_DB_TABLE_STORAGE, MEDIA_SVC_STORAGE_EXTERNAL);
 
 	media_svc_retv_if(sql == NULL, MEDIA_INFO_ERROR_OUT_OF_MEMORY);
 
@@ -187,113 +820,142 @@ int _media_svc_create_folder_table(sqlite3 *db_handle)
 
 	media_svc_debug_func();
 
+	ret = _media_svc_sql_begin_trans(db_handle);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
 	sql = sqlite3_mprintf("CREATE TABLE IF NOT EXISTS %s (\
-				folder_uuid 		TEXT PRIMARY KEY, \
+				folder_id		INTEGER PRIMARY KEY, \
+				folder_uuid 		TEXT NOT NULL UNIQUE, \
 				path				TEXT NOT NULL UNIQUE, \
 				name 			TEXT NOT NULL, \
 				modified_time		INTEGER DEFAULT 0, \
 				storage_type		INTEGER, \
 				unique(path, name) \
 				);",
-				MEDIA_SVC_DB_TABLE_FOLDER);
-
-	media_svc_retv_if(sql == NULL, MEDIA_INFO_ERROR_OUT_OF_MEMORY);
-
-	ret = _media_svc_sql_query(db_handle, sql);
-	sqlite3_free(sql);
-	if (ret != SQLITE_OK) {
-		media_svc_error("It failed to create db table (%d)", ret);
-		return MEDIA_INFO_ERROR_DATABASE_TABLE_OPEN;
-	}
-
-	/* Create Trigger to remove folder which have no content from folder when media remove from media_table*/
-	sql = sqlite3_mprintf("CREATE TRIGGER IF NOT EXISTS folder_cleanup \
-				DELETE ON %s BEGIN DELETE FROM %s \
-				WHERE (SELECT count(*) FROM %s WHERE folder_uuid=old.folder_uuid)=1 AND folder_uuid=old.folder_uuid;END;",
-				MEDIA_SVC_DB_TABLE_MEDIA, MEDIA_SVC_DB_TABLE_FOLDER, MEDIA_SVC_DB_TABLE_MEDIA);
-
-	media_svc_retv_if(sql == NULL, MEDIA_INFO_ERROR_OUT_OF_MEMORY);
-
-	ret = _media_svc_sql_query(db_handle, sql);
-	sqlite3_free(sql);
-	if (ret != SQLITE_OK) {
-		media_svc_error("It failed to create trigger (%d)", ret);
-		return MEDIA_INFO_ERROR_DATABASE_TABLE_OPEN;
+				MEDIA_SVC_DB_TABLE_FOLDER_DATA);
+	ret = __media_svc_create_query(db_handle, sql);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	/* folder table of old version */
+	if (__media_svc_is_table(db_handle, MEDIA_SVC_DB_TABLE_FOLDER)) {
+		media_svc_debug("folder table of old version. migrate it to %s", MEDIA_SVC_DB_TABLE_FOLDER_DATA);
+
+		sql = sqlite3_mprintf("INSERT INTO %s (folder_uuid, path, name, modified_time, storage_type) \
+					SELECT folder_uuid, path, name, modified_time, storage_type FROM %s; \
+					DROP TABLE %s;",
+					MEDIA_SVC_DB_TABLE_FOLDER_DATA, MEDIA_SVC_DB_TABLE_FOLDER, MEDIA_SVC_DB_TABLE_FOLDER);
+		ret = __media_svc_create_query(db_handle, sql);
+		media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 	}
 
-	return MEDIA_INFO_ERROR_NONE;
+	/* folder view keeps the columns of old folder table, and folder_id is appended. Folder of unmounted storage is not shown */
+	sql = sqlite3_mprintf("CREATE VIEW IF NOT EXISTS %s AS SELECT f.folder_uuid, f.path, f.name, f.modified_time, f.storage_type, f.folder_id \
+				FROM %s AS f INNER JOIN %s AS s ON s.storage_type=f.storage_type AND s.mounted=1; \
+				CREATE TRIGGER IF NOT EXISTS folder_insert INSTEAD OF INSERT ON %s BEGIN \
+				INSERT INTO %s (folder_uuid, path, name, modified_time, storage_type) \
+				VALUES (new.folder_uuid, new.path, new.name, ifnull(new.modified_time, 0), new.storage_type);END; \
+				CREATE TRIGGER IF NOT EXISTS folder_update INSTEAD OF UPDATE ON %s BEGIN \
+				UPDATE %s SET folder_uuid=new.folder_uuid, path=new.path, name=new.name, modified_time=new.modified_time, \
+				storage_type=new.storage_type WHERE folder_id=old.folder_id;END; \
+				CREATE TRIGGER IF NOT EXISTS folder_delete INSTEAD OF DELETE ON %s BEGIN \
+				DELETE FROM %s WHERE folder_id=old.folder_id;END;",
+				MEDIA_SVC_DB_TABLE_FOLDER, MEDIA_SVC_DB_TABLE_FOLDER_DATA, MEDIA_SVC_DB_TABLE_STORAGE,
+				MEDIA_SVC_DB_TABLE_FOLDER, MEDIA_SVC_DB_TABLE_FOLDER_DATA,
+				MEDIA_SVC_DB_TABLE_FOLDER, MEDIA_SVC_DB_TABLE_FOLDER_DATA,
+				MEDIA_SVC_DB_TABLE_FOLDER, MEDIA_SVC_DB_TABLE_FOLDER_DATA);
+	ret = __media_svc_create_query(db_handle, sql);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	return __media_svc_create_end_trans(db_handle);
 }
 
 int _media_svc_create_playlist_table(sqlite3 *db_handle)
 {
 	int ret = MEDIA_INFO_ERROR_NONE;
 	char * sql = NULL;
+	int count = 0;
 
 	media_svc_debug_func();
 
+	ret = _media_svc_sql_begin_trans(db_handle);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
 	/*Create playlist table*/
 	sql = sqlite3_mprintf("CREATE TABLE IF NOT EXISTS %s (\
 				playlist_id		INTEGER PRIMARY KEY AUTOINCREMENT, \
 				name			TEXT NOT NULL UNIQUE\
 				);",
 				MEDIA_SVC_DB_TABLE_PLAYLIST);
+	ret = __media_svc_create_query(db_handle, sql);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 
-	media_svc_retv_if(sql == NULL, MEDIA_INFO_ERROR_OUT_OF_MEMORY);
-
-	ret = _media_svc_sql_query(db_handle, sql);
-	sqlite3_free(sql);
-	if (ret != SQLITE_OK) {
-		media_svc_error("It failed to create db table (%d)", ret);
-		return MEDIA_INFO_ERROR_DATABASE_TABLE_OPEN;
-	}
-
-	/*Create playlist_map table*/
+	/*Create playlist_map_data table*/
 	sql = sqlite3_mprintf("CREATE TABLE IF NOT EXISTS %s (\
 				_id				INTEGER PRIMARY KEY AUTOINCREMENT, \
 				playlist_id		INTEGER NOT NULL,\
-				media_uuid		TEXT NOT NULL,\
+				media_id		INTEGER NOT NULL,\
 				play_order		INTEGER NOT NULL\
-				);",
-				MEDIA_SVC_DB_TABLE_PLAYLIST_MAP);
-
-	media_svc_retv_if(sql == NULL, MEDIA_INFO_ERROR_OUT_OF_MEMORY);
-
-	ret = _media_svc_sql_query(db_handle, sql);
-	sqlite3_free(sql);
-	if (ret != SQLITE_OK) {
-		media_svc_error("It failed to create db table (%d)", ret);
-		return MEDIA_INFO_ERROR_DATABASE_TABLE_OPEN;
+				); \
+				CREATE INDEX IF NOT EXISTS playlist_map_playlist_id_idx on %s (playlist_id); \
+				CREATE INDEX IF NOT EXISTS playlist_map_media_id_idx on %s (media_id);",
+				MEDIA_SVC_DB_TABLE_PLAYLIST_MAP_DATA, MEDIA_SVC_DB_TABLE_PLAYLIST_MAP_DATA, MEDIA_SVC_DB_TABLE_PLAYLIST_MAP_DATA);
+	ret = __media_svc_create_query(db_handle, sql);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	/* playlist_map of old version. The trigger of playlist table refers it */
+	if (__media_svc_is_table(db_handle, MEDIA_SVC_DB_TABLE_PLAYLIST_MAP)) {
+		media_svc_debug("playlist_map table of old version. migrate it to %s", MEDIA_SVC_DB_TABLE_PLAYLIST_MAP_DATA);
+
+		count = __media_svc_count_rows(db_handle, MEDIA_SVC_DB_TABLE_PLAYLIST_MAP);
+
+		/* Row of unknown media is not moved */
+		sql = sqlite3_mprintf("INSERT INTO %s (_id, playlist_id, media_id, play_order) \
+					SELECT p._id, p.playlist_id, m.media_id, p.play_order FROM %s AS p INNER JOIN %s AS m ON m.media_uuid=p.media_uuid;",
+					MEDIA_SVC_DB_TABLE_PLAYLIST_MAP_DATA, MEDIA_SVC_DB_TABLE_PLAYLIST_MAP, MEDIA_SVC_DB_TABLE_MEDIA_DATA);
+		ret = __media_svc_create_query(db_handle, sql);
+		media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+		__media_svc_log_dropped_rows(db_handle, MEDIA_SVC_DB_TABLE_PLAYLIST_MAP, count);
+
+		sql = sqlite3_mprintf("DROP TABLE %s; DROP TRIGGER IF EXISTS playlist_map_cleanup_1;", MEDIA_SVC_DB_TABLE_PLAYLIST_MAP);
+		ret = __media_svc_create_query(db_handle, sql);
+		media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 	}
 
-	/* Create Trigger to remove media from playlist_map when media remove from media_table*/
+	/* playlist_map view keeps media_uuid of old version */
+	sql = sqlite3_mprintf("CREATE VIEW IF NOT EXISTS %s AS SELECT p._id, p.playlist_id, m.media_uuid, p.play_order, p.media_id \
+				FROM %s AS p INNER JOIN %s AS m ON m.media_id=p.media_id \
+				INNER JOIN %s AS s ON s.storage_type=m.storage_type AND s.mounted=1; \
+				CREATE TRIGGER IF NOT EXISTS playlist_map_insert INSTEAD OF INSERT ON %s BEGIN \
+				INSERT INTO %s (_id, playlist_id, media_id, play_order) VALUES (new._id, new.playlist_id, \
+				(SELECT media_id FROM %s WHERE media_uuid=new.media_uuid), new.play_order);END; \
+				CREATE TRIGGER IF NOT EXISTS playlist_map_update INSTEAD OF UPDATE ON %s BEGIN \
+				UPDATE %s SET playlist_id=new.playlist_id, media_id=(SELECT media_id FROM %s WHERE media_uuid=new.media_uuid), \
+				play_order=new.play_order WHERE _id=old._id;END; \
+				CREATE TRIGGER IF NOT EXISTS playlist_map_delete INSTEAD OF DELETE ON %s BEGIN \
+				DELETE FROM %s WHERE _id=old._id;END;",
+				MEDIA_SVC_DB_TABLE_PLAYLIST_MAP, MEDIA_SVC_DB_TABLE_PLAYLIST_MAP_DATA, MEDIA_SVC_DB_TABLE_MEDIA_DATA, MEDIA_SVC_DB_TABLE_STORAGE,
+				MEDIA_SVC_DB_TABLE_PLAYLIST_MAP, MEDIA_SVC_DB_TABLE_PLAYLIST_MAP_DATA, MEDIA_SVC_DB_TABLE_MEDIA_DATA,
+				MEDIA_SVC_DB_TABLE_PLAYLIST_MAP, MEDIA_SVC_DB_TABLE_PLAYLIST_MAP_DATA, MEDIA_SVC_DB_TABLE_MEDIA_DATA,
+				MEDIA_SVC_DB_TABLE_PLAYLIST_MAP, MEDIA_SVC_DB_TABLE_PLAYLIST_MAP_DATA);
+	ret = __media_svc_create_query(db_handle, sql);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	/* Create Trigger to remove media from playlist_map when media remove from media_data table*/
 	sql = sqlite3_mprintf("CREATE TRIGGER IF NOT EXISTS playlist_map_cleanup \
-				DELETE ON %s BEGIN DELETE FROM %s WHERE media_uuid=old.media_uuid;END;",
-				MEDIA_SVC_DB_TABLE_MEDIA, MEDIA_SVC_DB_TABLE_PLAYLIST_MAP);
-
-	media_svc_retv_if(sql == NULL, MEDIA_INFO_ERROR_OUT_OF_MEMORY);
-
-	ret = _media_svc_sql_query(db_handle, sql);
-	sqlite3_free(sql);
-	if (ret != SQLITE_OK) {
-		media_svc_error("It failed to create trigger (%d)", ret);
-		return MEDIA_INFO_ERROR_DATABASE_TABLE_OPEN;
-	}
+				DELETE ON %s BEGIN DELETE FROM %s WHERE media_id=old.media_id;END;",
+				MEDIA_SVC_DB_TABLE_MEDIA_DATA, MEDIA_SVC_DB_TABLE_PLAYLIST_MAP_DATA);
+	ret = __media_svc_create_query(db_handle, sql);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 
 	/* Create Trigger to remove media from playlist_map when playlist removed from playlist table*/
 	sql = sqlite3_mprintf("CREATE TRIGGER IF NOT EXISTS playlist_map_cleanup_1 \
 				DELETE ON %s BEGIN DELETE FROM %s WHERE playlist_id=old.playlist_id;END;",
-				MEDIA_SVC_DB_TABLE_PLAYLIST, MEDIA_SVC_DB_TABLE_PLAYLIST_MAP);
-
-	media_svc_retv_if(sql == NULL, MEDIA_INFO_ERROR_OUT_OF_MEMORY);
-
-	ret = _media_svc_sql_query(db_handle, sql);
-	sqlite3_free(sql);
-	if (ret != SQLITE_OK) {
-		media_svc_error("It failed to create trigger (%d)", ret);
-		return MEDIA_INFO_ERROR_DATABASE_TABLE_OPEN;
-	}
+				MEDIA_SVC_DB_TABLE_PLAYLIST, MEDIA_SVC_DB_TABLE_PLAYLIST_MAP_DATA);
+	ret = __media_svc_create_query(db_handle, sql);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 
-	return MEDIA_INFO_ERROR_NONE;
+	return __media_svc_create_end_trans(db_handle);
 }
 
 int _media_svc_create_album_table(sqlite3 *db_handle)
@@ -321,11 +983,11 @@ int _media_svc_create_album_table(sqlite3 *db_handle)
 		return MEDIA_INFO_ERROR_DATABASE_TABLE_OPEN;
 	}
 
-	/* Create Trigger to remove album when media remove from media_table*/
+	/* Create Trigger to remove album when media remove from media_data table*/
 	sql = sqlite3_mprintf("CREATE TRIGGER IF NOT EXISTS album_cleanup \
 				DELETE ON %s BEGIN DELETE FROM %s \
 				WHERE (SELECT count(*) FROM %s WHERE album_id=old.album_id)=1 AND album_id=old.album_id;END;",
-				MEDIA_SVC_DB_TABLE_MEDIA, MEDIA_SVC_DB_TABLE_ALBUM, MEDIA_SVC_DB_TABLE_MEDIA);
+				MEDIA_SVC_DB_TABLE_MEDIA_DATA, MEDIA_SVC_DB_TABLE_ALBUM, MEDIA_SVC_DB_TABLE_MEDIA_DATA);
 
 	media_svc_retv_if(sql == NULL, MEDIA_INFO_ERROR_OUT_OF_MEMORY);
 
@@ -343,71 +1005,88 @@ int _media_svc_create_tag_table(sqlite3 *db_handle)
 {
 	int ret = MEDIA_INFO_ERROR_NONE;
 	char * sql = NULL;
+	int count = 0;
 
 	media_svc_debug_func();
 
+	ret = _media_svc_sql_begin_trans(db_handle);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
 	/*Create tag table*/
 	sql = sqlite3_mprintf("CREATE TABLE IF NOT EXISTS %s (\
 				tag_id		INTEGER PRIMARY KEY AUTOINCREMENT, \
 				name		TEXT NOT NULL UNIQUE\
 				);",
 				MEDIA_SVC_DB_TABLE_TAG);
+	ret = __media_svc_create_query(db_handle, sql);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 
-	media_svc_retv_if(sql == NULL, MEDIA_INFO_ERROR_OUT_OF_MEMORY);
-
-	ret = _media_svc_sql_query(db_handle, sql);
-	sqlite3_free(sql);
-	if (ret != SQLITE_OK) {
-		media_svc_error("It failed to create db table (%d)", ret);
-		return MEDIA_INFO_ERROR_DATABASE_TABLE_OPEN;
-	}
-
-	/*Create tag_map table*/
+	/*Create tag_map_data table*/
 	sql = sqlite3_mprintf("CREATE TABLE IF NOT EXISTS %s (\
 				_id				INTEGER PRIMARY KEY AUTOINCREMENT, \
 				tag_id			INTEGER NOT NULL,\
-				media_uuid		TEXT NOT NULL,\
-				unique(tag_id, media_uuid) \
-				);",
-				MEDIA_SVC_DB_TABLE_TAG_MAP);
-
-	media_svc_retv_if(sql == NULL, MEDIA_INFO_ERROR_OUT_OF_MEMORY);
-
-	ret = _media_svc_sql_query(db_handle, sql);
-	sqlite3_free(sql);
-	if (ret != SQLITE_OK) {
-		media_svc_error("It failed to create db table (%d)", ret);
-		return MEDIA_INFO_ERROR_DATABASE_TABLE_OPEN;
+				media_id		INTEGER NOT NULL,\
+				unique(tag_id, media_id) \
+				); \
+				CREATE INDEX IF NOT EXISTS tag_map_media_id_idx on %s (media_id);",
+				MEDIA_SVC_DB_TABLE_TAG_MAP_DATA, MEDIA_SVC_DB_TABLE_TAG_MAP_DATA);
+	ret = __media_svc_create_query(db_handle, sql);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	/* tag_map of old version. The trigger of tag table refers it */
+	if (__media_svc_is_table(db_handle, MEDIA_SVC_DB_TABLE_TAG_MAP)) {
+		media_svc_debug("tag_map table of old version. migrate it to %s", MEDIA_SVC_DB_TABLE_TAG_MAP_DATA);
+
+		count = __media_svc_count_rows(db_handle, MEDIA_SVC_DB_TABLE_TAG_MAP);
+
+		/* Row of unknown media is not moved */
+		sql = sqlite3_mprintf("INSERT INTO %s (_id, tag_id, media_id) \
+					SELECT t._id, t.tag_id, m.media_id FROM %s AS t INNER JOIN %s AS m ON m.media_uuid=t.media_uuid;",
+					MEDIA_SVC_DB_TABLE_TAG_MAP_DATA, MEDIA_SVC_DB_TABLE_TAG_MAP, MEDIA_SVC_DB_TABLE_MEDIA_DATA);
+		ret = __media_svc_create_query(db_handle, sql);
+		media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+		__media_svc_log_dropped_rows(db_handle, MEDIA_SVC_DB_TABLE_TAG_MAP, count);
+
+		sql = sqlite3_mprintf("DROP TABLE %s; DROP TRIGGER IF EXISTS tag_map_cleanup_1;", MEDIA_SVC_DB_TABLE_TAG_MAP);
+		ret = __media_svc_create_query(db_handle, sql);
+		media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 	}
 
-	/* Create Trigger to remove media from tag_map when media remove from media_table*/
+	/* tag_map view keeps media_uuid of old version */
+	sql = sqlite3_mprintf("CREATE VIEW IF NOT EXISTS %s AS SELECT t._id, t.tag_id, m.media_uuid, t.media_id \
+				FROM %s AS t INNER JOIN %s AS m ON m.media_id=t.media_id \
+				INNER JOIN %s AS s ON s.storage_type=m.storage_type AND s.mounted=1; \
+				CREATE TRIGGER IF NOT EXISTS tag_map_insert INSTEAD OF INSERT ON %s BEGIN \
+				INSERT INTO %s (_id, tag_id, media_id) VALUES (new._id, new.tag_id, \
+				(SELECT media_id FROM %s WHERE media_uuid=new.media_uuid));END; \
+				CREATE TRIGGER IF NOT EXISTS tag_map_update INSTEAD OF UPDATE ON %s BEGIN \
+				UPDATE %s SET tag_id=new.tag_id, media_id=(SELECT media_id FROM %s WHERE media_uuid=new.media_uuid) \
+				WHERE _id=old._id;END; \
+				CREATE TRIGGER IF NOT EXISTS tag_map_delete INSTEAD OF DELETE ON %s BEGIN \
+				DELETE FROM %s WHERE _id=old._id;END;",
+				MEDIA_SVC_DB_TABLE_TAG_MAP, MEDIA_SVC_DB_TABLE_TAG_MAP_DATA, MEDIA_SVC_DB_TABLE_MEDIA_DATA, MEDIA_SVC_DB_TABLE_STORAGE,
+				MEDIA_SVC_DB_TABLE_TAG_MAP, MEDIA_SVC_DB_TABLE_TAG_MAP_DATA, MEDIA_SVC_DB_TABLE_MEDIA_DATA,
+				MEDIA_SVC_DB_TABLE_TAG_MAP, MEDIA_SVC_DB_TABLE_TAG_MAP_DATA, MEDIA_SVC_DB_TABLE_MEDIA_DATA,
+				MEDIA_SVC_DB_TABLE_TAG_MAP, MEDIA_SVC_DB_TABLE_TAG_MAP_DATA);
+	ret = __media_svc_create_query(db_handle, sql);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	/* Create Trigger to remove media from tag_map when media remove from media_data table*/
 	sql = sqlite3_mprintf("CREATE TRIGGER IF NOT EXISTS tag_map_cleanup \
-				DELETE ON %s BEGIN DELETE FROM %s WHERE media_uuid=old.media_uuid;END;",
-				MEDIA_SVC_DB_TABLE_MEDIA, MEDIA_SVC_DB_TABLE_TAG_MAP);
-
-	media_svc_retv_if(sql == NULL, MEDIA_INFO_ERROR_OUT_OF_MEMORY);
-
-	ret = _media_svc_sql_query(db_handle, sql);
-	sqlite3_free(sql);
-	if (ret != SQLITE_OK) {
-		media_svc_error("It failed to create trigger (%d)", ret);
-		return MEDIA_INFO_ERROR_DATABASE_TABLE_OPEN;
-	}
+				DELETE ON %s BEGIN DELETE FROM %s WHERE media_id=old.media_id;END;",
+				MEDIA_SVC_DB_TABLE_MEDIA_DATA, MEDIA_SVC_DB_TABLE_TAG_MAP_DATA);
+	ret = __media_svc_create_query(db_handle, sql);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 
 	/* Create Trigger to remove media from tag_map when tag removed from tag table*/
 	sql = sqlite3_mprintf("CREATE TRIGGER IF NOT EXISTS tag_map_cleanup_1 \
 				DELETE ON %s BEGIN DELETE FROM %s WHERE tag_id=old.tag_id;END;",
-				MEDIA_SVC_DB_TABLE_TAG, MEDIA_SVC_DB_TABLE_TAG_MAP);
+				MEDIA_SVC_DB_TABLE_TAG, MEDIA_SVC_DB_TABLE_TAG_MAP_DATA);
+	ret = __media_svc_create_query(db_handle, sql);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 
-	media_svc_retv_if(sql == NULL, MEDIA_INFO_ERROR_OUT_OF_MEMORY);
-
-	ret = _media_svc_sql_query(db_handle, sql);
-	sqlite3_free(sql);
-	if (ret != SQLITE_OK) {
-		media_svc_error("It failed to create trigger (%d)", ret);
-		return MEDIA_INFO_ERROR_DATABASE_TABLE_OPEN;
-	}
-	return MEDIA_INFO_ERROR_NONE;
+	return __media_svc_create_end_trans(db_handle);
 }
 
 int _media_svc_create_bookmark_table(sqlite3 *db_handle)
@@ -435,10 +1114,10 @@ int _media_svc_create_bookmark_table(sqlite3 *db_handle)
 		return MEDIA_INFO_ERROR_DATABASE_TABLE_OPEN;
 	}
 
-	/* Create Trigger to remove media from tag_map when media remove from media_table*/
+	/* Create Trigger to remove media from tag_map when media remove from media_data table*/
 	sql = sqlite3_mprintf("CREATE TRIGGER IF NOT EXISTS bookmark_cleanup \
 				DELETE ON %s BEGIN DELETE FROM %s WHERE media_uuid=old.media_uuid;END;",
-				MEDIA_SVC_DB_TABLE_MEDIA, MEDIA_SVC_DB_TABLE_BOOKMARK);
+				MEDIA_SVC_DB_TABLE_MEDIA_DATA, MEDIA_SVC_DB_TABLE_BOOKMARK);
 
 	media_svc_retv_if(sql == NULL, MEDIA_INFO_ERROR_OUT_OF_MEMORY);
 
@@ -481,10 +1160,10 @@ int _media_svc_create_custom_table(sqlite3 *db_handle)
 		return MEDIA_INFO_ERROR_DATABASE_TABLE_OPEN;
 	}
 
-	/* Create Trigger to remove media from tag_map when media remove from media_table*/
+	/* Create Trigger to remove media from tag_map when media remove from media_data table*/
 	sql = sqlite3_mprintf("CREATE TRIGGER IF NOT EXISTS custom_cleanup \
 				DELETE ON %s BEGIN DELETE FROM %s WHERE media_uuid=old.media_uuid;END;",
-				MEDIA_SVC_DB_TABLE_MEDIA, MEDIA_SVC_DB_TABLE_CUSTOM);
+				MEDIA_SVC_DB_TABLE_MEDIA_DATA, MEDIA_SVC_DB_TABLE_CUSTOM);
 
 	media_svc_retv_if(sql == NULL, MEDIA_INFO_ERROR_OUT_OF_MEMORY);
 
@@ -512,6 +1191,290 @@ int _media_svc_create_custom_table(sqlite3 *db_handle)
 	return MEDIA_INFO_ERROR_NONE;
 }
 
+int _media_svc_create_thumb_journal_table(sqlite3 *db_handle)
+{
+	int ret = MEDIA_INFO_ERROR_NONE;
+	char * sql = NULL;
+
+	media_svc_debug_func();
+
+	sql = sqlite3_mprintf("CREATE TABLE IF NOT EXISTS %s (\
+				_id				INTEGER PRIMARY KEY AUTOINCREMENT, \
+				src_path		TEXT NOT NULL, \
+				dst_path		TEXT \
+				);",
+				MEDIA_SVC_DB_TABLE_THUMB_JOURNAL);
+
+	media_svc_retv_if(sql == NULL, MEDIA_INFO_ERROR_OUT_OF_MEMORY);
+
+	ret = _media_svc_sql_query(db_handle, sql);
+	sqlite3_free(sql);
+	if (ret != SQLITE_OK) {
+		media_svc_error("It failed to create db table (%d)", ret);
+		return MEDIA_INFO_ERROR_DATABASE_TABLE_OPEN;
+	}
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+/*
+ * visual_media refers its folder by folder_id of visual_folder, so lists join them on integer key instead of folder_uuid string.
+ * The tables are made by older version without the columns, so they are added here and kept by triggers
+ * for the writers which set folder_uuid only. Readers of visual module assume it is done.
+ */
+int _media_svc_create_visual_folder_id(sqlite3 *db_handle)
+{
+	int ret = MEDIA_INFO_ERROR_NONE;
+	char *sql = NULL;
+	sqlite3_stmt *sql_stmt = NULL;
+
+	media_svc_debug_func();
+
+	if (!__media_svc_is_table(db_handle, "visual_media") || !__media_svc_is_table(db_handle, "visual_folder"))
+		return MEDIA_INFO_ERROR_NONE;
+
+	ret = sqlite3_prepare_v2(db_handle, "SELECT folder_id FROM visual_media LIMIT 0;", -1, &sql_stmt, NULL);
+	SQLITE3_FINALIZE(sql_stmt);
+	if (ret == SQLITE_OK)
+		return MEDIA_INFO_ERROR_NONE;
+
+	media_svc_debug("add folder_id to visual_media and visual_folder");
+
+	ret = _media_svc_sql_begin_trans(db_handle);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	sql = sqlite3_mprintf("ALTER TABLE visual_folder ADD COLUMN folder_id INTEGER; \
+				UPDATE visual_folder SET folder_id=rowid; \
+				CREATE UNIQUE INDEX IF NOT EXISTS visual_folder_folder_id_idx ON visual_folder (folder_id); \
+				ALTER TABLE visual_media ADD COLUMN folder_id INTEGER; \
+				UPDATE visual_media SET folder_id=(SELECT folder_id FROM visual_folder AS f \
+				WHERE f.folder_uuid=visual_media.folder_uuid); \
+				CREATE INDEX IF NOT EXISTS visual_media_folder_id_idx ON visual_media (folder_id); \
+				CREATE TRIGGER IF NOT EXISTS visual_folder_folder_id AFTER INSERT ON visual_folder BEGIN \
+				UPDATE visual_folder SET folder_id=(SELECT ifnull(max(folder_id), 0) + 1 FROM visual_folder) \
+				WHERE rowid=new.rowid AND new.folder_id IS NULL; \
+				UPDATE visual_media SET folder_id=(SELECT folder_id FROM visual_folder WHERE rowid=new.rowid) \
+				WHERE folder_uuid=new.folder_uuid;END; \
+				CREATE TRIGGER IF NOT EXISTS visual_media_folder_id_insert AFTER INSERT ON visual_media BEGIN \
+				UPDATE visual_media SET folder_id=(SELECT folder_id FROM visual_folder WHERE folder_uuid=new.folder_uuid) \
+				WHERE rowid=new.rowid;END; \
+				CREATE TRIGGER IF NOT EXISTS visual_media_folder_id_update AFTER UPDATE OF folder_uuid ON visual_media BEGIN \
+				UPDATE visual_media SET folder_id=(SELECT folder_id FROM visual_folder WHERE folder_uuid=new.folder_uuid) \
+				WHERE rowid=new.rowid;END;");
+	ret = __media_svc_create_query(db_handle, sql);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	return __media_svc_create_end_trans(db_handle);
+}
+
+/* columns of legacy tables of audio and visual modules, of which update is logged in change log like media_data.
+ * valid is logged only when it is changed, and storage of visual_media is the one of its folder */
+#define MEDIA_SVC_AUDIO_LOGGED_COLUMNS	"path, thumbnail_path, title, album_dict_id, artist_dict_id, genre_dict_id, author_dict_id, \
+					year_dict_id, copyright, description, \
+					format, bitrate, track_num, duration, rating, played_count, last_played_time, rated_time, album_rating, \
+					modified_date, size, category, folder_uuid, storage_type, favourite"
+#define MEDIA_SVC_VISUAL_LOGGED_COLUMNS	"path, folder_uuid, display_name, content_type, rating, modified_date, thumbnail_path, http_url, size"
+
+static const struct {
+	const char *table;
+	media_svc_change_source_e source;
+	const char *uuid;
+	const char *new_storage;
+	const char *old_storage;
+	const char *columns;
+} g_media_svc_legacy_log[] = {
+	{"audio_media_data", MEDIA_SVC_CHANGE_SOURCE_AUDIO, "audio_uuid", "new.storage_type", "old.storage_type", MEDIA_SVC_AUDIO_LOGGED_COLUMNS},
+	{"visual_media", MEDIA_SVC_CHANGE_SOURCE_VISUAL, "visual_uuid", "(SELECT storage_type FROM visual_folder WHERE folder_uuid=new.folder_uuid)",
+		"(SELECT storage_type FROM visual_folder WHERE folder_uuid=old.folder_uuid)", MEDIA_SVC_VISUAL_LOGGED_COLUMNS},
+};
+
+#define MEDIA_SVC_LEGACY_LOG_CNT	(int)(sizeof(g_media_svc_legacy_log) / sizeof(g_media_svc_legacy_log[0]))
+
+/* "new.column IS NOT old.column OR ..." for the columns of a column list. Free it by sqlite3_free */
+static char *__media_svc_changed_columns_sql(const char *columns)
+{
+	char *sql = NULL;
+	char *prev = NULL;
+	const char *col = columns;
+	int len = 0;
+
+	while (*col != '\0') {
+		col += strspn(col, ", \t\n");
+		len = strcspn(col, ", \t\n");
+		if (len == 0)
+			break;
+
+		prev = sql;
+		sql = sqlite3_mprintf("%s%snew.%.*s IS NOT old.%.*s", (prev != NULL) ? prev : "", (prev != NULL) ? " OR " : "", len, col, len, col);
+		sqlite3_free(prev);
+		if (sql == NULL)
+			return NULL;
+
+		col += len;
+	}
+
+	return sql;
+}
+
+static int __media_svc_create_change_log(sqlite3 *db_handle)
+{
+	int ret = MEDIA_INFO_ERROR_NONE;
+	sqlite3_stmt *sql_stmt = NULL;
+	char *sql = sqlite3_mprintf("CREATE TABLE IF NOT EXISTS %s (\
+				version			INTEGER PRIMARY KEY AUTOINCREMENT, \
+				change_type		INTEGER NOT NULL, \
+				source			INTEGER NOT NULL DEFAULT %d, \
+				storage_type		INTEGER, \
+				media_uuid		TEXT \
+				); \
+				CREATE TRIGGER IF NOT EXISTS change_log_truncate AFTER INSERT ON %s \
+				WHEN new.version %% %d = 0 BEGIN \
+				DELETE FROM %s WHERE version <= new.version - %d;END;",
+				MEDIA_SVC_DB_TABLE_CHANGE_LOG, MEDIA_SVC_CHANGE_SOURCE_MEDIA,
+				MEDIA_SVC_DB_TABLE_CHANGE_LOG, MEDIA_SVC_CHANGE_LOG_TRUNCATE_STEP,
+				MEDIA_SVC_DB_TABLE_CHANGE_LOG, MEDIA_SVC_CHANGE_LOG_MAX);
+
+	ret = __media_svc_create_query(db_handle, sql);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	ret = sqlite3_prepare_v2(db_handle, "SELECT source FROM "MEDIA_SVC_DB_TABLE_CHANGE_LOG" LIMIT 0;", -1, &sql_stmt, NULL);
+	SQLITE3_FINALIZE(sql_stmt);
+	if (ret == SQLITE_OK)
+		return MEDIA_INFO_ERROR_NONE;
+
+	/* Log of older version mixes ID spaces of the tables without source, so it is dropped.
+	 * version is kept by AUTOINCREMENT, and consumers reload their lists as the changes are truncated */
+	media_svc_debug("add source to change log");
+
+	sql = sqlite3_mprintf("ALTER TABLE %s ADD COLUMN source INTEGER NOT NULL DEFAULT %d; DELETE FROM %s;",
+				MEDIA_SVC_DB_TABLE_CHANGE_LOG, MEDIA_SVC_CHANGE_SOURCE_MEDIA, MEDIA_SVC_DB_TABLE_CHANGE_LOG);
+
+	return __media_svc_create_query(db_handle, sql);
+}
+
+/* triggers of a legacy table, named after the table. They are made again, so that an old database gets the current ones */
+static int __media_svc_create_legacy_change_log(sqlite3 *db_handle, int idx)
+{
+	const char *table = g_media_svc_legacy_log[idx].table;
+	int source = g_media_svc_legacy_log[idx].source;
+	const char *uuid = g_media_svc_legacy_log[idx].uuid;
+	const char *new_storage = g_media_svc_legacy_log[idx].new_storage;
+	const char *old_storage = g_media_svc_legacy_log[idx].old_storage;
+	char *changed = NULL;
+	char *sql = NULL;
+
+	changed = __media_svc_changed_columns_sql(g_media_svc_legacy_log[idx].columns);
+	if (changed != NULL) {
+		sql = sqlite3_mprintf("DROP TRIGGER IF EXISTS %s_change_log_insert; \
+				DROP TRIGGER IF EXISTS %s_change_log_delete; \
+				DROP TRIGGER IF EXISTS %s_change_log_validity; \
+				DROP TRIGGER IF EXISTS %s_change_log_update; \
+				CREATE TRIGGER IF NOT EXISTS %s_change_log_insert AFTER INSERT ON %s BEGIN \
+				INSERT INTO %s (change_type, source, storage_type, media_uuid) VALUES (%d, %d, %s, new.%s);END; \
+				CREATE TRIGGER IF NOT EXISTS %s_change_log_delete AFTER DELETE ON %s BEGIN \
+				INSERT INTO %s (change_type, source, storage_type, media_uuid) VALUES (%d, %d, %s, old.%s);END; \
+				CREATE TRIGGER IF NOT EXISTS %s_change_log_validity AFTER UPDATE OF valid ON %s \
+				WHEN new.valid IS NOT old.valid BEGIN \
+				INSERT INTO %s (change_type, source, storage_type, media_uuid) VALUES (%d, %d, %s, new.%s);END; \
+				CREATE TRIGGER IF NOT EXISTS %s_change_log_update AFTER UPDATE ON %s \
+				WHEN new.valid IS old.valid AND (%s) BEGIN \
+				INSERT INTO %s (change_type, source, storage_type, media_uuid) VALUES (%d, %d, %s, new.%s);END;",
+				table, table, table, table,
+				table, table, MEDIA_SVC_DB_TABLE_CHANGE_LOG, MEDIA_SVC_CHANGE_INSERT, source, new_storage, uuid,
+				table, table, MEDIA_SVC_DB_TABLE_CHANGE_LOG, MEDIA_SVC_CHANGE_DELETE, source, old_storage, uuid,
+				table, table, MEDIA_SVC_DB_TABLE_CHANGE_LOG, MEDIA_SVC_CHANGE_UPDATE, source, new_storage, uuid,
+				table, table, changed, MEDIA_SVC_DB_TABLE_CHANGE_LOG, MEDIA_SVC_CHANGE_UPDATE, source, new_storage, uuid);
+		sqlite3_free(changed);
+	}
+
+	return __media_svc_create_query(db_handle, sql);
+}
+
+/* Changes of media_data are logged by triggers, so every path writing media is logged, including the ones of other modules.
+ * Update only stamping scan_gen of found media, or setting a column to the same value, is not logged.
+ * Change of valid_gen or mount state of a storage is logged once for the storage.
+ * They take the default source of media table, so triggers of older version are kept.
+ * Legacy audio_media and visual_media tables are logged by their own triggers, when they exist, with their own source.
+ * A file in media_data and in a legacy table is logged once per table, and consumers filter the changes by source.
+ * version is AUTOINCREMENT, so it is not reused after truncation */
+int _media_svc_create_change_log_table(sqlite3 *db_handle)
+{
+	int ret = MEDIA_INFO_ERROR_NONE;
+	char *changed = NULL;
+	char *sql = NULL;
+	int i = 0;
+
+	media_svc_debug_func();
+
+	ret = _media_svc_sql_begin_trans(db_handle);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	ret = __media_svc_create_change_log(db_handle);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	changed = __media_svc_changed_columns_sql(MEDIA_SVC_MEDIA_LOGGED_COLUMNS);
+	if (changed != NULL) {
+		sql = sqlite3_mprintf("DROP TRIGGER IF EXISTS change_log_update; \
+				CREATE TRIGGER IF NOT EXISTS change_log_insert AFTER INSERT ON %s BEGIN \
+				INSERT INTO %s (change_type, storage_type, media_uuid) VALUES (%d, new.storage_type, new.media_uuid);END; \
+				CREATE TRIGGER IF NOT EXISTS change_log_delete AFTER DELETE ON %s BEGIN \
+				INSERT INTO %s (change_type, storage_type, media_uuid) VALUES (%d, old.storage_type, old.media_uuid);END; \
+				CREATE TRIGGER IF NOT EXISTS change_log_validity AFTER UPDATE OF validity ON %s \
+				WHEN new.validity IS NOT old.validity BEGIN \
+				INSERT INTO %s (change_type, storage_type, media_uuid) VALUES (%d, new.storage_type, new.media_uuid);END; \
+				CREATE TRIGGER IF NOT EXISTS change_log_update AFTER UPDATE OF "MEDIA_SVC_MEDIA_LOGGED_COLUMNS" ON %s \
+				WHEN new.validity IS old.validity AND (%s) BEGIN \
+				INSERT INTO %s (change_type, storage_type, media_uuid) VALUES (%d, new.storage_type, new.media_uuid);END; \
+				CREATE TRIGGER IF NOT EXISTS change_log_storage AFTER UPDATE OF valid_gen, mounted ON %s \
+				WHEN new.valid_gen IS NOT old.valid_gen OR new.mounted IS NOT old.mounted BEGIN \
+				INSERT INTO %s (change_type, storage_type) VALUES (%d, new.storage_type);END;",
+				MEDIA_SVC_DB_TABLE_MEDIA_DATA, MEDIA_SVC_DB_TABLE_CHANGE_LOG, MEDIA_SVC_CHANGE_INSERT,
+				MEDIA_SVC_DB_TABLE_MEDIA_DATA, MEDIA_SVC_DB_TABLE_CHANGE_LOG, MEDIA_SVC_CHANGE_DELETE,
+				MEDIA_SVC_DB_TABLE_MEDIA_DATA, MEDIA_SVC_DB_TABLE_CHANGE_LOG, MEDIA_SVC_CHANGE_UPDATE,
+				MEDIA_SVC_DB_TABLE_MEDIA_DATA, changed, MEDIA_SVC_DB_TABLE_CHANGE_LOG, MEDIA_SVC_CHANGE_UPDATE,
+				MEDIA_SVC_DB_TABLE_STORAGE, MEDIA_SVC_DB_TABLE_CHANGE_LOG, MEDIA_SVC_CHANGE_STORAGE);
+		sqlite3_free(changed);
+	}
+	ret = __media_svc_create_query(db_handle, sql);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	for (i = 0; i < MEDIA_SVC_LEGACY_LOG_CNT; i++) {
+		if (!__media_svc_is_table(db_handle, g_media_svc_legacy_log[i].table))
+			continue;
+
+		ret = __media_svc_create_legacy_change_log(db_handle, i);
+		media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+	}
+
+	return __media_svc_create_end_trans(db_handle);
+}
+
+/* for the modules which make a legacy table after media_svc_create_table */
+int _media_svc_create_legacy_change_log_table(sqlite3 *db_handle, const char *table)
+{
+	int ret = MEDIA_INFO_ERROR_NONE;
+	int i = 0;
+
+	media_svc_retvm_if(table == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "table is NULL");
+
+	for (i = 0; i < MEDIA_SVC_LEGACY_LOG_CNT; i++) {
+		if (strcmp(g_media_svc_legacy_log[i].table, table) == 0)
+			break;
+	}
+	media_svc_retvm_if(i == MEDIA_SVC_LEGACY_LOG_CNT, MEDIA_INFO_ERROR_INVALID_PARAMETER, "not a legacy table [%s]", table);
+
+	ret = _media_svc_sql_begin_trans(db_handle);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	ret = __media_svc_create_change_log(db_handle);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	ret = __media_svc_create_legacy_change_log(db_handle, i);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	return __media_svc_create_end_trans(db_handle);
+}
+
 int _media_svc_sql_query(sqlite3 *db_handle, const char *sql_str)
 {
 	int err = -1;
@@ -559,13 +1522,268 @@ int _media_svc_sql_prepare_to_step(sqlite3 *handle, const char *sql_str, sqlite3
 	return MEDIA_INFO_ERROR_NONE;
 }
 
+static unsigned long long __media_svc_get_usec(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (unsigned long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* Commits the work of scan session. A busy commit keeps the transaction, so it is tried again.
+ * On failure the transaction is open unless sqlite rolled it back by the error */
+static int __media_svc_scan_session_commit(sqlite3 *handle)
+{
+	int ret = SQLITE_OK;
+	int i = 0;
+
+	for (i = 0; i < MEDIA_SVC_SCAN_SESSION_COMMIT_RETRY; i++) {
+		ret = sqlite3_exec(handle, "COMMIT;", NULL, NULL, NULL);
+		if (ret != SQLITE_BUSY && ret != SQLITE_LOCKED)
+			break;
+	}
+
+	if (ret != SQLITE_OK) {
+		media_svc_error("failed to commit scan session [%s]", sqlite3_errmsg(handle));
+		return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
+	}
+
+	_media_svc_thumb_journal_process();
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+static int __media_svc_scan_session_open(sqlite3 *handle, media_svc_db_ctx_s *ctx)
+{
+	if (sqlite3_exec(handle, "BEGIN IMMEDIATE;", NULL, NULL, NULL) != SQLITE_OK) {
+		media_svc_error("failed to open transaction of scan session [%s]", sqlite3_errmsg(handle));
+		return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
+	}
+
+	ctx->scan_open = TRUE;
+	ctx->session_usec = __media_svc_get_usec();
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+/* Checks that sqlite did not roll back the transaction of scan session by an error, such as a full disk.
+ * Work of the session since last commit is lost then. It is never opened again silently, so the loss is reported */
+static int __media_svc_scan_session_check(sqlite3 *handle, media_svc_db_ctx_s *ctx)
+{
+	if (!ctx->scan_open || !sqlite3_get_autocommit(handle))
+		return MEDIA_INFO_ERROR_NONE;
+
+	media_svc_error("transaction of scan session is rolled back. its work since last commit is lost");
+	ctx->scan_open = FALSE;
+	ctx->scan_lost = TRUE;
+
+	return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
+}
+
+/* Commits the work of scan session when the lock is held longer than target, so that the lock is not held while caller is idle.
+ * A busy commit keeps the work in the transaction, and it is tried again by next leave or by session end */
+static void __media_svc_scan_session_release(sqlite3 *handle, media_svc_db_ctx_s *ctx)
+{
+	if (!ctx->scan_open || sqlite3_get_autocommit(handle))
+		return;
+
+	if (__media_svc_get_usec() - ctx->session_usec < (unsigned long long)ctx->max_lock_hold_usec)
+		return;
+
+	if (__media_svc_scan_session_commit(handle) == MEDIA_INFO_ERROR_NONE)
+		ctx->scan_open = FALSE;
+}
+
+/* Forgets the handle holding the session requested by media_svc_scan_update_begin */
+static void __media_svc_scan_session_forget(sqlite3 *handle)
+{
+	pthread_mutex_lock(&g_scan_session_mutex);
+	if (g_scan_handle == handle)
+		g_scan_handle = NULL;
+	pthread_mutex_unlock(&g_scan_session_mutex);
+}
+
+/* Transaction of one API call.
+ * When the connection already holds a transaction, of scan session or of the caller, it is a savepoint of it */
+int _media_svc_sql_trans(sqlite3 *handle, media_svc_trans_op_e op, char **err_msg)
+{
+	int ret = SQLITE_OK;
+	media_svc_db_ctx_s *ctx = _media_svc_db_ctx_get(handle);
+
+	if (ctx == NULL) {
+		if (op == MEDIA_SVC_TRANS_BEGIN)
+			return sqlite3_exec(handle, "BEGIN IMMEDIATE;", NULL, NULL, err_msg);
+		else if (op == MEDIA_SVC_TRANS_COMMIT)
+			return sqlite3_exec(handle, "COMMIT;", NULL, NULL, err_msg);
+		else
+			return sqlite3_exec(handle, "ROLLBACK;", NULL, NULL, err_msg);
+	}
+
+	if (op == MEDIA_SVC_TRANS_BEGIN) {
+		if (ctx->trans_depth == 0 && sqlite3_get_autocommit(handle))
+			return sqlite3_exec(handle, "BEGIN IMMEDIATE;", NULL, NULL, err_msg);
+
+		ret = sqlite3_exec(handle, "SAVEPOINT media_svc_call;", NULL, NULL, err_msg);
+		if (ret == SQLITE_OK)
+			ctx->trans_depth++;
+	} else if (op == MEDIA_SVC_TRANS_COMMIT) {
+		if (ctx->trans_depth == 0)
+			return sqlite3_exec(handle, "COMMIT;", NULL, NULL, err_msg);
+
+		/* On failure caller rolls it back */
+		ret = sqlite3_exec(handle, "RELEASE media_svc_call;", NULL, NULL, err_msg);
+		if (ret == SQLITE_OK)
+			ctx->trans_depth--;
+	} else {
+		if (ctx->trans_depth == 0)
+			return sqlite3_exec(handle, "ROLLBACK;", NULL, NULL, err_msg);
+
+		ret = sqlite3_exec(handle, "ROLLBACK TO media_svc_call; RELEASE media_svc_call;", NULL, NULL, err_msg);
+		ctx->trans_depth--;
+
+		/* rollback hook is not called for a savepoint. counts cached in it may include the rolled back changes */
+		ctx->rollback_serial++;
+	}
+
+	return ret;
+}
+
+int _media_svc_scan_session_begin(sqlite3 *db_handle)
+{
+	int ret = MEDIA_INFO_ERROR_NONE;
+	media_svc_db_ctx_s *ctx = _media_svc_db_ctx_get(db_handle);
+
+	media_svc_retvm_if(ctx == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is not connected");
+	media_svc_retvm_if(ctx->scan_session, MEDIA_INFO_ERROR_INVALID_PARAMETER, "scan session is already started");
+	media_svc_retvm_if(!sqlite3_get_autocommit(db_handle), MEDIA_INFO_ERROR_INVALID_PARAMETER, "transaction is in progress");
+
+	ret = __media_svc_scan_session_open(db_handle, ctx);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	ctx->scan_session = TRUE;
+	ctx->scan_lost = FALSE;
+	ctx->trans_depth = 0;
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+int _media_svc_scan_session_end(sqlite3 *db_handle)
+{
+	media_svc_db_ctx_s *ctx = _media_svc_db_ctx_get(db_handle);
+
+	media_svc_retvm_if(ctx == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is not connected");
+	media_svc_retvm_if(!ctx->scan_session, MEDIA_INFO_ERROR_INVALID_PARAMETER, "scan session is not started");
+	media_svc_retvm_if(ctx->trans_depth > 0, MEDIA_INFO_ERROR_INVALID_PARAMETER, "transaction is in progress");
+
+	__media_svc_scan_session_check(db_handle, ctx);
+
+	if (!ctx->scan_open) {
+		_media_svc_thumb_journal_process();
+	} else if (__media_svc_scan_session_commit(db_handle) == MEDIA_INFO_ERROR_NONE) {
+		ctx->scan_open = FALSE;
+	} else if (__media_svc_scan_session_check(db_handle, ctx) == MEDIA_INFO_ERROR_NONE) {
+		/* the session is kept with its work, so that caller can end it again */
+		return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
+	}
+
+	ctx->scan_session = FALSE;
+	__media_svc_scan_session_forget(db_handle);
+
+	if (ctx->scan_lost) {
+		ctx->scan_lost = FALSE;
+		return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
+	}
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+/* Called before each write call of the handle. Begins the session requested by media_svc_scan_update_begin,
+ * or opens the transaction of the session again after it is committed by leave.
+ * The requested session is begun only by the thread which requested it, and only one handle holds it,
+ * so that writers on other handles are not blocked by it until update end */
+int _media_svc_scan_session_enter(sqlite3 *db_handle)
+{
+	int ret = MEDIA_INFO_ERROR_NONE;
+	media_svc_db_ctx_s *ctx = _media_svc_db_ctx_get(db_handle);
+
+	media_svc_retvm_if(ctx == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is not connected");
+
+	if (ctx->scan_session) {
+		if (ctx->trans_depth > 0)
+			return MEDIA_INFO_ERROR_NONE;
+
+		/* items written since last commit are lost. caller writes them again */
+		ret = __media_svc_scan_session_check(db_handle, ctx);
+		media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+		/* caller which does not call leave still releases the lock here */
+		__media_svc_scan_session_release(db_handle, ctx);
+		if (!ctx->scan_open)
+			ret = __media_svc_scan_session_open(db_handle, ctx);
+
+		return ret;
+	}
+
+	if (!sqlite3_get_autocommit(db_handle))
+		return MEDIA_INFO_ERROR_NONE;
+
+	pthread_mutex_lock(&g_scan_session_mutex);
+	if (g_scan_requested && g_scan_handle == NULL && pthread_equal(g_scan_thread, pthread_self())) {
+		ret = _media_svc_scan_session_begin(db_handle);
+		if (ret == MEDIA_INFO_ERROR_NONE)
+			g_scan_handle = db_handle;
+	}
+	pthread_mutex_unlock(&g_scan_session_mutex);
+
+	return ret;
+}
+
+/* Called after each write call of the handle */
+int _media_svc_scan_session_leave(sqlite3 *db_handle)
+{
+	media_svc_db_ctx_s *ctx = _media_svc_db_ctx_get(db_handle);
+
+	media_svc_retvm_if(ctx == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is not connected");
+
+	if (ctx->scan_session && ctx->trans_depth == 0)
+		__media_svc_scan_session_release(db_handle, ctx);
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+/* Requests a scan session for writes of the calling thread */
+void _media_svc_scan_update_begin(void)
+{
+	pthread_mutex_lock(&g_scan_session_mutex);
+	g_scan_requested = TRUE;
+	g_scan_thread = pthread_self();
+	pthread_mutex_unlock(&g_scan_session_mutex);
+}
+
+/* Ends the requested session. Sessions begun by media_svc_scan_session_begin are ended by their callers */
+int _media_svc_scan_update_end(void)
+{
+	sqlite3 *handle = NULL;
+
+	pthread_mutex_lock(&g_scan_session_mutex);
+	g_scan_requested = FALSE;
+	handle = g_scan_handle;
+	pthread_mutex_unlock(&g_scan_session_mutex);
+
+	if (handle == NULL)
+		return MEDIA_INFO_ERROR_NONE;
+
+	return _media_svc_scan_session_end(handle);
+}
+
 int _media_svc_sql_begin_trans(sqlite3 *handle)
 {
 	char *err_msg = NULL;
 
 	media_svc_debug("========_media_svc_sql_begin_trans");
 
-	if (SQLITE_OK != sqlite3_exec(handle, "BEGIN IMMEDIATE;", NULL, NULL, &err_msg)) {
+	if (SQLITE_OK != _media_svc_sql_trans(handle, MEDIA_SVC_TRANS_BEGIN, &err_msg)) {
 		media_svc_error("Error:failed to begin transaction: error=%s", err_msg);
 		sqlite3_free(err_msg);
 		return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
@@ -582,7 +1800,7 @@ int _media_svc_sql_end_trans(sqlite3 *handle)
 
 	media_svc_debug("========_media_svc_sql_end_trans");
 
-	if (SQLITE_OK != sqlite3_exec(handle, "COMMIT;", NULL, NULL, &err_msg)) {
+	if (SQLITE_OK != _media_svc_sql_trans(handle, MEDIA_SVC_TRANS_COMMIT, &err_msg)) {
 		media_svc_error("Error:failed to end transaction: error=%s", err_msg);
 		sqlite3_free(err_msg);
 		return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
@@ -599,7 +1817,7 @@ int _media_svc_sql_rollback_trans(sqlite3 *handle)
 
 	media_svc_debug("========_media_svc_sql_rollback_trans");
 
-	if (SQLITE_OK != sqlite3_exec(handle, "ROLLBACK;", NULL, NULL, &err_msg)) {
+	if (SQLITE_OK != _media_svc_sql_trans(handle, MEDIA_SVC_TRANS_ROLLBACK, &err_msg)) {
 		media_svc_error("Error:failed to rollback transaction: error=%s", err_msg);
 		sqlite3_free(err_msg);
 		return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
@@ -612,15 +1830,17 @@ int _media_svc_sql_rollback_trans(sqlite3 *handle)
 
 int _media_svc_sql_query_list(sqlite3 *handle, GList **query_list)
 {
-	int i = 0;
-	int length = g_list_length(*query_list);
+	GList *iter = NULL;
 	int err = -1;
 	char *sql = NULL;
 
-	media_svc_debug("query list length : [%d]", length);
+	/* Queries are prepended when stacked, so restore the order first */
+	*query_list = g_list_reverse(*query_list);
+
+	media_svc_debug("query list length : [%d]", g_list_length(*query_list));
 
-	for (i = 0; i < length; i++) {
-		sql = (char*)g_list_nth_data(*query_list, i);
+	for (iter = *query_list; iter != NULL; iter = g_list_next(iter)) {
+		sql = (char*)iter->data;
 		if(sql != NULL) {
 			err = _media_svc_sql_query(handle, sql);
 
@@ -628,7 +1848,7 @@ int _media_svc_sql_query_list(sqlite3 *handle, GList **query_list)
 				media_svc_error("A query failed in batch");
 			}
 			sqlite3_free(sql);
-			sql = NULL;
+			iter->data = NULL;
 		}
 	}
 
@@ -640,7 +1860,7 @@ int _media_svc_sql_query_list(sqlite3 *handle, GList **query_list)
 
 void _media_svc_sql_query_add(GList **query_list, char **query)
 {
-	*query_list = g_list_append( *query_list, *query);
+	*query_list = g_list_prepend( *query_list, *query);
 }
 
 void _media_svc_sql_query_release(GList **query_list)
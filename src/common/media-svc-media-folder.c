@@ -26,15 +26,14 @@
 #include "media-svc-env.h"
 #include "media-svc-util.h"
 #include "media-svc-db-utils.h"
-
-extern __thread GList *g_media_svc_move_item_query_list;
+#include "media-svc-media.h"
 
 int _media_svc_get_folder_id_by_foldername(sqlite3 *handle, const char *folder_name, char *folder_id)
 {
 	int ret = MEDIA_INFO_ERROR_NONE;
 	sqlite3_stmt *sql_stmt = NULL;
 
-	char *sql = sqlite3_mprintf("SELECT folder_uuid FROM %s WHERE path = '%q';", MEDIA_SVC_DB_TABLE_FOLDER, folder_name);
+	char *sql = sqlite3_mprintf("SELECT folder_uuid FROM %s WHERE path = '%q';", MEDIA_SVC_DB_TABLE_FOLDER_DATA, folder_name);
 
 	ret = _media_svc_sql_prepare_to_step(handle, sql, &sql_stmt);
 
@@ -61,7 +60,7 @@ int _media_svc_append_folder(sqlite3 *handle, media_svc_storage_type_e storage_t
 	int err = -1;
 
 	char *sql = sqlite3_mprintf("INSERT INTO %s (folder_uuid, path, name, storage_type, modified_time) values (%Q, %Q, %Q, '%d', '%d'); ",
-					     MEDIA_SVC_DB_TABLE_FOLDER, folder_id, path_name, folder_name, storage_type, modified_date);
+					     MEDIA_SVC_DB_TABLE_FOLDER_DATA, folder_id, path_name, folder_name, storage_type, modified_date);
 	err = _media_svc_sql_query(handle, sql);
 	sqlite3_free(sql);
 	if (err != SQLITE_OK) {
@@ -79,7 +78,7 @@ int _media_svc_update_folder_modified_time_by_folder_uuid(sqlite3 *handle, const
 
 	modified_time = _media_svc_get_file_time(folder_path);
 
-	char *sql = sqlite3_mprintf("UPDATE %s SET modified_time=%d WHERE folder_uuid=%Q;", MEDIA_SVC_DB_TABLE_FOLDER, modified_time, folder_uuid);
+	char *sql = sqlite3_mprintf("UPDATE %s SET modified_time=%d WHERE folder_uuid=%Q;", MEDIA_SVC_DB_TABLE_FOLDER_DATA, modified_time, folder_uuid);
 
 	if(!stack_query) {
 		err = _media_svc_sql_query(handle, sql);
@@ -89,7 +88,8 @@ int _media_svc_update_folder_modified_time_by_folder_uuid(sqlite3 *handle, const
 			return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
 		}
 	} else {
-		_media_svc_sql_query_add(&g_media_svc_move_item_query_list, &sql);
+		err = _media_svc_stack_query(handle, MEDIA_SVC_QUERY_MOVE_ITEM, &sql);
+		media_svc_retv_if(err != MEDIA_INFO_ERROR_NONE, err);
 	}
 
 	return MEDIA_INFO_ERROR_NONE;
@@ -107,8 +107,8 @@ int _media_svc_get_and_append_folder_id_by_path(sqlite3 *handle, const char *pat
 	if(ret == MEDIA_INFO_ERROR_DATABASE_NO_RECORD) {
 		char *folder_name = NULL;
 		int folder_modified_date = 0;
-		char *folder_uuid = _media_info_generate_uuid();
-		if(folder_uuid == NULL ) {
+		char folder_uuid[MEDIA_SVC_UUID_SIZE+1] = {0,};
+		if(_media_svc_generate_uuid(folder_uuid, sizeof(folder_uuid)) != MEDIA_INFO_ERROR_NONE) {
 			media_svc_error("Invalid UUID");
 			SAFE_FREE(path_name);
 			return MEDIA_INFO_ERROR_INTERNAL;
@@ -132,8 +132,8 @@ int _media_svc_update_folder_table(sqlite3 *handle)
 	int err = -1;
 	char *sql = NULL;
 
-	sql = sqlite3_mprintf("DELETE FROM %s WHERE folder_uuid IN (SELECT folder_uuid FROM %s WHERE folder_uuid NOT IN (SELECT folder_uuid FROM %s))",
-	     MEDIA_SVC_DB_TABLE_FOLDER, MEDIA_SVC_DB_TABLE_FOLDER, MEDIA_SVC_DB_TABLE_MEDIA);
+	sql = sqlite3_mprintf("DELETE FROM %s WHERE folder_id NOT IN (SELECT folder_id FROM %s)",
+	     MEDIA_SVC_DB_TABLE_FOLDER_DATA, MEDIA_SVC_DB_TABLE_MEDIA_DATA);
 
 	err = _media_svc_sql_query(handle, sql);
 	sqlite3_free(sql);
@@ -144,3 +144,30 @@ int _media_svc_update_folder_table(sqlite3 *handle)
 
 	return MEDIA_INFO_ERROR_NONE;
 }
+
+int _media_svc_update_folder_path_by_prefix(sqlite3 *handle, const char *src_path, const char *dst_path, int modified_time)
+{
+	int err = -1;
+	char *folder_name = NULL;
+	char *sql = NULL;
+
+	folder_name = g_path_get_basename(dst_path);
+
+	/* The folder itself and all folders under it. Range on path is served by the index of path */
+	sql = sqlite3_mprintf("UPDATE %s SET \
+				name = CASE WHEN path = '%q' THEN %Q ELSE name END, \
+				path = '%q' || substr(path, length('%q') + 1), modified_time = %d \
+				WHERE path = '%q' OR (path >= '%q/' AND path < '%q0');",
+				MEDIA_SVC_DB_TABLE_FOLDER_DATA, src_path, folder_name, dst_path, src_path, modified_time, src_path, src_path, src_path);
+
+	SAFE_FREE(folder_name);
+
+	err = _media_svc_sql_query(handle, sql);
+	sqlite3_free(sql);
+	if (err != SQLITE_OK) {
+		media_svc_error("failed to update folder path");
+		return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
+	}
+
+	return MEDIA_INFO_ERROR_NONE;
+}
@@ -20,58 +20,84 @@
  */
 
 #include <string.h>
+#include <time.h>
 #include "media-svc-media.h"
 #include "media-svc-media-folder.h"
 #include "media-svc-error.h"
 #include "media-svc-debug.h"
 #include "media-svc-util.h"
 #include "media-svc-db-utils.h"
+#include "media-svc-thumb-journal.h"
+#include "media-svc-db-ctx.h"
+
+/* dictionary id of the value of the kind, NULL when the value is NULL */
+#define MEDIA_SVC_META_DICT_ID	"(SELECT dict_id FROM "MEDIA_SVC_DB_TABLE_META_DICT" WHERE kind=%d AND value=%Q)"
+/* folder_id of the folder uuid */
+#define MEDIA_SVC_FOLDER_ID		"(SELECT folder_id FROM "MEDIA_SVC_DB_TABLE_FOLDER_DATA" WHERE folder_uuid=%Q)"
+/* current scan generation of the storage type */
+#define MEDIA_SVC_SCAN_GEN		"(SELECT scan_gen FROM "MEDIA_SVC_DB_TABLE_STORAGE" WHERE storage_type=%d)"
+/* condition of valid media in media_data. Media is valid until its storage starts a scan of newer generation */
+#define MEDIA_SVC_VALID_MEDIA	"validity=1 AND scan_gen>=(SELECT valid_gen FROM "MEDIA_SVC_DB_TABLE_STORAGE" \
+					WHERE storage_type="MEDIA_SVC_DB_TABLE_MEDIA_DATA".storage_type)"
+
+static void __media_svc_thumb_path_func(sqlite3_context *context, int argc, sqlite3_value **argv);
+
+/* SQL function : thumbnail path of the given media path */
+static void __media_svc_thumb_path_func(sqlite3_context *context, int argc, sqlite3_value **argv)
+{
+	const char *path = NULL;
+	char thumb_path[MEDIA_SVC_PATHNAME_SIZE] = {0,};
+	media_svc_storage_type_e storage_type = MEDIA_SVC_STORAGE_INTERNAL;
+
+	if (argc != 1) {
+		sqlite3_result_null(context);
+		return;
+	}
+
+	path = (const char *)sqlite3_value_text(argv[0]);
 
-typedef struct{
-	char thumbnail_path[MEDIA_SVC_PATHNAME_SIZE];
-}media_svc_thumbnailpath_s;
+	if (_media_svc_get_store_type_by_path(path, &storage_type) != MEDIA_INFO_ERROR_NONE) {
+		sqlite3_result_null(context);
+		return;
+	}
 
-static __thread GList *g_media_svc_item_validity_query_list = NULL;
-static __thread GList *g_media_svc_insert_item_query_list = NULL;
-__thread GList *g_media_svc_move_item_query_list = NULL;
+	if (_media_svc_get_thumbnail_path(storage_type, thumb_path, path, THUMB_EXT) == FALSE) {
+		sqlite3_result_null(context);
+		return;
+	}
 
-static int __media_svc_count_invalid_records_with_thumbnail(sqlite3 *handle, media_svc_storage_type_e storage_type, int *count);
-static int __media_svc_get_invalid_records_with_thumbnail(sqlite3 *handle, media_svc_storage_type_e storage_type,
-							int count, media_svc_thumbnailpath_s * thumb_path);
+	sqlite3_result_text(context, thumb_path, -1, SQLITE_TRANSIENT);
+}
 
-static int __media_svc_count_invalid_records_with_thumbnail(sqlite3 *handle, media_svc_storage_type_e storage_type, int *count)
+int _media_svc_count_record_with_path(sqlite3 *handle, const char *path, int *count)
 {
 	int ret = MEDIA_INFO_ERROR_NONE;
 	sqlite3_stmt *sql_stmt = NULL;
-	char *sql = sqlite3_mprintf("SELECT count(*) FROM %s WHERE validity=0 AND storage_type=%d AND thumbnail_path IS NOT NULL",
-					MEDIA_SVC_DB_TABLE_MEDIA, storage_type);
+
+	char *sql = sqlite3_mprintf("SELECT count(*) FROM %s WHERE path='%q'", MEDIA_SVC_DB_TABLE_MEDIA_DATA, path);
 
 	ret = _media_svc_sql_prepare_to_step(handle, sql, &sql_stmt);
 
-	if (ret != MEDIA_INFO_ERROR_NONE) {
-		media_svc_error("error when __media_svc_count_invalid_records_with_thumbnail. err = [%d]", ret);
-		return ret;
-	}
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 
 	*count = sqlite3_column_int(sql_stmt, 0);
 
 	SQLITE3_FINALIZE(sql_stmt);
 
 	return MEDIA_INFO_ERROR_NONE;
-
 }
 
-static int __media_svc_get_invalid_records_with_thumbnail(sqlite3 *handle, media_svc_storage_type_e storage_type,
-							int count, media_svc_thumbnailpath_s * thumb_path)
+/* Finds the state of each file with one prepared statement, in one read transaction */
+int _media_svc_check_items(sqlite3 *handle, media_svc_item_check_s *items, int count)
 {
+	int ret = MEDIA_INFO_ERROR_NONE;
 	int err = -1;
-	int idx = 0;
+	int i = 0;
+	bool own_trans = FALSE;
 	sqlite3_stmt *sql_stmt = NULL;
+	char *sql = sqlite3_mprintf("SELECT size, modified_time FROM %s WHERE path=?", MEDIA_SVC_DB_TABLE_MEDIA_DATA);
 
-	char *sql = sqlite3_mprintf("select thumbnail_path from %s WHERE validity=0 AND storage_type=%d AND thumbnail_path IS NOT NULL",
-					MEDIA_SVC_DB_TABLE_MEDIA, storage_type);
-
-	media_svc_debug("[SQL query] : %s", sql);
+	media_svc_retv_if(sql == NULL, MEDIA_INFO_ERROR_OUT_OF_MEMORY);
 
 	err = sqlite3_prepare_v2(handle, sql, -1, &sql_stmt, NULL);
 	sqlite3_free(sql);
@@ -80,49 +106,201 @@ static int __media_svc_get_invalid_records_with_thumbnail(sqlite3 *handle, media
 		return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
 	}
 
-	while (sqlite3_step(sql_stmt) == SQLITE_ROW) {
-		_strncpy_safe(thumb_path[idx].thumbnail_path, (const char *)sqlite3_column_text(sql_stmt, 0), sizeof(thumb_path[idx]));
-		media_svc_debug("thumb_path[%d]=[%s]", idx, thumb_path[idx].thumbnail_path);
-		idx++;
+	/* All files are checked with the same snapshot, and the read lock is taken once */
+	if (sqlite3_get_autocommit(handle)) {
+		own_trans = (_media_svc_sql_query(handle, "BEGIN DEFERRED;") == SQLITE_OK);
+	}
+
+	for (i = 0; i < count; i++) {
+		sqlite3_bind_text(sql_stmt, 1, items[i].path, -1, SQLITE_STATIC);
+
+		err = sqlite3_step(sql_stmt);
+		if (err == SQLITE_ROW) {
+			if (((unsigned long long)sqlite3_column_int64(sql_stmt, 0) == items[i].size) &&
+				(sqlite3_column_int64(sql_stmt, 1) == (sqlite3_int64)items[i].modified_time)) {
+				items[i].state = MEDIA_SVC_ITEM_STATE_UNCHANGED;
+			} else {
+				items[i].state = MEDIA_SVC_ITEM_STATE_MODIFIED;
+			}
+		} else if (err == SQLITE_DONE) {
+			items[i].state = MEDIA_SVC_ITEM_STATE_NEW;
+		} else {
+			media_svc_error("failed to check [%s] [%s]", items[i].path, sqlite3_errmsg(handle));
+			ret = MEDIA_INFO_ERROR_DATABASE_INTERNAL;
+			break;
+		}
+
+		sqlite3_reset(sql_stmt);
 	}
 
 	SQLITE3_FINALIZE(sql_stmt);
 
+	if (own_trans) {
+		if (ret == MEDIA_INFO_ERROR_NONE && _media_svc_sql_query(handle, "COMMIT;") != SQLITE_OK) {
+			media_svc_error("failed to end read transaction [%s]", sqlite3_errmsg(handle));
+			ret = MEDIA_INFO_ERROR_DATABASE_INTERNAL;
+		}
+
+		if (ret != MEDIA_INFO_ERROR_NONE)
+			_media_svc_sql_query(handle, "ROLLBACK;");
+	}
+
+	return ret;
+}
+
+/* Version of database is the last version of change log. It is kept in sqlite_sequence, even after the log is truncated */
+int _media_svc_get_change_version(sqlite3 *handle, long long *version)
+{
+	int err = -1;
+	sqlite3_stmt *sql_stmt = NULL;
+
+	err = _media_svc_db_ctx_prepare_stmt(handle, "SELECT seq FROM sqlite_sequence WHERE name='"MEDIA_SVC_DB_TABLE_CHANGE_LOG"'", &sql_stmt);
+	if (err != SQLITE_OK) {
+		media_svc_error("prepare error [%s]", sqlite3_errmsg(handle));
+		return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
+	}
+
+	err = sqlite3_step(sql_stmt);
+	if (err == SQLITE_ROW) {
+		*version = sqlite3_column_int64(sql_stmt, 0);
+	} else if (err == SQLITE_DONE) {
+		*version = 0;
+	} else {
+		media_svc_error("failed to get change version [%s]", sqlite3_errmsg(handle));
+		_media_svc_db_ctx_release_stmt(sql_stmt);
+		return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
+	}
+
+	_media_svc_db_ctx_release_stmt(sql_stmt);
+
 	return MEDIA_INFO_ERROR_NONE;
 }
 
-int _media_svc_count_record_with_path(sqlite3 *handle, const char *path, int *count)
+/* Changes after since_version, oldest first. When changes of the range are truncated already,
+ * MEDIA_INFO_ERROR_DATABASE_INVALID is returned and the caller should reload its lists */
+int _media_svc_get_changes(sqlite3 *handle, long long since_version, media_svc_change_s *changes, int max_count, int *count)
 {
 	int ret = MEDIA_INFO_ERROR_NONE;
+	int err = -1;
+	int idx = 0;
+	bool own_trans = FALSE;
+	long long version = 0;
+	long long oldest = 0;
 	sqlite3_stmt *sql_stmt = NULL;
 
-	char *sql = sqlite3_mprintf("SELECT count(*) FROM %s WHERE path='%q'", MEDIA_SVC_DB_TABLE_MEDIA, path);
+	*count = 0;
 
-	ret = _media_svc_sql_prepare_to_step(handle, sql, &sql_stmt);
+	/* Truncation check and the changes are read in the same snapshot */
+	if (sqlite3_get_autocommit(handle)) {
+		own_trans = (_media_svc_sql_query(handle, "BEGIN DEFERRED;") == SQLITE_OK);
+	}
 
-	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+	ret = _media_svc_get_change_version(handle, &version);
+	if (ret != MEDIA_INFO_ERROR_NONE)
+		goto END;
 
-	*count = sqlite3_column_int(sql_stmt, 0);
+	if (since_version >= version) {
+		if (since_version > version) {
+			media_svc_error("version [%lld] is newer than database [%lld]", since_version, version);
+			ret = MEDIA_INFO_ERROR_DATABASE_INVALID;
+		}
+		goto END;
+	}
 
-	SQLITE3_FINALIZE(sql_stmt);
+	err = _media_svc_db_ctx_prepare_stmt(handle, "SELECT min(version) FROM "MEDIA_SVC_DB_TABLE_CHANGE_LOG, &sql_stmt);
+	if (err != SQLITE_OK || sqlite3_step(sql_stmt) != SQLITE_ROW) {
+		media_svc_error("failed to get oldest change [%s]", sqlite3_errmsg(handle));
+		ret = MEDIA_INFO_ERROR_DATABASE_INTERNAL;
+		goto END;
+	}
 
-	return MEDIA_INFO_ERROR_NONE;
+	oldest = (sqlite3_column_type(sql_stmt, 0) == SQLITE_NULL) ? version + 1 : sqlite3_column_int64(sql_stmt, 0);
+	_media_svc_db_ctx_release_stmt(sql_stmt);
+	sql_stmt = NULL;
+
+	if (since_version + 1 < oldest) {
+		media_svc_debug("changes after [%lld] are truncated. oldest is [%lld]", since_version, oldest);
+		ret = MEDIA_INFO_ERROR_DATABASE_INVALID;
+		goto END;
+	}
+
+	err = _media_svc_db_ctx_prepare_stmt(handle, "SELECT version, change_type, source, storage_type, media_uuid FROM "MEDIA_SVC_DB_TABLE_CHANGE_LOG" \
+				WHERE version>? ORDER BY version LIMIT ?", &sql_stmt);
+	if (err != SQLITE_OK) {
+		media_svc_error("prepare error [%s]", sqlite3_errmsg(handle));
+		ret = MEDIA_INFO_ERROR_DATABASE_INTERNAL;
+		goto END;
+	}
+
+	sqlite3_bind_int64(sql_stmt, 1, since_version);
+	sqlite3_bind_int(sql_stmt, 2, max_count);
+
+	while ((err = sqlite3_step(sql_stmt)) == SQLITE_ROW) {
+		memset(&changes[idx], 0, sizeof(media_svc_change_s));
+		changes[idx].version = sqlite3_column_int64(sql_stmt, 0);
+		changes[idx].change_type = sqlite3_column_int(sql_stmt, 1);
+		changes[idx].source = sqlite3_column_int(sql_stmt, 2);
+		changes[idx].storage_type = sqlite3_column_int(sql_stmt, 3);
+		if (sqlite3_column_type(sql_stmt, 4) != SQLITE_NULL)
+			_strncpy_safe(changes[idx].media_uuid, (const char *)sqlite3_column_text(sql_stmt, 4), sizeof(changes[idx].media_uuid));
+		idx++;
+	}
+
+	if (err != SQLITE_DONE) {
+		media_svc_error("failed to get changes [%s]", sqlite3_errmsg(handle));
+		ret = MEDIA_INFO_ERROR_DATABASE_INTERNAL;
+		goto END;
+	}
+
+	*count = idx;
+
+END:
+	if (sql_stmt != NULL)
+		_media_svc_db_ctx_release_stmt(sql_stmt);
+
+	if (own_trans)
+		_media_svc_sql_query(handle, "COMMIT;");
+
+	return ret;
+}
+
+/* Interns album, artist, genre, composer and year of the content in meta_dict table */
+static char *__media_svc_intern_meta_sql(media_svc_content_meta_s *meta)
+{
+	return sqlite3_mprintf("INSERT OR IGNORE INTO %s (kind, value) SELECT kind, value FROM \
+				(SELECT %d AS kind, %Q AS value UNION ALL SELECT %d, %Q UNION ALL SELECT %d, %Q \
+				UNION ALL SELECT %d, %Q UNION ALL SELECT %d, %Q) WHERE value IS NOT NULL;",
+				MEDIA_SVC_DB_TABLE_META_DICT,
+				MEDIA_SVC_META_DICT_ALBUM, meta->album,
+				MEDIA_SVC_META_DICT_ARTIST, meta->artist,
+				MEDIA_SVC_META_DICT_GENRE, meta->genre,
+				MEDIA_SVC_META_DICT_COMPOSER, meta->composer,
+				MEDIA_SVC_META_DICT_YEAR, meta->year);
 }
 
 int _media_svc_insert_item_with_data(sqlite3 *handle, media_svc_content_info_s *content_info, bool stack_query)
 {
 	int err = -1;
+	char *intern_sql = NULL;
 
-	char * db_fields = "media_uuid, path, file_name, media_type, mime_type, size, added_time, modified_time, folder_uuid, \
-					thumbnail_path, title, album_id, album, artist, genre, composer, year, recorded_date, copyright, track_num, description,\
+	char * db_fields = "media_uuid, path, file_name, media_type, mime_type, size, added_time, modified_time, folder_id, \
+					thumbnail_path, title, album_id, album_dict_id, artist_dict_id, genre_dict_id, composer_dict_id, year_dict_id, \
+					recorded_date, copyright, track_num, description,\
 					bitrate, samplerate, channel, duration, longitude, latitude, altitude, width, height, datetaken, orientation,\
-					rating, is_drm, storage_type";
+					rating, is_drm, storage_type, scan_gen";
 
-	char *sql = sqlite3_mprintf("INSERT INTO %s (%s) VALUES (%Q, %Q, %Q, %d, %Q, %lld, %d, %d, %Q, \
-													%Q, %Q, %d, %Q, %Q, %Q, %Q, %Q, %Q, %Q, %Q, %Q, \
+	intern_sql = __media_svc_intern_meta_sql(&content_info->media_meta);
+	media_svc_retv_if(intern_sql == NULL, MEDIA_INFO_ERROR_OUT_OF_MEMORY);
+
+	/* Both statements are stacked together, so the dictionary values are always in the same transaction */
+	char *sql = sqlite3_mprintf("%s INSERT INTO %s (%s) VALUES (%Q, %Q, %Q, %d, %Q, %lld, %d, %d, "MEDIA_SVC_FOLDER_ID", \
+													%Q, %Q, %d, "MEDIA_SVC_META_DICT_ID", "MEDIA_SVC_META_DICT_ID", \
+													"MEDIA_SVC_META_DICT_ID", "MEDIA_SVC_META_DICT_ID", "MEDIA_SVC_META_DICT_ID", \
+													%Q, %Q, %Q, %Q, \
 													%d, %d, %d, %d, %f, %f, %f, %d, %d, %Q, %d, \
-													%d, %d, %d);",
-		MEDIA_SVC_DB_TABLE_MEDIA, db_fields,
+													%d, %d, %d, "MEDIA_SVC_SCAN_GEN");",
+		intern_sql,
+		MEDIA_SVC_DB_TABLE_MEDIA_DATA, db_fields,
 		content_info->media_uuid,
 		content_info->path,
 		content_info->file_name,
@@ -135,11 +313,11 @@ int _media_svc_insert_item_with_data(sqlite3 *handle, media_svc_content_info_s *
 		content_info->thumbnail_path,		//
 		content_info->media_meta.title,
 		content_info->album_id,
-		content_info->media_meta.album,
-		content_info->media_meta.artist,
-		content_info->media_meta.genre,
-		content_info->media_meta.composer,
-		content_info->media_meta.year,
+		MEDIA_SVC_META_DICT_ALBUM, content_info->media_meta.album,
+		MEDIA_SVC_META_DICT_ARTIST, content_info->media_meta.artist,
+		MEDIA_SVC_META_DICT_GENRE, content_info->media_meta.genre,
+		MEDIA_SVC_META_DICT_COMPOSER, content_info->media_meta.composer,
+		MEDIA_SVC_META_DICT_YEAR, content_info->media_meta.year,
 		content_info->media_meta.recorded_date,
 		content_info->media_meta.copyright,
 		content_info->media_meta.track_num,
@@ -157,8 +335,12 @@ int _media_svc_insert_item_with_data(sqlite3 *handle, media_svc_content_info_s *
 		content_info->media_meta.orientation,
 		content_info->media_meta.rating,
 		content_info->is_drm,
+		content_info->storage_type,
 		content_info->storage_type);
 
+	sqlite3_free(intern_sql);
+	media_svc_retv_if(sql == NULL, MEDIA_INFO_ERROR_OUT_OF_MEMORY);
+
 	media_svc_debug("query : %s", sql);
 
 	if(!stack_query) {
@@ -170,7 +352,8 @@ int _media_svc_insert_item_with_data(sqlite3 *handle, media_svc_content_info_s *
 			return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
 		}
 	} else {
-		_media_svc_sql_query_add(&g_media_svc_insert_item_query_list, &sql);
+		err = _media_svc_stack_query(handle, MEDIA_SVC_QUERY_INSERT_ITEM, &sql);
+		media_svc_retv_if(err != MEDIA_INFO_ERROR_NONE, err);
 	}
 
 	return MEDIA_INFO_ERROR_NONE;
@@ -179,23 +362,30 @@ int _media_svc_insert_item_with_data(sqlite3 *handle, media_svc_content_info_s *
 int _media_svc_update_item_with_data(sqlite3 *handle, media_svc_content_info_s *content_info)
 {
 	int err = -1;
+	char *intern_sql = NULL;
 
-	char *sql = sqlite3_mprintf("UPDATE %s SET \
-		size=%lld, modified_time=%d, thumbnail_path=%Q, title=%Q, album_id=%d, album=%Q, artist=%Q, genre=%Q, \
-		composer=%Q, year=%Q, recorded_date=%Q, copyright=%Q, track_num=%Q, description=%Q, \
+	intern_sql = __media_svc_intern_meta_sql(&content_info->media_meta);
+	media_svc_retv_if(intern_sql == NULL, MEDIA_INFO_ERROR_OUT_OF_MEMORY);
+
+	char *sql = sqlite3_mprintf("%s UPDATE %s SET \
+		size=%lld, modified_time=%d, thumbnail_path=%Q, title=%Q, album_id=%d, album_dict_id="MEDIA_SVC_META_DICT_ID", \
+		artist_dict_id="MEDIA_SVC_META_DICT_ID", genre_dict_id="MEDIA_SVC_META_DICT_ID", \
+		composer_dict_id="MEDIA_SVC_META_DICT_ID", year_dict_id="MEDIA_SVC_META_DICT_ID", \
+		recorded_date=%Q, copyright=%Q, track_num=%Q, description=%Q, \
 		bitrate=%d, samplerate=%d, channel=%d, duration=%d, longitude=%f, latitude=%f, altitude=%f, width=%d, height=%d, datetaken=%Q, \
 													orientation=%d WHERE path=%Q",
-		MEDIA_SVC_DB_TABLE_MEDIA,
+		intern_sql,
+		MEDIA_SVC_DB_TABLE_MEDIA_DATA,
 		content_info->size,
 		content_info->modified_time,
 		content_info->thumbnail_path,
 		content_info->media_meta.title,
 		content_info->album_id,
-		content_info->media_meta.album,
-		content_info->media_meta.artist,
-		content_info->media_meta.genre,
-		content_info->media_meta.composer,
-		content_info->media_meta.year,
+		MEDIA_SVC_META_DICT_ALBUM, content_info->media_meta.album,
+		MEDIA_SVC_META_DICT_ARTIST, content_info->media_meta.artist,
+		MEDIA_SVC_META_DICT_GENRE, content_info->media_meta.genre,
+		MEDIA_SVC_META_DICT_COMPOSER, content_info->media_meta.composer,
+		MEDIA_SVC_META_DICT_YEAR, content_info->media_meta.year,
 		content_info->media_meta.recorded_date,
 		content_info->media_meta.copyright,
 		content_info->media_meta.track_num,
@@ -214,6 +404,9 @@ int _media_svc_update_item_with_data(sqlite3 *handle, media_svc_content_info_s *
 		content_info->path
 		);
 
+	sqlite3_free(intern_sql);
+	media_svc_retv_if(sql == NULL, MEDIA_INFO_ERROR_OUT_OF_MEMORY);
+
 	media_svc_debug("query : %s", sql);
 
 	err = _media_svc_sql_query(handle, sql);
@@ -231,7 +424,7 @@ int _media_svc_get_thumbnail_path_by_path(sqlite3 *handle, const char *path, cha
 	int ret = MEDIA_INFO_ERROR_NONE;
 	sqlite3_stmt *sql_stmt = NULL;
 
-	char *sql = sqlite3_mprintf("SELECT thumbnail_path FROM %s WHERE path='%q'", MEDIA_SVC_DB_TABLE_MEDIA, path);
+	char *sql = sqlite3_mprintf("SELECT thumbnail_path FROM %s WHERE path='%q'", MEDIA_SVC_DB_TABLE_MEDIA_DATA, path);
 
 	ret = _media_svc_sql_prepare_to_step(handle, sql, &sql_stmt);
 
@@ -257,7 +450,7 @@ int _media_svc_get_media_type_by_path(sqlite3 *handle, const char *path, int *me
 	int ret = MEDIA_INFO_ERROR_NONE;
 	sqlite3_stmt *sql_stmt = NULL;
 
-	char *sql = sqlite3_mprintf("SELECT media_type FROM %s WHERE path='%q'", MEDIA_SVC_DB_TABLE_MEDIA, path);
+	char *sql = sqlite3_mprintf("SELECT media_type FROM %s WHERE path='%q'", MEDIA_SVC_DB_TABLE_MEDIA_DATA, path);
 
 	ret = _media_svc_sql_prepare_to_step(handle, sql, &sql_stmt);
 
@@ -276,7 +469,7 @@ int _media_svc_get_media_type_by_path(sqlite3 *handle, const char *path, int *me
 int _media_svc_delete_item_by_path(sqlite3 *handle, const char *path)
 {
 	int err = -1;
-	char *sql = sqlite3_mprintf("DELETE FROM %s WHERE validity=1 AND path='%q'", MEDIA_SVC_DB_TABLE_MEDIA, path);
+	char *sql = sqlite3_mprintf("DELETE FROM %s WHERE "MEDIA_SVC_VALID_MEDIA" AND path='%q'", MEDIA_SVC_DB_TABLE_MEDIA_DATA, path);
 
 	err = _media_svc_sql_query(handle, sql);
 	sqlite3_free(sql);
@@ -291,7 +484,7 @@ int _media_svc_delete_item_by_path(sqlite3 *handle, const char *path)
 int _media_svc_truncate_table(sqlite3 *handle, media_svc_storage_type_e storage_type)
 {
 	int err = -1;
-	char *sql = sqlite3_mprintf("DELETE FROM %s WHERE storage_type=%d", MEDIA_SVC_DB_TABLE_MEDIA, storage_type);
+	char *sql = sqlite3_mprintf("DELETE FROM %s WHERE storage_type=%d", MEDIA_SVC_DB_TABLE_MEDIA_DATA, storage_type);
 
 	err = _media_svc_sql_query(handle, sql);
 	sqlite3_free(sql);
@@ -306,55 +499,51 @@ int _media_svc_truncate_table(sqlite3 *handle, media_svc_storage_type_e storage_
 
 int _media_svc_delete_invalid_items(sqlite3 *handle, media_svc_storage_type_e storage_type)
 {
-	int idx = 0;
-	media_svc_thumbnailpath_s *thumbpath_record = NULL;
 	int err = -1;
-	int invalid_count = 0;
 	int ret = MEDIA_INFO_ERROR_NONE;
+	char *sql = NULL;
 
-	ret = __media_svc_count_invalid_records_with_thumbnail(handle, storage_type, &invalid_count);
+	ret = _media_svc_sql_begin_trans(handle);
 	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 
-	media_svc_debug("invalid count: %d\n", invalid_count);
-
-	if (invalid_count > 0) {
-		thumbpath_record = (media_svc_thumbnailpath_s *)calloc( invalid_count, sizeof(media_svc_thumbnailpath_s));
-		if (thumbpath_record == NULL) {
-			media_svc_error("fail to memory allocation");
-			return MEDIA_INFO_ERROR_OUT_OF_MEMORY;
-		}
-
-		ret = __media_svc_get_invalid_records_with_thumbnail(handle, storage_type, invalid_count, thumbpath_record);
-		if (ret != MEDIA_INFO_ERROR_NONE) {
-			media_svc_error("error when get thumbnail record");
-			SAFE_FREE(thumbpath_record);
-			return ret;
-		}
-	} else {
-		media_svc_debug("There is no item with thumbnail");
+	/* Thumbnails are journaled with the delete, and removed by the thumbnail journal after commit.
+	 * Media which is not found by the last scan has older generation, and it is a range of (storage_type, scan_gen) index */
+	sql = sqlite3_mprintf("INSERT INTO %s (src_path) SELECT DISTINCT thumbnail_path FROM %s \
+				WHERE storage_type=%d AND (scan_gen<(SELECT valid_gen FROM %s WHERE storage_type=%d) OR validity=0) \
+				AND thumbnail_path IS NOT NULL AND thumbnail_path != ''",
+				MEDIA_SVC_DB_TABLE_THUMB_JOURNAL, MEDIA_SVC_DB_TABLE_MEDIA_DATA, storage_type,
+				MEDIA_SVC_DB_TABLE_STORAGE, storage_type);
+	err = _media_svc_sql_query(handle, sql);
+	sqlite3_free(sql);
+	if (err != SQLITE_OK) {
+		media_svc_error("To journal thumbnails of invalid items is failed(%d)", err);
+		_media_svc_sql_rollback_trans(handle);
+		return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
 	}
 
-	char *sql = sqlite3_mprintf("DELETE FROM %s WHERE validity = 0 AND storage_type=%d", MEDIA_SVC_DB_TABLE_MEDIA, storage_type);
+	sql = sqlite3_mprintf("DELETE FROM %s WHERE storage_type=%d AND scan_gen<(SELECT valid_gen FROM %s WHERE storage_type=%d); \
+				DELETE FROM %s WHERE storage_type=%d AND validity=0;",
+				MEDIA_SVC_DB_TABLE_MEDIA_DATA, storage_type, MEDIA_SVC_DB_TABLE_STORAGE, storage_type,
+				MEDIA_SVC_DB_TABLE_MEDIA_DATA, storage_type);
 	err = _media_svc_sql_query(handle, sql);
 	sqlite3_free(sql);
 	if (err != SQLITE_OK) {
 		media_svc_error("To delete invalid items is failed(%d)", err);
-		SAFE_FREE(thumbpath_record);
+		_media_svc_sql_rollback_trans(handle);
 		return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
 	}
 
-	/*Delete thumbnails*/
-	for (idx = 0; idx < invalid_count; idx++) {
-		if (strlen(thumbpath_record[idx].thumbnail_path) > 0) {
-			if (_media_svc_remove_file(thumbpath_record[idx].thumbnail_path) == FALSE) {
-				media_svc_error("fail to remove thumbnail file.");
-				SAFE_FREE(thumbpath_record);
-				return MEDIA_INFO_ERROR_INTERNAL;
-			}
-		}
+	ret = _media_svc_sql_end_trans(handle);
+	if (ret != MEDIA_INFO_ERROR_NONE) {
+		media_svc_error("mb_svc_sqlite3_commit_trans failed.. Now start to rollback\n");
+		_media_svc_sql_rollback_trans(handle);
+		return ret;
 	}
 
-	SAFE_FREE(thumbpath_record);
+	/*Delete thumbnails*/
+	ret = _media_svc_thumb_journal_process();
+	if (ret != MEDIA_INFO_ERROR_NONE)
+		media_svc_error("fail to start thumbnail journal. It is resumed by next pass");
 
 	return MEDIA_INFO_ERROR_NONE;
 }
@@ -363,7 +552,16 @@ int _media_svc_update_item_validity(sqlite3 *handle, const char *path, int valid
 {
 	int err = -1;
 
-	char *sql = sqlite3_mprintf("UPDATE %s SET validity=%d WHERE path= '%q'", MEDIA_SVC_DB_TABLE_MEDIA, validity, path);
+	char *sql = NULL;
+
+	/* Valid media is stamped with the current scan generation of its storage */
+	if (validity == 1) {
+		sql = sqlite3_mprintf("UPDATE %s SET validity=1, scan_gen=(SELECT scan_gen FROM %s WHERE storage_type=%s.storage_type) \
+					WHERE path= '%q'",
+					MEDIA_SVC_DB_TABLE_MEDIA_DATA, MEDIA_SVC_DB_TABLE_STORAGE, MEDIA_SVC_DB_TABLE_MEDIA_DATA, path);
+	} else {
+		sql = sqlite3_mprintf("UPDATE %s SET validity=%d WHERE path= '%q'", MEDIA_SVC_DB_TABLE_MEDIA_DATA, validity, path);
+	}
 
 	if(!stack_query) {
 		err = _media_svc_sql_query(handle, sql);
@@ -373,7 +571,8 @@ int _media_svc_update_item_validity(sqlite3 *handle, const char *path, int valid
 			return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
 		}
 	} else {
-		_media_svc_sql_query_add(&g_media_svc_item_validity_query_list, &sql);
+		err = _media_svc_stack_query(handle, MEDIA_SVC_QUERY_SET_ITEM_VALIDITY, &sql);
+		media_svc_retv_if(err != MEDIA_INFO_ERROR_NONE, err);
 	}
 
 	return MEDIA_INFO_ERROR_NONE;
@@ -383,7 +582,7 @@ int _media_svc_update_thumbnail_path(sqlite3 *handle, const char *path, const ch
 {
 	int err = -1;
 
-	char *sql = sqlite3_mprintf("UPDATE %s SET thumbnail_path=%Q WHERE path= %Q", MEDIA_SVC_DB_TABLE_MEDIA, thumb_path, path);
+	char *sql = sqlite3_mprintf("UPDATE %s SET thumbnail_path=%Q WHERE path= %Q", MEDIA_SVC_DB_TABLE_MEDIA_DATA, thumb_path, path);
 
 	err = _media_svc_sql_query(handle, sql);
 	sqlite3_free(sql);
@@ -398,7 +597,19 @@ int _media_svc_update_thumbnail_path(sqlite3 *handle, const char *path, const ch
 int _media_svc_update_valid_of_music_records(sqlite3 *handle, media_svc_storage_type_e storage_type, int validity)
 {
 	int err = -1;
-	char *sql = sqlite3_mprintf("UPDATE %s SET validity=%d WHERE storage_type=%d", MEDIA_SVC_DB_TABLE_MEDIA, validity, storage_type);
+	char *sql = NULL;
+
+	/* Media rows are not written. Invalidating starts a new scan generation, and media of older generation is invalid.
+	 * Validating accepts every generation, and only media which is invalidated one by one is updated */
+	if (validity == 0) {
+		sql = sqlite3_mprintf("UPDATE %s SET scan_gen=scan_gen+1, valid_gen=scan_gen+1 WHERE storage_type=%d",
+					MEDIA_SVC_DB_TABLE_STORAGE, storage_type);
+	} else {
+		sql = sqlite3_mprintf("UPDATE %s SET valid_gen=0 WHERE storage_type=%d; \
+					UPDATE %s SET validity=1 WHERE storage_type=%d AND validity=0;",
+					MEDIA_SVC_DB_TABLE_STORAGE, storage_type, MEDIA_SVC_DB_TABLE_MEDIA_DATA, storage_type);
+	}
+
 	err = _media_svc_sql_query(handle, sql);
 	sqlite3_free(sql);
 	if (err != SQLITE_OK) {
@@ -412,7 +623,7 @@ int _media_svc_update_valid_of_music_records(sqlite3 *handle, media_svc_storage_
 int _media_svc_update_item_by_path(sqlite3 *handle, const char *src_path, media_svc_storage_type_e dest_storage, const char *dest_path,
 				const char *file_name, int modified_time, const char *folder_uuid, const char *thumb_path, bool stack_query)
 {
-	/* update path, filename, modified_time, folder_uuid, thumbnail_path, */
+	/* update path, filename, modified_time, folder_id, thumbnail_path, */
 	/* played_count, last_played_time, last_played_position, favourite, storaget_type*/
 
 	int err = -1;
@@ -420,16 +631,18 @@ int _media_svc_update_item_by_path(sqlite3 *handle, const char *src_path, media_
 
 	if(thumb_path != NULL) {
 		sql = sqlite3_mprintf("UPDATE %s SET \
-					path=%Q, file_name=%Q, modified_time=%d, folder_uuid=%Q, thumbnail_path=%Q, storage_type=%d, \
-					played_count=0, last_played_time=0, last_played_position=0, favourite=0 \
+					path=%Q, file_name=%Q, modified_time=%d, folder_id="MEDIA_SVC_FOLDER_ID", thumbnail_path=%Q, storage_type=%d, \
+					scan_gen="MEDIA_SVC_SCAN_GEN", played_count=0, last_played_time=0, last_played_position=0, favourite=0 \
 					WHERE path=%Q",
-					MEDIA_SVC_DB_TABLE_MEDIA, dest_path, file_name, modified_time, folder_uuid, thumb_path, dest_storage, src_path);
+					MEDIA_SVC_DB_TABLE_MEDIA_DATA, dest_path, file_name, modified_time, folder_uuid, thumb_path, dest_storage,
+					dest_storage, src_path);
 	} else {
 		sql = sqlite3_mprintf("UPDATE %s SET \
-					path=%Q, file_name=%Q, modified_time=%d, folder_uuid=%Q, storage_type=%d, \
-					played_count=0, last_played_time=0, last_played_position=0, favourite=0 \
+					path=%Q, file_name=%Q, modified_time=%d, folder_id="MEDIA_SVC_FOLDER_ID", storage_type=%d, \
+					scan_gen="MEDIA_SVC_SCAN_GEN", played_count=0, last_played_time=0, last_played_position=0, favourite=0 \
 					WHERE path=%Q",
-					MEDIA_SVC_DB_TABLE_MEDIA, dest_path, file_name, modified_time, folder_uuid, dest_storage, src_path);
+					MEDIA_SVC_DB_TABLE_MEDIA_DATA, dest_path, file_name, modified_time, folder_uuid, dest_storage,
+					dest_storage, src_path);
 	}
 
 	if(!stack_query) {
@@ -440,7 +653,302 @@ int _media_svc_update_item_by_path(sqlite3 *handle, const char *src_path, media_
 			return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
 		}
 	} else {
-		_media_svc_sql_query_add(&g_media_svc_move_item_query_list, &sql);
+		err = _media_svc_stack_query(handle, MEDIA_SVC_QUERY_MOVE_ITEM, &sql);
+		media_svc_retv_if(err != MEDIA_INFO_ERROR_NONE, err);
+	}
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+int _media_svc_update_item_path_by_prefix(sqlite3 *handle, const char *src_path, const char *dst_path)
+{
+	int err = -1;
+	char *sql = NULL;
+
+	err = sqlite3_create_function(handle, "media_svc_thumb_path", 1, SQLITE_UTF8, NULL, __media_svc_thumb_path_func, NULL, NULL);
+	if (err != SQLITE_OK) {
+		media_svc_error("failed to register thumb path function [%s]", sqlite3_errmsg(handle));
+		return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
+	}
+
+	/* Journal the thumbnail files of image and video. They are moved after commit */
+	sql = sqlite3_mprintf("INSERT INTO %s (src_path, dst_path) \
+				SELECT thumbnail_path, media_svc_thumb_path('%q' || substr(path, length('%q') + 1)) FROM %s \
+				WHERE path >= '%q/' AND path < '%q0' AND media_type IN (%d, %d) AND thumbnail_path IS NOT NULL AND thumbnail_path != '';",
+				MEDIA_SVC_DB_TABLE_THUMB_JOURNAL, dst_path, src_path, MEDIA_SVC_DB_TABLE_MEDIA_DATA,
+				src_path, src_path, MEDIA_SVC_MEDIA_TYPE_IMAGE, MEDIA_SVC_MEDIA_TYPE_VIDEO);
+
+	err = _media_svc_sql_query(handle, sql);
+	sqlite3_free(sql);
+	if (err != SQLITE_OK) {
+		media_svc_error("failed to journal thumbnail path");
+		return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
+	}
+
+	sql = sqlite3_mprintf("UPDATE %s SET \
+				thumbnail_path = CASE WHEN media_type IN (%d, %d) AND thumbnail_path IS NOT NULL AND thumbnail_path != '' \
+					THEN media_svc_thumb_path('%q' || substr(path, length('%q') + 1)) ELSE thumbnail_path END, \
+				path = '%q' || substr(path, length('%q') + 1) \
+				WHERE path >= '%q/' AND path < '%q0';",
+				MEDIA_SVC_DB_TABLE_MEDIA_DATA, MEDIA_SVC_MEDIA_TYPE_IMAGE, MEDIA_SVC_MEDIA_TYPE_VIDEO,
+				dst_path, src_path, dst_path, src_path, src_path, src_path);
+
+	err = _media_svc_sql_query(handle, sql);
+	sqlite3_free(sql);
+	if (err != SQLITE_OK) {
+		media_svc_error("failed to update item path");
+		return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
+	}
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+/* Moves items of (src_path, dest_path) pairs at once. Pairs are loaded into a temp table, and the items, their thumbnails
+ * and the folders are updated by a few statements joined with it. Caller holds the transaction */
+int _media_svc_move_items(sqlite3 *handle, media_svc_storage_type_e dest_storage, const media_svc_move_item_s *items, int count)
+{
+	int ret = MEDIA_INFO_ERROR_NONE;
+	int err = -1;
+	int i = 0;
+	char *sql = NULL;
+	char *file_name = NULL;
+	char *folder_path = NULL;
+	char *last_folder_path = NULL;
+	char folder_uuid[MEDIA_SVC_UUID_SIZE+1] = {0,};
+	sqlite3_stmt *sql_stmt = NULL;
+
+	err = sqlite3_create_function(handle, "media_svc_thumb_path", 1, SQLITE_UTF8, NULL, __media_svc_thumb_path_func, NULL, NULL);
+	if (err != SQLITE_OK) {
+		media_svc_error("failed to register thumb path function [%s]", sqlite3_errmsg(handle));
+		return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
+	}
+
+	err = _media_svc_sql_query(handle, "CREATE TEMP TABLE IF NOT EXISTS move_item (\
+				src_path			TEXT PRIMARY KEY, \
+				dest_path		TEXT NOT NULL, \
+				file_name		TEXT NOT NULL, \
+				modified_time		INTEGER, \
+				folder_id		INTEGER, \
+				src_folder_id		INTEGER \
+				); \
+				DELETE FROM temp.move_item;");
+	if (err != SQLITE_OK) {
+		media_svc_error("failed to create move_item table");
+		return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
+	}
+
+	sql = sqlite3_mprintf("INSERT OR REPLACE INTO temp.move_item (src_path, dest_path, file_name, modified_time, folder_id) \
+				VALUES (?, ?, ?, ?, (SELECT folder_id FROM %s WHERE folder_uuid=?))", MEDIA_SVC_DB_TABLE_FOLDER_DATA);
+	media_svc_retv_if(sql == NULL, MEDIA_INFO_ERROR_OUT_OF_MEMORY);
+
+	err = sqlite3_prepare_v2(handle, sql, -1, &sql_stmt, NULL);
+	sqlite3_free(sql);
+	if (err != SQLITE_OK) {
+		media_svc_error("prepare error [%s]", sqlite3_errmsg(handle));
+		return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
+	}
+
+	for (i = 0; i < count; i++) {
+		/* Items are usually moved to a few folders, so the folder is looked up only when it differs from the last one */
+		folder_path = g_path_get_dirname(items[i].dest_path);
+		if (g_strcmp0(folder_path, last_folder_path) != 0) {
+			ret = _media_svc_get_and_append_folder_id_by_path(handle, items[i].dest_path, dest_storage, folder_uuid);
+			if (ret == MEDIA_INFO_ERROR_NONE)
+				ret = _media_svc_update_folder_modified_time_by_folder_uuid(handle, folder_uuid, folder_path, FALSE);
+
+			SAFE_FREE(last_folder_path);
+			last_folder_path = folder_path;
+
+			if (ret != MEDIA_INFO_ERROR_NONE)
+				break;
+		} else {
+			SAFE_FREE(folder_path);
+		}
+
+		file_name = g_path_get_basename(items[i].dest_path);
+
+		sqlite3_bind_text(sql_stmt, 1, items[i].src_path, -1, SQLITE_STATIC);
+		sqlite3_bind_text(sql_stmt, 2, items[i].dest_path, -1, SQLITE_STATIC);
+		sqlite3_bind_text(sql_stmt, 3, file_name, -1, SQLITE_STATIC);
+		sqlite3_bind_int(sql_stmt, 4, _media_svc_get_file_time(items[i].dest_path));
+		sqlite3_bind_text(sql_stmt, 5, folder_uuid, -1, SQLITE_STATIC);
+
+		err = sqlite3_step(sql_stmt);
+		sqlite3_reset(sql_stmt);
+		SAFE_FREE(file_name);
+
+		if (err != SQLITE_DONE) {
+			media_svc_error("failed to add [%s] to move [%s]", items[i].src_path, sqlite3_errmsg(handle));
+			ret = MEDIA_INFO_ERROR_DATABASE_INTERNAL;
+			break;
+		}
+	}
+
+	SAFE_FREE(last_folder_path);
+	SQLITE3_FINALIZE(sql_stmt);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	/* Source folders are kept to remove the ones left empty, and thumbnails of image and video are journaled to move after commit */
+	sql = sqlite3_mprintf("UPDATE temp.move_item SET src_folder_id=(SELECT folder_id FROM %s WHERE path=move_item.src_path); \
+				INSERT INTO %s (src_path, dst_path) SELECT m.thumbnail_path, media_svc_thumb_path(t.dest_path) \
+				FROM %s AS m INNER JOIN temp.move_item AS t ON t.src_path=m.path \
+				WHERE m.media_type IN (%d, %d) AND m.thumbnail_path IS NOT NULL AND m.thumbnail_path != ''; \
+				UPDATE %s SET \
+				thumbnail_path = CASE WHEN media_type IN (%d, %d) AND thumbnail_path IS NOT NULL AND thumbnail_path != '' \
+					THEN (SELECT media_svc_thumb_path(dest_path) FROM temp.move_item WHERE src_path=%s.path) ELSE thumbnail_path END, \
+				file_name=(SELECT file_name FROM temp.move_item WHERE src_path=%s.path), \
+				modified_time=(SELECT modified_time FROM temp.move_item WHERE src_path=%s.path), \
+				folder_id=(SELECT folder_id FROM temp.move_item WHERE src_path=%s.path), \
+				storage_type=%d, scan_gen=(SELECT scan_gen FROM %s WHERE storage_type=%d), \
+				played_count=0, last_played_time=0, last_played_position=0, favourite=0, \
+				path=(SELECT dest_path FROM temp.move_item WHERE src_path=%s.path) \
+				WHERE path IN (SELECT src_path FROM temp.move_item); \
+				DELETE FROM %s WHERE folder_id IN (SELECT src_folder_id FROM temp.move_item) \
+				AND NOT EXISTS (SELECT 1 FROM %s WHERE folder_id=%s.folder_id); \
+				DELETE FROM temp.move_item;",
+				MEDIA_SVC_DB_TABLE_MEDIA_DATA,
+				MEDIA_SVC_DB_TABLE_THUMB_JOURNAL, MEDIA_SVC_DB_TABLE_MEDIA_DATA,
+				MEDIA_SVC_MEDIA_TYPE_IMAGE, MEDIA_SVC_MEDIA_TYPE_VIDEO,
+				MEDIA_SVC_DB_TABLE_MEDIA_DATA, MEDIA_SVC_MEDIA_TYPE_IMAGE, MEDIA_SVC_MEDIA_TYPE_VIDEO,
+				MEDIA_SVC_DB_TABLE_MEDIA_DATA, MEDIA_SVC_DB_TABLE_MEDIA_DATA, MEDIA_SVC_DB_TABLE_MEDIA_DATA,
+				MEDIA_SVC_DB_TABLE_MEDIA_DATA, dest_storage, MEDIA_SVC_DB_TABLE_STORAGE, dest_storage,
+				MEDIA_SVC_DB_TABLE_MEDIA_DATA,
+				MEDIA_SVC_DB_TABLE_FOLDER_DATA, MEDIA_SVC_DB_TABLE_MEDIA_DATA, MEDIA_SVC_DB_TABLE_FOLDER_DATA);
+	media_svc_retv_if(sql == NULL, MEDIA_INFO_ERROR_OUT_OF_MEMORY);
+
+	err = _media_svc_sql_query(handle, sql);
+	sqlite3_free(sql);
+	if (err != SQLITE_OK) {
+		media_svc_error("failed to move items");
+		return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
+	}
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+static unsigned long long __media_svc_get_usec(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (unsigned long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* Moving average with weight 1/4 for the new sample */
+static void __media_svc_update_batch_latency(sqlite3 *handle, int query_cnt, unsigned long long exec_usec, unsigned long long commit_usec)
+{
+	media_svc_db_ctx_s *ctx = _media_svc_db_ctx_get(handle);
+
+	if (ctx == NULL || query_cnt <= 0)
+		return;
+
+	ctx->query_usec += ((double)exec_usec / query_cnt - ctx->query_usec) / 4;
+	ctx->commit_usec += ((double)commit_usec - ctx->commit_usec) / 4;
+
+	media_svc_debug("batch of [%d] queries : exec [%llu] commit [%llu] usec", query_cnt, exec_usec, commit_usec);
+}
+
+static bool __media_svc_batch_is_old(media_svc_batch_s *batch)
+{
+	if (batch->queued_cnt == 0)
+		return FALSE;
+
+	return (__media_svc_get_usec() - batch->first_usec >= MEDIA_SVC_BATCH_MAX_DELAY_USEC);
+}
+
+/*
+ * Commit is due when the first query is too old, the queries are too big,
+ * or the transaction is expected to hold the lock as long as the target.
+ * Queries should take at least as long as the commit, so a slow commit is amortized by a bigger batch.
+ */
+static bool __media_svc_batch_is_full(sqlite3 *handle, media_svc_batch_s *batch)
+{
+	media_svc_db_ctx_s *ctx = NULL;
+	double exec_usec = 0;
+
+	if (batch->queued_cnt == 0)
+		return FALSE;
+
+	if (__media_svc_batch_is_old(batch))
+		return TRUE;
+
+	if (batch->queued_bytes >= MEDIA_SVC_BATCH_MAX_BYTES)
+		return TRUE;
+
+	ctx = _media_svc_db_ctx_get(handle);
+	if (ctx == NULL)
+		return TRUE;
+
+	exec_usec = ctx->query_usec * batch->queued_cnt;
+
+	return ((exec_usec + ctx->commit_usec >= ctx->max_lock_hold_usec) && (exec_usec >= ctx->commit_usec));
+}
+
+int _media_svc_stack_query(sqlite3 *handle, media_svc_query_type_e query_type, char **sql)
+{
+	media_svc_batch_s *batch = NULL;
+
+	batch = _media_svc_db_ctx_get_batch(handle, MEDIA_SVC_BATCH_OWNER_MEDIA, query_type);
+	if (batch == NULL) {
+		sqlite3_free(*sql);
+		*sql = NULL;
+		return MEDIA_INFO_ERROR_INVALID_PARAMETER;
+	}
+
+	if (batch->queued_cnt == 0)
+		batch->first_usec = __media_svc_get_usec();
+
+	batch->queued_cnt++;
+	batch->queued_bytes += strlen(*sql);
+
+	_media_svc_sql_query_add(&batch->query_list, sql);
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+int _media_svc_batch_commit_if_full(sqlite3 *handle, media_svc_query_type_e query_type)
+{
+	int ret = MEDIA_INFO_ERROR_NONE;
+	media_svc_batch_s *batch = NULL;
+
+	batch = _media_svc_db_ctx_get_batch(handle, MEDIA_SVC_BATCH_OWNER_MEDIA, query_type);
+	media_svc_retv_if(batch == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER);
+
+	if (!batch->adaptive || !__media_svc_batch_is_full(handle, batch))
+		return _media_svc_batch_commit_if_old(handle);
+
+	media_svc_debug("commit adaptive batch of [%d] items", batch->cur_data_cnt);
+
+	ret = _media_svc_list_query_do(handle, query_type);
+	batch->cur_data_cnt = 0;
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	return _media_svc_batch_commit_if_old(handle);
+}
+
+/*
+ * Age of a batch is checked when an item is added to it. Another kind of batch,
+ * or a batch which gets no more items, is committed here when its first query is too old.
+ */
+int _media_svc_batch_commit_if_old(sqlite3 *handle)
+{
+	int ret = MEDIA_INFO_ERROR_NONE;
+	media_svc_batch_s *batch = NULL;
+	int query_type = 0;
+
+	for (query_type = MEDIA_SVC_QUERY_INSERT_ITEM; query_type < MEDIA_SVC_BATCH_QUERY_MAX; query_type++) {
+		batch = _media_svc_db_ctx_get_batch(handle, MEDIA_SVC_BATCH_OWNER_MEDIA, query_type);
+		media_svc_retv_if(batch == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER);
+
+		if (!batch->adaptive || !__media_svc_batch_is_old(batch))
+			continue;
+
+		media_svc_debug("commit old adaptive batch of [%d] items", batch->cur_data_cnt);
+
+		ret = _media_svc_list_query_do(handle, query_type);
+		batch->cur_data_cnt = 0;
+		media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 	}
 
 	return MEDIA_INFO_ERROR_NONE;
@@ -449,18 +957,24 @@ int _media_svc_update_item_by_path(sqlite3 *handle, const char *src_path, media_
 int _media_svc_list_query_do(sqlite3 *handle, media_svc_query_type_e query_type)
 {
 	int ret = MEDIA_INFO_ERROR_NONE;
+	media_svc_batch_s *batch = NULL;
+	int query_cnt = 0;
+	unsigned long long begin_usec = 0;
+	unsigned long long exec_usec = 0;
+
+	batch = _media_svc_db_ctx_get_batch(handle, MEDIA_SVC_BATCH_OWNER_MEDIA, query_type);
+	media_svc_retv_if(batch == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER);
+
+	begin_usec = __media_svc_get_usec();
 
 	ret = _media_svc_sql_begin_trans(handle);
 	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 
-	if (query_type == MEDIA_SVC_QUERY_SET_ITEM_VALIDITY)
-		ret = _media_svc_sql_query_list(handle, &g_media_svc_item_validity_query_list);
-	else if (query_type == MEDIA_SVC_QUERY_MOVE_ITEM)
-		ret = _media_svc_sql_query_list(handle, &g_media_svc_move_item_query_list);
-	else if (query_type == MEDIA_SVC_QUERY_INSERT_ITEM)
-		ret = _media_svc_sql_query_list(handle, &g_media_svc_insert_item_query_list);
-	else
-		ret = MEDIA_INFO_ERROR_INVALID_PARAMETER;
+	query_cnt = batch->queued_cnt;
+	batch->queued_cnt = 0;
+	batch->queued_bytes = 0;
+
+	ret = _media_svc_sql_query_list(handle, &batch->query_list);
 
 	if (ret != MEDIA_INFO_ERROR_NONE) {
 		media_svc_error("_media_svc_list_query_do failed. start rollback");
@@ -468,6 +982,8 @@ int _media_svc_list_query_do(sqlite3 *handle, media_svc_query_type_e query_type)
 		return ret;
 	}
 
+	exec_usec = __media_svc_get_usec();
+
 	ret = _media_svc_sql_end_trans(handle);
 	if (ret != MEDIA_INFO_ERROR_NONE) {
 		media_svc_error("mb_svc_sqlite3_commit_trans failed.. Now start to rollback\n");
@@ -475,6 +991,8 @@ int _media_svc_list_query_do(sqlite3 *handle, media_svc_query_type_e query_type)
 		return ret;
 	}
 
+	__media_svc_update_batch_latency(handle, query_cnt, exec_usec - begin_usec, __media_svc_get_usec() - exec_usec);
+
 	return MEDIA_INFO_ERROR_NONE;
 }
 
@@ -482,8 +1000,8 @@ int _media_svc_get_media_id_by_path(sqlite3 *handle, const char *path, char *med
 {
 	int ret = MEDIA_INFO_ERROR_NONE;
 	sqlite3_stmt *sql_stmt = NULL;
-	char *sql = sqlite3_mprintf("SELECT media_uuid FROM %s WHERE validity=1 AND path='%q'",
-					MEDIA_SVC_DB_TABLE_MEDIA, path);
+	char *sql = sqlite3_mprintf("SELECT media_uuid FROM %s WHERE "MEDIA_SVC_VALID_MEDIA" AND path='%q'",
+					MEDIA_SVC_DB_TABLE_MEDIA_DATA, path);
 
 	ret = _media_svc_sql_prepare_to_step(handle, sql, &sql_stmt);
 
@@ -0,0 +1,131 @@
+/*
+ * libmedia-service
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Hyunjun Ko <zzoon.ko@samsung.com>, Haejeong Kim <backto.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <string.h>
+#include "media-svc-storage.h"
+#include "media-svc-error.h"
+#include "media-svc-debug.h"
+#include "media-svc-env.h"
+#include "media-svc-util.h"
+#include "media-svc-db-utils.h"
+#include "media-svc-thumb-journal.h"
+
+/* Deletes items and folders left by the last volume of the storage. Thumbnails are journaled with the delete */
+static int __media_svc_purge_storage(sqlite3 *handle, media_svc_storage_type_e storage_type)
+{
+	int err = -1;
+	char *sql = sqlite3_mprintf("INSERT INTO %s (src_path) SELECT DISTINCT thumbnail_path FROM %s \
+				WHERE storage_type=%d AND thumbnail_path IS NOT NULL AND thumbnail_path != ''; \
+				DELETE FROM %s WHERE storage_type=%d; \
+				DELETE FROM %s WHERE storage_type=%d;",
+				MEDIA_SVC_DB_TABLE_THUMB_JOURNAL, MEDIA_SVC_DB_TABLE_MEDIA_DATA, storage_type,
+				MEDIA_SVC_DB_TABLE_MEDIA_DATA, storage_type,
+				MEDIA_SVC_DB_TABLE_FOLDER_DATA, storage_type);
+
+	media_svc_retv_if(sql == NULL, MEDIA_INFO_ERROR_OUT_OF_MEMORY);
+
+	err = _media_svc_sql_query(handle, sql);
+	sqlite3_free(sql);
+	if (err != SQLITE_OK) {
+		media_svc_error("failed to delete items of last volume (%d)", err);
+		return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
+	}
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+int _media_svc_mount_storage(sqlite3 *handle, media_svc_storage_type_e storage_type, const char *volume_id)
+{
+	int ret = MEDIA_INFO_ERROR_NONE;
+	int err = -1;
+	bool purge = FALSE;
+	char *sql = NULL;
+	sqlite3_stmt *sql_stmt = NULL;
+
+	ret = _media_svc_sql_begin_trans(handle);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	sql = sqlite3_mprintf("SELECT volume_id FROM %s WHERE storage_type=%d", MEDIA_SVC_DB_TABLE_STORAGE, storage_type);
+	ret = _media_svc_sql_prepare_to_step(handle, sql, &sql_stmt);
+	if (ret == MEDIA_INFO_ERROR_NONE) {
+		const char *last_volume_id = (const char *)sqlite3_column_text(sql_stmt, 0);
+
+		/* Volume is unknown when the items are added by old version. They are kept, and checked by the next scan */
+		purge = (STRING_VALID(last_volume_id) && (strcmp(last_volume_id, volume_id) != 0));
+		SQLITE3_FINALIZE(sql_stmt);
+	} else if (ret != MEDIA_INFO_ERROR_DATABASE_NO_RECORD) {
+		_media_svc_sql_rollback_trans(handle);
+		return ret;
+	}
+
+	media_svc_debug("storage[%d] volume[%s] purge last volume[%d]", storage_type, volume_id, purge);
+
+	if (purge) {
+		ret = __media_svc_purge_storage(handle, storage_type);
+		if (ret != MEDIA_INFO_ERROR_NONE) {
+			_media_svc_sql_rollback_trans(handle);
+			return ret;
+		}
+	}
+
+	/* Row is updated rather than replaced, so scan generations of the storage are kept */
+	sql = sqlite3_mprintf("INSERT OR IGNORE INTO %s (storage_type) VALUES (%d); \
+				UPDATE %s SET volume_id=%Q, mounted=1 WHERE storage_type=%d;",
+				MEDIA_SVC_DB_TABLE_STORAGE, storage_type,
+				MEDIA_SVC_DB_TABLE_STORAGE, volume_id, storage_type);
+	err = _media_svc_sql_query(handle, sql);
+	sqlite3_free(sql);
+	if (err != SQLITE_OK) {
+		media_svc_error("failed to mount storage (%d)", err);
+		_media_svc_sql_rollback_trans(handle);
+		return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
+	}
+
+	ret = _media_svc_sql_end_trans(handle);
+	if (ret != MEDIA_INFO_ERROR_NONE) {
+		media_svc_error("mb_svc_sqlite3_commit_trans failed.. Now start to rollback\n");
+		_media_svc_sql_rollback_trans(handle);
+		return ret;
+	}
+
+	if (purge) {
+		ret = _media_svc_thumb_journal_process();
+		if (ret != MEDIA_INFO_ERROR_NONE)
+			media_svc_error("fail to start thumbnail journal. It is resumed by next pass");
+	}
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+int _media_svc_unmount_storage(sqlite3 *handle, media_svc_storage_type_e storage_type)
+{
+	int err = -1;
+	char *sql = sqlite3_mprintf("UPDATE %s SET mounted=0 WHERE storage_type=%d", MEDIA_SVC_DB_TABLE_STORAGE, storage_type);
+
+	err = _media_svc_sql_query(handle, sql);
+	sqlite3_free(sql);
+	if (err != SQLITE_OK) {
+		media_svc_error("failed to unmount storage (%d)", err);
+		return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
+	}
+
+	return MEDIA_INFO_ERROR_NONE;
+}
@@ -0,0 +1,300 @@
+/*
+ * libmedia-service
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Hyunjun Ko <zzoon.ko@samsung.com>, Haejeong Kim <backto.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdio.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "media-svc-thumb-journal.h"
+#include "media-svc-error.h"
+#include "media-svc-debug.h"
+#include "media-svc-env.h"
+#include "media-svc-util.h"
+#include "media-svc-db-utils.h"
+
+#define MEDIA_SVC_THUMB_JOURNAL_BATCH_SIZE		64
+#define MEDIA_SVC_THUMB_JOURNAL_WORKER_NUM		4
+
+typedef struct {
+	int id;
+	char *src_path;
+	char *dst_path;		/* NULL means remove */
+} media_svc_thumb_job_s;
+
+typedef struct {
+	media_svc_thumb_job_s *jobs;
+	int count;
+	int next;
+} media_svc_thumb_batch_s;
+
+static pthread_mutex_t g_thumb_journal_mutex = PTHREAD_MUTEX_INITIALIZER;
+static bool g_thumb_journal_running = FALSE;
+static bool g_thumb_journal_requested = FALSE;
+
+static bool __media_svc_thumb_job_conflicts(media_svc_thumb_job_s *jobs, int count, media_svc_thumb_job_s *job);
+static int __media_svc_thumb_journal_fetch(sqlite3 *handle, int last_id, media_svc_thumb_job_s *jobs, int *count);
+static void __media_svc_thumb_journal_release(media_svc_thumb_job_s *jobs, int count);
+static void __media_svc_thumb_job_do(media_svc_thumb_job_s *job);
+static void *__media_svc_thumb_journal_worker(void *data);
+static void __media_svc_thumb_journal_run_batch(media_svc_thumb_batch_s *batch);
+static void *__media_svc_thumb_journal_thread(void *data);
+
+/* Jobs touching the same file must keep the journal order, so such a job is deferred to the next batch */
+static bool __media_svc_thumb_job_conflicts(media_svc_thumb_job_s *jobs, int count, media_svc_thumb_job_s *job)
+{
+	int i = 0;
+
+	for (i = 0; i < count; i++) {
+		if (strcmp(jobs[i].src_path, job->src_path) == 0)
+			return TRUE;
+		if (jobs[i].dst_path != NULL && strcmp(jobs[i].dst_path, job->src_path) == 0)
+			return TRUE;
+		if (job->dst_path != NULL) {
+			if (strcmp(jobs[i].src_path, job->dst_path) == 0)
+				return TRUE;
+			if (jobs[i].dst_path != NULL && strcmp(jobs[i].dst_path, job->dst_path) == 0)
+				return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+static int __media_svc_thumb_journal_fetch(sqlite3 *handle, int last_id, media_svc_thumb_job_s *jobs, int *count)
+{
+	int err = -1;
+	int idx = 0;
+	sqlite3_stmt *sql_stmt = NULL;
+	char *sql = sqlite3_mprintf("SELECT _id, src_path, dst_path FROM %s WHERE _id > %d ORDER BY _id LIMIT %d",
+					MEDIA_SVC_DB_TABLE_THUMB_JOURNAL, last_id, MEDIA_SVC_THUMB_JOURNAL_BATCH_SIZE);
+
+	media_svc_retv_if(sql == NULL, MEDIA_INFO_ERROR_OUT_OF_MEMORY);
+
+	err = sqlite3_prepare_v2(handle, sql, -1, &sql_stmt, NULL);
+	sqlite3_free(sql);
+	if (err != SQLITE_OK) {
+		media_svc_error("prepare error [%s]", sqlite3_errmsg(handle));
+		return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
+	}
+
+	*count = 0;
+
+	while (sqlite3_step(sql_stmt) == SQLITE_ROW) {
+		media_svc_thumb_job_s job;
+
+		job.id = sqlite3_column_int(sql_stmt, 0);
+		job.src_path = (char *)sqlite3_column_text(sql_stmt, 1);
+		job.dst_path = (char *)sqlite3_column_text(sql_stmt, 2);
+
+		if (!STRING_VALID(job.dst_path))
+			job.dst_path = NULL;
+
+		if (STRING_VALID(job.src_path)) {
+			if (__media_svc_thumb_job_conflicts(jobs, idx, &job))
+				break;
+
+			jobs[idx].src_path = strdup(job.src_path);
+			jobs[idx].dst_path = (job.dst_path != NULL) ? strdup(job.dst_path) : NULL;
+			if (jobs[idx].src_path == NULL || (job.dst_path != NULL && jobs[idx].dst_path == NULL)) {
+				media_svc_error("fail to memory allocation");
+				SAFE_FREE(jobs[idx].src_path);
+				SAFE_FREE(jobs[idx].dst_path);
+				break;
+			}
+		} else {
+			/* Nothing to do. Keep the row only to be dropped with this batch */
+			jobs[idx].src_path = NULL;
+			jobs[idx].dst_path = NULL;
+		}
+
+		jobs[idx].id = job.id;
+		idx++;
+	}
+
+	SQLITE3_FINALIZE(sql_stmt);
+
+	*count = idx;
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+static void __media_svc_thumb_journal_release(media_svc_thumb_job_s *jobs, int count)
+{
+	int i = 0;
+
+	for (i = 0; i < count; i++) {
+		SAFE_FREE(jobs[i].src_path);
+		SAFE_FREE(jobs[i].dst_path);
+	}
+}
+
+static void __media_svc_thumb_job_do(media_svc_thumb_job_s *job)
+{
+	if (job->src_path == NULL)
+		return;
+
+	if (job->dst_path != NULL) {
+		if (strcmp(job->src_path, job->dst_path) == 0)
+			return;
+
+		if (rename(job->src_path, job->dst_path) < 0) {
+			/* Already moved by an earlier pass, or never made */
+			if (errno == ENOENT)
+				media_svc_debug("thumbnail [%s] does not exist", job->src_path);
+			else
+				media_svc_error("fail to move thumbnail [%s] to [%s]. errno : %s", job->src_path, job->dst_path, strerror(errno));
+		}
+	} else {
+		if (unlink(job->src_path) < 0) {
+			if (errno == ENOENT)
+				media_svc_debug("thumbnail [%s] does not exist", job->src_path);
+			else
+				media_svc_error("fail to remove thumbnail [%s]. errno : %s", job->src_path, strerror(errno));
+		}
+	}
+}
+
+static void *__media_svc_thumb_journal_worker(void *data)
+{
+	media_svc_thumb_batch_s *batch = (media_svc_thumb_batch_s *)data;
+	int idx = 0;
+
+	while ((idx = __sync_fetch_and_add(&batch->next, 1)) < batch->count)
+		__media_svc_thumb_job_do(&batch->jobs[idx]);
+
+	return NULL;
+}
+
+static void __media_svc_thumb_journal_run_batch(media_svc_thumb_batch_s *batch)
+{
+	pthread_t workers[MEDIA_SVC_THUMB_JOURNAL_WORKER_NUM];
+	int worker_cnt = 0;
+	int i = 0;
+
+	batch->next = 0;
+
+	for (i = 1; i < MEDIA_SVC_THUMB_JOURNAL_WORKER_NUM && i < batch->count; i++) {
+		if (pthread_create(&workers[worker_cnt], NULL, __media_svc_thumb_journal_worker, batch) != 0) {
+			media_svc_error("fail to create thumbnail worker");
+			break;
+		}
+		worker_cnt++;
+	}
+
+	/* This thread takes its share too, so the batch is done even if no worker could be made */
+	__media_svc_thumb_journal_worker(batch);
+
+	for (i = 0; i < worker_cnt; i++)
+		pthread_join(workers[i], NULL);
+}
+
+static void *__media_svc_thumb_journal_thread(void *data)
+{
+	int ret = MEDIA_INFO_ERROR_NONE;
+	sqlite3 *handle = NULL;
+	media_svc_thumb_job_s jobs[MEDIA_SVC_THUMB_JOURNAL_BATCH_SIZE];
+	media_svc_thumb_batch_s batch;
+	int last_id = 0;
+	char *sql = NULL;
+
+	ret = _media_svc_connect_db_with_handle(&handle);
+	if (ret != MEDIA_INFO_ERROR_NONE) {
+		media_svc_error("fail to connect db for thumbnail journal");
+		handle = NULL;
+	}
+
+	while (handle != NULL) {
+		last_id = 0;
+
+		while (1) {
+			int count = 0;
+
+			ret = __media_svc_thumb_journal_fetch(handle, last_id, jobs, &count);
+			if (ret != MEDIA_INFO_ERROR_NONE || count == 0)
+				break;
+
+			batch.jobs = jobs;
+			batch.count = count;
+			__media_svc_thumb_journal_run_batch(&batch);
+
+			last_id = jobs[count - 1].id;
+			__media_svc_thumb_journal_release(jobs, count);
+
+			/* Progress record. Rows are dropped only after their jobs are done */
+			sql = sqlite3_mprintf("DELETE FROM %s WHERE _id <= %d", MEDIA_SVC_DB_TABLE_THUMB_JOURNAL, last_id);
+			if (_media_svc_sql_query(handle, sql) != SQLITE_OK)
+				media_svc_error("fail to update thumbnail journal");
+			sqlite3_free(sql);
+		}
+
+		pthread_mutex_lock(&g_thumb_journal_mutex);
+		if (!g_thumb_journal_requested) {
+			g_thumb_journal_running = FALSE;
+			pthread_mutex_unlock(&g_thumb_journal_mutex);
+			break;
+		}
+		g_thumb_journal_requested = FALSE;
+		pthread_mutex_unlock(&g_thumb_journal_mutex);
+	}
+
+	if (handle != NULL) {
+		_media_svc_disconnect_db_with_handle(handle);
+	} else {
+		pthread_mutex_lock(&g_thumb_journal_mutex);
+		g_thumb_journal_running = FALSE;
+		pthread_mutex_unlock(&g_thumb_journal_mutex);
+	}
+
+	return NULL;
+}
+
+int _media_svc_thumb_journal_process(void)
+{
+	pthread_t thread;
+	pthread_attr_t attr;
+	int err = -1;
+
+	pthread_mutex_lock(&g_thumb_journal_mutex);
+	if (g_thumb_journal_running) {
+		/* The running pass checks the journal once more before it ends */
+		g_thumb_journal_requested = TRUE;
+		pthread_mutex_unlock(&g_thumb_journal_mutex);
+		return MEDIA_INFO_ERROR_NONE;
+	}
+	g_thumb_journal_running = TRUE;
+	g_thumb_journal_requested = FALSE;
+	pthread_mutex_unlock(&g_thumb_journal_mutex);
+
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+	err = pthread_create(&thread, &attr, __media_svc_thumb_journal_thread, NULL);
+	pthread_attr_destroy(&attr);
+
+	if (err != 0) {
+		media_svc_error("fail to create thumbnail journal thread");
+		pthread_mutex_lock(&g_thumb_journal_mutex);
+		g_thumb_journal_running = FALSE;
+		pthread_mutex_unlock(&g_thumb_journal_mutex);
+		return MEDIA_INFO_ERROR_INTERNAL;
+	}
+
+	return MEDIA_INFO_ERROR_NONE;
+}
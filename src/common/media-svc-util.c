@@ -35,7 +35,9 @@
 #include <mm_error.h>
 #include <libexif/exif-data.h>
 #include <media-thumbnail.h>
-#include "uuid.h"
+#include <fcntl.h>
+#include <stdint.h>
+#include <pthread.h>
 #include "media-svc-util.h"
 #include "media-svc-error.h"
 #include "media-svc-debug.h"
@@ -44,8 +46,6 @@
 #include "media-svc-album.h"
 
 
-#define MEDIA_SVC_FILE_EXT_LEN_MAX				6			/**<  Maximum file ext lenth*/
-
 typedef enum {
 	MEDIA_SVC_EXTRACTED_FIELD_NONE 			= 0x00000001,
 	MEDIA_SVC_EXTRACTED_FIELD_TITLE 			= MEDIA_SVC_EXTRACTED_FIELD_NONE << 1,
@@ -76,16 +76,159 @@ static char *__year_2_str(int year)
 }
 #endif
 
-char *_media_info_generate_uuid(void)
+/*
+ * UUID v4 generator.
+ * Each thread keeps its own xoshiro256** state, seeded once from /dev/urandom, and makes random bytes for a batch of UUIDs at a time.
+ * So there is no lock, no file access and no system call per UUID.
+ * State is reseeded in a child process after fork, so parent and child never make the same sequence.
+ */
+#define MEDIA_SVC_UUID_BATCH_CNT		64
+#define MEDIA_SVC_UUID_BYTES			16
+
+typedef struct {
+	unsigned int fork_generation;
+	bool seeded;
+	uint64_t state[4];
+	unsigned char pool[MEDIA_SVC_UUID_BATCH_CNT * MEDIA_SVC_UUID_BYTES];
+	int pool_pos;
+} media_svc_uuid_gen_s;
+
+static __thread media_svc_uuid_gen_s g_media_svc_uuid_gen;
+static __thread char g_media_svc_uuid_str[MEDIA_SVC_UUID_SIZE + 1];
+static unsigned int g_media_svc_uuid_fork_generation = 0;
+static pthread_once_t g_media_svc_uuid_once = PTHREAD_ONCE_INIT;
+
+static void __media_svc_uuid_atfork_child(void)
+{
+	g_media_svc_uuid_fork_generation++;
+}
+
+static void __media_svc_uuid_init_once(void)
+{
+	pthread_atfork(NULL, NULL, __media_svc_uuid_atfork_child);
+}
+
+static uint64_t __media_svc_uuid_splitmix64(uint64_t *x)
+{
+	uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+static uint64_t __media_svc_uuid_rotl(const uint64_t x, int k)
+{
+	return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t __media_svc_uuid_next(uint64_t *s)
+{
+	const uint64_t result = __media_svc_uuid_rotl(s[1] * 5, 7) * 9;
+	const uint64_t t = s[1] << 17;
+
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = __media_svc_uuid_rotl(s[3], 45);
+
+	return result;
+}
+
+static void __media_svc_uuid_seed(media_svc_uuid_gen_s *gen)
+{
+	int fd = -1;
+	ssize_t len = 0;
+	int i = 0;
+
+	fd = open("/dev/urandom", O_RDONLY);
+	if (fd >= 0) {
+		len = read(fd, gen->state, sizeof(gen->state));
+		close(fd);
+	}
+
+	if (len != sizeof(gen->state)) {
+		/* Fallback. Weak, but still unique per thread and process */
+		struct timespec ts;
+		uint64_t seed = 0;
+
+		media_svc_error("fail to read /dev/urandom");
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		seed = ((uint64_t)ts.tv_sec << 32) ^ (uint64_t)ts.tv_nsec ^ ((uint64_t)getpid() << 16) ^ (uint64_t)(uintptr_t)gen;
+		for (i = 0; i < 4; i++)
+			gen->state[i] = __media_svc_uuid_splitmix64(&seed);
+	}
+
+	/* All zero state never leaves zero */
+	if ((gen->state[0] | gen->state[1] | gen->state[2] | gen->state[3]) == 0)
+		gen->state[0] = 0x9E3779B97F4A7C15ULL;
+
+	gen->fork_generation = g_media_svc_uuid_fork_generation;
+	gen->pool_pos = sizeof(gen->pool);
+	gen->seeded = TRUE;
+}
+
+static void __media_svc_uuid_fill_pool(media_svc_uuid_gen_s *gen)
 {
-	uuid_t uuid_value;
-	static char uuid_unparsed[50];	
+	unsigned int i = 0;
+	uint64_t value = 0;
 
-	uuid_generate(uuid_value);
-	uuid_unparse(uuid_value, uuid_unparsed);
+	for (i = 0; i < sizeof(gen->pool); i += sizeof(value)) {
+		value = __media_svc_uuid_next(gen->state);
+		memcpy(&gen->pool[i], &value, sizeof(value));
+	}
+
+	gen->pool_pos = 0;
+}
+
+int _media_svc_generate_uuid(char *uuid, int max_length)
+{
+	static const char hex[] = "0123456789abcdef";
+	media_svc_uuid_gen_s *gen = &g_media_svc_uuid_gen;
+	unsigned char *bytes = NULL;
+	char *out = uuid;
+	int i = 0;
+
+	media_svc_retvm_if(uuid == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "uuid is NULL");
+	media_svc_retvm_if(max_length < MEDIA_SVC_UUID_SIZE + 1, MEDIA_INFO_ERROR_INVALID_PARAMETER, "buffer is too small");
+
+	if (!gen->seeded) {
+		pthread_once(&g_media_svc_uuid_once, __media_svc_uuid_init_once);
+		__media_svc_uuid_seed(gen);
+	} else if (gen->fork_generation != g_media_svc_uuid_fork_generation) {
+		__media_svc_uuid_seed(gen);
+	}
+
+	if (gen->pool_pos + MEDIA_SVC_UUID_BYTES > (int)sizeof(gen->pool))
+		__media_svc_uuid_fill_pool(gen);
+
+	bytes = &gen->pool[gen->pool_pos];
+	gen->pool_pos += MEDIA_SVC_UUID_BYTES;
+
+	/* version 4, variant RFC 4122 */
+	bytes[6] = (bytes[6] & 0x0F) | 0x40;
+	bytes[8] = (bytes[8] & 0x3F) | 0x80;
+
+	for (i = 0; i < MEDIA_SVC_UUID_BYTES; i++) {
+		if (i == 4 || i == 6 || i == 8 || i == 10)
+			*out++ = '-';
+		*out++ = hex[bytes[i] >> 4];
+		*out++ = hex[bytes[i] & 0x0F];
+	}
+	*out = '\0';
+
+	return MEDIA_INFO_ERROR_NONE;
+}
 
-	//media_svc_debug("UUID : %s", uuid_unparsed);
-	return uuid_unparsed;
+/* The returned buffer is per thread, and is overwritten by next call in the same thread */
+char *_media_info_generate_uuid(void)
+{
+	if (_media_svc_generate_uuid(g_media_svc_uuid_str, sizeof(g_media_svc_uuid_str)) != MEDIA_INFO_ERROR_NONE)
+		return NULL;
+
+	return g_media_svc_uuid_str;
 }
 
 void _strncpy_safe(char *x_dst, const char *x_src, int max_len)
@@ -132,6 +275,102 @@ int __media_svc_malloc_and_strncpy(char **dst, const char *src)
 	return MEDIA_INFO_ERROR_NONE;
 }
 
+/* Returns len bytes aligned for any struct, so items of a list can share the arena with their strings */
+void *_media_svc_arena_alloc(media_svc_arena_s *arena, size_t len)
+{
+	media_svc_arena_block_s *block = arena->head;
+	size_t size = MEDIA_SVC_ARENA_BLOCK_SIZE;
+	size_t pad = 0;
+	char *p = NULL;
+
+	if (block != NULL)
+		pad = (size_t)(-(uintptr_t)(block->data + block->used)) & (MEDIA_SVC_ARENA_ALIGN - 1);
+
+	if (block == NULL || block->size - block->used < pad + len) {
+		if (len + MEDIA_SVC_ARENA_ALIGN > size)
+			size = len + MEDIA_SVC_ARENA_ALIGN;
+
+		block = malloc(sizeof(media_svc_arena_block_s) + size);
+		if (block == NULL)
+			return NULL;
+
+		block->size = size;
+		block->used = 0;
+		block->next = arena->head;
+		arena->head = block;
+
+		pad = (size_t)(-(uintptr_t)block->data) & (MEDIA_SVC_ARENA_ALIGN - 1);
+	}
+
+	p = block->data + block->used + pad;
+	block->used += pad + len;
+
+	return p;
+}
+
+char *_media_svc_arena_strdup(media_svc_arena_s *arena, const char *src)
+{
+	size_t len = 0;
+	char *p = NULL;
+
+	if (src == NULL)
+		return NULL;
+
+	len = strlen(src) + 1;
+	p = _media_svc_arena_alloc(arena, len);
+	if (p != NULL)
+		memcpy(p, src, len);
+
+	return p;
+}
+
+void _media_svc_arena_reset(media_svc_arena_s *arena)
+{
+	media_svc_arena_block_s *block = NULL;
+
+	if (arena == NULL || arena->head == NULL)
+		return;
+
+	while (arena->head->next != NULL) {
+		block = arena->head;
+		arena->head = block->next;
+		free(block);
+	}
+
+	arena->head->used = 0;
+}
+
+void _media_svc_arena_destroy(media_svc_arena_s *arena)
+{
+	if (arena == NULL)
+		return;
+
+	_media_svc_arena_reset(arena);
+	SAFE_FREE(arena->head);
+}
+
+/* Sets a string of content info. Old value is kept in arena until it is reset */
+int _media_svc_set_content_str(media_svc_content_info_s *content_info, char **dst, const char *src)
+{
+	size_t len = 0;
+
+	if (content_info->arena == NULL)
+		return __media_svc_malloc_and_strncpy(dst, src);
+
+	if (!STRING_VALID(src)) {
+		media_svc_error("invalid src");
+		return MEDIA_INFO_ERROR_INVALID_PARAMETER;
+	}
+
+	*dst = _media_svc_arena_strdup(content_info->arena, src);
+	if (*dst == NULL) {
+		media_svc_error("malloc failed");
+		return MEDIA_INFO_ERROR_INTERNAL;
+	}
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
 static void __media_svc_split_to_double(char *input, double *arr, int *num)
 {
 	char tmp_arr[255] = { 0, };
@@ -547,26 +786,214 @@ int _media_svc_get_file_time(const char *full_path)
 	 return statbuf.st_mtime;
 }
 
-int _media_svc_set_media_info(media_svc_content_info_s *content_info, media_svc_storage_type_e storage_type,
+/* Extensions which are not used by any DRM scheme. DRM client is not asked for these files */
+static const char *g_media_svc_non_drm_ext[] = {
+	"jpg", "jpeg", "png", "gif", "bmp", "wbmp", "tif", "tiff",
+	"mp3", "wav", "amr", "awb", "ogg", "oga", "flac", "aac", "mid", "midi", "imy", "xmf", "mmf", "spm",
+	NULL
+};
+
+void _media_svc_probe_init(media_svc_probe_s *probe, const char *path)
+{
+	memset(probe, 0, sizeof(media_svc_probe_s));
+	probe->path = path;
+}
+
+const struct stat *_media_svc_probe_stat(media_svc_probe_s *probe)
+{
+	if (!probe->stat_done) {
+		probe->stat_done = TRUE;
+
+		if (stat(probe->path, &probe->st) == 0) {
+			probe->stat_ok = TRUE;
+		} else {
+			media_svc_error("stat failed : %s", strerror(errno));
+		}
+	}
+
+	return probe->stat_ok ? &probe->st : NULL;
+}
+
+const char *_media_svc_probe_ext(media_svc_probe_s *probe)
+{
+	if (!probe->ext_done) {
+		probe->ext_done = TRUE;
+
+		if (!_media_svc_get_file_ext(probe->path, probe->ext))
+			probe->ext[0] = '\0';
+	}
+
+	return probe->ext;
+}
+
+int _media_svc_probe_is_drm(media_svc_probe_s *probe)
+{
+	int ret = 0;
+	int i = 0;
+	const char *ext = NULL;
+	drm_bool_type_e drm_type = DRM_FALSE;
+
+	if (probe->drm_done)
+		return probe->is_drm;
+
+	probe->drm_done = TRUE;
+	probe->is_drm = DRM_FALSE;
+
+	ext = _media_svc_probe_ext(probe);
+	for (i = 0; g_media_svc_non_drm_ext[i] != NULL; i++) {
+		if (strcasecmp(ext, g_media_svc_non_drm_ext[i]) == 0)
+			return probe->is_drm;
+	}
+
+	ret = drm_is_drm_file(probe->path, &drm_type);
+	if (ret < 0) {
+		media_svc_error("drm_is_drm_file falied : %d", ret);
+		drm_type = DRM_FALSE;
+	}
+
+	probe->is_drm = drm_type;
+
+	return probe->is_drm;
+}
+
+bool _media_svc_probe_drm_locked(media_svc_probe_s *probe)
+{
+	int ret = 0;
+	bool invalid_file = FALSE;
+	drm_license_status_e license_status;
+
+	if (probe->drm_detail_done)
+		return probe->drm_locked;
+
+	probe->drm_detail_done = TRUE;
+	probe->drm_locked = FALSE;
+	probe->drm_file_type = DRM_TYPE_UNDEFINED;
+	memset(&probe->drm_content, 0x00, sizeof(drm_content_info_s));
+
+	if (!_media_svc_probe_is_drm(probe))
+		return probe->drm_locked;
+
+	ret = drm_get_file_type(probe->path, &probe->drm_file_type);
+	if (ret < 0) {
+		media_svc_error("drm_get_file_type falied : %d", ret);
+		invalid_file = TRUE;
+	}
+
+	ret = drm_get_content_info(probe->path, &probe->drm_content);
+	if (ret != DRM_RETURN_SUCCESS) {
+		media_svc_error("drm_get_content_info() fails. : %d", ret);
+		invalid_file = TRUE;
+	}
+
+	ret = drm_get_license_status(probe->path, DRM_PERMISSION_TYPE_PLAY, &license_status);
+	if (ret != DRM_RETURN_SUCCESS) {
+		media_svc_error("drm_get_license_status() fails. : %d", ret);
+		invalid_file = TRUE;
+	}
+
+	/* DRM header is used only when all of it is read */
+	if (invalid_file) {
+		probe->drm_file_type = DRM_TYPE_UNDEFINED;
+		memset(&probe->drm_content, 0x00, sizeof(drm_content_info_s));
+		probe->drm_locked = TRUE;
+	} else if (license_status != DRM_LICENSE_STATUS_VALID) {
+		probe->drm_locked = TRUE;
+	}
+
+	return probe->drm_locked;
+}
+
+/* Scanner classifies .3gp and .mp4 files by their streams when it checks a file and when it inserts it,
+ * and extraction opens the same file next. Stream info of the last probed file is kept while the file is not changed */
+typedef struct {
+	char		*path;
+	time_t	mtime;
+	off_t		size;
+	int			audio;
+	int			video;
+} media_svc_stream_info_cache_s;
+
+static pthread_mutex_t g_media_svc_stream_info_mutex = PTHREAD_MUTEX_INITIALIZER;
+static media_svc_stream_info_cache_s g_media_svc_stream_info_cache;
+
+static bool __media_svc_lookup_stream_info(const char *path, const struct stat *st, int *audio, int *video)
+{
+	bool found = FALSE;
+
+	pthread_mutex_lock(&g_media_svc_stream_info_mutex);
+	if (g_media_svc_stream_info_cache.path != NULL && g_media_svc_stream_info_cache.mtime == st->st_mtime
+		&& g_media_svc_stream_info_cache.size == st->st_size && strcmp(g_media_svc_stream_info_cache.path, path) == 0) {
+		*audio = g_media_svc_stream_info_cache.audio;
+		*video = g_media_svc_stream_info_cache.video;
+		found = TRUE;
+	}
+	pthread_mutex_unlock(&g_media_svc_stream_info_mutex);
+
+	return found;
+}
+
+static void __media_svc_keep_stream_info(const char *path, const struct stat *st, int audio, int video)
+{
+	char *dup = strdup(path);
+
+	if (dup == NULL)
+		return;
+
+	pthread_mutex_lock(&g_media_svc_stream_info_mutex);
+	SAFE_FREE(g_media_svc_stream_info_cache.path);
+	g_media_svc_stream_info_cache.path = dup;
+	g_media_svc_stream_info_cache.mtime = st->st_mtime;
+	g_media_svc_stream_info_cache.size = st->st_size;
+	g_media_svc_stream_info_cache.audio = audio;
+	g_media_svc_stream_info_cache.video = video;
+	pthread_mutex_unlock(&g_media_svc_stream_info_mutex);
+}
+
+int _media_svc_get_stream_info(const char *path, int *audio, int *video)
+{
+	int err = 0;
+	struct stat st;
+
+	if (stat(path, &st) != 0)
+		return mm_file_get_stream_info(path, audio, video);
+
+	if (__media_svc_lookup_stream_info(path, &st, audio, video))
+		return 0;
+
+	err = mm_file_get_stream_info(path, audio, video);
+	if (err == 0)
+		__media_svc_keep_stream_info(path, &st, *audio, *video);
+
+	return err;
+}
+
+bool _media_svc_probe_stream_info(media_svc_probe_s *probe, int *audio, int *video)
+{
+	const struct stat *st = _media_svc_probe_stat(probe);
+
+	if (st == NULL)
+		return FALSE;
+
+	return __media_svc_lookup_stream_info(probe->path, st, audio, video);
+}
+
+int _media_svc_set_media_info(media_svc_content_info_s *content_info, media_svc_probe_s *probe, media_svc_storage_type_e storage_type,
 			  const char *path, const char *mime_type, media_svc_media_type_e media_type, bool refresh)
 {
 	int ret = MEDIA_INFO_ERROR_NONE;
-	char * media_uuid = NULL;
+	char media_uuid[MEDIA_SVC_UUID_SIZE+1] = {0,};
 	char * file_name = NULL;
-	struct stat st;
-	drm_bool_type_e drm_type;
+	const struct stat *st = NULL;
 
-	ret = __media_svc_malloc_and_strncpy(&content_info->path, path);
+	ret = _media_svc_set_content_str(content_info, &content_info->path, path);
 	media_svc_retv_del_if(ret < 0, ret, content_info);
 
-	memset(&st, 0, sizeof(struct stat));
-	if (stat(path, &st) == 0) {
-		content_info->modified_time = st.st_mtime;
-		content_info->size = st.st_size;
+	st = _media_svc_probe_stat(probe);
+	if (st != NULL) {
+		content_info->modified_time = st->st_mtime;
+		content_info->size = st->st_size;
 		media_svc_debug("Modified time : %d", content_info->modified_time);
 		media_svc_debug("Size : %lld", content_info->size);
-	} else {
-		media_svc_error("stat failed : %s", strerror(errno));
 	}
 
 	/* refresh is TRUE when file modified. so only modified_time and size are changed*/
@@ -579,28 +1006,22 @@ int _media_svc_set_media_info(media_svc_content_info_s *content_info, media_svc_
 	content_info->storage_type = storage_type;
 	time(&content_info->added_time);
 
-	media_uuid = _media_info_generate_uuid();
-	media_svc_retvm_if(media_uuid == NULL, MEDIA_INFO_ERROR_INTERNAL, "Invalid UUID");
+	ret = _media_svc_generate_uuid(media_uuid, sizeof(media_uuid));
+	media_svc_retvm_if(ret != MEDIA_INFO_ERROR_NONE, MEDIA_INFO_ERROR_INTERNAL, "Invalid UUID");
 
-	ret = __media_svc_malloc_and_strncpy(&content_info->media_uuid, media_uuid);
+	ret = _media_svc_set_content_str(content_info, &content_info->media_uuid, media_uuid);
 	media_svc_retv_del_if(ret < 0, ret, content_info);
 
-	ret = __media_svc_malloc_and_strncpy(&content_info->mime_type, mime_type);
+	ret = _media_svc_set_content_str(content_info, &content_info->mime_type, mime_type);
 	media_svc_retv_del_if(ret < 0, ret, content_info);
 
 	file_name = g_path_get_basename(path);
-	ret = __media_svc_malloc_and_strncpy(&content_info->file_name, file_name);
+	ret = _media_svc_set_content_str(content_info, &content_info->file_name, file_name);
 	SAFE_FREE(file_name);
 	media_svc_retv_del_if(ret < 0, ret, content_info);
 	//_strncpy_safe(content_info->file_name, file_name, sizeof(content_info->file_name));
 
-	ret = drm_is_drm_file(content_info->path, &drm_type);
-	if (ret < 0) {
-		media_svc_error("drm_is_drm_file falied : %d", ret);
-		drm_type = DRM_FALSE;
-	}
-
-	content_info->is_drm = drm_type;
+	content_info->is_drm = _media_svc_probe_is_drm(probe);
 
 	content_info->played_count = 0;
 	content_info->last_played_time= 0;
@@ -694,15 +1115,15 @@ int _media_svc_extract_image_metadata(media_svc_content_info_s *content_info, me
 	if (__media_svc_get_exif_info(ed, description_buf, NULL, NULL, EXIF_IFD_0, EXIF_TAG_IMAGE_DESCRIPTION) == MEDIA_INFO_ERROR_NONE) {
 		if (strlen(description_buf) == 0) {
 			media_svc_debug("Use 'No description'");
-			ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.description, "No description");
+			ret = _media_svc_set_content_str(content_info, &content_info->media_meta.description, "No description");
 			media_svc_retv_del_if(ret < 0, ret, content_info);
 		} else {
-			ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.description, description_buf);
+			ret = _media_svc_set_content_str(content_info, &content_info->media_meta.description, description_buf);
 			media_svc_retv_del_if(ret < 0, ret, content_info);
 		}
 	} else {
 		media_svc_debug("Use 'No description'");
-		ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.description, "No description");
+		ret = _media_svc_set_content_str(content_info, &content_info->media_meta.description, "No description");
 		media_svc_retv_del_if(ret < 0, ret, content_info);
 	}
 
@@ -713,7 +1134,7 @@ int _media_svc_extract_image_metadata(media_svc_content_info_s *content_info, me
 			media_svc_debug("time  is NULL");
 		} else {
 			media_svc_debug("time  is %s", buf);
-			ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.datetaken, buf);
+			ret = _media_svc_set_content_str(content_info, &content_info->media_meta.datetaken, buf);
 			media_svc_retv_del_if(ret < 0, ret, content_info);
 		}
 	} else {
@@ -769,13 +1190,13 @@ int _media_svc_extract_image_metadata(media_svc_content_info_s *content_info, me
 
 	content_info->media_meta.width = width;
 	content_info->media_meta.height = height;
-	ret = __media_svc_malloc_and_strncpy(&content_info->thumbnail_path, thumb_path);
+	ret = _media_svc_set_content_str(content_info, &content_info->thumbnail_path, thumb_path);
 	media_svc_retv_del_if(ret < 0, ret, content_info);
 
 	return MEDIA_INFO_ERROR_NONE;
 }
 
-int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s *content_info, media_svc_media_type_e media_type)
+int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s *content_info, media_svc_probe_s *probe, media_svc_media_type_e media_type)
 {
 	MMHandleType content = 0;
 	MMHandleType tag = 0;
@@ -792,129 +1213,96 @@ int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s
 	int album_id = 0;
 	double gps_value = 0.0;
 	int ret = MEDIA_INFO_ERROR_NONE;
-	drm_bool_type_e drm_type;
 	char *path = content_info->path;
-
-	ret = drm_is_drm_file(path, &drm_type);
-	if (ret < 0) {
-		media_svc_error("drm_is_drm_file falied : %d", ret);
-		drm_type = DRM_FALSE;
-	}
+	int audio_stream = 0;
+	int video_stream = 0;
+	bool no_video_stream = FALSE;
 
 	/*To do - code for DRM content*/
-	if (drm_type) {
-		bool invalid_file = FALSE;
-		drm_file_type_e drm_file_type;
-		drm_permission_type_e drm_perm_type = DRM_PERMISSION_TYPE_PLAY;
-		drm_content_info_s contentInfo;
-		drm_license_status_e license_status;
-		memset(&contentInfo, 0x00, sizeof(drm_content_info_s));
-
-		ret = drm_get_file_type(path, &drm_file_type);
-		if (ret < 0) {
-			media_svc_error("drm_get_file_type falied : %d", ret);
-			drm_file_type = DRM_TYPE_UNDEFINED;
-			invalid_file = TRUE;
-		}
-
-		ret = drm_get_content_info(path, &contentInfo);
-		if (ret != DRM_RETURN_SUCCESS) {
-			media_svc_error("drm_get_content_info() fails. : %d", ret);
-			invalid_file = TRUE;
-		}
-
-		ret = drm_get_license_status(path, drm_perm_type, &license_status);
-		if (ret != DRM_RETURN_SUCCESS) {
-			media_svc_error("drm_get_license_status() fails. : %d", ret);
-			invalid_file = TRUE;
-		}
-
-		if ((!invalid_file) && (license_status != DRM_LICENSE_STATUS_VALID)) {
-			invalid_file = TRUE;
-			if (drm_file_type == DRM_TYPE_OMA_V1) {
-
-				if (strlen(contentInfo.title) > 0) {
-					 __media_svc_malloc_and_strncpy(&content_info->media_meta.title, contentInfo.title);
-					media_svc_retv_del_if(ret < 0, ret, content_info);
-					extracted_field |= MEDIA_SVC_EXTRACTED_FIELD_TITLE;
-				}
+	if (_media_svc_probe_drm_locked(probe)) {
+		const drm_content_info_s *contentInfo = &probe->drm_content;
 
-				if (strlen(contentInfo.description) > 0) {
-					 __media_svc_malloc_and_strncpy(&content_info->media_meta.description, contentInfo.description);
-					media_svc_retv_del_if(ret < 0, ret, content_info);
-					extracted_field |= MEDIA_SVC_EXTRACTED_FIELD_DESC;
-				}
-			} else if (drm_file_type == DRM_TYPE_OMA_V2) {
-				if (strlen(contentInfo.title) > 0) {
-					 __media_svc_malloc_and_strncpy(&content_info->media_meta.title, contentInfo.title);
-					media_svc_retv_del_if(ret < 0, ret, content_info);
-					extracted_field |= MEDIA_SVC_EXTRACTED_FIELD_TITLE;
-				}
-
-				if (strlen(contentInfo.description) > 0) {
-					 __media_svc_malloc_and_strncpy(&content_info->media_meta.description, contentInfo.description);
-					media_svc_retv_del_if(ret < 0, ret, content_info);
-					extracted_field |= MEDIA_SVC_EXTRACTED_FIELD_DESC;
-				}
-
-				if (strlen(contentInfo.copyright) > 0) {
-					 __media_svc_malloc_and_strncpy(&content_info->media_meta.copyright, contentInfo.copyright);
-					media_svc_retv_del_if(ret < 0, ret, content_info);
-					extracted_field |= MEDIA_SVC_EXTRACTED_FIELD_COPYRIGHT;
-				}
-
-				if (strlen(contentInfo.author) > 0) {
-					 __media_svc_malloc_and_strncpy(&content_info->media_meta.composer, contentInfo.author);
-					media_svc_retv_del_if(ret < 0, ret, content_info);
-					 __media_svc_malloc_and_strncpy(&content_info->media_meta.artist, contentInfo.author);
-					media_svc_retv_del_if(ret < 0, ret, content_info);
+		if (probe->drm_file_type == DRM_TYPE_OMA_V1) {
 
-					extracted_field |= MEDIA_SVC_EXTRACTED_FIELD_AUTHOR;
-					extracted_field |= MEDIA_SVC_EXTRACTED_FIELD_ARTIST;
-				}
+			if (strlen(contentInfo->title) > 0) {
+				 _media_svc_set_content_str(content_info, &content_info->media_meta.title, contentInfo->title);
+				media_svc_retv_del_if(ret < 0, ret, content_info);
+				extracted_field |= MEDIA_SVC_EXTRACTED_FIELD_TITLE;
 			}
-		}
 
-		if (invalid_file) {
-			if (!(extracted_field & MEDIA_SVC_EXTRACTED_FIELD_TITLE)) {
-				title = _media_svc_get_title_from_filepath(path);
-				if (title) {
-					ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.title, title);
-					SAFE_FREE(title);
-					media_svc_retv_del_if(ret < 0, ret, content_info);
-				} else {
-					media_svc_error("Can't extract title from filepath [%s]", content_info->path);
-					ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.title, MEDIA_SVC_TAG_UNKNOWN);
-					media_svc_retv_del_if(ret < 0, ret, content_info);
-				}
+			if (strlen(contentInfo->description) > 0) {
+				 _media_svc_set_content_str(content_info, &content_info->media_meta.description, contentInfo->description);
+				media_svc_retv_del_if(ret < 0, ret, content_info);
+				extracted_field |= MEDIA_SVC_EXTRACTED_FIELD_DESC;
+			}
+		} else if (probe->drm_file_type == DRM_TYPE_OMA_V2) {
+			if (strlen(contentInfo->title) > 0) {
+				 _media_svc_set_content_str(content_info, &content_info->media_meta.title, contentInfo->title);
+				media_svc_retv_del_if(ret < 0, ret, content_info);
+				extracted_field |= MEDIA_SVC_EXTRACTED_FIELD_TITLE;
 			}
 
-			if (!(extracted_field & MEDIA_SVC_EXTRACTED_FIELD_DESC)) {
-				__media_svc_malloc_and_strncpy(&content_info->media_meta.description, MEDIA_SVC_TAG_UNKNOWN);
+			if (strlen(contentInfo->description) > 0) {
+				 _media_svc_set_content_str(content_info, &content_info->media_meta.description, contentInfo->description);
 				media_svc_retv_del_if(ret < 0, ret, content_info);
+				extracted_field |= MEDIA_SVC_EXTRACTED_FIELD_DESC;
 			}
-			if (!(extracted_field & MEDIA_SVC_EXTRACTED_FIELD_AUTHOR)) {
-				__media_svc_malloc_and_strncpy(&content_info->media_meta.composer, MEDIA_SVC_TAG_UNKNOWN);
+
+			if (strlen(contentInfo->copyright) > 0) {
+				 _media_svc_set_content_str(content_info, &content_info->media_meta.copyright, contentInfo->copyright);
 				media_svc_retv_del_if(ret < 0, ret, content_info);
+				extracted_field |= MEDIA_SVC_EXTRACTED_FIELD_COPYRIGHT;
 			}
-			if (!(extracted_field & MEDIA_SVC_EXTRACTED_FIELD_ARTIST)) {
-				__media_svc_malloc_and_strncpy(&content_info->media_meta.description, MEDIA_SVC_TAG_UNKNOWN);
+
+			if (strlen(contentInfo->author) > 0) {
+				 _media_svc_set_content_str(content_info, &content_info->media_meta.composer, contentInfo->author);
+				media_svc_retv_del_if(ret < 0, ret, content_info);
+				 _media_svc_set_content_str(content_info, &content_info->media_meta.artist, contentInfo->author);
 				media_svc_retv_del_if(ret < 0, ret, content_info);
+
+				extracted_field |= MEDIA_SVC_EXTRACTED_FIELD_AUTHOR;
+				extracted_field |= MEDIA_SVC_EXTRACTED_FIELD_ARTIST;
 			}
-			if (!(extracted_field & MEDIA_SVC_EXTRACTED_FIELD_COPYRIGHT)) {
-				__media_svc_malloc_and_strncpy(&content_info->media_meta.copyright, MEDIA_SVC_TAG_UNKNOWN);
+		}
+
+		if (!(extracted_field & MEDIA_SVC_EXTRACTED_FIELD_TITLE)) {
+			title = _media_svc_get_title_from_filepath(path);
+			if (title) {
+				ret = _media_svc_set_content_str(content_info, &content_info->media_meta.title, title);
+				SAFE_FREE(title);
+				media_svc_retv_del_if(ret < 0, ret, content_info);
+			} else {
+				media_svc_error("Can't extract title from filepath [%s]", content_info->path);
+				ret = _media_svc_set_content_str(content_info, &content_info->media_meta.title, MEDIA_SVC_TAG_UNKNOWN);
 				media_svc_retv_del_if(ret < 0, ret, content_info);
 			}
+		}
 
-			__media_svc_malloc_and_strncpy(&content_info->media_meta.album, MEDIA_SVC_TAG_UNKNOWN);
+		if (!(extracted_field & MEDIA_SVC_EXTRACTED_FIELD_DESC)) {
+			_media_svc_set_content_str(content_info, &content_info->media_meta.description, MEDIA_SVC_TAG_UNKNOWN);
+			media_svc_retv_del_if(ret < 0, ret, content_info);
+		}
+		if (!(extracted_field & MEDIA_SVC_EXTRACTED_FIELD_AUTHOR)) {
+			_media_svc_set_content_str(content_info, &content_info->media_meta.composer, MEDIA_SVC_TAG_UNKNOWN);
 			media_svc_retv_del_if(ret < 0, ret, content_info);
-			__media_svc_malloc_and_strncpy(&content_info->media_meta.genre, MEDIA_SVC_TAG_UNKNOWN);
+		}
+		if (!(extracted_field & MEDIA_SVC_EXTRACTED_FIELD_ARTIST)) {
+			_media_svc_set_content_str(content_info, &content_info->media_meta.description, MEDIA_SVC_TAG_UNKNOWN);
 			media_svc_retv_del_if(ret < 0, ret, content_info);
-			__media_svc_malloc_and_strncpy(&content_info->media_meta.year, MEDIA_SVC_TAG_UNKNOWN);
+		}
+		if (!(extracted_field & MEDIA_SVC_EXTRACTED_FIELD_COPYRIGHT)) {
+			_media_svc_set_content_str(content_info, &content_info->media_meta.copyright, MEDIA_SVC_TAG_UNKNOWN);
 			media_svc_retv_del_if(ret < 0, ret, content_info);
-
-			return MEDIA_INFO_ERROR_NONE;
 		}
+
+		_media_svc_set_content_str(content_info, &content_info->media_meta.album, MEDIA_SVC_TAG_UNKNOWN);
+		media_svc_retv_del_if(ret < 0, ret, content_info);
+		_media_svc_set_content_str(content_info, &content_info->media_meta.genre, MEDIA_SVC_TAG_UNKNOWN);
+		media_svc_retv_del_if(ret < 0, ret, content_info);
+		_media_svc_set_content_str(content_info, &content_info->media_meta.year, MEDIA_SVC_TAG_UNKNOWN);
+		media_svc_retv_del_if(ret < 0, ret, content_info);
+
+		return MEDIA_INFO_ERROR_NONE;
 	}
 
 #if 0
@@ -932,13 +1320,13 @@ int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s
 				media_svc_debug("cannot get dcf header info. just get the title");
 				title = _media_svc_get_title_from_filepath(content_info->path);
 				if (title) {
-					ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.title, title);
+					ret = _media_svc_set_content_str(content_info, &content_info->media_meta.title, title);
 					SAFE_FREE(title);
 					media_svc_retv_del_if(ret < 0, ret, content_info);
 					//_strncpy_safe(content_info->media_meta.title, title, sizeof(content_info->media_meta.title));
 				} else {
 					media_svc_error("Can't extract title from filepath [%s]", content_info->path);
-					ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.title, MEDIA_SVC_TAG_UNKNOWN);
+					ret = _media_svc_set_content_str(content_info, &content_info->media_meta.title, MEDIA_SVC_TAG_UNKNOWN);
 					media_svc_retv_del_if(ret < 0, ret, content_info);
 				}
 
@@ -950,15 +1338,15 @@ int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s
 				_strncpy_safe(content_info->media_meta.year, MEDIA_SVC_TAG_UNKNOWN, sizeof(content_info->media_meta.year));
 */
 
-				ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.album, MEDIA_SVC_TAG_UNKNOWN);
+				ret = _media_svc_set_content_str(content_info, &content_info->media_meta.album, MEDIA_SVC_TAG_UNKNOWN);
 				media_svc_retv_del_if(ret < 0, ret, content_info);
-				ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.artist, MEDIA_SVC_TAG_UNKNOWN);
+				ret = _media_svc_set_content_str(content_info, &content_info->media_meta.artist, MEDIA_SVC_TAG_UNKNOWN);
 				media_svc_retv_del_if(ret < 0, ret, content_info);
-				ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.genre, MEDIA_SVC_TAG_UNKNOWN);
+				ret = _media_svc_set_content_str(content_info, &content_info->media_meta.genre, MEDIA_SVC_TAG_UNKNOWN);
 				media_svc_retv_del_if(ret < 0, ret, content_info);
-				ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.composer, MEDIA_SVC_TAG_UNKNOWN);
+				ret = _media_svc_set_content_str(content_info, &content_info->media_meta.composer, MEDIA_SVC_TAG_UNKNOWN);
 				media_svc_retv_del_if(ret < 0, ret, content_info);
-				ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.year, MEDIA_SVC_TAG_UNKNOWN);
+				ret = _media_svc_set_content_str(content_info, &content_info->media_meta.year, MEDIA_SVC_TAG_UNKNOWN);
 				media_svc_retv_del_if(ret < 0, ret, content_info);
 
 				return MEDIA_INFO_ERROR_NONE;
@@ -976,7 +1364,7 @@ int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s
 					if (strlen(header_info.headerUnion.headerV1.contentName) > 0) {
 
 						//_strncpy_safe(content_info->media_meta.title, header_info.headerUnion.headerV1.contentName, sizeof(content_info->media_meta.title));
-						ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.title, header_info.headerUnion.headerV1.contentName);
+						ret = _media_svc_set_content_str(content_info, &content_info->media_meta.title, header_info.headerUnion.headerV1.contentName);
 						media_svc_retv_del_if(ret < 0, ret, content_info);
 
 						extracted_field |= MEDIA_SVC_EXTRACTED_FIELD_TITLE;
@@ -985,7 +1373,7 @@ int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s
 
 					if (strlen(header_info.headerUnion.headerV1.contentDescription) > 0) {
 						//_strncpy_safe(content_info->media_meta.description, header_info.headerUnion.headerV1.contentDescription, sizeof(content_info->media_meta.description));
-						ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.description, header_info.headerUnion.headerV1.contentDescription);
+						ret = _media_svc_set_content_str(content_info, &content_info->media_meta.description, header_info.headerUnion.headerV1.contentDescription);
 						media_svc_retv_del_if(ret < 0, ret, content_info);
 
 						extracted_field |= MEDIA_SVC_EXTRACTED_FIELD_DESC;
@@ -1000,7 +1388,7 @@ int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s
 
 				if (drm_svc_get_user_data_box_info(content_info->path, DRM_UDTA_TITLE, &metadata) == DRM_RESULT_SUCCESS) {
 					//_strncpy_safe(content_info->media_meta.title, metadata.subBox.title.str, sizeof(content_info->media_meta.title));
-					ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.title, metadata.subBox.title.str);
+					ret = _media_svc_set_content_str(content_info, &content_info->media_meta.title, metadata.subBox.title.str);
 					media_svc_retv_del_if(ret < 0, ret, content_info);
 
 					extracted_field |= MEDIA_SVC_EXTRACTED_FIELD_TITLE;
@@ -1009,7 +1397,7 @@ int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s
 
 				if (drm_svc_get_user_data_box_info(content_info->path, DRM_UDTA_DESCRIPTION, &metadata) == DRM_RESULT_SUCCESS) {
 					//_strncpy_safe(content_info->media_meta.description, metadata.subBox.desc.str, sizeof(content_info->media_meta.description));
-					ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.description, metadata.subBox.desc.str);
+					ret = _media_svc_set_content_str(content_info, &content_info->media_meta.description, metadata.subBox.desc.str);
 					media_svc_retv_del_if(ret < 0, ret, content_info);
 
 					extracted_field |= MEDIA_SVC_EXTRACTED_FIELD_DESC;
@@ -1017,7 +1405,7 @@ int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s
 
 				if (drm_svc_get_user_data_box_info(content_info->path, DRM_UDTA_COPYRIGHT, &metadata) == DRM_RESULT_SUCCESS) {
 					//_strncpy_safe(content_info->media_meta.copyright, metadata.subBox.copyright.str, sizeof(content_info->media_meta.copyright));
-					ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.copyright, metadata.subBox.copyright.str);
+					ret = _media_svc_set_content_str(content_info, &content_info->media_meta.copyright, metadata.subBox.copyright.str);
 					media_svc_retv_del_if(ret < 0, ret, content_info);
 
 					extracted_field |= MEDIA_SVC_EXTRACTED_FIELD_COPYRIGHT;
@@ -1025,7 +1413,7 @@ int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s
 
 				if (drm_svc_get_user_data_box_info(content_info->path, DRM_UDTA_AUTHOR, &metadata) == DRM_RESULT_SUCCESS) {
 					//_strncpy_safe(content_info->media_meta.composer, metadata.subBox.author.str, sizeof(content_info->media_meta.composer));
-					ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.composer, metadata.subBox.author.str);
+					ret = _media_svc_set_content_str(content_info, &content_info->media_meta.composer, metadata.subBox.author.str);
 					media_svc_retv_del_if(ret < 0, ret, content_info);
 
 					extracted_field |= MEDIA_SVC_EXTRACTED_FIELD_AUTHOR;
@@ -1033,7 +1421,7 @@ int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s
 
 				if (drm_svc_get_user_data_box_info(content_info->path, DRM_UDTA_PERFORMER, &metadata) == DRM_RESULT_SUCCESS) {
 					//_strncpy_safe(content_info->media_meta.artist, metadata.subBox.performer.str, sizeof(content_info->media_meta.artist));
-					ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.artist, metadata.subBox.performer.str);
+					ret = _media_svc_set_content_str(content_info, &content_info->media_meta.artist, metadata.subBox.performer.str);
 					media_svc_retv_del_if(ret < 0, ret, content_info);
 
 					extracted_field |= MEDIA_SVC_EXTRACTED_FIELD_ARTIST;
@@ -1041,7 +1429,7 @@ int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s
 
 				if (drm_svc_get_user_data_box_info(content_info->path, DRM_UDTA_GENRE, &metadata) == DRM_RESULT_SUCCESS) {
 					//_strncpy_safe(content_info->media_meta.genre, metadata.subBox.genre.str, sizeof(content_info->media_meta.genre));
-					ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.genre, metadata.subBox.genre.str);
+					ret = _media_svc_set_content_str(content_info, &content_info->media_meta.genre, metadata.subBox.genre.str);
 					media_svc_retv_del_if(ret < 0, ret, content_info);
 
 					media_svc_debug("genre : %s", content_info->media_meta.genre);
@@ -1053,7 +1441,7 @@ int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s
 
 				if (drm_svc_get_user_data_box_info(content_info->path, DRM_UDTA_ALBUM, &metadata) == DRM_RESULT_SUCCESS) {
 					//_strncpy_safe(content_info->media_meta.album, metadata.subBox.album.albumTitle, sizeof(content_info->media_meta.album));
-					ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.album, metadata.subBox.album.albumTitle);
+					ret = _media_svc_set_content_str(content_info, &content_info->media_meta.album, metadata.subBox.album.albumTitle);
 					media_svc_retv_del_if(ret < 0, ret, content_info);
 
 					extracted_field |= MEDIA_SVC_EXTRACTED_FIELD_ALBUM;
@@ -1061,7 +1449,7 @@ int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s
 					char track_num[MEDIA_SVC_METADATA_LEN_MAX] = {0,};
 					snprintf(track_num, sizeof(track_num), "%d", metadata.subBox.album.trackNum);
 
-					ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.track_num, track_num);
+					ret = _media_svc_set_content_str(content_info, &content_info->media_meta.track_num, track_num);
 					media_svc_retv_del_if(ret < 0, ret, content_info);
 
 					//snprintf(content_info->media_meta.track_num, MEDIA_SVC_METADATA_LEN_MAX, "%d", metadata.subBox.album.trackNum);
@@ -1069,7 +1457,7 @@ int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s
 
 				if (drm_svc_get_user_data_box_info(content_info->path, DRM_UDTA_RECODINGYEAR, &metadata) == DRM_RESULT_SUCCESS) {
 					//_strncpy_safe(content_info->media_meta.year, __year_2_str(metadata.subBox.recodingYear.recodingYear), sizeof(content_info->media_meta.year));
-					ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.year, __year_2_str(metadata.subBox.recodingYear.recodingYear));
+					ret = _media_svc_set_content_str(content_info, &content_info->media_meta.year, __year_2_str(metadata.subBox.recodingYear.recodingYear));
 					media_svc_retv_del_if(ret < 0, ret, content_info);
 
 					extracted_field |= MEDIA_SVC_EXTRACTED_FIELD_YEAR;
@@ -1123,25 +1511,25 @@ int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s
 				title = _media_svc_get_title_from_filepath(content_info->path);
 				if (title) {
 					//_strncpy_safe(content_info->media_meta.title, title, sizeof(content_info->media_meta.title));
-					ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.title, title);
+					ret = _media_svc_set_content_str(content_info, &content_info->media_meta.title, title);
 					SAFE_FREE(title);
 					media_svc_retv_del_if(ret < 0, ret, content_info);
 
 				} else {
 					media_svc_error("Can't extract title from filepath [%s]", content_info->path);
-					ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.title, MEDIA_SVC_TAG_UNKNOWN);
+					ret = _media_svc_set_content_str(content_info, &content_info->media_meta.title, MEDIA_SVC_TAG_UNKNOWN);
 					media_svc_retv_del_if(ret < 0, ret, content_info);
 				}
 
-				ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.album, MEDIA_SVC_TAG_UNKNOWN);
+				ret = _media_svc_set_content_str(content_info, &content_info->media_meta.album, MEDIA_SVC_TAG_UNKNOWN);
 				media_svc_retv_del_if(ret < 0, ret, content_info);
-				ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.artist, MEDIA_SVC_TAG_UNKNOWN);
+				ret = _media_svc_set_content_str(content_info, &content_info->media_meta.artist, MEDIA_SVC_TAG_UNKNOWN);
 				media_svc_retv_del_if(ret < 0, ret, content_info);
-				ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.genre, MEDIA_SVC_TAG_UNKNOWN);
+				ret = _media_svc_set_content_str(content_info, &content_info->media_meta.genre, MEDIA_SVC_TAG_UNKNOWN);
 				media_svc_retv_del_if(ret < 0, ret, content_info);
-				ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.composer, MEDIA_SVC_TAG_UNKNOWN);
+				ret = _media_svc_set_content_str(content_info, &content_info->media_meta.composer, MEDIA_SVC_TAG_UNKNOWN);
 				media_svc_retv_del_if(ret < 0, ret, content_info);
-				ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.year, MEDIA_SVC_TAG_UNKNOWN);
+				ret = _media_svc_set_content_str(content_info, &content_info->media_meta.year, MEDIA_SVC_TAG_UNKNOWN);
 				media_svc_retv_del_if(ret < 0, ret, content_info);
 /*
 				_strncpy_safe(content_info->media_meta.album, MEDIA_SVC_TAG_UNKNOWN, sizeof(content_info->media_meta.album));
@@ -1158,7 +1546,7 @@ int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s
 					title = _media_svc_get_title_from_filepath(content_info->path);
 					if (title) {
 						//_strncpy_safe(content_info->media_meta.title, title, sizeof(content_info->media_meta.title));
-						ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.title, title);
+						ret = _media_svc_set_content_str(content_info, &content_info->media_meta.title, title);
 						SAFE_FREE(title);
 						media_svc_retv_del_if(ret < 0, ret, content_info);
 
@@ -1169,15 +1557,15 @@ int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s
 						return MEDIA_INFO_ERROR_INTERNAL;
 					}
 
-					ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.album, MEDIA_SVC_TAG_UNKNOWN);
+					ret = _media_svc_set_content_str(content_info, &content_info->media_meta.album, MEDIA_SVC_TAG_UNKNOWN);
 					media_svc_retv_del_if(ret < 0, ret, content_info);
-					ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.artist, MEDIA_SVC_TAG_UNKNOWN);
+					ret = _media_svc_set_content_str(content_info, &content_info->media_meta.artist, MEDIA_SVC_TAG_UNKNOWN);
 					media_svc_retv_del_if(ret < 0, ret, content_info);
-					ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.genre, MEDIA_SVC_TAG_UNKNOWN);
+					ret = _media_svc_set_content_str(content_info, &content_info->media_meta.genre, MEDIA_SVC_TAG_UNKNOWN);
 					media_svc_retv_del_if(ret < 0, ret, content_info);
-					ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.composer, MEDIA_SVC_TAG_UNKNOWN);
+					ret = _media_svc_set_content_str(content_info, &content_info->media_meta.composer, MEDIA_SVC_TAG_UNKNOWN);
 					media_svc_retv_del_if(ret < 0, ret, content_info);
-					ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.year, MEDIA_SVC_TAG_UNKNOWN);
+					ret = _media_svc_set_content_str(content_info, &content_info->media_meta.year, MEDIA_SVC_TAG_UNKNOWN);
 					media_svc_retv_del_if(ret < 0, ret, content_info);
 /*
 					_strncpy_safe(content_info->media_meta.album, MEDIA_SVC_TAG_UNKNOWN, sizeof(content_info->media_meta.album));
@@ -1197,25 +1585,25 @@ int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s
 				media_svc_debug("no valid ro. can't extract meta data");
 				title = _media_svc_get_title_from_filepath(content_info->path);
 				if (title) {
-					ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.title, title);
+					ret = _media_svc_set_content_str(content_info, &content_info->media_meta.title, title);
 					SAFE_FREE(title);
 					media_svc_retv_del_if(ret < 0, ret, content_info);
 					//_strncpy_safe(content_info->media_meta.title, title, sizeof(content_info->media_meta.title));
 				} else {
 					media_svc_error("Can't extract title from filepath [%s]", content_info->path);
-					ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.title, MEDIA_SVC_TAG_UNKNOWN);
+					ret = _media_svc_set_content_str(content_info, &content_info->media_meta.title, MEDIA_SVC_TAG_UNKNOWN);
 					media_svc_retv_del_if(ret < 0, ret, content_info);
 				}
 
-				ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.album, MEDIA_SVC_TAG_UNKNOWN);
+				ret = _media_svc_set_content_str(content_info, &content_info->media_meta.album, MEDIA_SVC_TAG_UNKNOWN);
 				media_svc_retv_del_if(ret < 0, ret, content_info);
-				ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.artist, MEDIA_SVC_TAG_UNKNOWN);
+				ret = _media_svc_set_content_str(content_info, &content_info->media_meta.artist, MEDIA_SVC_TAG_UNKNOWN);
 				media_svc_retv_del_if(ret < 0, ret, content_info);
-				ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.genre, MEDIA_SVC_TAG_UNKNOWN);
+				ret = _media_svc_set_content_str(content_info, &content_info->media_meta.genre, MEDIA_SVC_TAG_UNKNOWN);
 				media_svc_retv_del_if(ret < 0, ret, content_info);
-				ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.composer, MEDIA_SVC_TAG_UNKNOWN);
+				ret = _media_svc_set_content_str(content_info, &content_info->media_meta.composer, MEDIA_SVC_TAG_UNKNOWN);
 				media_svc_retv_del_if(ret < 0, ret, content_info);
-				ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.year, MEDIA_SVC_TAG_UNKNOWN);
+				ret = _media_svc_set_content_str(content_info, &content_info->media_meta.year, MEDIA_SVC_TAG_UNKNOWN);
 				media_svc_retv_del_if(ret < 0, ret, content_info);
 /*
 				_strncpy_safe(content_info->media_meta.album, MEDIA_SVC_TAG_UNKNOWN, sizeof(content_info->media_meta.album));
@@ -1231,25 +1619,25 @@ int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s
 			media_svc_error("Not supported DRM type");
 			title = _media_svc_get_title_from_filepath(content_info->path);
 			if (title) {
-				ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.title, title);
+				ret = _media_svc_set_content_str(content_info, &content_info->media_meta.title, title);
 				SAFE_FREE(title);
 				media_svc_retv_del_if(ret < 0, ret, content_info);
 				//_strncpy_safe(content_info->media_meta.title, title, sizeof(content_info->media_meta.title));
 			} else {
 				media_svc_error("Can't extract title from filepath [%s]", content_info->path);
-				ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.title, MEDIA_SVC_TAG_UNKNOWN);
+				ret = _media_svc_set_content_str(content_info, &content_info->media_meta.title, MEDIA_SVC_TAG_UNKNOWN);
 				media_svc_retv_del_if(ret < 0, ret, content_info);
 			}
 
-			ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.album, MEDIA_SVC_TAG_UNKNOWN);
+			ret = _media_svc_set_content_str(content_info, &content_info->media_meta.album, MEDIA_SVC_TAG_UNKNOWN);
 			media_svc_retv_del_if(ret < 0, ret, content_info);
-			ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.artist, MEDIA_SVC_TAG_UNKNOWN);
+			ret = _media_svc_set_content_str(content_info, &content_info->media_meta.artist, MEDIA_SVC_TAG_UNKNOWN);
 			media_svc_retv_del_if(ret < 0, ret, content_info);
-			ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.genre, MEDIA_SVC_TAG_UNKNOWN);
+			ret = _media_svc_set_content_str(content_info, &content_info->media_meta.genre, MEDIA_SVC_TAG_UNKNOWN);
 			media_svc_retv_del_if(ret < 0, ret, content_info);
-			ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.composer, MEDIA_SVC_TAG_UNKNOWN);
+			ret = _media_svc_set_content_str(content_info, &content_info->media_meta.composer, MEDIA_SVC_TAG_UNKNOWN);
 			media_svc_retv_del_if(ret < 0, ret, content_info);
-			ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.year, MEDIA_SVC_TAG_UNKNOWN);
+			ret = _media_svc_set_content_str(content_info, &content_info->media_meta.year, MEDIA_SVC_TAG_UNKNOWN);
 			media_svc_retv_del_if(ret < 0, ret, content_info);
 /*
 			_strncpy_safe(content_info->media_meta.album, MEDIA_SVC_TAG_UNKNOWN, sizeof(content_info->media_meta.album));
@@ -1262,6 +1650,10 @@ int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s
 		}
 	}
 #endif
+	/* Stream info kept when the scanner classified the file is reused. Video without video stream has no size and no frame */
+	if ((media_type == MEDIA_SVC_MEDIA_TYPE_VIDEO) && _media_svc_probe_stream_info(probe, &audio_stream, &video_stream) && (video_stream == 0))
+		no_video_stream = TRUE;
+
 	/*Get Content attribute ===========*/
 	mmf_error = mm_file_create_content_attrs(&content, content_info->path);
 	if (mmf_error == MM_ERROR_NONE) {
@@ -1300,6 +1692,8 @@ int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s
 			} else {
 				media_svc_debug("channel : %d", content_info->media_meta.channel);
 			}
+		}else if(no_video_stream)	{
+			media_svc_debug("no video stream : %d audio stream", audio_stream);
 		}else if(media_type == MEDIA_SVC_MEDIA_TYPE_VIDEO)	{	/*Video attribute*/
 
 			mmf_error = mm_file_get_attrs(content, &err_attr_name, MM_FILE_CONTENT_VIDEO_WIDTH, &content_info->media_meta.width, NULL);
@@ -1338,14 +1732,14 @@ int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s
 		mmf_error = mm_file_get_attrs(tag, &err_attr_name, MM_FILE_TAG_ALBUM, &p, &size, NULL);
 		if ((!(extracted_field & MEDIA_SVC_EXTRACTED_FIELD_ALBUM)) && mmf_error == 0 && size > 0) {
 			//_strncpy_safe(content_info->media_meta.album, p, sizeof(content_info->media_meta.album));
-			ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.album, p);
+			ret = _media_svc_set_content_str(content_info, &content_info->media_meta.album, p);
 			media_svc_retv_del_if(ret < 0, ret, content_info);
 
 			media_svc_debug("album[%d] : %s", size, content_info->media_meta.album);
 		} else {
 			SAFE_FREE(err_attr_name);
 			media_svc_debug("album - unknown");
-			ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.album, MEDIA_SVC_TAG_UNKNOWN);
+			ret = _media_svc_set_content_str(content_info, &content_info->media_meta.album, MEDIA_SVC_TAG_UNKNOWN);
 			media_svc_retv_del_if(ret < 0, ret, content_info);
 			//_strncpy_safe(content_info->media_meta.album, MEDIA_SVC_TAG_UNKNOWN, sizeof(content_info->media_meta.album));
 		}
@@ -1353,21 +1747,21 @@ int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s
 		mmf_error = mm_file_get_attrs(tag, &err_attr_name, MM_FILE_TAG_ARTIST, &p, &size, NULL);
 		if ((!(extracted_field & MEDIA_SVC_EXTRACTED_FIELD_ARTIST)) && mmf_error == 0 && size > 0) {
 			//_strncpy_safe(content_info->media_meta.artist, p, sizeof(content_info->media_meta.artist));
-			ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.artist, p);
+			ret = _media_svc_set_content_str(content_info, &content_info->media_meta.artist, p);
 			media_svc_retv_del_if(ret < 0, ret, content_info);
 			media_svc_debug("artist[%d] : %s", size, content_info->media_meta.artist);
 		} else {
 			SAFE_FREE(err_attr_name);
 			media_svc_debug("artist - unknown");
 			//_strncpy_safe(content_info->media_meta.artist, MEDIA_SVC_TAG_UNKNOWN, sizeof(content_info->media_meta.artist));
-			ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.artist, MEDIA_SVC_TAG_UNKNOWN);
+			ret = _media_svc_set_content_str(content_info, &content_info->media_meta.artist, MEDIA_SVC_TAG_UNKNOWN);
 			media_svc_retv_del_if(ret < 0, ret, content_info);
 		}
 
 		mmf_error = mm_file_get_attrs(tag, &err_attr_name, MM_FILE_TAG_GENRE, &p, &size, NULL);
 		if ((!(extracted_field & MEDIA_SVC_EXTRACTED_FIELD_GENRE)) && mmf_error == 0 && size > 0) {
 			//_strncpy_safe(content_info->media_meta.genre, p, sizeof(content_info->media_meta.genre));
-			ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.genre, p);
+			ret = _media_svc_set_content_str(content_info, &content_info->media_meta.genre, p);
 			media_svc_retv_del_if(ret < 0, ret, content_info);
 
 			media_svc_debug("genre : %s", content_info->media_meta.genre);
@@ -1378,14 +1772,14 @@ int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s
 			SAFE_FREE(err_attr_name);
 			media_svc_debug("genre - unknown");
 			//_strncpy_safe(content_info->media_meta.genre, MEDIA_SVC_TAG_UNKNOWN, sizeof(content_info->media_meta.genre));
-			ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.genre, MEDIA_SVC_TAG_UNKNOWN);
+			ret = _media_svc_set_content_str(content_info, &content_info->media_meta.genre, MEDIA_SVC_TAG_UNKNOWN);
 			media_svc_retv_del_if(ret < 0, ret, content_info);
 		}
 
 		mmf_error = mm_file_get_attrs(tag, &err_attr_name, MM_FILE_TAG_TITLE, &p, &size, NULL);
 		if ((!(extracted_field & MEDIA_SVC_EXTRACTED_FIELD_TITLE)) && mmf_error == 0 && size > 0 && 	(!isspace(*p))) {
 			//_strncpy_safe(content_info->media_meta.title, p, sizeof(content_info->media_meta.title));
-			ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.title, p);
+			ret = _media_svc_set_content_str(content_info, &content_info->media_meta.title, p);
 			media_svc_retv_del_if(ret < 0, ret, content_info);
 
 			extracted_field |= MEDIA_SVC_EXTRACTED_FIELD_TITLE;
@@ -1396,12 +1790,12 @@ int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s
 			title = _media_svc_get_title_from_filepath(content_info->path);
 			if (title) {
 				//_strncpy_safe(content_info->media_meta.title, title, sizeof(content_info->media_meta.title));
-				ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.title, title);
+				ret = _media_svc_set_content_str(content_info, &content_info->media_meta.title, title);
 				SAFE_FREE(title);
 				media_svc_retv_del_if(ret < 0, ret, content_info);
 			} else {
 				media_svc_error("Can't extract title from filepath [%s]", content_info->path);
-				ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.title, MEDIA_SVC_TAG_UNKNOWN);
+				ret = _media_svc_set_content_str(content_info, &content_info->media_meta.title, MEDIA_SVC_TAG_UNKNOWN);
 				media_svc_retv_del_if(ret < 0, ret, content_info);
 			}
 		}
@@ -1409,7 +1803,7 @@ int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s
 		mmf_error = mm_file_get_attrs(tag, &err_attr_name, MM_FILE_TAG_DESCRIPTION, &p, &size, NULL);
 		if ((!(extracted_field & MEDIA_SVC_EXTRACTED_FIELD_DESC)) && mmf_error == 0 && size > 0) {
 			//_strncpy_safe(content_info->media_meta.description, p, sizeof(content_info->media_meta.description));
-			ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.description, p);
+			ret = _media_svc_set_content_str(content_info, &content_info->media_meta.description, p);
 			media_svc_retv_del_if(ret < 0, ret, content_info);
 			media_svc_debug("desc : %s", content_info->media_meta.description);
 		} else {
@@ -1420,7 +1814,7 @@ int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s
 		mmf_error = mm_file_get_attrs(tag, &err_attr_name, MM_FILE_TAG_AUTHOR, &p, &size, NULL);
 		if ((!(extracted_field & MEDIA_SVC_EXTRACTED_FIELD_AUTHOR)) && mmf_error == 0 && size > 0) {
 			//_strncpy_safe(content_info->media_meta.composer, p, sizeof(content_info->media_meta.composer));
-			ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.composer, p);
+			ret = _media_svc_set_content_str(content_info, &content_info->media_meta.composer, p);
 			media_svc_retv_del_if(ret < 0, ret, content_info);
 			extracted_field |= MEDIA_SVC_EXTRACTED_FIELD_AUTHOR;
 			media_svc_debug("extract composer from content : %s", content_info->media_meta.composer);
@@ -1428,31 +1822,31 @@ int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s
 			media_svc_debug("composer - unknown");
 			SAFE_FREE(err_attr_name);
 			//_strncpy_safe(content_info->media_meta.composer, MEDIA_SVC_TAG_UNKNOWN, sizeof(content_info->media_meta.composer));
-			ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.composer, MEDIA_SVC_TAG_UNKNOWN);
+			ret = _media_svc_set_content_str(content_info, &content_info->media_meta.composer, MEDIA_SVC_TAG_UNKNOWN);
 			media_svc_retv_del_if(ret < 0, ret, content_info);
 		}
 
 		mmf_error = mm_file_get_attrs(tag, &err_attr_name, MM_FILE_TAG_TRACK_NUM, &p, &size, NULL);
 		if (mmf_error == 0 && size > 0) {
 			//_strncpy_safe(content_info->media_meta.track_num, p, sizeof(content_info->media_meta.track_num));
-			ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.track_num, p);
+			ret = _media_svc_set_content_str(content_info, &content_info->media_meta.track_num, p);
 			media_svc_retv_del_if(ret < 0, ret, content_info);
 		} else {
 			SAFE_FREE(err_attr_name);
 			//_strncpy_safe(content_info->media_meta.track_num, MEDIA_SVC_TAG_UNKNOWN, sizeof(content_info->media_meta.track_num));
-			ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.track_num, MEDIA_SVC_TAG_UNKNOWN);
+			ret = _media_svc_set_content_str(content_info, &content_info->media_meta.track_num, MEDIA_SVC_TAG_UNKNOWN);
 			media_svc_retv_del_if(ret < 0, ret, content_info);
 		}
 		mmf_error = mm_file_get_attrs(tag, &err_attr_name, MM_FILE_TAG_DATE, &p, &size, NULL);
 		if (!(extracted_field & MEDIA_SVC_EXTRACTED_FIELD_YEAR)) {
 			if (mmf_error == 0 && size > 0) {
 				//_strncpy_safe(content_info->media_meta.year, p, sizeof(content_info->media_meta.year));
-				ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.year, p);
+				ret = _media_svc_set_content_str(content_info, &content_info->media_meta.year, p);
 				media_svc_retv_del_if(ret < 0, ret, content_info);
 			} else {
 				SAFE_FREE(err_attr_name);
 				//_strncpy_safe(content_info->media_meta.year, MEDIA_SVC_TAG_UNKNOWN, sizeof(content_info->media_meta.year));
-				ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.year, MEDIA_SVC_TAG_UNKNOWN);
+				ret = _media_svc_set_content_str(content_info, &content_info->media_meta.year, MEDIA_SVC_TAG_UNKNOWN);
 				media_svc_retv_del_if(ret < 0, ret, content_info);
 			}
 		} else {
@@ -1467,6 +1861,16 @@ int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s
 			content_info->media_meta.rating = 0;
 		}
 
+		if (media_type == MEDIA_SVC_MEDIA_TYPE_VIDEO) {
+			mmf_error = mm_file_get_attrs(tag, &err_attr_name, MM_FILE_TAG_RECDATE, &p, &size, NULL);
+			if (mmf_error == 0 && size > 0) {
+				ret = _media_svc_set_content_str(content_info, &content_info->media_meta.recorded_date, p);
+				media_svc_retv_del_if(ret < 0, ret, content_info);
+			} else {
+				SAFE_FREE(err_attr_name);
+			}
+		}
+
 		/*Initialize album_id to 0. below code will set the album_id*/
 		content_info->album_id = album_id;
 
@@ -1573,7 +1977,7 @@ int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s
 				}
 
 				//_strncpy_safe(content_info->thumbnail_path, thumb_path, sizeof(content_info->thumbnail_path));
-				ret = __media_svc_malloc_and_strncpy(&content_info->thumbnail_path, thumb_path);
+				ret = _media_svc_set_content_str(content_info, &content_info->thumbnail_path, thumb_path);
 				media_svc_retv_del_if(ret < 0, ret, content_info);
 			}
 		}
@@ -1622,7 +2026,7 @@ int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s
 				content_info->media_meta.altitude = MEDIA_SVC_DEFAULT_GPS_VALUE;
 			}
 
-			if ((!thumb_extracted_from_drm) && (extract_thumbnail == TRUE))
+			if ((!thumb_extracted_from_drm) && (extract_thumbnail == TRUE) && (!no_video_stream))
 			{
 				/* Extracting thumbnail */
 				char thumb_path[MEDIA_SVC_PATHNAME_SIZE + 1] = {0, };
@@ -1636,7 +2040,7 @@ int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s
 					media_svc_debug("thumbnail_request_from_db success: %s", thumb_path);
 				}
 
-				ret = __media_svc_malloc_and_strncpy(&content_info->thumbnail_path, thumb_path);
+				ret = _media_svc_set_content_str(content_info, &content_info->thumbnail_path, thumb_path);
 				media_svc_retv_del_if(ret < 0, ret, content_info);
 
 				if (content_info->media_meta.width <= 0) content_info->media_meta.width = width;
@@ -1655,25 +2059,25 @@ int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s
 		title = _media_svc_get_title_from_filepath(content_info->path);
 		if (title) {
 			//_strncpy_safe(content_info->media_meta.title, title, sizeof(content_info->media_meta.title));
-			ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.title, title);
+			ret = _media_svc_set_content_str(content_info, &content_info->media_meta.title, title);
 			SAFE_FREE(title);
 			media_svc_retv_del_if(ret < 0, ret, content_info);
 		} else {
 			media_svc_error("Can't extract title from filepath [%s]", content_info->path);
-			ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.title, MEDIA_SVC_TAG_UNKNOWN);
+			ret = _media_svc_set_content_str(content_info, &content_info->media_meta.title, MEDIA_SVC_TAG_UNKNOWN);
 			media_svc_retv_del_if(ret < 0, ret, content_info);
 		}
 
 		/* in case of file size 0, MMFW Can't parsting tag info but add it to Music DB. */
-		ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.album, MEDIA_SVC_TAG_UNKNOWN);
+		ret = _media_svc_set_content_str(content_info, &content_info->media_meta.album, MEDIA_SVC_TAG_UNKNOWN);
 		media_svc_retv_del_if(ret < 0, ret, content_info);
-		ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.artist, MEDIA_SVC_TAG_UNKNOWN);
+		ret = _media_svc_set_content_str(content_info, &content_info->media_meta.artist, MEDIA_SVC_TAG_UNKNOWN);
 		media_svc_retv_del_if(ret < 0, ret, content_info);
-		ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.genre, MEDIA_SVC_TAG_UNKNOWN);
+		ret = _media_svc_set_content_str(content_info, &content_info->media_meta.genre, MEDIA_SVC_TAG_UNKNOWN);
 		media_svc_retv_del_if(ret < 0, ret, content_info);
-		ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.composer, MEDIA_SVC_TAG_UNKNOWN);
+		ret = _media_svc_set_content_str(content_info, &content_info->media_meta.composer, MEDIA_SVC_TAG_UNKNOWN);
 		media_svc_retv_del_if(ret < 0, ret, content_info);
-		ret = __media_svc_malloc_and_strncpy(&content_info->media_meta.year, MEDIA_SVC_TAG_UNKNOWN);
+		ret = _media_svc_set_content_str(content_info, &content_info->media_meta.year, MEDIA_SVC_TAG_UNKNOWN);
 		media_svc_retv_del_if(ret < 0, ret, content_info);
 /*
 		_strncpy_safe(content_info->media_meta.album, MEDIA_SVC_TAG_UNKNOWN, sizeof(content_info->media_meta.album));
@@ -1695,6 +2099,12 @@ void _media_svc_destroy_content_info(media_svc_content_info_s *content_info)
 {
 	media_svc_retm_if(content_info == NULL, "content info is NULL");
 
+	if (content_info->arena != NULL) {
+		_media_svc_arena_reset(content_info->arena);
+		memset(content_info, 0, sizeof(media_svc_content_info_s));
+		return;
+	}
+
 	/* Delete media_svc_content_info_s */
 	if (content_info->media_uuid) {
 		SAFE_FREE(content_info->media_uuid);
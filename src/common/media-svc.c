@@ -27,17 +27,12 @@
 #include "media-svc-db-utils.h"
 #include "media-svc-media-folder.h"
 #include "media-svc-album.h"
+#include "media-svc-thumb-journal.h"
+#include "media-svc-storage.h"
+#include "media-svc-db-pool.h"
+#include "media-svc-db-ctx.h"
 
 
-static __thread int g_media_svc_item_validity_data_cnt = 1;
-static __thread int g_media_svc_item_validity_cur_data_cnt = 0;
-
-static __thread int g_media_svc_move_item_data_cnt = 1;
-static __thread int g_media_svc_move_item_cur_data_cnt = 0;
-
-static __thread int g_media_svc_insert_item_data_cnt = 1;
-static __thread int g_media_svc_insert_item_cur_data_cnt = 0;
-
 int media_svc_connect(MediaSvcHandle **handle)
 {
 	int ret = MEDIA_INFO_ERROR_NONE;
@@ -64,6 +59,254 @@ int media_svc_disconnect(MediaSvcHandle *handle)
 	return _media_svc_disconnect_db_with_handle(db_handle);
 }
 
+int media_svc_set_busy_strategy(MediaSvcHandle *handle, media_svc_busy_strategy_e strategy)
+{
+	sqlite3 * db_handle = (sqlite3 *)handle;
+	media_svc_db_ctx_s *ctx = NULL;
+
+	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
+
+	if ((strategy < MEDIA_SVC_BUSY_STRATEGY_BACKOFF) || (strategy >= MEDIA_SVC_BUSY_STRATEGY_MAX)) {
+		media_svc_error("busy strategy is incorrect[%d]", strategy);
+		return MEDIA_INFO_ERROR_INVALID_PARAMETER;
+	}
+
+	ctx = _media_svc_db_ctx_get(db_handle);
+	media_svc_retv_if(ctx == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&ctx->stats_mutex);
+	ctx->busy_strategy = strategy;
+	pthread_mutex_unlock(&ctx->stats_mutex);
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+int media_svc_get_lock_stats(MediaSvcHandle *handle, media_svc_lock_stats_s *stats)
+{
+	sqlite3 * db_handle = (sqlite3 *)handle;
+	media_svc_db_ctx_s *ctx = NULL;
+
+	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
+	media_svc_retvm_if(stats == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "stats is NULL");
+
+	ctx = _media_svc_db_ctx_get(db_handle);
+	media_svc_retv_if(ctx == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&ctx->stats_mutex);
+	memcpy(stats, &ctx->lock_stats, sizeof(media_svc_lock_stats_s));
+	pthread_mutex_unlock(&ctx->stats_mutex);
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+int media_svc_reset_lock_stats(MediaSvcHandle *handle)
+{
+	sqlite3 * db_handle = (sqlite3 *)handle;
+	media_svc_db_ctx_s *ctx = NULL;
+
+	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
+
+	ctx = _media_svc_db_ctx_get(db_handle);
+	media_svc_retv_if(ctx == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&ctx->stats_mutex);
+	memset(&ctx->lock_stats, 0, sizeof(media_svc_lock_stats_s));
+	pthread_mutex_unlock(&ctx->stats_mutex);
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+int media_svc_get_count_cache_stats(MediaSvcHandle *handle, media_svc_count_cache_stats_s *stats)
+{
+	sqlite3 * db_handle = (sqlite3 *)handle;
+	media_svc_db_ctx_s *ctx = NULL;
+
+	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
+	media_svc_retvm_if(stats == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "stats is NULL");
+
+	ctx = _media_svc_db_ctx_get(db_handle);
+	media_svc_retv_if(ctx == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&ctx->stats_mutex);
+	memcpy(stats, &ctx->count_stats, sizeof(media_svc_count_cache_stats_s));
+	pthread_mutex_unlock(&ctx->stats_mutex);
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+int media_svc_reset_count_cache_stats(MediaSvcHandle *handle)
+{
+	sqlite3 * db_handle = (sqlite3 *)handle;
+	media_svc_db_ctx_s *ctx = NULL;
+
+	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
+
+	ctx = _media_svc_db_ctx_get(db_handle);
+	media_svc_retv_if(ctx == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&ctx->stats_mutex);
+	memset(&ctx->count_stats, 0, sizeof(media_svc_count_cache_stats_s));
+	pthread_mutex_unlock(&ctx->stats_mutex);
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+int media_svc_set_batch_lock_hold_time(MediaSvcHandle *handle, int max_lock_hold_msec)
+{
+	sqlite3 * db_handle = (sqlite3 *)handle;
+	media_svc_db_ctx_s *ctx = NULL;
+
+	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
+	media_svc_retvm_if(max_lock_hold_msec <= 0, MEDIA_INFO_ERROR_INVALID_PARAMETER, "max_lock_hold_msec should be bigger than 0");
+
+	ctx = _media_svc_db_ctx_get(db_handle);
+	media_svc_retv_if(ctx == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER);
+
+	ctx->max_lock_hold_usec = max_lock_hold_msec * 1000;
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+int media_svc_commit_old_batch(MediaSvcHandle *handle)
+{
+	sqlite3 * db_handle = (sqlite3 *)handle;
+
+	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
+
+	return _media_svc_batch_commit_if_old(db_handle);
+}
+
+int media_svc_bulk_load_begin(MediaSvcHandle *handle)
+{
+	sqlite3 * db_handle = (sqlite3 *)handle;
+
+	media_svc_debug_func();
+
+	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
+
+	return _media_svc_bulk_load_begin(db_handle);
+}
+
+int media_svc_bulk_load_end(MediaSvcHandle *handle)
+{
+	sqlite3 * db_handle = (sqlite3 *)handle;
+
+	media_svc_debug_func();
+
+	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
+
+	return _media_svc_bulk_load_end(db_handle);
+}
+
+int media_svc_scan_session_begin(MediaSvcHandle *handle)
+{
+	sqlite3 * db_handle = (sqlite3 *)handle;
+
+	media_svc_debug_func();
+
+	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
+
+	return _media_svc_scan_session_begin(db_handle);
+}
+
+int media_svc_scan_session_end(MediaSvcHandle *handle)
+{
+	sqlite3 * db_handle = (sqlite3 *)handle;
+
+	media_svc_debug_func();
+
+	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
+
+	return _media_svc_scan_session_end(db_handle);
+}
+
+int media_svc_scan_session_enter(MediaSvcHandle *handle)
+{
+	sqlite3 * db_handle = (sqlite3 *)handle;
+
+	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
+
+	return _media_svc_scan_session_enter(db_handle);
+}
+
+int media_svc_scan_session_leave(MediaSvcHandle *handle)
+{
+	sqlite3 * db_handle = (sqlite3 *)handle;
+
+	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
+
+	return _media_svc_scan_session_leave(db_handle);
+}
+
+int media_svc_scan_update_begin(void)
+{
+	media_svc_debug_func();
+
+	_media_svc_scan_update_begin();
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+int media_svc_scan_update_end(void)
+{
+	media_svc_debug_func();
+
+	return _media_svc_scan_update_end();
+}
+
+int media_svc_pool_get_reader(MediaSvcHandle **handle)
+{
+	int ret = MEDIA_INFO_ERROR_NONE;
+	sqlite3 * db_handle = NULL;
+
+	media_svc_retvm_if(handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
+
+	ret = _media_svc_db_pool_get_reader(&db_handle);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	*handle = db_handle;
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+int media_svc_pool_put_reader(MediaSvcHandle *handle)
+{
+	sqlite3 * db_handle = (sqlite3 *)handle;
+
+	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
+
+	return _media_svc_db_pool_put_reader(db_handle);
+}
+
+int media_svc_pool_get_writer(MediaSvcHandle **handle)
+{
+	int ret = MEDIA_INFO_ERROR_NONE;
+	sqlite3 * db_handle = NULL;
+
+	media_svc_retvm_if(handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
+
+	ret = _media_svc_db_pool_get_writer(&db_handle);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	*handle = db_handle;
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+int media_svc_pool_put_writer(MediaSvcHandle *handle)
+{
+	sqlite3 * db_handle = (sqlite3 *)handle;
+
+	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
+
+	return _media_svc_db_pool_put_writer(db_handle);
+}
+
+int media_svc_pool_destroy(void)
+{
+	media_svc_debug_func();
+
+	return _media_svc_db_pool_destroy();
+}
+
 int media_svc_create_table(MediaSvcHandle *handle)
 {
 	int ret = MEDIA_INFO_ERROR_NONE;
@@ -73,14 +316,18 @@ int media_svc_create_table(MediaSvcHandle *handle)
 
 	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
 
-	/*create media table*/
-	ret = _media_svc_create_media_table(handle);
+	/*create storage table. media and folder views refer it*/
+	ret = _media_svc_create_storage_table(handle);
 	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 
-	/*create folder table*/
+	/*create folder table. media refers folder_id of it*/
 	ret = _media_svc_create_folder_table(handle);
 	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 
+	/*create media table*/
+	ret = _media_svc_create_media_table(handle);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
 	/*create playlist table*/
 	ret = _media_svc_create_playlist_table(handle);
 	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
@@ -97,12 +344,27 @@ int media_svc_create_table(MediaSvcHandle *handle)
 	ret = _media_svc_create_bookmark_table(handle);
 	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 
+	/*create thumbnail journal table*/
+	ret = _media_svc_create_thumb_journal_table(handle);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	/*add folder_id to visual tables. visual lists read it without checking*/
+	ret = _media_svc_create_visual_folder_id(handle);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	/*create change log table. triggers of media and storage table write it*/
+	ret = _media_svc_create_change_log_table(handle);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
 #if 0	/*unify media and custom table*/
 	/*create custom table*/
 	ret = _media_svc_create_custom_table(handle);
 	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 #endif
 
+	/*resume thumbnail jobs left by previous run*/
+	_media_svc_thumb_journal_process();
+
 	return MEDIA_INFO_ERROR_NONE;
 }
 
@@ -131,17 +393,63 @@ int media_svc_check_item_exist_by_path(MediaSvcHandle *handle, const char *path)
 	return MEDIA_INFO_ERROR_NONE;
 }
 
+int media_svc_check_items(MediaSvcHandle *handle, media_svc_item_check_s *items, int count)
+{
+	sqlite3 * db_handle = (sqlite3 *)handle;
+	int i = 0;
+
+	media_svc_debug_func();
+
+	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
+	media_svc_retvm_if(items == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "items is NULL");
+	media_svc_retvm_if(count <= 0, MEDIA_INFO_ERROR_INVALID_PARAMETER, "count is invalid [%d]", count);
+
+	for (i = 0; i < count; i++) {
+		media_svc_retvm_if(!STRING_VALID(items[i].path), MEDIA_INFO_ERROR_INVALID_PARAMETER, "Path of item[%d] is NULL", i);
+	}
+
+	return _media_svc_check_items(db_handle, items, count);
+}
+
+int media_svc_get_change_version(MediaSvcHandle *handle, long long *version)
+{
+	sqlite3 * db_handle = (sqlite3 *)handle;
+
+	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
+	media_svc_retvm_if(version == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "version is NULL");
+
+	return _media_svc_get_change_version(db_handle, version);
+}
+
+int media_svc_get_changes(MediaSvcHandle *handle, long long since_version, media_svc_change_s *changes, int max_count, int *count)
+{
+	sqlite3 * db_handle = (sqlite3 *)handle;
+
+	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
+	media_svc_retvm_if(since_version < 0, MEDIA_INFO_ERROR_INVALID_PARAMETER, "since_version is invalid [%lld]", since_version);
+	media_svc_retvm_if(changes == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "changes is NULL");
+	media_svc_retvm_if(max_count <= 0, MEDIA_INFO_ERROR_INVALID_PARAMETER, "max_count is invalid [%d]", max_count);
+	media_svc_retvm_if(count == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "count is NULL");
+
+	return _media_svc_get_changes(db_handle, since_version, changes, max_count, count);
+}
+
 int media_svc_insert_item_begin(MediaSvcHandle *handle, int data_cnt)
 {
 	sqlite3 * db_handle = (sqlite3 *)handle;
+	media_svc_batch_s *batch = NULL;
 
 	media_svc_debug("Transaction data count : [%d]", data_cnt);
 
 	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
-	media_svc_retvm_if(data_cnt < 1, MEDIA_INFO_ERROR_INVALID_PARAMETER, "data_cnt shuld be bigger than 1");
+	media_svc_retvm_if((data_cnt < 1) && (data_cnt != MEDIA_SVC_BATCH_ADAPTIVE), MEDIA_INFO_ERROR_INVALID_PARAMETER, "data_cnt shuld be bigger than 1");
+
+	batch = _media_svc_db_ctx_get_batch(db_handle, MEDIA_SVC_BATCH_OWNER_MEDIA, MEDIA_SVC_QUERY_INSERT_ITEM);
+	media_svc_retv_if(batch == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER);
 
-	g_media_svc_insert_item_data_cnt  = data_cnt;
-	g_media_svc_insert_item_cur_data_cnt  = 0;
+	batch->data_cnt = data_cnt;
+	batch->cur_data_cnt = 0;
+	batch->adaptive = (data_cnt == MEDIA_SVC_BATCH_ADAPTIVE);
 
 	return MEDIA_INFO_ERROR_NONE;
 }
@@ -150,97 +458,137 @@ int media_svc_insert_item_end(MediaSvcHandle *handle)
 {
 	int ret = MEDIA_INFO_ERROR_NONE;
 	sqlite3 * db_handle = (sqlite3 *)handle;
+	media_svc_batch_s *batch = NULL;
 
 	media_svc_debug_func();
 
 	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
 
-	if (g_media_svc_insert_item_cur_data_cnt  > 0) {
+	batch = _media_svc_db_ctx_get_batch(db_handle, MEDIA_SVC_BATCH_OWNER_MEDIA, MEDIA_SVC_QUERY_INSERT_ITEM);
+	media_svc_retv_if(batch == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER);
+
+	if (batch->cur_data_cnt > 0) {
 
 		ret = _media_svc_list_query_do(db_handle, MEDIA_SVC_QUERY_INSERT_ITEM);
 	}
 
-	g_media_svc_insert_item_data_cnt  = 1;
-	g_media_svc_insert_item_cur_data_cnt  = 0;
+	_media_svc_db_ctx_reset_batch(batch);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	/* other batches which got no item for a while */
+	ret = _media_svc_batch_commit_if_old(db_handle);
 
 	return ret;
 }
 
-int media_svc_insert_item_bulk(MediaSvcHandle *handle, media_svc_storage_type_e storage_type,
-			  const char *path, const char *mime_type, media_svc_media_type_e media_type)
+/* Parses the file once. Audio and visual modules fill their own tables from the same content info,
+ * and reuse stat and DRM info of the file from the probe which the caller initialized for path */
+int _media_svc_make_content_info(sqlite3 *db_handle, media_svc_probe_s *probe, media_svc_storage_type_e storage_type,
+			  const char *path, const char *mime_type, media_svc_media_type_e media_type, media_svc_content_info_s *content_info)
 {
 	int ret = MEDIA_INFO_ERROR_NONE;
-	sqlite3 * db_handle = (sqlite3 *)handle;
 	char folder_uuid[MEDIA_SVC_UUID_SIZE+1] = {0,};
 
-	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
-	media_svc_retvm_if(!STRING_VALID(path), MEDIA_INFO_ERROR_INVALID_PARAMETER, "path is NULL");
-	media_svc_retvm_if(!STRING_VALID(mime_type), MEDIA_INFO_ERROR_INVALID_PARAMETER, "mime_type is NULL");
-
-	if ((storage_type != MEDIA_SVC_STORAGE_INTERNAL) && (storage_type != MEDIA_SVC_STORAGE_EXTERNAL)) {
-		media_svc_error("storage type is incorrect[%d]", storage_type);
-		return MEDIA_INFO_ERROR_INVALID_PARAMETER;
-	}
-
-	if ((media_type < MEDIA_SVC_MEDIA_TYPE_IMAGE) || (media_type > MEDIA_SVC_MEDIA_TYPE_OTHER)) {
-		media_svc_error("invalid media_type condition[%d]", media_type);
-		return MEDIA_INFO_ERROR_INVALID_PARAMETER;
-	}
-
-	media_svc_debug("storage[%d], path[%s], media_type[%d]", storage_type, path, media_type);
-
-	media_svc_content_info_s content_info;
-	memset(&content_info, 0, sizeof(media_svc_content_info_s));
+	content_info->arena = _media_svc_db_ctx_get_arena(db_handle);
 
 	/*Set media info*/
-	ret = _media_svc_set_media_info(&content_info, storage_type, path, mime_type, media_type, FALSE);
+	ret = _media_svc_set_media_info(content_info, probe, storage_type, path, mime_type, media_type, FALSE);
 	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 
 	if(media_type == MEDIA_SVC_MEDIA_TYPE_OTHER) {
 		/*Do nothing.*/
 	} else if(media_type == MEDIA_SVC_MEDIA_TYPE_IMAGE) {
-		ret = _media_svc_extract_image_metadata(&content_info, media_type);
+		ret = _media_svc_extract_image_metadata(content_info, media_type);
 		media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 	} else {
-		ret = _media_svc_extract_media_metadata(handle, &content_info, media_type);
+		ret = _media_svc_extract_media_metadata(db_handle, content_info, probe, media_type);
 		media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 	}
 
 	/*Set or Get folder id*/
-	ret = _media_svc_get_and_append_folder_id_by_path(handle, path, storage_type, folder_uuid);
-	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+	ret = _media_svc_get_and_append_folder_id_by_path(db_handle, path, storage_type, folder_uuid);
+	media_svc_retv_del_if(ret != MEDIA_INFO_ERROR_NONE, ret, content_info);
 
-	ret = __media_svc_malloc_and_strncpy(&content_info.folder_uuid, folder_uuid);
-	media_svc_retv_del_if(ret < 0, ret, &content_info);
+	ret = _media_svc_set_content_str(content_info, &content_info->folder_uuid, folder_uuid);
+	media_svc_retv_del_if(ret < 0, ret, content_info);
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+int _media_svc_insert_content_info_bulk(sqlite3 *db_handle, media_svc_content_info_s *content_info)
+{
+	media_svc_batch_s *batch = NULL;
+	int ret = MEDIA_INFO_ERROR_NONE;
+
+	batch = _media_svc_db_ctx_get_batch(db_handle, MEDIA_SVC_BATCH_OWNER_MEDIA, MEDIA_SVC_QUERY_INSERT_ITEM);
+	media_svc_retv_if(batch == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER);
+
+	if (batch->data_cnt == 1) {
 
-	if (g_media_svc_insert_item_data_cnt == 1) {
+		ret = _media_svc_insert_item_with_data(db_handle, content_info, FALSE);
+		media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 
-		ret = _media_svc_insert_item_with_data(db_handle, &content_info, FALSE);
-		media_svc_retv_del_if(ret != MEDIA_INFO_ERROR_NONE, ret, &content_info);
+	} else if (batch->adaptive || batch->cur_data_cnt < (batch->data_cnt - 1)) {
 
-	} else if(g_media_svc_insert_item_cur_data_cnt  < (g_media_svc_insert_item_data_cnt  - 1)) {
+		ret = _media_svc_insert_item_with_data(db_handle, content_info, TRUE);
+		media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 
-		ret = _media_svc_insert_item_with_data(db_handle, &content_info, TRUE);
-		media_svc_retv_del_if(ret != MEDIA_INFO_ERROR_NONE, ret, &content_info);
+		batch->cur_data_cnt++;
 
-		g_media_svc_insert_item_cur_data_cnt ++;
+		ret = _media_svc_batch_commit_if_full(db_handle, MEDIA_SVC_QUERY_INSERT_ITEM);
+		media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 
-	} else if (g_media_svc_insert_item_cur_data_cnt  == (g_media_svc_insert_item_data_cnt  - 1)) {
+	} else if (batch->cur_data_cnt == (batch->data_cnt - 1)) {
 
-		ret = _media_svc_insert_item_with_data(db_handle, &content_info, TRUE);
-		media_svc_retv_del_if(ret != MEDIA_INFO_ERROR_NONE, ret, &content_info);
+		ret = _media_svc_insert_item_with_data(db_handle, content_info, TRUE);
+		media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 
 		ret = _media_svc_list_query_do(db_handle, MEDIA_SVC_QUERY_INSERT_ITEM);
-		media_svc_retv_del_if(ret != MEDIA_INFO_ERROR_NONE, ret, &content_info);
+		media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 
-		g_media_svc_insert_item_cur_data_cnt = 0;
+		batch->cur_data_cnt = 0;
 
 	} else {
 		media_svc_debug("Error in media_svc_insert_item_bulk");
-		_media_svc_destroy_content_info(&content_info);
 		return MEDIA_INFO_ERROR_INTERNAL;
 	}
 
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+int media_svc_insert_item_bulk(MediaSvcHandle *handle, media_svc_storage_type_e storage_type,
+			  const char *path, const char *mime_type, media_svc_media_type_e media_type)
+{
+	int ret = MEDIA_INFO_ERROR_NONE;
+	sqlite3 * db_handle = (sqlite3 *)handle;
+
+	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
+	media_svc_retvm_if(!STRING_VALID(path), MEDIA_INFO_ERROR_INVALID_PARAMETER, "path is NULL");
+	media_svc_retvm_if(!STRING_VALID(mime_type), MEDIA_INFO_ERROR_INVALID_PARAMETER, "mime_type is NULL");
+
+	if ((storage_type != MEDIA_SVC_STORAGE_INTERNAL) && (storage_type != MEDIA_SVC_STORAGE_EXTERNAL)) {
+		media_svc_error("storage type is incorrect[%d]", storage_type);
+		return MEDIA_INFO_ERROR_INVALID_PARAMETER;
+	}
+
+	if ((media_type < MEDIA_SVC_MEDIA_TYPE_IMAGE) || (media_type > MEDIA_SVC_MEDIA_TYPE_OTHER)) {
+		media_svc_error("invalid media_type condition[%d]", media_type);
+		return MEDIA_INFO_ERROR_INVALID_PARAMETER;
+	}
+
+	media_svc_debug("storage[%d], path[%s], media_type[%d]", storage_type, path, media_type);
+
+	media_svc_content_info_s content_info;
+	media_svc_probe_s probe;
+	memset(&content_info, 0, sizeof(media_svc_content_info_s));
+	_media_svc_probe_init(&probe, path);
+
+	ret = _media_svc_make_content_info(db_handle, &probe, storage_type, path, mime_type, media_type, &content_info);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	ret = _media_svc_insert_content_info_bulk(db_handle, &content_info);
+	media_svc_retv_del_if(ret != MEDIA_INFO_ERROR_NONE, ret, &content_info);
+
 	_media_svc_destroy_content_info(&content_info);
 
 	return MEDIA_INFO_ERROR_NONE;
@@ -273,9 +621,13 @@ int media_svc_insert_item_immediately(MediaSvcHandle *handle, media_svc_storage_
 
 	media_svc_content_info_s content_info;
 	memset(&content_info, 0, sizeof(media_svc_content_info_s));
+	content_info.arena = _media_svc_db_ctx_get_arena(db_handle);
+	media_svc_probe_s probe;
+
+	_media_svc_probe_init(&probe, path);
 
 	/*Set media info*/
-	ret = _media_svc_set_media_info(&content_info, storage_type, path, mime_type, media_type, FALSE);
+	ret = _media_svc_set_media_info(&content_info, &probe, storage_type, path, mime_type, media_type, FALSE);
 	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 
 	if(media_type == MEDIA_SVC_MEDIA_TYPE_OTHER) {
@@ -284,7 +636,7 @@ int media_svc_insert_item_immediately(MediaSvcHandle *handle, media_svc_storage_
 		ret = _media_svc_extract_image_metadata(&content_info, media_type);
 		media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 	} else {
-		ret = _media_svc_extract_media_metadata(handle, &content_info, media_type);
+		ret = _media_svc_extract_media_metadata(handle, &content_info, &probe, media_type);
 		media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 	}
 
@@ -292,7 +644,7 @@ int media_svc_insert_item_immediately(MediaSvcHandle *handle, media_svc_storage_
 	ret = _media_svc_get_and_append_folder_id_by_path(handle, path, storage_type, folder_uuid);
 	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 
-	ret = __media_svc_malloc_and_strncpy(&content_info.folder_uuid, folder_uuid);
+	ret = _media_svc_set_content_str(&content_info, &content_info.folder_uuid, folder_uuid);
 	media_svc_retv_del_if(ret < 0, ret, &content_info);
 
 	ret = _media_svc_insert_item_with_data(db_handle, &content_info, FALSE);
@@ -322,8 +674,8 @@ int media_svc_insert_folder(MediaSvcHandle *handle, media_svc_storage_type_e sto
 	/*Get folder info*/
 	char *folder_name = NULL;
 	int folder_modified_date = 0;
-	char *folder_uuid = _media_info_generate_uuid();
-	if(folder_uuid == NULL ) {
+	char folder_uuid[MEDIA_SVC_UUID_SIZE+1] = {0,};
+	if(_media_svc_generate_uuid(folder_uuid, sizeof(folder_uuid)) != MEDIA_INFO_ERROR_NONE) {
 		media_svc_error("Invalid UUID");
 		return MEDIA_INFO_ERROR_INTERNAL;
 	}
@@ -345,14 +697,19 @@ int media_svc_insert_folder(MediaSvcHandle *handle, media_svc_storage_type_e sto
 int media_svc_move_item_begin(MediaSvcHandle *handle, int data_cnt)
 {
 	sqlite3 * db_handle = (sqlite3 *)handle;
+	media_svc_batch_s *batch = NULL;
 
 	media_svc_debug("Transaction data count : [%d]", data_cnt);
 
 	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
-	media_svc_retvm_if(data_cnt < 1, MEDIA_INFO_ERROR_INVALID_PARAMETER, "data_cnt shuld be bigger than 1");
+	media_svc_retvm_if((data_cnt < 1) && (data_cnt != MEDIA_SVC_BATCH_ADAPTIVE), MEDIA_INFO_ERROR_INVALID_PARAMETER, "data_cnt shuld be bigger than 1");
+
+	batch = _media_svc_db_ctx_get_batch(db_handle, MEDIA_SVC_BATCH_OWNER_MEDIA, MEDIA_SVC_QUERY_MOVE_ITEM);
+	media_svc_retv_if(batch == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER);
 
-	g_media_svc_move_item_data_cnt  = data_cnt;
-	g_media_svc_move_item_cur_data_cnt  = 0;
+	batch->data_cnt = data_cnt;
+	batch->cur_data_cnt = 0;
+	batch->adaptive = (data_cnt == MEDIA_SVC_BATCH_ADAPTIVE);
 
 	return MEDIA_INFO_ERROR_NONE;
 }
@@ -361,12 +718,16 @@ int media_svc_move_item_end(MediaSvcHandle *handle)
 {
 	int ret = MEDIA_INFO_ERROR_NONE;
 	sqlite3 * db_handle = (sqlite3 *)handle;
+	media_svc_batch_s *batch = NULL;
 
 	media_svc_debug_func();
 
 	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
 
-	if (g_media_svc_move_item_cur_data_cnt  > 0) {
+	batch = _media_svc_db_ctx_get_batch(db_handle, MEDIA_SVC_BATCH_OWNER_MEDIA, MEDIA_SVC_QUERY_MOVE_ITEM);
+	media_svc_retv_if(batch == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER);
+
+	if (batch->cur_data_cnt > 0) {
 
 		ret = _media_svc_list_query_do(db_handle, MEDIA_SVC_QUERY_MOVE_ITEM);
 	}
@@ -375,8 +736,10 @@ int media_svc_move_item_end(MediaSvcHandle *handle)
 	ret = _media_svc_update_folder_table(handle);
 	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 
-	g_media_svc_move_item_data_cnt  = 1;
-	g_media_svc_move_item_cur_data_cnt  = 0;
+	_media_svc_db_ctx_reset_batch(batch);
+
+	/* other batches which got no item for a while */
+	ret = _media_svc_batch_commit_if_old(db_handle);
 
 	return ret;
 }
@@ -386,6 +749,7 @@ int media_svc_move_item(MediaSvcHandle *handle, media_svc_storage_type_e src_sto
 {
 	int ret = MEDIA_INFO_ERROR_NONE;
 	sqlite3 * db_handle = (sqlite3 *)handle;
+	media_svc_batch_s *batch = NULL;
 	char *file_name = NULL;
 	char *folder_path = NULL;
 	int modified_time = 0;
@@ -397,6 +761,7 @@ int media_svc_move_item(MediaSvcHandle *handle, media_svc_storage_type_e src_sto
 	media_svc_debug_func();
 
 	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
+
 	media_svc_retvm_if(!STRING_VALID(src_path), MEDIA_INFO_ERROR_INVALID_PARAMETER, "src_path is NULL");
 	media_svc_retvm_if(!STRING_VALID(dest_path), MEDIA_INFO_ERROR_INVALID_PARAMETER, "dest_path is NULL");
 
@@ -409,6 +774,9 @@ int media_svc_move_item(MediaSvcHandle *handle, media_svc_storage_type_e src_sto
 		return MEDIA_INFO_ERROR_INVALID_PARAMETER;
 	}
 
+	batch = _media_svc_db_ctx_get_batch(db_handle, MEDIA_SVC_BATCH_OWNER_MEDIA, MEDIA_SVC_QUERY_MOVE_ITEM);
+	media_svc_retv_if(batch == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER);
+
 	/*check and update folder*/
 	ret = _media_svc_get_and_append_folder_id_by_path(handle, dest_path, dest_storage, folder_uuid);
 	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
@@ -431,7 +799,7 @@ int media_svc_move_item(MediaSvcHandle *handle, media_svc_storage_type_e src_sto
 		_media_svc_get_thumbnail_path(dest_storage, new_thumb_path, dest_path, THUMB_EXT);
 	}
 
-	if (g_media_svc_move_item_data_cnt == 1) {
+	if (batch->data_cnt == 1) {
 
 		/*update item*/
 		if((media_type == MEDIA_SVC_MEDIA_TYPE_IMAGE) ||(media_type == MEDIA_SVC_MEDIA_TYPE_VIDEO)) {
@@ -451,7 +819,7 @@ int media_svc_move_item(MediaSvcHandle *handle, media_svc_storage_type_e src_sto
 		ret = _media_svc_update_folder_table(handle);
 		media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 
-	} else if (g_media_svc_move_item_cur_data_cnt  < (g_media_svc_move_item_data_cnt  - 1)) {
+	} else if (batch->adaptive || batch->cur_data_cnt < (batch->data_cnt - 1)) {
 
 		/*update item*/
 		if((media_type == MEDIA_SVC_MEDIA_TYPE_IMAGE) ||(media_type == MEDIA_SVC_MEDIA_TYPE_VIDEO)) {
@@ -468,9 +836,12 @@ int media_svc_move_item(MediaSvcHandle *handle, media_svc_storage_type_e src_sto
 		SAFE_FREE(folder_path);
 		media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 
-		g_media_svc_move_item_cur_data_cnt ++;
+		batch->cur_data_cnt++;
 
-	} else if (g_media_svc_move_item_cur_data_cnt  == (g_media_svc_move_item_data_cnt  - 1)) {
+		ret = _media_svc_batch_commit_if_full(db_handle, MEDIA_SVC_QUERY_MOVE_ITEM);
+		media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	} else if (batch->cur_data_cnt == (batch->data_cnt - 1)) {
 
 		/*update item*/
 		if((media_type == MEDIA_SVC_MEDIA_TYPE_IMAGE) ||(media_type == MEDIA_SVC_MEDIA_TYPE_VIDEO)) {
@@ -491,7 +862,7 @@ int media_svc_move_item(MediaSvcHandle *handle, media_svc_storage_type_e src_sto
 		ret = _media_svc_list_query_do(db_handle, MEDIA_SVC_QUERY_MOVE_ITEM);
 		media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 
-		g_media_svc_move_item_cur_data_cnt = 0;
+		batch->cur_data_cnt = 0;
 
 	} else {
 		media_svc_error("Error in media_svc_move_item");
@@ -509,17 +880,68 @@ int media_svc_move_item(MediaSvcHandle *handle, media_svc_storage_type_e src_sto
 	return MEDIA_INFO_ERROR_NONE;
 }
 
+int media_svc_move_items(MediaSvcHandle *handle, media_svc_storage_type_e dest_storage, const media_svc_move_item_s *items, int count)
+{
+	int ret = MEDIA_INFO_ERROR_NONE;
+	sqlite3 * db_handle = (sqlite3 *)handle;
+	int i = 0;
+
+	media_svc_debug_func();
+
+	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
+	media_svc_retvm_if(items == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "items is NULL");
+	media_svc_retvm_if(count <= 0, MEDIA_INFO_ERROR_INVALID_PARAMETER, "count is invalid [%d]", count);
+
+	if ((dest_storage != MEDIA_SVC_STORAGE_INTERNAL) && (dest_storage != MEDIA_SVC_STORAGE_EXTERNAL)) {
+		media_svc_error("dest_storage type is incorrect[%d]", dest_storage);
+		return MEDIA_INFO_ERROR_INVALID_PARAMETER;
+	}
+
+	for (i = 0; i < count; i++) {
+		media_svc_retvm_if(!STRING_VALID(items[i].src_path), MEDIA_INFO_ERROR_INVALID_PARAMETER, "src_path of item[%d] is NULL", i);
+		media_svc_retvm_if(!STRING_VALID(items[i].dest_path), MEDIA_INFO_ERROR_INVALID_PARAMETER, "dest_path of item[%d] is NULL", i);
+	}
+
+	ret = _media_svc_sql_begin_trans(handle);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	ret = _media_svc_move_items(db_handle, dest_storage, items, count);
+	if (ret != MEDIA_INFO_ERROR_NONE) {
+		_media_svc_sql_rollback_trans(handle);
+		return ret;
+	}
+
+	ret = _media_svc_sql_end_trans(handle);
+	if (ret != MEDIA_INFO_ERROR_NONE) {
+		media_svc_error("mb_svc_sqlite3_commit_trans failed.. Now start to rollback\n");
+		_media_svc_sql_rollback_trans(handle);
+		return ret;
+	}
+
+	/* Move thumbnail files in background */
+	ret = _media_svc_thumb_journal_process();
+	if (ret != MEDIA_INFO_ERROR_NONE)
+		media_svc_error("fail to start thumbnail journal. It is resumed by next pass");
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
 int media_svc_set_item_validity_begin(MediaSvcHandle *handle, int data_cnt)
 {
 	sqlite3 * db_handle = (sqlite3 *)handle;
+	media_svc_batch_s *batch = NULL;
 
 	media_svc_debug("Transaction data count : [%d]", data_cnt);
 
 	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
-	media_svc_retvm_if(data_cnt < 1, MEDIA_INFO_ERROR_INVALID_PARAMETER, "data_cnt shuld be bigger than 1");
+	media_svc_retvm_if((data_cnt < 1) && (data_cnt != MEDIA_SVC_BATCH_ADAPTIVE), MEDIA_INFO_ERROR_INVALID_PARAMETER, "data_cnt shuld be bigger than 1");
 
-	g_media_svc_item_validity_data_cnt  = data_cnt;
-	g_media_svc_item_validity_cur_data_cnt  = 0;
+	batch = _media_svc_db_ctx_get_batch(db_handle, MEDIA_SVC_BATCH_OWNER_MEDIA, MEDIA_SVC_QUERY_SET_ITEM_VALIDITY);
+	media_svc_retv_if(batch == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER);
+
+	batch->data_cnt = data_cnt;
+	batch->cur_data_cnt = 0;
+	batch->adaptive = (data_cnt == MEDIA_SVC_BATCH_ADAPTIVE);
 
 	return MEDIA_INFO_ERROR_NONE;
 }
@@ -528,18 +950,25 @@ int media_svc_set_item_validity_end(MediaSvcHandle *handle)
 {
 	int ret = MEDIA_INFO_ERROR_NONE;
 	sqlite3 * db_handle = (sqlite3 *)handle;
+	media_svc_batch_s *batch = NULL;
 
 	media_svc_debug_func();
 
 	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
 
-	if (g_media_svc_item_validity_cur_data_cnt  > 0) {
+	batch = _media_svc_db_ctx_get_batch(db_handle, MEDIA_SVC_BATCH_OWNER_MEDIA, MEDIA_SVC_QUERY_SET_ITEM_VALIDITY);
+	media_svc_retv_if(batch == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER);
+
+	if (batch->cur_data_cnt > 0) {
 
 		ret = _media_svc_list_query_do(db_handle, MEDIA_SVC_QUERY_SET_ITEM_VALIDITY);
 	}
 
-	g_media_svc_item_validity_data_cnt  = 1;
-	g_media_svc_item_validity_cur_data_cnt  = 0;
+	_media_svc_db_ctx_reset_batch(batch);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	/* other batches which got no item for a while */
+	ret = _media_svc_batch_commit_if_old(db_handle);
 
 	return ret;
 }
@@ -548,26 +977,34 @@ int media_svc_set_item_validity(MediaSvcHandle *handle, const char *path, int va
 {
 	int ret = MEDIA_INFO_ERROR_NONE;
 	sqlite3 * db_handle = (sqlite3 *)handle;
+	media_svc_batch_s *batch = NULL;
 
 	media_svc_debug_func();
 
 	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
+
 	media_svc_retvm_if(!STRING_VALID(path), MEDIA_INFO_ERROR_INVALID_PARAMETER, "path is NULL");
 
+	batch = _media_svc_db_ctx_get_batch(db_handle, MEDIA_SVC_BATCH_OWNER_MEDIA, MEDIA_SVC_QUERY_SET_ITEM_VALIDITY);
+	media_svc_retv_if(batch == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER);
+
 	media_svc_debug("path=[%s], validity=[%d]", path, validity);
 
-	if (g_media_svc_item_validity_data_cnt  == 1) {
+	if (batch->data_cnt == 1) {
 
 		return _media_svc_update_item_validity(db_handle, path, validity, FALSE);
 
-	} else if (g_media_svc_item_validity_cur_data_cnt  < (g_media_svc_item_validity_data_cnt  - 1)) {
+	} else if (batch->adaptive || batch->cur_data_cnt < (batch->data_cnt - 1)) {
 
 		ret = _media_svc_update_item_validity(db_handle, path, validity, TRUE);
 		media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 
-		g_media_svc_item_validity_cur_data_cnt ++;
+		batch->cur_data_cnt++;
 
-	} else if (g_media_svc_item_validity_cur_data_cnt  == (g_media_svc_item_validity_data_cnt  - 1)) {
+		ret = _media_svc_batch_commit_if_full(db_handle, MEDIA_SVC_QUERY_SET_ITEM_VALIDITY);
+		media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+
+	} else if (batch->cur_data_cnt == (batch->data_cnt - 1)) {
 
 		ret = _media_svc_update_item_validity(db_handle, path, validity, TRUE);
 		media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
@@ -575,7 +1012,7 @@ int media_svc_set_item_validity(MediaSvcHandle *handle, const char *path, int va
 		ret = _media_svc_list_query_do(db_handle, MEDIA_SVC_QUERY_SET_ITEM_VALIDITY);
 		media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 
-		g_media_svc_item_validity_cur_data_cnt  = 0;
+		batch->cur_data_cnt = 0;
 
 	} else {
 
@@ -679,6 +1116,39 @@ int media_svc_set_all_storage_items_validity(MediaSvcHandle *handle, media_svc_s
 	return _media_svc_update_valid_of_music_records(db_handle, storage_type, validity);
 }
 
+int media_svc_mount_storage(MediaSvcHandle *handle, media_svc_storage_type_e storage_type, const char *volume_id)
+{
+	sqlite3 * db_handle = (sqlite3 *)handle;
+
+	media_svc_debug_func();
+
+	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
+	media_svc_retvm_if(!STRING_VALID(volume_id), MEDIA_INFO_ERROR_INVALID_PARAMETER, "volume_id is NULL");
+
+	if (storage_type != MEDIA_SVC_STORAGE_EXTERNAL) {
+		media_svc_error("storage type is incorrect[%d]", storage_type);
+		return MEDIA_INFO_ERROR_INVALID_PARAMETER;
+	}
+
+	return _media_svc_mount_storage(db_handle, storage_type, volume_id);
+}
+
+int media_svc_unmount_storage(MediaSvcHandle *handle, media_svc_storage_type_e storage_type)
+{
+	sqlite3 * db_handle = (sqlite3 *)handle;
+
+	media_svc_debug_func();
+
+	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
+
+	if (storage_type != MEDIA_SVC_STORAGE_EXTERNAL) {
+		media_svc_error("storage type is incorrect[%d]", storage_type);
+		return MEDIA_INFO_ERROR_INVALID_PARAMETER;
+	}
+
+	return _media_svc_unmount_storage(db_handle, storage_type);
+}
+
 int media_svc_refresh_item(MediaSvcHandle *handle, media_svc_storage_type_e storage_type,
 			  const char *path, media_svc_media_type_e media_type)
 {
@@ -704,9 +1174,13 @@ int media_svc_refresh_item(MediaSvcHandle *handle, media_svc_storage_type_e stor
 
 	media_svc_content_info_s content_info;
 	memset(&content_info, 0, sizeof(media_svc_content_info_s));
+	content_info.arena = _media_svc_db_ctx_get_arena(db_handle);
+	media_svc_probe_s probe;
+
+	_media_svc_probe_init(&probe, path);
 
 	/*Set media info*/
-	ret = _media_svc_set_media_info(&content_info, storage_type, path, NULL, media_type, TRUE);
+	ret = _media_svc_set_media_info(&content_info, &probe, storage_type, path, NULL, media_type, TRUE);
 	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 
 	/* Initialize thumbnail information to remake thumbnail. */
@@ -728,7 +1202,7 @@ int media_svc_refresh_item(MediaSvcHandle *handle, media_svc_storage_type_e stor
 		ret = _media_svc_extract_image_metadata(&content_info, media_type);
 		media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 	} else {
-		ret = _media_svc_extract_media_metadata(handle, &content_info, media_type);
+		ret = _media_svc_extract_media_metadata(handle, &content_info, &probe, media_type);
 		media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 	}
 
@@ -744,183 +1218,45 @@ int media_svc_rename_folder(MediaSvcHandle *handle, const char *src_path, const
 {
 	sqlite3 * db_handle = (sqlite3 *)handle;
 	int ret = MEDIA_INFO_ERROR_NONE;
+	char src_folder[MEDIA_SVC_PATHNAME_SIZE + 1] = {0,};
+	char dst_folder[MEDIA_SVC_PATHNAME_SIZE + 1] = {0,};
+	int len = 0;
+	time_t date;
 
 	media_svc_retvm_if(db_handle == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "Handle is NULL");
-	media_svc_retvm_if(src_path == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "src_path is NULL");
-	media_svc_retvm_if(dst_path == NULL, MEDIA_INFO_ERROR_INVALID_PARAMETER, "dst_path is NULL");
+	media_svc_retvm_if(!STRING_VALID(src_path), MEDIA_INFO_ERROR_INVALID_PARAMETER, "src_path is NULL");
+	media_svc_retvm_if(!STRING_VALID(dst_path), MEDIA_INFO_ERROR_INVALID_PARAMETER, "dst_path is NULL");
 
 	media_svc_debug("Src path : %s,  Dst Path : %s", src_path, dst_path);
 
-	ret = _media_svc_sql_begin_trans(handle);
-	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
+	/* Path prefix is matched with '/' appended, so trailing '/' is removed */
+	_strncpy_safe(src_folder, src_path, sizeof(src_folder));
+	_strncpy_safe(dst_folder, dst_path, sizeof(dst_folder));
 
-	/* Update all folder record's path, which are matched by old parent path */
-	char *update_folder_path_sql = NULL;
-	char src_path_slash[MEDIA_SVC_PATHNAME_SIZE + 1];
-	char dst_path_slash[MEDIA_SVC_PATHNAME_SIZE + 1];
+	for (len = strlen(src_folder); len > 1 && src_folder[len - 1] == '/'; len--)
+		src_folder[len - 1] = '\0';
+	for (len = strlen(dst_folder); len > 1 && dst_folder[len - 1] == '/'; len--)
+		dst_folder[len - 1] = '\0';
 
-	snprintf(src_path_slash, sizeof(src_path_slash), "%s/", src_path);
-	snprintf(dst_path_slash, sizeof(dst_path_slash), "%s/", dst_path);
-
-	update_folder_path_sql = sqlite3_mprintf("UPDATE folder SET path = REPLACE( path, '%q', '%q');", src_path_slash, dst_path_slash);
-
-	ret = _media_svc_sql_query(handle, update_folder_path_sql);
-	sqlite3_free(update_folder_path_sql);
-
-	if (ret != SQLITE_OK) {
-		media_svc_error("failed to update folder path");
-		_media_svc_sql_rollback_trans(handle);
-
-		return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
-	}
-
-	/* Update all folder record's modified date, which are changed above */
-	char *update_folder_modified_time_sql = NULL;
-	time_t date;
 	time(&date);
 
-	update_folder_modified_time_sql = sqlite3_mprintf("UPDATE folder SET modified_time = %d where path like '%q';", date, dst_path);
-
-	ret = _media_svc_sql_query(handle, update_folder_modified_time_sql);
-	sqlite3_free(update_folder_modified_time_sql);
+	ret = _media_svc_sql_begin_trans(handle);
+	media_svc_retv_if(ret != MEDIA_INFO_ERROR_NONE, ret);
 
-	if (ret != SQLITE_OK) {
-		media_svc_error("failed to update folder modified time");
+	/* Update path of the folder and all folders under it */
+	ret = _media_svc_update_folder_path_by_prefix(handle, src_folder, dst_folder, date);
+	if (ret != MEDIA_INFO_ERROR_NONE) {
 		_media_svc_sql_rollback_trans(handle);
-
-		return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
+		return ret;
 	}
 
-	/* Update all items */
-	char *select_all_sql = NULL;
-	sqlite3_stmt *sql_stmt = NULL;
-	char dst_child_path[MEDIA_SVC_PATHNAME_SIZE + 1];
-
-	snprintf(dst_child_path, sizeof(dst_child_path), "%s/%%", dst_path);
-
-	select_all_sql = sqlite3_mprintf("SELECT media_uuid, path, thumbnail_path, media_type from media where folder_uuid IN ( SELECT folder_uuid FROM folder where path='%q' or path like '%q');", dst_path, dst_child_path);
-
-	media_svc_debug("[SQL query] : %s", select_all_sql);
-
-	ret = sqlite3_prepare_v2(handle, select_all_sql, -1, &sql_stmt, NULL);
-	sqlite3_free((char *)select_all_sql);
-
-	if (ret != SQLITE_OK) {
-		media_svc_error ("prepare error [%s]", sqlite3_errmsg(handle));
+	/* Update path and thumbnail path of all items under the folder, and journal the thumbnail files to move */
+	ret = _media_svc_update_item_path_by_prefix(handle, src_folder, dst_folder);
+	if (ret != MEDIA_INFO_ERROR_NONE) {
 		_media_svc_sql_rollback_trans(handle);
-		return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
-	}
-
-	while (1) {
-		ret = sqlite3_step(sql_stmt);
-		if (ret != SQLITE_ROW) {
-			media_svc_debug("end of iteration");
-			break;
-		}
-
-		char media_uuid[MEDIA_SVC_UUID_SIZE + 1] = {0,};
-		char media_path[MEDIA_SVC_PATHNAME_SIZE + 1] = {0,};
-		char media_thumb_path[MEDIA_SVC_PATHNAME_SIZE + 1] = {0,};
-		char media_new_thumb_path[MEDIA_SVC_PATHNAME_SIZE + 1] = {0,};
-		int media_type;
-		bool no_thumb = FALSE;
-
-		if (STRING_VALID((const char *)sqlite3_column_text(sql_stmt, 0))) {
-			strncpy(media_uuid,	(const char *)sqlite3_column_text(sql_stmt, 0), sizeof(media_uuid));
-		} else {
-			media_svc_error("media UUID is NULL");
-			return MEDIA_INFO_ERROR_DATABASE_INVALID;
-		}
-
-		if (STRING_VALID((const char *)sqlite3_column_text(sql_stmt, 1))) {
-			strncpy(media_path,	(const char *)sqlite3_column_text(sql_stmt, 1), sizeof(media_path));
-		} else {
-			media_svc_error("media path is NULL");
-			return MEDIA_INFO_ERROR_DATABASE_INVALID;
-		}
-
-		if (STRING_VALID((const char *)sqlite3_column_text(sql_stmt, 2))) {
-			strncpy(media_thumb_path,	(const char *)sqlite3_column_text(sql_stmt, 2), sizeof(media_thumb_path));
-		} else {
-			media_svc_debug("media thumb path doesn't exist in DB");
-			no_thumb = TRUE;
-		}
-
-		media_type = sqlite3_column_int(sql_stmt, 3);
-
-		/* Update path, thumbnail path of this item */
-		char *replaced_path = NULL;
-		replaced_path = _media_svc_replace_path(media_path, src_path, dst_path);
-		if (replaced_path == NULL) {
-			media_svc_error("_media_svc_replace_path failed");
-			SQLITE3_FINALIZE(sql_stmt);
-			_media_svc_sql_rollback_trans(handle);
-			return MEDIA_INFO_ERROR_INTERNAL;
-		}
-
-		media_svc_debug("New media path : %s", replaced_path);
-		media_svc_storage_type_e storage_type;
-
-		if (!no_thumb) {
-			ret = _media_svc_get_store_type_by_path(replaced_path, &storage_type);
-			if (ret < 0) {
-				media_svc_error("_media_svc_get_store_type_by_path failed : %d", ret);
-				SAFE_FREE(replaced_path);
-				_media_svc_sql_rollback_trans(handle);
-				return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
-			}
-
-			ret = _media_svc_get_thumbnail_path(storage_type, media_new_thumb_path, replaced_path, THUMB_EXT);
-			if (ret < 0) {
-				media_svc_error("_media_svc_get_thumbnail_path failed : %d", ret);
-				SAFE_FREE(replaced_path);
-				SQLITE3_FINALIZE(sql_stmt);
-				_media_svc_sql_rollback_trans(handle);
-				return MEDIA_INFO_ERROR_INTERNAL;
-			}
-
-			media_svc_debug("New media thumbnail path : %s", media_new_thumb_path);
-		}
-
-		char *update_item_sql = NULL;
-
-		if (no_thumb) {
-			update_item_sql = sqlite3_mprintf("UPDATE media SET path='%q' WHERE media_uuid='%q'", replaced_path, media_uuid);
-		} else {
-			if (media_type == MEDIA_SVC_MEDIA_TYPE_IMAGE || media_type == MEDIA_SVC_MEDIA_TYPE_VIDEO) {
-				update_item_sql = sqlite3_mprintf("UPDATE media SET path='%q', thumbnail_path='%q' WHERE media_uuid='%q'", replaced_path, media_new_thumb_path, media_uuid);
-			} else {
-				update_item_sql = sqlite3_mprintf("UPDATE media SET path='%q', thumbnail_path='%q' WHERE media_uuid='%q'", replaced_path, media_thumb_path, media_uuid);
-			}
-		}
-
-		ret = _media_svc_sql_query(handle, update_item_sql);
-		sqlite3_free(update_item_sql);
-		SAFE_FREE(replaced_path);
-
-		if (ret != SQLITE_OK) {
-			media_svc_error("failed to update item");
-			SQLITE3_FINALIZE(sql_stmt);
-			_media_svc_sql_rollback_trans(handle);
-	
-			return MEDIA_INFO_ERROR_DATABASE_INTERNAL;
-		}
-
-		/* Rename thumbnail file of file system */
-		if ((!no_thumb) && (media_type == MEDIA_SVC_MEDIA_TYPE_IMAGE || media_type == MEDIA_SVC_MEDIA_TYPE_VIDEO)) {
-			ret = _media_svc_rename_file(media_thumb_path, media_new_thumb_path);
-			if (ret < 0) {
-				media_svc_error("_media_svc_rename_file failed : %d", ret);
-				SQLITE3_FINALIZE(sql_stmt);
-				_media_svc_sql_rollback_trans(handle);
-	
-				return MEDIA_INFO_ERROR_INTERNAL;
-			}
-		}
+		return ret;
 	}
 
-	SQLITE3_FINALIZE(sql_stmt);
-
 	ret = _media_svc_sql_end_trans(handle);
 	if (ret != MEDIA_INFO_ERROR_NONE) {
 		media_svc_error("mb_svc_sqlite3_commit_trans failed.. Now start to rollback\n");
@@ -928,6 +1264,10 @@ int media_svc_rename_folder(MediaSvcHandle *handle, const char *src_path, const
 		return ret;
 	}
 
+	/* Move thumbnail files in background */
+	ret = _media_svc_thumb_journal_process();
+	if (ret != MEDIA_INFO_ERROR_NONE)
+		media_svc_error("fail to start thumbnail journal. It is resumed by next pass");
+
 	return MEDIA_INFO_ERROR_NONE;
 }
-
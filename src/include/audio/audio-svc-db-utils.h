@@ -33,13 +33,16 @@
 
 #include <sqlite3.h>
 #include <glib.h>
+#include "media-svc-db-ctx.h"
 
 #define SQLITE3_FINALIZE(x)       if(x  != NULL) {sqlite3_finalize(x);}
+#define SQLITE3_RELEASE(x)        if(x  != NULL) {_media_svc_db_ctx_release_stmt(x);}
 
 int _audio_svc_sql_busy_handler(void *pData, int count);
 int _audio_svc_sql_query(sqlite3 *handle, const char *sql_str);
 int _audio_svc_sql_query_list(sqlite3 *handle, GList **query_list);
 int _audio_svc_sql_prepare_to_step(sqlite3 *handle, const char *sql_str, sqlite3_stmt** stmt);
+int _audio_svc_sql_bind_limit(sqlite3_stmt *stmt, int offset, int rows);
 int _audio_svc_sql_begin_trans(sqlite3 *handle);
 int _audio_svc_sql_end_trans(sqlite3 *handle);
 int _audio_svc_sql_rollback_trans(sqlite3 *handle);
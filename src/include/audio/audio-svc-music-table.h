@@ -36,6 +36,9 @@
 #include <sqlite3.h>
 #include "audio-svc-types.h"
 #include "audio-svc-types-priv.h"
+#include "media-svc-types.h"
+#include "media-svc-env.h"
+#include "media-svc-db-ctx.h"
 
 typedef struct{
 	char thumbnail_path[AUDIO_SVC_PATHNAME_SIZE];
@@ -74,11 +77,13 @@ int _audio_svc_get_music_track_records(sqlite3 *handle, audio_svc_track_type_e t
 int _audio_svc_search_audio_id_by_path(sqlite3 *handle, const char *path, char *audio_id);
 int _audio_svc_update_valid_of_music_records(sqlite3 *handle, audio_svc_storage_type_e storage_type, int valid);
 int _audio_svc_count_record_with_path(sqlite3 *handle, const char *path);
+int _audio_svc_check_records_with_path(sqlite3 *handle, const char **path_list, int count, int *exist_list);
 int _audio_svc_delete_invalid_music_records(sqlite3 *handle, audio_svc_storage_type_e storage_type);
 int _audio_svc_update_valid_in_music_record(sqlite3 *handle, const char *path, int valid);
 int _audio_svc_update_valid_in_music_record_query_add(sqlite3 *handle, const char *path, int valid);
 int _audio_svc_move_item_query_add(sqlite3 *handle, const char *src_path, const char *path, audio_svc_storage_type_e storage_type, const char *folder_id);
 int _audio_svc_list_query_do(sqlite3 *handle, audio_svc_query_type_e query_type);
+media_svc_batch_s *_audio_svc_get_batch(sqlite3 *handle, audio_svc_query_type_e query_type);
 int _audio_svc_get_path(sqlite3 *handle, const char *audio_id, char *path);
 int _audio_svc_delete_music_track_groups(sqlite3 *handle, audio_svc_group_type_e group_type, const char *type_string);
 int _audio_svc_check_and_update_folder_table(sqlite3 *handle, const char* path_name);
@@ -92,6 +97,7 @@ int _audio_svc_append_audio_folder(sqlite3 *handle, audio_svc_storage_type_e sto
 char * _audio_svc_get_thumbnail_path_by_album_id(sqlite3 *handle, int album_id);
 int _audio_svc_check_and_remove_thumbnail(sqlite3 *handle, const char * thumbnail_path);
 int _audio_svc_list_search(sqlite3 *handle, audio_svc_audio_item_s *item,
+							unsigned int field_mask,
 							char *where_query,
 							audio_svc_search_order_e order_field,
 							int offset,
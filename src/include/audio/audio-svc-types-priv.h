@@ -34,7 +34,9 @@
 /**
  * DB table information
  */
-#define AUDIO_SVC_DB_TABLE_AUDIO						"audio_media"			/**<  audio_media table. (old mp_music_phone table)*/
+#define AUDIO_SVC_DB_TABLE_AUDIO						"audio_media"			/**<  audio_media view. (old mp_music_phone table)*/
+#define AUDIO_SVC_DB_TABLE_AUDIO_DATA				"audio_media_data"		/**<  audio_media_data table, which audio_media view is made from*/
+#define AUDIO_SVC_DB_TABLE_AUDIO_META_DICT			"audio_meta_dict"		/**<  audio_meta_dict table of album, artist, genre, author and year*/
 #define AUDIO_SVC_DB_TABLE_AUDIO_PLAYLISTS			"audio_playlists"			/**<  audio_playlists table*/
 #define AUDIO_SVC_DB_TABLE_AUDIO_PLAYLISTS_MAP		"audio_playlists_map"		/**<  audio_playlists_map table*/
 #define AUDIO_SVC_DB_TABLE_ALBUMS					"albums"				/**<  albums table*/
@@ -78,6 +80,9 @@ typedef struct {
 	int		rating;										/**< user defined rating */
 	int		category;									/**< category. sound or music*/
 	int		favourate;									/**< favourate. o or 1 */
+	int		file_stat_done;								/**< 1 if time_modified and size are set from stat of the file */
+	int		time_modified;								/**< modified time of the file */
+	int		size;										/**< size of the file */
 	audio_svc_audio_meta_s		audio;					/**< meta data structure for audio files */
 } audio_svc_audio_item_s;
 
@@ -94,16 +99,37 @@ typedef struct{
 	int album_rating;										/**< album rating*/
 }audio_svc_group_item_s;
 
+#define AUDIO_SVC_STR_HEAP_INIT_SIZE		4096
+
+typedef struct _audio_svc_str_block_s{
+	struct _audio_svc_str_block_s *next;					/**< next block of the heap */
+	char *data;											/**< NUL terminated strings, allocated with the block */
+	int size;												/**< size of data */
+	int used;												/**< used size of data */
+}audio_svc_str_block_s;
+
+/**
+ * String heap of a packed result list.
+ * Records of the list point to their strings in the heap instead of fixed size arrays,
+ * so a page of results is sized to its contents.
+ * The heap grows by chaining blocks, so strings given to callers are not moved while the list is filled.
+ */
+typedef struct{
+	audio_svc_str_block_s *head;							/**< first block */
+	audio_svc_str_block_s *cur;							/**< block being filled */
+}audio_svc_str_heap_s;
+
 /**
  * List item search result record
  */
 typedef struct{
+	audio_svc_str_heap_s *heap;							/**< string heap of the list */
 	char	 audio_uuid[AUDIO_SVC_UUID_SIZE+1];			/**< Unique ID of item */
-	char pathname[AUDIO_SVC_PATHNAME_SIZE];			/**< Full path and file name of media file */
-	char title[AUDIO_SVC_METADATA_LEN_MAX];				/**< title of track */
-	char artist[AUDIO_SVC_METADATA_LEN_MAX];			/**< artist of track */
-	char thumbnail_path[AUDIO_SVC_PATHNAME_SIZE];			/**< Thumbnail image file path */
-	char album[AUDIO_SVC_METADATA_LEN_MAX];			/**< album of track */
+	const char *pathname;										/**< full path and file name of media file */
+	const char *title;											/**< title of track */
+	const char *artist;										/**< artist of track */
+	const char *thumbnail_path;								/**< thumbnail image file path */
+	const char *album;											/**< album of track */
 	int duration;											/**< track duration*/
 	int rating;											/**< track rating*/
 }audio_svc_list_item_s;
@@ -118,12 +144,13 @@ typedef struct{
 }audio_svc_playlist_s;
 
 typedef struct{
+	audio_svc_str_heap_s *heap;							/**< string heap of the list */
 	int u_id;												/**< Unique ID of playlist item*/	
 	char	 audio_uuid[AUDIO_SVC_UUID_SIZE+1];			/**< Unique Audio ID */
-	char pathname[AUDIO_SVC_PATHNAME_SIZE];			/**< Full path and file name of media file */
-	char title[AUDIO_SVC_METADATA_LEN_MAX];				/**< title of track */
-	char artist[AUDIO_SVC_METADATA_LEN_MAX];			/**< artist of track */
-	char thumbnail_path[AUDIO_SVC_PATHNAME_SIZE];			/**< Thumbnail image file path */
+	const char *pathname;										/**< full path and file name of media file */
+	const char *title;											/**< title of track */
+	const char *artist;										/**< artist of track */
+	const char *thumbnail_path;								/**< thumbnail image file path */
 	int duration;											/**< track duration*/
 	int rating;											/**< track rating*/
 	int play_order;										/**< Play order*/
@@ -37,6 +37,8 @@
 #include <string.h>
 #include "audio-svc-types.h"
 #include "audio-svc-types-priv.h"
+#include "media-svc-env.h"
+#include "media-svc-util.h"
 
 
 #ifndef FALSE
@@ -58,7 +60,8 @@ char * _year_2_str(int year);
 //void _strncpy_safe(char *x_dst, const char *x_src, int max_len);
 void _strlcat_safe(char *x_dst, char *x_src, int max_len);
 void _audio_svc_get_parental_rating(const char *path, char *parental_rating);
-int _audio_svc_extract_metadata_audio(audio_svc_storage_type_e storage_type, const char *path, audio_svc_audio_item_s *item);
+int _audio_svc_extract_metadata_audio(audio_svc_storage_type_e storage_type, const char *path, media_svc_probe_s *probe, audio_svc_audio_item_s *item);
+int _audio_svc_extract_metadata_by_content_info(const media_svc_content_info_s *content_info, media_svc_probe_s *probe, audio_svc_audio_item_s *item);
 int _audio_svc_remove_all_files_in_dir(const char *dir_path);
 int _audio_svc_get_drm_mime_type(const char *path, char *mime_type);
 bool _audio_svc_possible_to_extract_title_from_file(const char *path);
@@ -71,5 +74,11 @@ char * _audio_svc_get_title_from_filepath (const char *path);
 unsigned int _audio_svc_print_elapse_time(int start_time, const char* log_msg);
 int _audio_svc_get_order_field_str(audio_svc_search_order_e order_field, char* output_str, int len);
 int _audio_svc_get_file_dir_modified_date(const char *full_path);
+/* string field of a packed list record. never NULL */
+#define AUDIO_SVC_LIST_STR(record, field)	((char *)(((record).field != NULL) ? (record).field : ""))
+
+int _audio_svc_str_heap_add(audio_svc_str_heap_s *heap, const char *str, const char **ptr);
+void _audio_svc_str_heap_reset(audio_svc_str_heap_s *heap);
+void _audio_svc_str_heap_free(audio_svc_str_heap_s *heap);
 
 #endif /*_AUDIO_SVC_UTILS_H_*/
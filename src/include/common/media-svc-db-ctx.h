@@ -0,0 +1,102 @@
+/*
+ * libmedia-service
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Hyunjun Ko <zzoon.ko@samsung.com>, Haejeong Kim <backto.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _MEDIA_SVC_DB_CTX_H_
+#define _MEDIA_SVC_DB_CTX_H_
+
+#include <sqlite3.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <glib.h>
+#include "media-svc-types.h"
+#include "media-svc-env.h"
+
+/**
+ * Owner of batch state. media, audio and visual API stack their own queries on the same handle.
+ */
+typedef enum {
+	MEDIA_SVC_BATCH_OWNER_MEDIA,
+	MEDIA_SVC_BATCH_OWNER_AUDIO,
+	MEDIA_SVC_BATCH_OWNER_VISUAL,
+	MEDIA_SVC_BATCH_OWNER_MAX,
+} media_svc_batch_owner_e;
+
+#define MEDIA_SVC_BATCH_QUERY_MAX	(MEDIA_SVC_QUERY_MOVE_ITEM + 1)
+
+/**
+ * Batch state of one kind of query (insert, validity, move).
+ * It was kept in thread local globals before, so two handles on one thread shared it.
+ */
+typedef struct {
+	int data_cnt;			/**< number of items in one transaction, set by *_begin */
+	int cur_data_cnt;		/**< number of items stacked in current transaction */
+	GList *query_list;		/**< stacked queries. allocated by sqlite3_mprintf */
+	bool adaptive;			/**< commit by time and size instead of data_cnt. media API only */
+	int queued_cnt;			/**< number of stacked queries */
+	size_t queued_bytes;	/**< total length of stacked queries */
+	unsigned long long first_usec;	/**< monotonic time the first query is stacked */
+} media_svc_batch_s;
+
+/**
+ * Per-handle state.
+ * MediaSvcHandle is the sqlite3 connection itself and it is shared with audio and visual API,
+ * so state of a handle is kept in a registry keyed by the connection.
+ * A context is made when a connection is opened, and freed when it is closed.
+ */
+typedef struct {
+	media_svc_busy_strategy_e busy_strategy;	/**< busy wait strategy */
+	int busy_wait_usec;						/**< waited time in current lock wait */
+	media_svc_lock_stats_s lock_stats;		/**< lock contention counters */
+	pthread_mutex_t stats_mutex;			/**< busy strategy and counters are used by the thread running queries and set or read by API from any thread */
+	media_svc_batch_s batch[MEDIA_SVC_BATCH_OWNER_MAX][MEDIA_SVC_BATCH_QUERY_MAX];	/**< batch state */
+	int max_lock_hold_usec;					/**< target lock hold time of adaptive batch */
+	double query_usec;						/**< moving average of a query time in batch */
+	double commit_usec;						/**< moving average of a commit time */
+	bool bulk_load;							/**< in bulk load session. secondary indexes of media_data are dropped */
+	bool scan_session;						/**< in scan session. API calls run in savepoints of its transaction */
+	bool scan_open;							/**< transaction of scan session is open. it is committed between calls once the lock is held longer than target */
+	bool scan_lost;							/**< sqlite rolled back the transaction of scan session, and its work is lost. reported by session end */
+	int trans_depth;						/**< open savepoints of API calls nested in a transaction of scan session or of the caller */
+	unsigned long long session_usec;		/**< monotonic time the transaction of scan session is opened */
+	media_svc_arena_s content_arena;		/**< strings of content info being inserted or refreshed */
+	GHashTable *stmt_cache;					/**< prepared statements of list and count queries, keyed by their parameterized sql */
+	unsigned int stmt_cache_tick;			/**< number of statement cache lookups. least recently used statement is evicted when cache is full */
+	GHashTable *count_cache;				/**< results of count API, keyed by API and its arguments */
+	int count_data_version;					/**< data_version of database when count_cache is filled. changed by commits of other connections */
+	int count_total_changes;				/**< total changes of this connection when count_cache is filled */
+	unsigned int count_rollback_serial;	/**< rollback_serial when count_cache is filled */
+	unsigned int rollback_serial;			/**< number of rollbacks of this connection. rolled back changes are not seen in total changes */
+	media_svc_count_cache_stats_s count_stats;	/**< count result cache counters */
+	char last_updated_folder_uuid[MEDIA_SVC_UUID_SIZE + 1];	/**< folder set as valid last in visual validity batch */
+} media_svc_db_ctx_s;
+
+media_svc_db_ctx_s *_media_svc_db_ctx_create(sqlite3 *db_handle);
+media_svc_db_ctx_s *_media_svc_db_ctx_get(sqlite3 *db_handle);
+void _media_svc_db_ctx_destroy(sqlite3 *db_handle);
+media_svc_batch_s *_media_svc_db_ctx_get_batch(sqlite3 *db_handle, media_svc_batch_owner_e owner, media_svc_query_type_e query_type);
+void _media_svc_db_ctx_reset_batch(media_svc_batch_s *batch);
+media_svc_arena_s *_media_svc_db_ctx_get_arena(sqlite3 *db_handle);
+int _media_svc_db_ctx_prepare_stmt(sqlite3 *db_handle, const char *sql, sqlite3_stmt **stmt);
+int _media_svc_db_ctx_release_stmt(sqlite3_stmt *stmt);
+bool _media_svc_db_ctx_get_count(sqlite3 *db_handle, const char *key, int *count);
+void _media_svc_db_ctx_set_count(sqlite3 *db_handle, const char *key, int count);
+
+#endif /*_MEDIA_SVC_DB_CTX_H_*/
@@ -0,0 +1,35 @@
+/*
+ * libmedia-service
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Hyunjun Ko <zzoon.ko@samsung.com>, Haejeong Kim <backto.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _MEDIA_SVC_DB_POOL_H_
+#define _MEDIA_SVC_DB_POOL_H_
+
+#include <sqlite3.h>
+
+#define MEDIA_SVC_DB_POOL_READER_MAX		4		/**< Max number of idle read connections kept in pool */
+
+int _media_svc_db_pool_get_reader(sqlite3 **db_handle);
+int _media_svc_db_pool_put_reader(sqlite3 *db_handle);
+int _media_svc_db_pool_get_writer(sqlite3 **db_handle);
+int _media_svc_db_pool_put_writer(sqlite3 *db_handle);
+int _media_svc_db_pool_destroy(void);
+
+#endif /*_MEDIA_SVC_DB_POOL_H_*/
@@ -28,8 +28,15 @@
 
 #define SQLITE3_FINALIZE(x)       if(x  != NULL) {sqlite3_finalize(x);}
 
+typedef enum {
+	MEDIA_SVC_TRANS_BEGIN,
+	MEDIA_SVC_TRANS_COMMIT,
+	MEDIA_SVC_TRANS_ROLLBACK,
+} media_svc_trans_op_e;
+
 int _media_svc_connect_db_with_handle(sqlite3 **db_handle);
 int _media_svc_disconnect_db_with_handle(sqlite3 *db_handle);
+int _media_svc_create_storage_table(sqlite3 *db_handle);
 int _media_svc_create_media_table(sqlite3 *db_handle);
 int _media_svc_create_folder_table(sqlite3 *db_handle);
 int _media_svc_create_playlist_table(sqlite3 *db_handle);
@@ -37,8 +44,23 @@ int _media_svc_create_album_table(sqlite3 *db_handle);
 int _media_svc_create_tag_table(sqlite3 *db_handle);
 int _media_svc_create_bookmark_table(sqlite3 *db_handle);
 int _media_svc_create_custom_table(sqlite3 *db_handle);
+int _media_svc_create_thumb_journal_table(sqlite3 *db_handle);
+int _media_svc_create_change_log_table(sqlite3 *db_handle);
+int _media_svc_create_legacy_change_log_table(sqlite3 *db_handle, const char *table);
+int _media_svc_create_visual_folder_id(sqlite3 *db_handle);
+int _media_svc_create_media_index(sqlite3 *db_handle);
+int _media_svc_drop_media_index(sqlite3 *db_handle);
+int _media_svc_bulk_load_begin(sqlite3 *db_handle);
+int _media_svc_bulk_load_end(sqlite3 *db_handle);
+int _media_svc_scan_session_begin(sqlite3 *db_handle);
+int _media_svc_scan_session_end(sqlite3 *db_handle);
+int _media_svc_scan_session_enter(sqlite3 *db_handle);
+int _media_svc_scan_session_leave(sqlite3 *db_handle);
+void _media_svc_scan_update_begin(void);
+int _media_svc_scan_update_end(void);
 int _media_svc_sql_query(sqlite3 *db_handle, const char *sql_str);
 int _media_svc_sql_prepare_to_step(sqlite3 *handle, const char *sql_str, sqlite3_stmt** stmt);
+int _media_svc_sql_trans(sqlite3 *handle, media_svc_trans_op_e op, char **err_msg);
 int _media_svc_sql_begin_trans(sqlite3 *handle);
 int _media_svc_sql_end_trans(sqlite3 *handle);
 int _media_svc_sql_rollback_trans(sqlite3 *handle);
@@ -35,20 +35,38 @@ extern "C" {
  */
 
 #define MEDIA_SVC_DB_NAME 						"/opt/dbspace/.media.db"		/**<  media db name*/
+#define MEDIA_SVC_DB_CACHE_SIZE					4000		/**<  page cache size of a connection, in pages*/
+#define MEDIA_SVC_DB_WAL_AUTOCHECKPOINT			1000		/**<  WAL size in pages to trigger checkpoint*/
+#define MEDIA_SVC_DB_BUSY_MIN_USEC				100			/**<  first wait of backoff busy strategy*/
+#define MEDIA_SVC_DB_BUSY_MAX_USEC				50000		/**<  max wait of a retry*/
+#define MEDIA_SVC_DB_BUSY_TIMEOUT_USEC			5000000		/**<  give up a lock wait after this*/
+#define MEDIA_SVC_BATCH_LOCK_HOLD_MSEC			100			/**<  default target of writer lock hold time of adaptive batch*/
+#define MEDIA_SVC_BATCH_MAX_DELAY_USEC			1000000		/**<  adaptive batch is committed when its first query is older than this*/
+#define MEDIA_SVC_BATCH_MAX_BYTES				(1024 * 1024)	/**<  adaptive batch is committed when its queries are bigger than this*/
+#define MEDIA_SVC_BATCH_QUERY_USEC				200			/**<  initial estimate of a query time in batch*/
+#define MEDIA_SVC_BATCH_COMMIT_USEC				10000		/**<  initial estimate of a commit time*/
 
 /**
  * DB table information
  */
 
-#define MEDIA_SVC_DB_TABLE_MEDIA					"media"				/**<  media table*/
-#define MEDIA_SVC_DB_TABLE_FOLDER					"folder"				/**<  media_folder table*/
+#define MEDIA_SVC_DB_TABLE_MEDIA					"media"				/**<  media view of mounted storage, joined with folder and meta_dict*/
+#define MEDIA_SVC_DB_TABLE_MEDIA_DATA				"media_data"			/**<  media table*/
+#define MEDIA_SVC_DB_TABLE_META_DICT				"meta_dict"			/**<  interned album, artist, genre, composer and year*/
+#define MEDIA_SVC_DB_TABLE_FOLDER					"folder"				/**<  media_folder view, of mounted storage*/
+#define MEDIA_SVC_DB_TABLE_FOLDER_DATA			"folder_data"			/**<  media_folder table*/
+#define MEDIA_SVC_DB_TABLE_STORAGE				"storage"			/**<  volume and mount state of storage*/
 #define MEDIA_SVC_DB_TABLE_PLAYLIST				"playlist"				/**<  playlist table*/
-#define MEDIA_SVC_DB_TABLE_PLAYLIST_MAP			"playlist_map"			/**<  playlist_map table*/
+#define MEDIA_SVC_DB_TABLE_PLAYLIST_MAP			"playlist_map"			/**<  playlist_map view, joined with media_data*/
+#define MEDIA_SVC_DB_TABLE_PLAYLIST_MAP_DATA		"playlist_map_data"	/**<  playlist_map table*/
 #define MEDIA_SVC_DB_TABLE_ALBUM					"album"				/**<  album table*/
 #define MEDIA_SVC_DB_TABLE_TAG					"tag"				/**<  tag table*/
-#define MEDIA_SVC_DB_TABLE_TAG_MAP				"tag_map"			/**<  tag_map table*/
+#define MEDIA_SVC_DB_TABLE_TAG_MAP				"tag_map"			/**<  tag_map view, joined with media_data*/
+#define MEDIA_SVC_DB_TABLE_TAG_MAP_DATA			"tag_map_data"		/**<  tag_map table*/
 #define MEDIA_SVC_DB_TABLE_BOOKMARK				"bookmark"			/**<  bookmark table*/
 #define MEDIA_SVC_DB_TABLE_CUSTOM				"custom"				/**<  custom table*/
+#define MEDIA_SVC_DB_TABLE_THUMB_JOURNAL			"thumbnail_journal"	/**<  thumbnail journal table*/
+#define MEDIA_SVC_DB_TABLE_CHANGE_LOG				"change_log"			/**<  log of changes of media_data, for incremental refresh*/
 
 
 #define MEDIA_SVC_METADATA_LEN_MAX			128						/**<  Length of metadata*/
@@ -63,6 +81,11 @@ extern "C" {
 #define MEDIA_SVC_THUMB_EXTERNAL_PATH 		MEDIA_SVC_THUMB_PATH_PREFIX"/mmc"		/**<  MMC thumbnail path*/
 
 #define MEDIA_SVC_DEFAULT_GPS_VALUE			-200			/**<  Default GPS Value*/
+#define MEDIA_SVC_ARENA_BLOCK_SIZE			(16 * 1024)		/**<  Size of a block of content info arena*/
+#define MEDIA_SVC_ARENA_ALIGN				8				/**<  Alignment of arena allocation*/
+#define MEDIA_SVC_STMT_CACHE_MAX			32				/**<  Max number of cached statements of a handle*/
+#define MEDIA_SVC_COUNT_CACHE_MAX			64				/**<  Max number of cached count results of a handle*/
+#define MEDIA_SVC_CHANGE_LOG_TRUNCATE_STEP	256				/**<  Change log is truncated once per this number of changes*/
 #define THUMB_EXT 	"jpg"
 
 #define MEDIA_SVC_PATH_PHONE				"/opt/media"
@@ -136,6 +159,21 @@ typedef struct {
 	media_svc_content_meta_s		media_meta;					/**< meta data structure for audio files */
 } media_svc_content_info_s;
 #else
+/**
+ * Bump allocator of strings of content info, and of items of minfo lists.
+ * Allocations are not freed one by one. All of them are dropped by reset, and the first block is kept for next item.
+ */
+typedef struct _media_svc_arena_block_s {
+	struct _media_svc_arena_block_s *next;	/**< older block */
+	size_t	size;					/**< size of data */
+	size_t	used;					/**< used bytes of data */
+	char		data[];					/**< strings */
+} media_svc_arena_block_s;
+
+typedef struct {
+	media_svc_arena_block_s *head;	/**< newest block */
+} media_svc_arena_s;
+
 /**
  * Media meta data information
  */
@@ -187,6 +225,7 @@ typedef struct {
 	int		is_drm;						/**< is_drm. o or 1 */
 	int		storage_type;					/**< Storage of media file : internal/external */
 	media_svc_content_meta_s	media_meta;	/**< meta data structure for audio files */
+	media_svc_arena_s	*	arena;			/**< strings are allocated from this arena if set, and dropped by reset of it */
 } media_svc_content_info_s;
 #endif
 
@@ -196,6 +235,15 @@ typedef enum{
 	MEDIA_SVC_QUERY_MOVE_ITEM,
 } media_svc_query_type_e;
 
+/* kind of value interned in meta_dict table */
+typedef enum{
+	MEDIA_SVC_META_DICT_ALBUM,
+	MEDIA_SVC_META_DICT_ARTIST,
+	MEDIA_SVC_META_DICT_GENRE,
+	MEDIA_SVC_META_DICT_COMPOSER,
+	MEDIA_SVC_META_DICT_YEAR,
+} media_svc_meta_dict_kind_e;
+
 #ifdef __cplusplus
 }
 #endif
@@ -26,8 +26,12 @@
 #include <stdbool.h>
 #include "media-svc-types.h"
 #include "media-svc-env.h"
+#include "media-svc-util.h"
 
 int _media_svc_count_record_with_path(sqlite3 *handle, const char *path, int *count);
+int _media_svc_check_items(sqlite3 *handle, media_svc_item_check_s *items, int count);
+int _media_svc_get_change_version(sqlite3 *handle, long long *version);
+int _media_svc_get_changes(sqlite3 *handle, long long since_version, media_svc_change_s *changes, int max_count, int *count);
 int _media_svc_insert_item_with_data(sqlite3 *handle, media_svc_content_info_s *content_info, bool stack_query);
 int _media_svc_update_item_with_data(sqlite3 *handle, media_svc_content_info_s *content_info);
 int _media_svc_get_thumbnail_path_by_path(sqlite3 *handle, const char *path, char *thumbnail_path);
@@ -38,7 +42,14 @@ int _media_svc_delete_invalid_items(sqlite3 *handle, media_svc_storage_type_e st
 int _media_svc_update_valid_of_music_records(sqlite3 *handle, media_svc_storage_type_e storage_type, int validity);
 int _media_svc_update_item_validity(sqlite3 *handle, const char *path, int validity, bool stack_query);
 int _media_svc_update_item_by_path(sqlite3 *handle, const char *src_path, media_svc_storage_type_e dest_storage, const char *dest_path, const char *file_name, int modified_time, const char *folder_uuid, const char *thumb_path, bool stack_query);
+int _media_svc_update_item_path_by_prefix(sqlite3 *handle, const char *src_path, const char *dst_path);
+int _media_svc_move_items(sqlite3 *handle, media_svc_storage_type_e dest_storage, const media_svc_move_item_s *items, int count);
+int _media_svc_stack_query(sqlite3 *handle, media_svc_query_type_e query_type, char **sql);
+int _media_svc_batch_commit_if_full(sqlite3 *handle, media_svc_query_type_e query_type);
+int _media_svc_batch_commit_if_old(sqlite3 *handle);
 int _media_svc_list_query_do(sqlite3 *handle, media_svc_query_type_e query_type);
+int _media_svc_make_content_info(sqlite3 *handle, media_svc_probe_s *probe, media_svc_storage_type_e storage_type, const char *path, const char *mime_type, media_svc_media_type_e media_type, media_svc_content_info_s *content_info);
+int _media_svc_insert_content_info_bulk(sqlite3 *handle, media_svc_content_info_s *content_info);
 int _media_svc_get_media_id_by_path(sqlite3 *handle, const char *path, char *media_uuid, int max_length);
 int _media_svc_update_thumbnail_path(sqlite3 *handle, const char *path, const char *thumb_path);
 
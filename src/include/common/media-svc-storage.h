@@ -0,0 +1,41 @@
+/*
+ * libmedia-service
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Hyunjun Ko <zzoon.ko@samsung.com>, Haejeong Kim <backto.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _MEDIA_SVC_STORAGE_H_
+#define _MEDIA_SVC_STORAGE_H_
+
+#include <sqlite3.h>
+#include "media-svc-types.h"
+
+/**
+ * Storage mount state
+ *
+ * Media and folders of external storage stay in the DB while the storage is unmounted,
+ * and media and folder views show only those of mounted storage.
+ * So unmount is a single row update, and the same volume is shown again right after it is mounted.
+ * When a volume other than the last one is mounted, the items of the last volume are deleted
+ * and their thumbnails are removed through the thumbnail journal.
+ */
+
+int _media_svc_mount_storage(sqlite3 *handle, media_svc_storage_type_e storage_type, const char *volume_id);
+int _media_svc_unmount_storage(sqlite3 *handle, media_svc_storage_type_e storage_type);
+
+#endif /*_MEDIA_SVC_STORAGE_H_*/
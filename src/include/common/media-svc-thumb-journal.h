@@ -0,0 +1,39 @@
+/*
+ * libmedia-service
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Hyunjun Ko <zzoon.ko@samsung.com>, Haejeong Kim <backto.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _MEDIA_SVC_THUMB_JOURNAL_H_
+#define _MEDIA_SVC_THUMB_JOURNAL_H_
+
+#include <sqlite3.h>
+
+/**
+ * Thumbnail journal
+ *
+ * File system work on thumbnails (move or remove) is not done inside DB transactions.
+ * Instead, the job is written to the journal table in the same transaction as the DB change,
+ * and the files are handled later by a background pass which drops each journal row once its job is done.
+ * If the process dies before the pass is finished, the remaining rows are picked up by the next pass.
+ * A row which has NULL dst_path means that the thumbnail file has to be removed.
+ */
+
+int _media_svc_thumb_journal_process(void);
+
+#endif /*_MEDIA_SVC_THUMB_JOURNAL_H_*/
@@ -27,6 +27,8 @@
 #include <string.h>
 #include <stdbool.h>
 #include <sqlite3.h>
+#include <sys/stat.h>
+#include <drm_client.h>
 #include "media-svc-types.h"
 #include "media-svc-env.h"
 
@@ -45,7 +47,28 @@ extern "C" {
 #define STRING_VALID(str)	\
 	((str != NULL && strlen(str) > 0) ? TRUE : FALSE)
 
+#define MEDIA_SVC_FILE_EXT_LEN_MAX				6			/**<  Maximum file ext lenth*/
+
+/**
+ * Probe of a file while it is inserted or refreshed. Each check runs once, and the result is kept for the next caller
+ */
+typedef struct {
+	const char	*path;									/**< Full path of media file */
+	bool		stat_done;								/**< stat is tried */
+	bool		stat_ok;									/**< stat succeeded, st is valid */
+	struct stat	st;										/**< result of stat */
+	bool		ext_done;								/**< extension is parsed */
+	char		ext[MEDIA_SVC_FILE_EXT_LEN_MAX + 1];		/**< file extension, empty if none */
+	bool		drm_done;								/**< DRM is checked */
+	int			is_drm;									/**< is_drm. 0 or 1 */
+	bool		drm_detail_done;						/**< DRM file type, content info and license are read */
+	bool		drm_locked;								/**< DRM file without valid license. Its metadata is not extracted from the file */
+	drm_file_type_e	drm_file_type;					/**< DRM file type, DRM_TYPE_UNDEFINED if DRM info can't be read */
+	drm_content_info_s	drm_content;					/**< DRM header of the file, valid if drm_file_type is defined */
+} media_svc_probe_s;
+
 char *_media_info_generate_uuid(void);
+int _media_svc_generate_uuid(char *uuid, int max_length);
 char *_media_svc_escape_str(char *input, int len);
 void _strncpy_safe(char *x_dst, const char *x_src, int max_len);
 unsigned int _media_svc_get_current_time(void);
@@ -57,10 +80,22 @@ int _media_svc_save_image(void *image, int size, char *image_path);
 bool _media_svc_get_thumbnail_path(media_svc_storage_type_e storage_type, char *thumb_path, const char *pathname, const char *img_format);
 bool _media_svc_get_file_ext(const char *file_path, char *file_ext);
 int _media_svc_get_file_time(const char *full_path);
-int _media_svc_set_media_info(media_svc_content_info_s *content_info, media_svc_storage_type_e storage_type, const char *path, const char *mime_type, media_svc_media_type_e media_type, bool refresh);
+void _media_svc_probe_init(media_svc_probe_s *probe, const char *path);
+const struct stat *_media_svc_probe_stat(media_svc_probe_s *probe);
+const char *_media_svc_probe_ext(media_svc_probe_s *probe);
+int _media_svc_probe_is_drm(media_svc_probe_s *probe);
+bool _media_svc_probe_drm_locked(media_svc_probe_s *probe);
+int _media_svc_get_stream_info(const char *path, int *audio, int *video);
+bool _media_svc_probe_stream_info(media_svc_probe_s *probe, int *audio, int *video);
+int _media_svc_set_media_info(media_svc_content_info_s *content_info, media_svc_probe_s *probe, media_svc_storage_type_e storage_type, const char *path, const char *mime_type, media_svc_media_type_e media_type, bool refresh);
 int _media_svc_extract_image_metadata(media_svc_content_info_s *content_info, media_svc_media_type_e media_type);
-int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s *content_info, media_svc_media_type_e media_type);
+int _media_svc_extract_media_metadata(sqlite3 *handle, media_svc_content_info_s *content_info, media_svc_probe_s *probe, media_svc_media_type_e media_type);
 int __media_svc_malloc_and_strncpy(char **dst, const char *src);
+int _media_svc_set_content_str(media_svc_content_info_s *content_info, char **dst, const char *src);
+void *_media_svc_arena_alloc(media_svc_arena_s *arena, size_t len);
+char *_media_svc_arena_strdup(media_svc_arena_s *arena, const char *src);
+void _media_svc_arena_reset(media_svc_arena_s *arena);
+void _media_svc_arena_destroy(media_svc_arena_s *arena);
 void _media_svc_destroy_content_info(media_svc_content_info_s *content_info);
 int _media_svc_get_store_type_by_path(const char *path, media_svc_storage_type_e *storage_type);
 char *_media_svc_replace_path(char *s, const char *olds, const char *news);
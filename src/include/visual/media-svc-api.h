@@ -41,6 +41,7 @@
 #include <glib.h>
 #include "media-svc-structures.h"
 #include "media-svc-types.h"
+#include "media-svc-env.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -215,6 +216,16 @@ mb_svc_move_items(MediaSvcHandle *mb_svc_handle);
 int
 mb_svc_insert_file_batch(MediaSvcHandle *mb_svc_handle, const char *file_full_path, minfo_file_type content_type);
 
+int
+mb_svc_insert_file_batch_with_meta(MediaSvcHandle *mb_svc_handle, const char *file_full_path, minfo_file_type content_type,
+				mb_svc_image_meta_record_s *image_record, mb_svc_video_meta_record_s *video_record, const char *thumb_path,
+				int modified_date, bool is_drm);
+
+int
+mb_svc_get_meta_by_content_info(const media_svc_content_info_s *content_info,
+				mb_svc_image_meta_record_s *image_record,
+				mb_svc_video_meta_record_s *video_record);
+
 int
 mb_svc_move_file_batch(MediaSvcHandle *mb_svc_handle,
 						const char *old_file_full_path,
@@ -40,6 +40,7 @@
 
 #include "media-svc-structures.h"
 #include "media-svc-types.h"
+#include "media-svc-util.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -63,31 +64,31 @@ _mb_svc_thumb_generate_hash_name(const char *file_full_path, char* thumb_hash_pa
 
 
 /**
- * @fn int mb_svc_image_create_thumb(char *file_fullpath, char* thumb_path_hash, bool force, mb_svc_image_meta_record_s *img_meta_record);
- * @brief  generate thumbnail path for image file
+ * @fn int mb_svc_image_create_thumb(char *file_fullpath, media_svc_probe_s *probe, char* thumb_path_hash, bool force, mb_svc_image_meta_record_s *img_meta_record);
+ * @brief  generate thumbnail path for image file. DRM of the file is taken from probe
 * @return error code.
  */
 
 int 
-mb_svc_image_create_thumb(const char *file_fullpath, char* thumb_path_hash, size_t max_thumb_length, bool force, mb_svc_image_meta_record_s *img_meta_record);
+mb_svc_image_create_thumb(const char *file_fullpath, media_svc_probe_s *probe, char* thumb_path_hash, size_t max_thumb_length, bool force, mb_svc_image_meta_record_s *img_meta_record);
 
 
 /**
- * @fn int mb_svc_image_create_thumb_new(char *file_fullpath, char* thumb_path_hash, mb_svc_image_meta_record_s *img_meta_record);
- * @brief  generate thumbnail path for image file
+ * @fn int mb_svc_image_create_thumb_new(char *file_fullpath, media_svc_probe_s *probe, char* thumb_path_hash, mb_svc_image_meta_record_s *img_meta_record);
+ * @brief  generate thumbnail path for image file. DRM of the file is taken from probe
 * @return error code.
  */
 
 int 
-mb_svc_image_create_thumb_new(const char *file_fullpath, char* thumb_path_hash, size_t max_thumb_length, mb_svc_image_meta_record_s *img_meta_record);
+mb_svc_image_create_thumb_new(const char *file_fullpath, media_svc_probe_s *probe, char* thumb_path_hash, size_t max_thumb_length, mb_svc_image_meta_record_s *img_meta_record);
 
 /**
- * @fn int mb_svc_video_create_thumb(char *file_fullpath, char* thumb_path_hash);
- * @brief  generate thumbnail path for video file
+ * @fn int mb_svc_video_create_thumb(char *file_fullpath, media_svc_probe_s *probe, char* thumb_path_hash);
+ * @brief  generate thumbnail path for video file. DRM of the file is taken from probe
 * @return error code.
 */
 int 
-mb_svc_video_create_thumb(const char *file_fullpath, char* thumb_path_hash, size_t max_thumb_length);
+mb_svc_video_create_thumb(const char *file_fullpath, media_svc_probe_s *probe, char* thumb_path_hash, size_t max_thumb_length);
 
 /**
 * @fn    int  mb_svc_get_video_meta(MediaSvcHandle *mb_svc_handle, char* file_full_path, mb_svc_video_meta_record_s *video_record);
@@ -123,6 +124,21 @@ mb_svc_get_video_meta(MediaSvcHandle *mb_svc_handle, const char* file_full_path,
 int
 mb_svc_get_image_meta(MediaSvcHandle *mb_svc_handle, const char* file_full_path, mb_svc_image_meta_record_s *image_record, bool *thumb_done);
 
+/**
+* @fn    int mb_svc_get_time_val_from_str(const char *buf);
+* This function converts exif style date string, "YYYY:MM:DD HH:MM:SS", to time_t value
+*
+* @return                        This function returns time_t value of the date.
+* @param[in]                    buf           date string
+* @exception                    None.
+* @remark
+*
+*
+*/
+
+int
+mb_svc_get_time_val_from_str(const char *buf);
+
 /**
 * @brief  Delete thumbnail file of original file.
 * @param  file_full_path  original file.
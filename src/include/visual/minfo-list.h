@@ -0,0 +1,114 @@
+/*
+ * libmedia-service
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Hyunjun Ko <zzoon.ko@samsung.com>, Haejeong Kim <backto.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/** 
+ * This file defines arena backed lists of minfo items.
+ *
+ * @file       	minfo-list.h
+ * @version 	1.0
+ * @brief     	This file defines in-house apis for media service.
+ */
+
+ 
+ /**
+  * @addtogroup MINFO_TYPES
+  * @{
+  */
+
+#include "visual-svc-types.h"
+#include "media-svc-types.h"
+#include "media-svc-api.h"
+
+#ifndef _MINFO_LIST_H_
+#define _MINFO_LIST_H_
+
+#define MINFO_TYPE_MLIST		(0x55547)
+#define MINFO_MLIST(obj)		((Mlist*)(obj))
+#define MINFO_MLIST_GET_TYPE(obj)	((obj)->gtype)
+#define IS_MINFO_MLIST(obj)          (MINFO_TYPE_MLIST == MINFO_MLIST_GET_TYPE(MINFO_MLIST(obj)))
+
+/* Items allocated in the arena of a list keep the list in _reserved, and are not freed one by one */
+#define MINFO_OWNED_BY_MLIST(obj)	((obj)->_reserved != NULL)
+
+/**
+* @fn    Mlist* minfo_mlist_new(void);
+* This function creates an empty mlist
+*
+* @return                        This function returns mlist, or NULL if out of memory
+* @exception                    None.
+* @remark                        
+*                                                             
+*                                                          
+*/
+
+Mlist*
+minfo_mlist_new(void);
+
+/**
+* @fn    int minfo_mlist_append_item(MediaSvcHandle *mb_svc_handle, Mlist *list, mb_svc_media_record_s *p_md_record, bool with_meta);
+* This function appends a mitem made from @p p_md_record to mlist
+*
+* @return                        This function returns 0 on success, or negative value with error code.
+* @param[in]                    p_md_record          media record got from iterator
+* @param[in]                    with_meta          also load meta data of the item
+* @exception                    None.
+* @remark                        
+*                                                             
+*                                                          
+*/
+
+int
+minfo_mlist_append_item(MediaSvcHandle *mb_svc_handle, Mlist *list, mb_svc_media_record_s *p_md_record, bool with_meta);
+
+/**
+* @fn    int minfo_mlist_append_cluster(MediaSvcHandle *mb_svc_handle, Mlist *list, mb_svc_folder_record_s *p_fd_record);
+* This function appends a mcluster made from @p p_fd_record to mlist
+*
+* @return                        This function returns 0 on success, or negative value with error code.
+* @param[in]                    p_fd_record          folder record got from iterator
+* @exception                    None.
+* @remark                        
+*                                                             
+*                                                          
+*/
+
+int
+minfo_mlist_append_cluster(MediaSvcHandle *mb_svc_handle, Mlist *list, mb_svc_folder_record_s *p_fd_record);
+
+/**
+* @fn    void minfo_mlist_destroy(Mlist* list);
+* This function destroies mlist with all of its items
+*
+* @param[in]                    list    mlist
+* @exception                    None.
+* @remark                        
+*                                                             
+*                                                          
+*/
+
+void
+minfo_mlist_destroy(Mlist* list);
+
+/**
+* @}
+*/
+
+#endif /*_MINFO_LIST_H_*/
@@ -41,6 +41,7 @@
 	
 #include <glib.h>
 #include "media-svc-types.h"
+#include "media-svc-db-ctx.h"
 	
 #ifdef __cplusplus
 extern "C" {
@@ -91,15 +92,15 @@ extern "C" {
 #define MB_SVC_SELECT_MEDIA_UUID_BY_FOLDER_UUID_AND_DISPLAY_NAME   "SELECT visual_uuid FROM %s WHERE folder_uuid = '%s' AND display_name = '%q';"
 #define MB_SVC_TABLE_SELECT_FOLDER_NAME_BY_UUID  "SELECT folder_name FROM %s WHERE folder_uuid = '%s';"
 //#define MB_SVC_SELECT_ALL_ITEM_COUNT "select count(*) from %s as m INNER JOIN visual_folder AS f ON m.folder_uuid = f.folder_uuid and f.lock_status=0 and m.valid=1 and f.storage_type!=2;"
-#define MB_SVC_SELECT_ALL_ITEM_COUNT "select count(*) from %s as m INNER JOIN visual_folder AS f ON m.folder_uuid = f.folder_uuid and f.lock_status=0 and m.valid=1 and %s %s %s;"
+#define MB_SVC_SELECT_ALL_ITEM_COUNT "select count(*) from %s as m INNER JOIN visual_folder AS f ON m.folder_id = f.folder_id and f.lock_status=0 and m.valid=1 and %s %s %s;"
 #define MB_SVC_TABLE_SELECT_FOLDER_NAME_BY_UUID  "SELECT folder_name FROM %s WHERE folder_uuid = '%s';"
 #define MB_SVC_TABLE_SELECT_FOLDER_ALL_QUERY_STRING  "SELECT folder_uuid, path, folder_name, modified_date, web_account_id, storage_type, sns_type, lock_status, web_album_id FROM %s "
 #define MB_SVC_SELECT_MEDIA_RECORD_BY_FOLDER_ID_AND_DISPLAY_NAME   "SELECT visual_uuid, path, folder_uuid, display_name, content_type, rating, modified_date, thumbnail_path, http_url, size FROM %s WHERE folder_uuid = '%s' AND display_name = '%q';"
 #define MB_SVC_SELECT_ALL_MEDIA  "SELECT m.visual_uuid, m.path, m.folder_uuid, display_name, content_type, rating, m.modified_date, thumbnail_path, http_url, size FROM %s as m INNER JOIN visual_folder AS f ON "
 #define MB_SVC_SELECT_FOLDER_BY_PATH "SELECT folder_uuid, path, folder_name, modified_date, web_account_id, storage_type, sns_type, lock_status, web_album_id FROM %s where valid=1 and path='%q' or path like '%q';"
 #define MB_SVC_SELECT_MEDIA_ID_BY_FOLDER_UUID_AND_DISPLAY_NAME   "SELECT visual_uuid FROM %s WHERE folder_uuid = '%s' AND display_name = '%q';"
-#define MB_SVC_SELECT_INVALID_MEDIA_LIST "SELECT m.visual_uuid, m.path, m.folder_uuid, display_name, content_type, rating, m.modified_date, thumbnail_path, http_url, size FROM visual_media as m INNER JOIN visual_folder AS f ON   f.folder_uuid = m.folder_uuid and m.valid=0 and f.storage_type=%d"
-#define MB_SVC_SELECT_ALL_MEDIA_LIST_BY_STORAGE "SELECT m.visual_uuid, m.path, m.folder_uuid, display_name, content_type, rating, m.modified_date, thumbnail_path, http_url, size FROM visual_media as m INNER JOIN visual_folder AS f ON f.folder_uuid = m.folder_uuid and f.storage_type=%d"
+#define MB_SVC_SELECT_INVALID_MEDIA_LIST "SELECT m.visual_uuid, m.path, m.folder_uuid, display_name, content_type, rating, m.modified_date, thumbnail_path, http_url, size FROM visual_media as m INNER JOIN visual_folder AS f ON f.folder_id = m.folder_id and m.valid=0 and f.storage_type=%d"
+#define MB_SVC_SELECT_ALL_MEDIA_LIST_BY_STORAGE "SELECT m.visual_uuid, m.path, m.folder_uuid, display_name, content_type, rating, m.modified_date, thumbnail_path, http_url, size FROM visual_media as m INNER JOIN visual_folder AS f ON f.folder_id = m.folder_id and f.storage_type=%d"
 
 #define MB_SVC_TABLE_SELECT_GEO_LIST  "SELECT a.visual_uuid, path, a.folder_uuid, display_name, content_type, rating, modified_date, thumbnail_path, http_url, size from ( SELECT m.visual_uuid, path, m.folder_uuid, display_name, content_type, rating, modified_date, thumbnail_path, http_url, size, valid FROM %s AS m INNER JOIN ( SELECT visual_uuid from image_meta where longitude between %f and %f and latitude between %f and %f union select visual_uuid from video_meta where longitude between %f and %f and latitude between %f and %f) AS meta ON meta.visual_uuid = m.visual_uuid ) a, (select folder_uuid, lock_status from visual_folder where valid=1 %s ) b where a.folder_uuid = b.folder_uuid and a.valid=1 "
 
@@ -194,6 +195,12 @@ mb_svc_sql_list_add(GList **list, char **sql);
 void
 mb_svc_sql_list_release(GList **sql_list);
 
+media_svc_batch_s *
+mb_svc_get_batch(MediaSvcHandle *mb_svc_handle, media_svc_query_type_e query_type);
+
+int
+mb_svc_sql_list_query_do(MediaSvcHandle *mb_svc_handle, media_svc_query_type_e query_type);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
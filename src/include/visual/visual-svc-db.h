@@ -607,10 +607,10 @@ mb_svc_update_record_folder_path(MediaSvcHandle *mb_svc_handle, char* old_path,
 int
 mb_svc_update_folder_modified_date(MediaSvcHandle *mb_svc_handle, char* path, int date);
 
-void mb_svc_init_last_updated_folder_uuid();
+void mb_svc_init_last_updated_folder_uuid(MediaSvcHandle *mb_svc_handle);
 
 int
-mb_svc_set_folder_as_valid_sql_add(const char *folder_id, int valid);
+mb_svc_set_folder_as_valid_sql_add(MediaSvcHandle *mb_svc_handle, const char *folder_id, int valid);
 
 int
 mb_svc_set_item_as_valid_sql_add(MediaSvcHandle *mb_svc_handle, const char *full_path, int valid);
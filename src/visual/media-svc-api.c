@@ -34,6 +34,7 @@
 #include "visual-svc-db.h"
 #include "media-svc-util.h"
 #include "media-svc-types.h"
+#include "media-svc-db-ctx.h"
 #include "visual-svc-error.h"
 
 #ifdef _PERFORMANCE_CHECK_
@@ -43,9 +44,6 @@ double g_meta = 0;
 long start = 0L, end = 0L;
 #endif
 
-static __thread GList *g_insert_sql_list = NULL;
-static __thread GList *g_move_sql_list = NULL;
-
 const char *mb_svc_media_order[5] = {
 	"visual_uuid ASC",
 	"display_name COLLATE NOCASE DESC",
@@ -86,59 +84,45 @@ static int __mb_svc_get_media_cnt_by_tagid(MediaSvcHandle *mb_svc_handle, int ta
 int mb_svc_insert_items(MediaSvcHandle *mb_svc_handle)
 {
 	mb_svc_debug("");
-	int i = 0;
-	int length = g_list_length(g_insert_sql_list);
-
-	for (i = 0; i < length; i++) {
-		char *sql = (char*)g_list_nth_data(g_insert_sql_list, i);
-		mb_svc_query_sql(mb_svc_handle, sql);
-	}
 
-	mb_svc_sql_list_release(&g_insert_sql_list);
-
-	return 0;
+	return mb_svc_sql_list_query_do(mb_svc_handle, MEDIA_SVC_QUERY_INSERT_ITEM);
 }
 
 int mb_svc_move_items(MediaSvcHandle *mb_svc_handle)
 {
 	mb_svc_debug("");
-	int i = 0;
-	int length = g_list_length(g_move_sql_list);
 
-	for (i = 0; i < length; i++) {
-		char *sql = (char*)g_list_nth_data(g_move_sql_list, i);
-		mb_svc_query_sql(mb_svc_handle, sql);
-	}
-
-	mb_svc_sql_list_release(&g_move_sql_list);
-
-	return 0;
+	return mb_svc_sql_list_query_do(mb_svc_handle, MEDIA_SVC_QUERY_MOVE_ITEM);
 }
 
 int
-mb_svc_insert_file_batch(MediaSvcHandle *mb_svc_handle, const char *file_full_path, minfo_file_type content_type)
+mb_svc_insert_file_batch_with_meta(MediaSvcHandle *mb_svc_handle, const char *file_full_path, minfo_file_type content_type,
+				mb_svc_image_meta_record_s *image_record, mb_svc_video_meta_record_s *video_record, const char *thumb_path,
+				int modified_date, bool is_drm)
 {
 	char dir_path[MB_SVC_DIR_PATH_LEN_MAX + 1] = { 0 };
 	char dir_display_name[MB_SVC_FILE_NAME_LEN_MAX + 1] = { 0 };
 	char file_display_name[MB_SVC_FILE_NAME_LEN_MAX + 1] = { 0 };
 	mb_svc_folder_record_s folder_record = {"",};
 	mb_svc_media_record_s media_record = {"",};
-	mb_svc_image_meta_record_s image_record = {0,};
-	mb_svc_video_meta_record_s video_record = {0,};
 	int folder_modified_date = 0;
 	int ret = 0;
 	int store_type = 0;
-	bool is_drm = false;
-	
+
 	char *folder_sql = NULL;
 	char *insert_sql = NULL;
 	char *meta_sql = NULL;
+	media_svc_batch_s *batch = NULL;
 
-	if (file_full_path == NULL ) {
-		mb_svc_debug("file_full_path == NULL || thumb_path == NULL\n");
+	if (file_full_path == NULL || image_record == NULL || video_record == NULL) {
+		mb_svc_debug("file_full_path == NULL || image_record == NULL || video_record == NULL\n");
 		return MB_SVC_ERROR_INVALID_PARAMETER;
 	}
 
+	batch = mb_svc_get_batch(mb_svc_handle, MEDIA_SVC_QUERY_INSERT_ITEM);
+	if (batch == NULL)
+		return MB_SVC_ERROR_INVALID_PARAMETER;
+
 	mb_svc_debug("file_full_path is %s\n", file_full_path);
 	/* 1. get file detail */
 	_mb_svc_get_file_parent_path(file_full_path, dir_path);
@@ -204,7 +188,7 @@ mb_svc_insert_file_batch(MediaSvcHandle *mb_svc_handle, const char *file_full_pa
 				     ret);
 			}
 
-			mb_svc_sql_list_add(&g_insert_sql_list, &folder_sql);
+			mb_svc_sql_list_add(&batch->query_list, &folder_sql);
 		}
 	}
 
@@ -220,27 +204,20 @@ mb_svc_insert_file_batch(MediaSvcHandle *mb_svc_handle, const char *file_full_pa
 
 	media_record.content_type = content_type;
 	media_record.rate = 0;
-	mb_svc_debug
-	    ("ready get file date for insert file info into media table\n");
-	media_record.modified_date =
-	    _mb_svc_get_file_dir_modified_date(file_full_path);
+	media_record.modified_date = modified_date;
+	mb_svc_debug("file date is %d, drm is %d\n", modified_date, is_drm);
 
-	drm_bool_type_e drm_type;
-	ret = drm_is_drm_file(file_full_path, &drm_type);
-	if (ret < 0) {
-		mb_svc_debug("drm_is_drm_file falied : %d", ret);
-		drm_type = DRM_FALSE;
-	}
-
-	is_drm = (drm_type == DRM_TRUE);
+	if (thumb_path != NULL && strlen(thumb_path) > 0) {
+		strncpy(media_record.thumbnail_path, thumb_path, MB_SVC_FILE_PATH_LEN_MAX + 1);
+	} else {
+		ret = _mb_svc_thumb_generate_hash_name(file_full_path,
+											media_record.thumbnail_path,
+											MB_SVC_FILE_PATH_LEN_MAX + 1);
 
-	ret = _mb_svc_thumb_generate_hash_name(file_full_path,
-										media_record.thumbnail_path,
-										MB_SVC_FILE_PATH_LEN_MAX + 1);
-       
-	if (ret < 0) {
-		mb_svc_debug("_mb_svc_thumb_generate_hash_name failed : %d", ret);
-		return ret;
+		if (ret < 0) {
+			mb_svc_debug("_mb_svc_thumb_generate_hash_name failed : %d", ret);
+			return ret;
+		}
 	}
 
 	/* 4. if it's image file, insert into image_meta table */
@@ -248,14 +225,7 @@ mb_svc_insert_file_batch(MediaSvcHandle *mb_svc_handle, const char *file_full_pa
 		mb_svc_debug
 		    ("ready insert file info into media table,file date is %d\n",
 		     media_record.modified_date);
-		
-		bool thumb_done = FALSE;
-		ret = mb_svc_get_image_meta(mb_svc_handle, file_full_path, &image_record, &thumb_done);
 
-		if (ret < 0) {
-			mb_svc_debug("mb_svc_get_image_meta failed\n");
-			return ret;
-		}
 
 		strncpy(media_record.folder_uuid, folder_record.uuid, MB_SVC_UUID_LEN_MAX + 1);
 
@@ -267,19 +237,19 @@ mb_svc_insert_file_batch(MediaSvcHandle *mb_svc_handle, const char *file_full_pa
 			return ret;
 		}
 		
-		mb_svc_sql_list_add(&g_insert_sql_list, &insert_sql);
+		mb_svc_sql_list_add(&batch->query_list, &insert_sql);
 
-		strncpy(image_record.media_uuid, media_record.media_uuid, MB_SVC_UUID_LEN_MAX + 1);
+		strncpy(image_record->media_uuid, media_record.media_uuid, MB_SVC_UUID_LEN_MAX + 1);
 
 		ret =
-		    mb_svc_insert_record_image_meta_sql(&image_record, store_type, &meta_sql);
+		    mb_svc_insert_record_image_meta_sql(image_record, store_type, &meta_sql);
 
 		if (ret < 0) {
 			mb_svc_debug("mb_svc_insert_record_image_meta_sql failed(%d)\n", ret);
 			return ret;
 		}
 
-		mb_svc_sql_list_add(&g_insert_sql_list, &meta_sql);
+		mb_svc_sql_list_add(&batch->query_list, &meta_sql);
 	}
 	/* 5       if video, insert video_meta and bookmark table */
 	else if (media_record.content_type == MINFO_ITEM_VIDEO) {	/* it's video file, insert into vidoe table */
@@ -287,16 +257,6 @@ mb_svc_insert_file_batch(MediaSvcHandle *mb_svc_handle, const char *file_full_pa
 		    ("ready insert file info into media table,file date is %d\n",
 		     media_record.modified_date);
 
-		video_record.last_played_time = 0;
-		video_record.latitude = 0.0;
-		video_record.longitude = 0.0;
-
-		ret = mb_svc_get_video_meta(mb_svc_handle, file_full_path, &video_record);
-		if (ret < 0) {
-			mb_svc_debug("mb_svc_get_video_meta failed\n");
-			return ret;
-		}
-
 		strncpy(media_record.folder_uuid, folder_record.uuid, MB_SVC_UUID_LEN_MAX + 1);
 
 		ret = mb_svc_insert_record_media_sql(&media_record, store_type, &insert_sql);
@@ -305,31 +265,122 @@ mb_svc_insert_file_batch(MediaSvcHandle *mb_svc_handle, const char *file_full_pa
 				     ret);
 			return ret;
 		}
-		mb_svc_sql_list_add(&g_insert_sql_list, &insert_sql);
+		mb_svc_sql_list_add(&batch->query_list, &insert_sql);
 
-		strncpy(video_record.media_uuid, media_record.media_uuid, MB_SVC_UUID_LEN_MAX + 1);
+		strncpy(video_record->media_uuid, media_record.media_uuid, MB_SVC_UUID_LEN_MAX + 1);
 
 		ret =
-		    mb_svc_insert_record_video_meta_sql(&video_record, store_type, &meta_sql);
+		    mb_svc_insert_record_video_meta_sql(video_record, store_type, &meta_sql);
 		if (ret < 0) {
 			mb_svc_debug
 			    ("mb_svc_insert_record_video_meta_sql failed(%d)\n", ret);
 			return ret;
 		}
-		mb_svc_sql_list_add(&g_insert_sql_list, &meta_sql);
+		mb_svc_sql_list_add(&batch->query_list, &meta_sql);
 	}
 
-	/* Extracting thumbnail */
-	ret = thumbnail_request_from_db(file_full_path, media_record.thumbnail_path, sizeof(media_record.thumbnail_path));
-	if (ret < 0) {
-		mb_svc_debug("thumbnail_request_from_db failed: %d", ret);
-	} else {
-		mb_svc_debug("thumbnail_request_from_db success: %s", media_record.thumbnail_path);
+	/* Extracting thumbnail. Skip it when the caller already has one */
+	if (thumb_path == NULL || strlen(thumb_path) == 0) {
+		ret = thumbnail_request_from_db(file_full_path, media_record.thumbnail_path, sizeof(media_record.thumbnail_path));
+		if (ret < 0) {
+			mb_svc_debug("thumbnail_request_from_db failed: %d", ret);
+		} else {
+			mb_svc_debug("thumbnail_request_from_db success: %s", media_record.thumbnail_path);
+		}
 	}
 
 	return 0;
 }
 
+int
+mb_svc_insert_file_batch(MediaSvcHandle *mb_svc_handle, const char *file_full_path, minfo_file_type content_type)
+{
+	mb_svc_image_meta_record_s image_record = {0,};
+	mb_svc_video_meta_record_s video_record = {0,};
+	media_svc_probe_s probe;
+	const struct stat *st = NULL;
+	bool thumb_done = FALSE;
+	int ret = 0;
+
+	if (file_full_path == NULL) {
+		mb_svc_debug("file_full_path == NULL\n");
+		return MB_SVC_ERROR_INVALID_PARAMETER;
+	}
+
+	_media_svc_probe_init(&probe, file_full_path);
+
+	if (content_type == MINFO_ITEM_IMAGE) {
+		ret = mb_svc_get_image_meta(mb_svc_handle, file_full_path, &image_record, &thumb_done);
+		if (ret < 0) {
+			mb_svc_debug("mb_svc_get_image_meta failed\n");
+			return ret;
+		}
+	} else if (content_type == MINFO_ITEM_VIDEO) {
+		video_record.last_played_time = 0;
+		video_record.latitude = 0.0;
+		video_record.longitude = 0.0;
+
+		ret = mb_svc_get_video_meta(mb_svc_handle, file_full_path, &video_record);
+		if (ret < 0) {
+			mb_svc_debug("mb_svc_get_video_meta failed\n");
+			return ret;
+		}
+	}
+
+	st = _media_svc_probe_stat(&probe);
+
+	return mb_svc_insert_file_batch_with_meta(mb_svc_handle, file_full_path, content_type, &image_record, &video_record, NULL,
+						(st != NULL) ? st->st_mtime : MB_SVC_ERROR_INTERNAL, (_media_svc_probe_is_drm(&probe) == DRM_TRUE));
+}
+
+int
+mb_svc_get_meta_by_content_info(const media_svc_content_info_s *content_info,
+				mb_svc_image_meta_record_s *image_record,
+				mb_svc_video_meta_record_s *video_record)
+{
+	const media_svc_content_meta_s *meta = NULL;
+
+	if (content_info == NULL || image_record == NULL || video_record == NULL) {
+		mb_svc_debug("content_info == NULL || image_record == NULL || video_record == NULL");
+		return MB_SVC_ERROR_INVALID_PARAMETER;
+	}
+
+	meta = &content_info->media_meta;
+
+	if (content_info->media_type == MEDIA_SVC_MEDIA_TYPE_IMAGE) {
+		image_record->latitude = (meta->latitude == MEDIA_SVC_DEFAULT_GPS_VALUE) ? MINFO_DEFAULT_GPS : meta->latitude;
+		image_record->longitude = (meta->longitude == MEDIA_SVC_DEFAULT_GPS_VALUE) ? MINFO_DEFAULT_GPS : meta->longitude;
+		image_record->width = meta->width;
+		image_record->height = meta->height;
+		image_record->orientation = meta->orientation;
+		strncpy(image_record->description, meta->description ? meta->description : "No description",
+			sizeof(image_record->description) - 1);
+		if (meta->datetaken != NULL && strlen(meta->datetaken) > 0)
+			image_record->datetaken = mb_svc_get_time_val_from_str(meta->datetaken);
+	} else if (content_info->media_type == MEDIA_SVC_MEDIA_TYPE_VIDEO) {
+		video_record->last_played_time = 0;
+		video_record->duration = meta->duration;
+		video_record->width = meta->width;
+		video_record->height = meta->height;
+		video_record->latitude = (meta->latitude == MEDIA_SVC_DEFAULT_GPS_VALUE) ? MINFO_DEFAULT_GPS : meta->latitude;
+		video_record->longitude = (meta->longitude == MEDIA_SVC_DEFAULT_GPS_VALUE) ? MINFO_DEFAULT_GPS : meta->longitude;
+		strncpy(video_record->title, meta->title ? meta->title : MEDIA_SVC_TAG_UNKNOWN, sizeof(video_record->title) - 1);
+		strncpy(video_record->artist, meta->artist ? meta->artist : MEDIA_SVC_TAG_UNKNOWN, sizeof(video_record->artist) - 1);
+		strncpy(video_record->album, meta->album ? meta->album : MEDIA_SVC_TAG_UNKNOWN, sizeof(video_record->album) - 1);
+		strncpy(video_record->description, meta->description ? meta->description : MEDIA_SVC_TAG_UNKNOWN, sizeof(video_record->description) - 1);
+		/* recorded date if the container has it, otherwise MM_FILE_TAG_DATE kept in year */
+		if (meta->recorded_date != NULL && strcmp(meta->recorded_date, MEDIA_SVC_TAG_UNKNOWN))
+			video_record->datetaken = mb_svc_get_time_val_from_str(meta->recorded_date);
+		else if (meta->year != NULL && strcmp(meta->year, MEDIA_SVC_TAG_UNKNOWN))
+			video_record->datetaken = mb_svc_get_time_val_from_str(meta->year);
+	} else {
+		mb_svc_debug("not visual content : %d", content_info->media_type);
+		return MB_SVC_ERROR_INVALID_PARAMETER;
+	}
+
+	return MB_SVC_ERROR_NONE;
+}
+
 int
 mb_svc_insert_file(MediaSvcHandle *mb_svc_handle, const char *file_full_path, minfo_file_type content_type)
 {
@@ -344,7 +395,8 @@ mb_svc_insert_file(MediaSvcHandle *mb_svc_handle, const char *file_full_path, mi
 	int folder_modified_date = 0;
 	int ret = 0;
 	int store_type = 0;
-	bool is_drm = false;
+	media_svc_probe_s probe;
+	const struct stat *st = NULL;
 	GList *insert_sql_list = NULL;
 	char *folder_sql = NULL;
 	char *insert_sql = NULL;
@@ -434,17 +486,11 @@ mb_svc_insert_file(MediaSvcHandle *mb_svc_handle, const char *file_full_path, mi
 	media_record.rate = 0;
 	mb_svc_debug
 	    ("ready get file date for insert file info into media table\n");
-	media_record.modified_date =
-	    _mb_svc_get_file_dir_modified_date(file_full_path);
-
-	drm_bool_type_e drm_type;
-	ret = drm_is_drm_file(file_full_path, &drm_type);
-	if (ret < 0) {
-		mb_svc_debug("drm_is_drm_file falied : %d", ret);
-		drm_type = DRM_FALSE;
-	}
 
-	is_drm = (drm_type == DRM_TRUE);
+	/* the file is stat-ed once through the probe. Its DRM is not stored in the visual tables, so DRM client is not asked */
+	_media_svc_probe_init(&probe, file_full_path);
+	st = _media_svc_probe_stat(&probe);
+	media_record.modified_date = (st != NULL) ? st->st_mtime : MB_SVC_ERROR_INTERNAL;
 
 	/* 4. if it's image file, insert into image_meta table */
 	if (media_record.content_type == MINFO_ITEM_IMAGE)	{ /* it's image file, insert into image_meta table */
@@ -810,6 +856,7 @@ mb_svc_move_file(MediaSvcHandle *mb_svc_handle,
 	mb_svc_debug("");
 
 	int ret = 0;
+	media_svc_batch_s *batch = NULL;
 
 	if (old_file_full_path == NULL || new_file_full_path == NULL
 	    || thumb_path == NULL) {
@@ -817,6 +864,10 @@ mb_svc_move_file(MediaSvcHandle *mb_svc_handle,
 		    ("old_file_full_path==NULL || new_file_full_path==NULL || thumb_path == NULL\n");
 		return MB_SVC_ERROR_INVALID_PARAMETER;
 	}
+
+	batch = mb_svc_get_batch(mb_svc_handle, MEDIA_SVC_QUERY_MOVE_ITEM);
+	if (batch == NULL)
+		return MB_SVC_ERROR_INVALID_PARAMETER;
 	mb_svc_debug("old file_full_path is %s, new file full path is %s\n",
 		     old_file_full_path, new_file_full_path);
 	
@@ -1014,6 +1065,7 @@ mb_svc_move_file_batch(MediaSvcHandle *mb_svc_handle,
 	mb_svc_debug("");
 
 	int ret = 0;
+	media_svc_batch_s *batch = NULL;
 
 	if (old_file_full_path == NULL || new_file_full_path == NULL
 	    || thumb_path == NULL) {
@@ -1021,6 +1073,10 @@ mb_svc_move_file_batch(MediaSvcHandle *mb_svc_handle,
 		    ("old_file_full_path==NULL || new_file_full_path==NULL || thumb_path == NULL\n");
 		return MB_SVC_ERROR_INVALID_PARAMETER;
 	}
+
+	batch = mb_svc_get_batch(mb_svc_handle, MEDIA_SVC_QUERY_MOVE_ITEM);
+	if (batch == NULL)
+		return MB_SVC_ERROR_INVALID_PARAMETER;
 	mb_svc_debug("old file_full_path is %s, new file full path is %s\n",
 		     old_file_full_path, new_file_full_path);
 
@@ -1114,7 +1170,7 @@ mb_svc_move_file_batch(MediaSvcHandle *mb_svc_handle,
 				     ret);
 			return ret;
 		}
-		mb_svc_sql_list_add(&g_move_sql_list, &delete_folder_sql);
+		mb_svc_sql_list_add(&batch->query_list, &delete_folder_sql);
 	} else	{	/* update  modified date */
 		src_clus_modified_date =
 		    _mb_svc_get_file_dir_modified_date(old_dir_path);
@@ -1131,7 +1187,7 @@ mb_svc_move_file_batch(MediaSvcHandle *mb_svc_handle,
 				return ret;
 			}
 
-			mb_svc_sql_list_add(&g_move_sql_list, &update_old_folder_sql);
+			mb_svc_sql_list_add(&batch->query_list, &update_old_folder_sql);
 		}
 	}
 
@@ -1160,7 +1216,7 @@ mb_svc_move_file_batch(MediaSvcHandle *mb_svc_handle,
 				return ret;
 			}
 
-			mb_svc_sql_list_add(&g_move_sql_list, &update_new_folder_sql);
+			mb_svc_sql_list_add(&batch->query_list, &update_new_folder_sql);
 		}
 	}
 
@@ -1170,7 +1226,7 @@ mb_svc_move_file_batch(MediaSvcHandle *mb_svc_handle,
 		return ret;
 	}
 
-	mb_svc_sql_list_add(&g_move_sql_list, &media_sql);
+	mb_svc_sql_list_add(&batch->query_list, &media_sql);
 
 	return ret;
 }
@@ -2067,6 +2123,8 @@ mb_svc_media_iter_start_new(MediaSvcHandle *mb_svc_handle,
 	char query_where[MB_SVC_DEFAULT_QUERY_SIZE + 1] = { 0 };
 	char condition_str[MB_SVC_DEFAULT_QUERY_SIZE + 1] = { 0 };
 	int len = 0;
+	int limit_cnt = 0;
+	int bind_idx = 0;
 
 	char table_name[MB_SVC_TABLE_NAME_MAX_LEN] = { 0, };
 	memset(table_name, 0x00, MB_SVC_TABLE_NAME_MAX_LEN);
@@ -2094,11 +2152,11 @@ mb_svc_media_iter_start_new(MediaSvcHandle *mb_svc_handle,
 
 	if (valid) {
 		strncpy(query_where,
-			" f.folder_uuid = m.folder_uuid and m.valid=1 and f.valid=1 ",
+			" f.folder_id = m.folder_id and m.valid=1 and f.valid=1 ",
 			sizeof(query_where));
 	} else {
 		strncpy(query_where,
-			" f.folder_uuid = m.folder_uuid and m.valid=0 and f.valid=0 ",
+			" f.folder_id = m.folder_id and m.valid=0 and f.valid=0 ",
 			sizeof(query_where));
 	}
 
@@ -2125,7 +2183,7 @@ mb_svc_media_iter_start_new(MediaSvcHandle *mb_svc_handle,
 	if (folder_id != NULL) {
 		int len =
 		    snprintf(condition_str, sizeof(condition_str),
-			     " and m.folder_uuid = '%s' ", folder_id);
+			     " and m.folder_uuid = ? ");
 		if (len < 0) {
 			mb_svc_debug("snprintf returns failure ( %d )", len);
 			condition_str[0] = '\0';
@@ -2275,8 +2333,8 @@ mb_svc_media_iter_start_new(MediaSvcHandle *mb_svc_handle,
 	memset(condition_str, 0x00, sizeof(condition_str));
 
 	if (filter->start_pos != MB_SVC_DB_DEFAULT_GET_ALL_RECORDS)	{/* -1 get all record */
-		int length = filter->end_pos - filter->start_pos + 1;
-		if (length <= 0) {
+		limit_cnt = filter->end_pos - filter->start_pos + 1;
+		if (limit_cnt <= 0) {
 			mb_svc_debug
 			    ("start position and end position is invalid ( start:%d, end:%d )",
 			     filter->start_pos, filter->end_pos);
@@ -2285,7 +2343,7 @@ mb_svc_media_iter_start_new(MediaSvcHandle *mb_svc_handle,
 
 		len =
 		    snprintf(condition_str, sizeof(condition_str),
-			     " LIMIT %d,%d", filter->start_pos, length);
+			     " LIMIT ?,?");
 		if (len < 0) {
 			mb_svc_debug("snprintf returns failure ( %d )", len);
 			condition_str[0] = '\0';
@@ -2305,16 +2363,32 @@ mb_svc_media_iter_start_new(MediaSvcHandle *mb_svc_handle,
 
 	mb_svc_iterator->current_position = 0;
 
+	/* folder id and range are bound, so one statement of a filter shape is reused by the handle */
 	err =
-	    sqlite3_prepare_v2(handle, query_complete_string,
-			       strlen(query_complete_string),
-			       &mb_svc_iterator->stmt, NULL);
+	    _media_svc_db_ctx_prepare_stmt(handle, query_complete_string,
+			       &mb_svc_iterator->stmt);
 	if (SQLITE_OK != err) {
 		mb_svc_debug("prepare error [%s]", sqlite3_errmsg(handle));
 		mb_svc_debug("query string is %s\n", query_complete_string);
 		return MB_SVC_ERROR_DB_INTERNAL;
 	}
 
+	if (folder_id != NULL)
+		err = sqlite3_bind_text(mb_svc_iterator->stmt, ++bind_idx, folder_id, -1, SQLITE_TRANSIENT);
+
+	if (err == SQLITE_OK && limit_cnt > 0) {
+		err = sqlite3_bind_int(mb_svc_iterator->stmt, ++bind_idx, filter->start_pos);
+		if (err == SQLITE_OK)
+			err = sqlite3_bind_int(mb_svc_iterator->stmt, ++bind_idx, limit_cnt);
+	}
+
+	if (SQLITE_OK != err) {
+		mb_svc_debug("bind error [%s]", sqlite3_errmsg(handle));
+		_media_svc_db_ctx_release_stmt(mb_svc_iterator->stmt);
+		mb_svc_iterator->stmt = NULL;
+		return MB_SVC_ERROR_DB_INTERNAL;
+	}
+
 	return err;
 }
 
@@ -2360,7 +2434,7 @@ mb_svc_media_search_iter_start(MediaSvcHandle *mb_svc_handle,
 		 table_name);
 
 	strncpy(query_where,
-		" f.folder_uuid = m.folder_uuid and m.valid=1 and f.valid=1 ",
+		" f.folder_id = m.folder_id and m.valid=1 and f.valid=1 ",
 		sizeof(query_where));
 
 	if (filter.favorite == MINFO_MEDIA_FAV_ONLY) {
@@ -2683,7 +2757,8 @@ mb_svc_media_iter_next(mb_svc_iterator_s *mb_svc_iterator,
 		err = mb_svc_load_record_media(mb_svc_iterator->stmt, record);
 		if (err < 0) {
 			mb_svc_debug("failed to load item\n");
-			sqlite3_finalize(mb_svc_iterator->stmt);
+			_media_svc_db_ctx_release_stmt(mb_svc_iterator->stmt);
+			mb_svc_iterator->stmt = NULL;
 			mb_svc_iterator->current_position = -1;
 			return MB_SVC_ERROR_DB_INTERNAL;
 		}
@@ -2704,7 +2779,7 @@ int mb_svc_iter_finish(mb_svc_iterator_s *mb_svc_iterator)
 		return MB_SVC_ERROR_INVALID_PARAMETER;
 	}
 
-	err = sqlite3_finalize(mb_svc_iterator->stmt);
+	err = _media_svc_db_ctx_release_stmt(mb_svc_iterator->stmt);
 	if (SQLITE_OK != err) {
 		mb_svc_debug("failed to clear row\n");
 		return MB_SVC_ERROR_DB_INTERNAL;
@@ -2929,6 +3004,7 @@ mb_svc_folder_iter_start(MediaSvcHandle *mb_svc_handle, minfo_cluster_filter *cl
 	char query_string[MB_SVC_DEFAULT_QUERY_SIZE + 1] = { 0 };
 	char query_where[MB_SVC_DEFAULT_QUERY_SIZE + 1] = { 0 };
 	char tmp_str[MB_SVC_DEFAULT_QUERY_SIZE + 1] = { 0 };
+	int limit_cnt = 0;
 
 	mb_svc_debug("mb_svc_folder_iter_start--enter\n");
 
@@ -2993,9 +3069,9 @@ mb_svc_folder_iter_start(MediaSvcHandle *mb_svc_handle, minfo_cluster_filter *cl
 		MB_SVC_DEFAULT_QUERY_SIZE - strlen(query_string));
 
 	if (cluster_filter->start_pos != MB_SVC_DB_DEFAULT_GET_ALL_RECORDS)	{/* -1 get all record */
-		int length =
+		limit_cnt =
 		    cluster_filter->end_pos - cluster_filter->start_pos + 1;
-		if (length <= 0) {
+		if (limit_cnt <= 0) {
 			mb_svc_debug
 			    ("start position and end position is invalid ( start:%d, end:%d )",
 			     cluster_filter->start_pos,
@@ -3003,9 +3079,8 @@ mb_svc_folder_iter_start(MediaSvcHandle *mb_svc_handle, minfo_cluster_filter *cl
 			return MB_SVC_ERROR_INVALID_PARAMETER;
 		}
 
-		snprintf(tmp_str, sizeof(tmp_str), " LIMIT %d,%d",
-			 cluster_filter->start_pos, length);
-		strcat(query_string, tmp_str);
+		strncat(query_string, " LIMIT ?,?",
+			MB_SVC_DEFAULT_QUERY_SIZE - strlen(query_string));
 	}
 
 	mb_svc_debug("############### SQL: %s\n", query_string);
@@ -3013,14 +3088,27 @@ mb_svc_folder_iter_start(MediaSvcHandle *mb_svc_handle, minfo_cluster_filter *cl
 	mb_svc_iterator->current_position = 0;
 
 	err =
-	    sqlite3_prepare_v2(handle, query_string, strlen(query_string),
-			       &mb_svc_iterator->stmt, NULL);
+	    _media_svc_db_ctx_prepare_stmt(handle, query_string,
+			       &mb_svc_iterator->stmt);
 	if (SQLITE_OK != err) {
 		mb_svc_debug("prepare error [%s]", sqlite3_errmsg(handle));
 		mb_svc_debug("query string is %s\n", query_string);
 		return MB_SVC_ERROR_DB_INTERNAL;
 	}
 
+	if (limit_cnt > 0) {
+		err = sqlite3_bind_int(mb_svc_iterator->stmt, 1, cluster_filter->start_pos);
+		if (err == SQLITE_OK)
+			err = sqlite3_bind_int(mb_svc_iterator->stmt, 2, limit_cnt);
+
+		if (SQLITE_OK != err) {
+			mb_svc_debug("bind error [%s]", sqlite3_errmsg(handle));
+			_media_svc_db_ctx_release_stmt(mb_svc_iterator->stmt);
+			mb_svc_iterator->stmt = NULL;
+			return MB_SVC_ERROR_DB_INTERNAL;
+		}
+	}
+
 	return err;
 }
 
@@ -3090,7 +3178,8 @@ mb_svc_folder_iter_next(mb_svc_iterator_s *mb_svc_iterator,
 		err = mb_svc_load_record_folder(mb_svc_iterator->stmt, record);
 		if (err < 0) {
 			mb_svc_debug("failed to load item\n");
-			sqlite3_finalize(mb_svc_iterator->stmt);
+			_media_svc_db_ctx_release_stmt(mb_svc_iterator->stmt);
+			mb_svc_iterator->stmt = NULL;
 			mb_svc_iterator->current_position = -1;
 			return MB_SVC_ERROR_DB_INTERNAL;
 		}
@@ -89,23 +89,10 @@ typedef struct{
 	char* thumb_hash_path;
 }mb_svc_thumb_info_s;
 
-enum Exif_Orientation {
-    NOT_AVAILABLE=0,
-    NORMAL  =1,
-    HFLIP   =2,
-    ROT_180 =3,
-    VFLIP   =4,
-    TRANSPOSE   =5,
-    ROT_90  =6,
-    TRANSVERSE  =7,
-    ROT_270 =8
-};
-
 static int __mb_svc_thumb_cp(char *src_file_full_path, char *dest_file_full_path);
 static int __mb_svc_thumb_save(const void *image, mb_svc_thumb_info_s thumb_info, size_t max_thumb_length, mb_svc_image_meta_record_s *img_meta_record);
 static int __get_thumbfile_size(char *filepath);
 static int __mb_svc_get_exif_info(ExifData *ed, char *buf, int *value, int ifdtype, long tagtype);
-static int __mb_svc_get_time_val_from_str(char *buf);
 static void __mb_svc_split_to_double(char *input, double *arr, int *num);
 
 static void __mb_svc_split_to_double(char *input, double *arr, int *num)
@@ -192,7 +179,8 @@ int _mb_svc_get_size_using_evas(const char *file_path, int *width, int *height)
 	return 0;
 }
 
-static int __mb_svc_get_time_val_from_str(char *buf)
+int
+mb_svc_get_time_val_from_str(const char *buf)
 {
 	int year, month, day, hour, min, sec;
 	struct tm val;
@@ -2380,7 +2368,7 @@ __mb_svc_thumb_save_new(const void *image, mb_svc_thumb_info_s thumb_info,
 }
 
 int
-mb_svc_image_create_thumb(const char *file_full_path, char *thumb_hash_path,
+mb_svc_image_create_thumb(const char *file_full_path, media_svc_probe_s *probe, char *thumb_hash_path,
 			  size_t max_thumb_length, bool force,
 			  mb_svc_image_meta_record_s *img_meta_record)
 {
@@ -2392,8 +2380,8 @@ mb_svc_image_create_thumb(const char *file_full_path, char *thumb_hash_path,
 
 	mb_svc_debug("_mb_svc_image_create_thumb------------start\n");
 
-	if (file_full_path == NULL || thumb_hash_path == NULL) {
-		mb_svc_debug("file_full_path==NULL || thumb_hash_path==NULL");
+	if (file_full_path == NULL || probe == NULL || thumb_hash_path == NULL) {
+		mb_svc_debug("file_full_path==NULL || probe==NULL || thumb_hash_path==NULL");
 		return MB_SVC_ERROR_INVALID_PARAMETER;
 	}
 
@@ -2459,14 +2447,7 @@ mb_svc_image_create_thumb(const char *file_full_path, char *thumb_hash_path,
 	thumb_info.thumb_hash_path = thumb_hash_path;
 	thumb_info.content_type = MINFO_ITEM_IMAGE;
 
-	drm_bool_type_e drm_type;
-	err = drm_is_drm_file(file_full_path, &drm_type);
-	if (err < 0) {
-		mb_svc_debug("drm_is_drm_file falied : %d", err);
-		drm_type = DRM_FALSE;
-	}
-
-	thumb_info.is_drm = (drm_type == DRM_TRUE);
+	thumb_info.is_drm = (_media_svc_probe_is_drm(probe) == DRM_TRUE);
 
 	err =
 	    __mb_svc_thumb_save(thumb, thumb_info, max_thumb_length,
@@ -2490,7 +2471,7 @@ mb_svc_image_create_thumb(const char *file_full_path, char *thumb_hash_path,
 }
 
 int
-mb_svc_image_create_thumb_new(const char *file_full_path, char *thumb_hash_path,
+mb_svc_image_create_thumb_new(const char *file_full_path, media_svc_probe_s *probe, char *thumb_hash_path,
 			      size_t max_thumb_length,
 			      mb_svc_image_meta_record_s *img_meta_record)
 {
@@ -2502,10 +2483,10 @@ mb_svc_image_create_thumb_new(const char *file_full_path, char *thumb_hash_path,
 
 	mb_svc_debug("_mb_svc_image_create_thumb------------start\n");
 
-	if (file_full_path == NULL || thumb_hash_path == NULL
+	if (file_full_path == NULL || probe == NULL || thumb_hash_path == NULL
 	    || img_meta_record == NULL) {
 		mb_svc_debug
-		    ("file_full_path==NULL || thumb_hash_path==NULL || img_meta_record == NULL");
+		    ("file_full_path==NULL || probe==NULL || thumb_hash_path==NULL || img_meta_record == NULL");
 		return MB_SVC_ERROR_INVALID_PARAMETER;
 	}
 
@@ -2548,14 +2529,7 @@ mb_svc_image_create_thumb_new(const char *file_full_path, char *thumb_hash_path,
 	thumb_info.thumb_hash_path = thumb_hash_path;
 	thumb_info.content_type = MINFO_ITEM_IMAGE;
 
-	drm_bool_type_e drm_type;
-	err = drm_is_drm_file(file_full_path, &drm_type);
-	if (err < 0) {
-		mb_svc_debug("drm_is_drm_file falied : %d", err);
-		drm_type = DRM_FALSE;
-	}
-
-	thumb_info.is_drm = (drm_type == DRM_TRUE);
+	thumb_info.is_drm = (_media_svc_probe_is_drm(probe) == DRM_TRUE);
 
 
 	err = __mb_svc_thumb_save_new(thumb, thumb_info, max_thumb_length);
@@ -2684,7 +2658,7 @@ mb_svc_get_image_meta(MediaSvcHandle *mb_svc_handle,
 		} else {
 			mb_svc_debug("time  is %s", buf);
 			image_record->datetaken =
-			    __mb_svc_get_time_val_from_str(buf);
+			    mb_svc_get_time_val_from_str(buf);
 		}
 	} else {
 		mb_svc_debug("__mb_svc_get_exif_info:EXIF_TAG_DATE_TIME  fails");
@@ -2925,7 +2899,7 @@ mb_svc_get_video_meta(MediaSvcHandle *mb_svc_handle,
 		if (err == 0 && size > 0) {
 			mb_svc_debug("Date: %s[%d]", p, size);
 			video_record->datetaken =
-			    __mb_svc_get_time_val_from_str(p);
+			    mb_svc_get_time_val_from_str(p);
 		} else {
 			if (size <= 0) {
 				mb_svc_debug("Size: [%d]", size);
@@ -2959,7 +2933,7 @@ mb_svc_get_video_meta(MediaSvcHandle *mb_svc_handle,
 }
 
 int
-mb_svc_video_create_thumb(const char *file_full_path, char *thumb_hash_path,
+mb_svc_video_create_thumb(const char *file_full_path, media_svc_probe_s *probe, char *thumb_hash_path,
 			  size_t max_thumb_length)
 {
 	MMHandleType content = (MMHandleType) NULL;
@@ -2970,19 +2944,12 @@ mb_svc_video_create_thumb(const char *file_full_path, char *thumb_hash_path,
 	char *err_msg = NULL;
 
 	mb_svc_debug("_mb_svc_video_generate_thumbnail------------start\n");
-	if (file_full_path == NULL) {
-		mb_svc_debug("file_full_path == NULL");
+	if (file_full_path == NULL || probe == NULL) {
+		mb_svc_debug("file_full_path == NULL || probe == NULL");
 		return MB_SVC_ERROR_INVALID_PARAMETER;
 	}
 
-	drm_bool_type_e drm_type;
-	err = drm_is_drm_file(file_full_path, &drm_type);
-	if (err < 0) {
-		mb_svc_debug("drm_is_drm_file falied : %d", err);
-		drm_type = DRM_FALSE;
-	}
-
-	thumb_info.is_drm = (drm_type == DRM_TRUE);
+	thumb_info.is_drm = (_media_svc_probe_is_drm(probe) == DRM_TRUE);
 
 	err = mm_file_create_content_attrs(&content, file_full_path);
 
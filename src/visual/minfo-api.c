@@ -35,14 +35,12 @@
 #include "minfo-meta.h"
 #include "minfo-bookmark.h"
 #include "minfo-streaming.h"
+#include "minfo-list.h"
 #include "visual-svc-db-util.h"
-
-static __thread int g_trans_valid_cnt = 1;
-static __thread int g_cur_trans_valid_cnt = 0;
-static __thread int g_trans_insert_cnt = 1;
-static __thread int g_cur_trans_insert_cnt = 0;
-static __thread int g_trans_move_cnt = 1;
-static __thread int g_cur_trans_move_cnt = 0;
+#include "media-svc-db-ctx.h"
+#include "media-svc-error.h"
+#include "media-svc-util.h"
+#include "media-svc-media.h"
 
 EXPORT_API int
 minfo_get_item_list(MediaSvcHandle *mb_svc_handle,
@@ -140,6 +138,74 @@ minfo_get_item_list(MediaSvcHandle *mb_svc_handle,
 		return MB_SVC_ERROR_NONE;
 }
 
+EXPORT_API int
+minfo_get_item_mlist(MediaSvcHandle *mb_svc_handle,
+			const char *cluster_id,
+			const minfo_item_filter filter,
+			Mlist **list)
+{
+	int ret = -1;
+	mb_svc_media_record_s md_record = {"",};
+	mb_svc_iterator_s mb_svc_iterator = { 0 };
+	Mlist *mlist = NULL;
+
+	if (mb_svc_handle == NULL) {
+		mb_svc_debug("media service handle is NULL");
+		return MB_SVC_ERROR_INVALID_PARAMETER;
+	}
+
+	if (list == NULL) {
+		mb_svc_debug("list is NULL");
+		return MB_SVC_ERROR_INVALID_PARAMETER;
+	}
+
+	minfo_item_filter mb_filter;
+	memcpy(&mb_filter, &filter, sizeof(minfo_item_filter));
+
+	ret =
+	    mb_svc_media_iter_start_new(mb_svc_handle, cluster_id, &mb_filter,
+					MINFO_CLUSTER_TYPE_ALL, TRUE, NULL,
+					&mb_svc_iterator);
+
+	if (ret < 0) {
+		mb_svc_debug("mb-svc iterator start failed");
+		return MB_SVC_ERROR_DB_INTERNAL;
+	}
+
+	mlist = minfo_mlist_new();
+	if (mlist == NULL) {
+		mb_svc_iter_finish(&mb_svc_iterator);
+		return MB_SVC_ERROR_OUT_OF_MEMORY;
+	}
+
+	while (1) {
+		ret = mb_svc_media_iter_next(&mb_svc_iterator, &md_record);
+		if (ret == MB_SVC_NO_RECORD_ANY_MORE)
+			break;
+
+		if (ret == 0)
+			ret = minfo_mlist_append_item(mb_svc_handle, mlist, &md_record, filter.with_meta);
+
+		if (ret < 0) {
+			mb_svc_debug("making item list failed : %d", ret);
+			mb_svc_iter_finish(&mb_svc_iterator);
+			minfo_mlist_destroy(mlist);
+			return ret;
+		}
+	}
+
+	mb_svc_iter_finish(&mb_svc_iterator);
+
+	if (mlist->count == 0) {
+		minfo_mlist_destroy(mlist);
+		return MB_SVC_ERROR_DB_NO_RECORD;
+	}
+
+	*list = mlist;
+
+	return MB_SVC_ERROR_NONE;
+}
+
 EXPORT_API int
 minfo_get_item_list_search(MediaSvcHandle *mb_svc_handle,
 								minfo_search_field_t search_field,
@@ -357,6 +423,7 @@ EXPORT_API int minfo_get_all_item_count(
 						int *cnt)
 {
 	int ret = -1;
+	char *cache_key = NULL;
 
 	mb_svc_debug("");
 
@@ -370,12 +437,23 @@ EXPORT_API int minfo_get_all_item_count(
 		return MB_SVC_ERROR_INVALID_PARAMETER;
 	}
 
+	cache_key = sqlite3_mprintf("all_item_cnt %d %d %d", folder_type, file_type, fav_type);
+	if (_media_svc_db_ctx_get_count((sqlite3 *)mb_svc_handle, cache_key, cnt)) {
+		sqlite3_free(cache_key);
+		mb_svc_debug("record count = %d (cached)", *cnt);
+		return MB_SVC_ERROR_NONE;
+	}
+
 	ret = mb_svc_get_all_item_count(mb_svc_handle, folder_type, file_type, fav_type, cnt);
 	if (ret < 0) {
 		mb_svc_debug("Error: mb_svc_get_all_item_count failed\n");
+		sqlite3_free(cache_key);
 		return ret;
 	}
 
+	_media_svc_db_ctx_set_count((sqlite3 *)mb_svc_handle, cache_key, *cnt);
+	sqlite3_free(cache_key);
+
 	mb_svc_debug("record count = %d", *cnt);
 	return MB_SVC_ERROR_NONE;
 }
@@ -462,6 +540,7 @@ minfo_get_item_cnt(MediaSvcHandle *mb_svc_handle,
 {
 	int ret = -1;
 	int record_cnt = 0;
+	char *cache_key = NULL;
 	mb_svc_iterator_s mb_svc_iterator = { 0 };
 
 	if (mb_svc_handle == NULL) {
@@ -489,6 +568,13 @@ minfo_get_item_cnt(MediaSvcHandle *mb_svc_handle,
 		     filter.with_meta);
 	mb_svc_debug("minfo_get_item_cnt#filter.favorite: %d", filter.favorite);
 
+	cache_key = sqlite3_mprintf("item_cnt %Q %d %d %d %d", cluster_id,
+				filter.file_type, filter.favorite, filter.start_pos, filter.end_pos);
+	if (_media_svc_db_ctx_get_count((sqlite3 *)mb_svc_handle, cache_key, cnt)) {
+		sqlite3_free(cache_key);
+		return (*cnt == 0) ? MB_SVC_ERROR_DB_NO_RECORD : MB_SVC_ERROR_NONE;
+	}
+
 	ret =
 	    mb_svc_media_iter_start_new(mb_svc_handle, cluster_id, &mb_filter,
 					MINFO_CLUSTER_TYPE_ALL, TRUE, NULL,
@@ -496,6 +582,7 @@ minfo_get_item_cnt(MediaSvcHandle *mb_svc_handle,
 
 	if (ret < 0) {
 		mb_svc_debug("mb_svc_media_iter_start failed");
+		sqlite3_free(cache_key);
 		*cnt = -1;
 		return MB_SVC_ERROR_DB_INTERNAL;
 	}
@@ -509,6 +596,7 @@ minfo_get_item_cnt(MediaSvcHandle *mb_svc_handle,
 		if (ret < 0) {
 			mb_svc_debug("mb-svc iterator get next recrod failed");
 			mb_svc_iter_finish(&mb_svc_iterator);
+			sqlite3_free(cache_key);
 			return ret;
 		}
 
@@ -519,6 +607,9 @@ minfo_get_item_cnt(MediaSvcHandle *mb_svc_handle,
 
 	*cnt = record_cnt;
 
+	_media_svc_db_ctx_set_count((sqlite3 *)mb_svc_handle, cache_key, record_cnt);
+	sqlite3_free(cache_key);
+
 	if (record_cnt == 0)
 		return MB_SVC_ERROR_DB_NO_RECORD;
 	else
@@ -531,6 +622,7 @@ minfo_get_cluster_cnt(MediaSvcHandle *mb_svc_handle, const minfo_cluster_filter
 	mb_svc_iterator_s mb_svc_iterator = { 0 };
 	int ret = -1;
 	int record_cnt = 0;
+	char *cache_key = NULL;
 
 	if (mb_svc_handle == NULL) {
 		mb_svc_debug("media service handle is NULL");
@@ -556,9 +648,16 @@ minfo_get_cluster_cnt(MediaSvcHandle *mb_svc_handle, const minfo_cluster_filter
 	mb_svc_debug("minfo_get_cluster_list#filter.end_pos: %d",
 		     filter.end_pos);
 
+	cache_key = sqlite3_mprintf("cluster_cnt %d %d %d", filter.cluster_type, filter.start_pos, filter.end_pos);
+	if (_media_svc_db_ctx_get_count((sqlite3 *)mb_svc_handle, cache_key, cnt)) {
+		sqlite3_free(cache_key);
+		return (*cnt == 0) ? MB_SVC_ERROR_DB_NO_RECORD : MB_SVC_ERROR_NONE;
+	}
+
 	ret = mb_svc_folder_iter_start(mb_svc_handle, &mb_filter, &mb_svc_iterator);
 	if (ret < 0) {
 		mb_svc_debug("mb_svc_folder_iter_start failed\n");
+		sqlite3_free(cache_key);
 		return MB_SVC_ERROR_DB_INTERNAL;
 	}
 
@@ -571,6 +670,7 @@ minfo_get_cluster_cnt(MediaSvcHandle *mb_svc_handle, const minfo_cluster_filter
 		if (ret < 0) {
 			mb_svc_debug("mb-svc iterator get next recrod failed");
 			mb_svc_iter_finish(&mb_svc_iterator);
+			sqlite3_free(cache_key);
 			return ret;
 		}
 
@@ -582,6 +682,9 @@ minfo_get_cluster_cnt(MediaSvcHandle *mb_svc_handle, const minfo_cluster_filter
 
 	mb_svc_iter_finish(&mb_svc_iterator);
 
+	_media_svc_db_ctx_set_count((sqlite3 *)mb_svc_handle, cache_key, record_cnt);
+	sqlite3_free(cache_key);
+
 	if (record_cnt == 0)
 		return MB_SVC_ERROR_DB_NO_RECORD;
 	else
@@ -658,6 +761,70 @@ minfo_get_cluster_list(MediaSvcHandle *mb_svc_handle,
 		return MB_SVC_ERROR_NONE;
 }
 
+EXPORT_API int
+minfo_get_cluster_mlist(MediaSvcHandle *mb_svc_handle,
+				const minfo_cluster_filter filter,
+				Mlist **list)
+{
+	mb_svc_iterator_s mb_svc_iterator = { 0 };
+	mb_svc_folder_record_s fd_record = {"",};
+	int ret = -1;
+	Mlist *mlist = NULL;
+
+	if (mb_svc_handle == NULL) {
+		mb_svc_debug("media service handle is NULL");
+		return MB_SVC_ERROR_INVALID_PARAMETER;
+	}
+
+	if (list == NULL) {
+		mb_svc_debug("list is NULL");
+		return MB_SVC_ERROR_INVALID_PARAMETER;
+	}
+
+	minfo_cluster_filter mb_filter;
+
+	memcpy(&mb_filter, &filter, sizeof(minfo_cluster_filter));
+
+	ret = mb_svc_folder_iter_start(mb_svc_handle, &mb_filter, &mb_svc_iterator);
+	if (ret < 0) {
+		mb_svc_debug("mb-svc iterator start failed\n");
+		return MB_SVC_ERROR_DB_INTERNAL;
+	}
+
+	mlist = minfo_mlist_new();
+	if (mlist == NULL) {
+		mb_svc_iter_finish(&mb_svc_iterator);
+		return MB_SVC_ERROR_OUT_OF_MEMORY;
+	}
+
+	while (1) {
+		ret = mb_svc_folder_iter_next(&mb_svc_iterator, &fd_record);
+		if (ret == MB_SVC_NO_RECORD_ANY_MORE)
+			break;
+
+		if (ret == 0)
+			ret = minfo_mlist_append_cluster(mb_svc_handle, mlist, &fd_record);
+
+		if (ret < 0) {
+			mb_svc_debug("making cluster list failed : %d", ret);
+			mb_svc_iter_finish(&mb_svc_iterator);
+			minfo_mlist_destroy(mlist);
+			return ret;
+		}
+	}
+
+	mb_svc_iter_finish(&mb_svc_iterator);
+
+	if (mlist->count == 0) {
+		minfo_mlist_destroy(mlist);
+		return MB_SVC_ERROR_DB_NO_RECORD;
+	}
+
+	*list = mlist;
+
+	return MB_SVC_ERROR_NONE;
+}
+
 EXPORT_API int
 minfo_get_web_cluster_by_web_account_id(MediaSvcHandle *mb_svc_handle,
 					const char *web_account_id,
@@ -1078,6 +1245,8 @@ minfo_update_image_meta_info_int(MediaSvcHandle *mb_svc_handle,
 EXPORT_API int
 minfo_add_media_start(MediaSvcHandle *mb_svc_handle, int trans_count)
 {
+	media_svc_batch_s *batch = NULL;
+
 	mb_svc_debug("Transaction count : %d", trans_count);
 
 	if (trans_count <= 1) {
@@ -1085,8 +1254,12 @@ minfo_add_media_start(MediaSvcHandle *mb_svc_handle, int trans_count)
 		return MB_SVC_ERROR_INVALID_PARAMETER;
 	}
 
-	g_trans_insert_cnt = trans_count;
-	g_cur_trans_insert_cnt = 0;
+	batch = mb_svc_get_batch(mb_svc_handle, MEDIA_SVC_QUERY_INSERT_ITEM);
+	if (batch == NULL)
+		return MB_SVC_ERROR_INVALID_PARAMETER;
+
+	batch->data_cnt = trans_count;
+	batch->cur_data_cnt = 0;
 
 	return MB_SVC_ERROR_NONE;
 }
@@ -1094,17 +1267,23 @@ minfo_add_media_start(MediaSvcHandle *mb_svc_handle, int trans_count)
 EXPORT_API int
 minfo_add_media_end(MediaSvcHandle *mb_svc_handle)
 {
+	media_svc_batch_s *batch = NULL;
+
 	mb_svc_debug("");
 
-	if (g_cur_trans_insert_cnt > 0) {
+	batch = mb_svc_get_batch(mb_svc_handle, MEDIA_SVC_QUERY_INSERT_ITEM);
+	if (batch == NULL)
+		return MB_SVC_ERROR_INVALID_PARAMETER;
+
+	if (batch->cur_data_cnt > 0) {
 		int ret = -1;
 
 		ret = mb_svc_sqlite3_begin_trans(mb_svc_handle);
 		if (ret < 0) {
 			mb_svc_debug("mb_svc_sqlite3_begin_trans failed\n");
 
-			g_cur_trans_insert_cnt = 0;
-			g_trans_insert_cnt = 1;
+			batch->cur_data_cnt = 0;
+			batch->data_cnt = 1;
 
 			return ret;
 		}
@@ -1122,19 +1301,61 @@ minfo_add_media_end(MediaSvcHandle *mb_svc_handle)
 				("mb_svc_sqlite3_commit_trans failed.. Now start to rollback\n");
 			mb_svc_sqlite3_rollback_trans(mb_svc_handle);
 
-			g_cur_trans_insert_cnt = 0;
-			g_trans_insert_cnt = 1;
+			batch->cur_data_cnt = 0;
+			batch->data_cnt = 1;
 
 			return ret;
 		}
 	}
 
-	g_cur_trans_insert_cnt = 0;
-	g_trans_insert_cnt = 1;
+	batch->cur_data_cnt = 0;
+	batch->data_cnt = 1;
 
 	return MB_SVC_ERROR_NONE;
 }
 
+static int __minfo_add_media_batch_done(MediaSvcHandle *mb_svc_handle)
+{
+	media_svc_batch_s *batch = NULL;
+	int err = 0;
+
+	batch = mb_svc_get_batch(mb_svc_handle, MEDIA_SVC_QUERY_INSERT_ITEM);
+	if (batch == NULL)
+		return MB_SVC_ERROR_INVALID_PARAMETER;
+
+	if (batch->cur_data_cnt < batch->data_cnt) {
+		batch->cur_data_cnt++;
+
+		return MB_SVC_ERROR_NONE;
+	}
+
+	batch->cur_data_cnt = 0;
+
+	err = mb_svc_sqlite3_begin_trans(mb_svc_handle);
+	if (err < 0) {
+		mb_svc_debug("mb_svc_sqlite3_begin_trans failed\n");
+		return err;
+	}
+
+	err = mb_svc_insert_items(mb_svc_handle);
+	if (err < 0) {
+		mb_svc_debug
+			("mb_svc_insert_items failed.. Now start to rollback\n");
+		mb_svc_sqlite3_rollback_trans(mb_svc_handle);
+		return err;
+	}
+
+	err = mb_svc_sqlite3_commit_trans(mb_svc_handle);
+	if (err < 0) {
+		mb_svc_debug
+			("mb_svc_sqlite3_commit_trans failed.. Now start to rollback\n");
+		mb_svc_sqlite3_rollback_trans(mb_svc_handle);
+		return err;
+	}
+
+	return err;
+}
+
 EXPORT_API int minfo_add_media_batch(MediaSvcHandle *mb_svc_handle, const char *file_url, minfo_file_type content_type)
 {
 	int err = 0;
@@ -1151,50 +1372,117 @@ EXPORT_API int minfo_add_media_batch(MediaSvcHandle *mb_svc_handle, const char *
 
 	mb_svc_debug("file_full_path is %s\n", file_url);
 
-	if (g_cur_trans_insert_cnt < g_trans_insert_cnt) {
-		err = mb_svc_insert_file_batch(mb_svc_handle, file_url, content_type);
+	err = mb_svc_insert_file_batch(mb_svc_handle, file_url, content_type);
+	if (err < 0) {
+		mb_svc_debug("mb_svc_insert_file_batch failed\n");
+		return err;
+	}
 
-		if (err < 0) {
-			mb_svc_debug("mb_svc_insert_file_batch failed\n");
-			return err;
-		}
+	return __minfo_add_media_batch_done(mb_svc_handle);
+}
 
-		g_cur_trans_insert_cnt++;
+static int __minfo_add_media_batch_by_content_info(MediaSvcHandle *mb_svc_handle, const media_svc_content_info_s *content_info)
+{
+	mb_svc_image_meta_record_s image_record = {0,};
+	mb_svc_video_meta_record_s video_record = {0,};
+	minfo_file_type content_type = MINFO_ITEM_NONE;
+	int err = 0;
 
-		return MB_SVC_ERROR_NONE;
+	if (mb_svc_handle == NULL) {
+		mb_svc_debug("media service handle is NULL");
+		return MB_SVC_ERROR_INVALID_PARAMETER;
 	}
 
-	if (g_cur_trans_insert_cnt == g_trans_insert_cnt) {
-		err = mb_svc_insert_file_batch(mb_svc_handle, file_url, content_type);
-		if (err < 0) {
-			mb_svc_debug("mb_svc_insert_file_batch failed\n");
-			return err;
-		}
+	if (content_info == NULL || content_info->path == NULL) {
+		mb_svc_debug("content_info is NULL");
+		return MB_SVC_ERROR_INVALID_PARAMETER;
+	}
 
-		g_cur_trans_insert_cnt = 0;
+	if (content_info->media_type == MEDIA_SVC_MEDIA_TYPE_IMAGE)
+		content_type = MINFO_ITEM_IMAGE;
+	else if (content_info->media_type == MEDIA_SVC_MEDIA_TYPE_VIDEO)
+		content_type = MINFO_ITEM_VIDEO;
 
-		err = mb_svc_sqlite3_begin_trans(mb_svc_handle);
-		if (err < 0) {
-			mb_svc_debug("mb_svc_sqlite3_begin_trans failed\n");
-			return err;
-		}
+	err = mb_svc_get_meta_by_content_info(content_info, &image_record, &video_record);
+	if (err < 0) {
+		mb_svc_debug("mb_svc_get_meta_by_content_info failed\n");
+		return err;
+	}
 
-		err = mb_svc_insert_items(mb_svc_handle);
-		if (err < 0) {
-			mb_svc_debug
-				("mb_svc_insert_items failed.. Now start to rollback\n");
-			mb_svc_sqlite3_rollback_trans(mb_svc_handle);
-			return err;
-		}
+	err = mb_svc_insert_file_batch_with_meta(mb_svc_handle, content_info->path, content_type,
+						&image_record, &video_record, content_info->thumbnail_path,
+						(int)content_info->modified_time, (content_info->is_drm != 0));
+	if (err < 0) {
+		mb_svc_debug("mb_svc_insert_file_batch_with_meta failed\n");
+		return err;
+	}
 
-		err = mb_svc_sqlite3_commit_trans(mb_svc_handle);
-		if (err < 0) {
-			mb_svc_debug
-				("mb_svc_sqlite3_commit_trans failed.. Now start to rollback\n");
-			mb_svc_sqlite3_rollback_trans(mb_svc_handle);
-			return err;
-		}
- 	}
+	return __minfo_add_media_batch_done(mb_svc_handle);
+}
+
+EXPORT_API int minfo_add_media_batch_with_media(MediaSvcHandle *mb_svc_handle, const char *file_url, minfo_file_type content_type, const char *mime_type)
+{
+	media_svc_content_info_s content_info;
+	media_svc_probe_s probe;
+	media_svc_storage_type_e storage_type = MEDIA_SVC_STORAGE_INTERNAL;
+	media_svc_media_type_e media_type = MEDIA_SVC_MEDIA_TYPE_IMAGE;
+	int store_type = MINFO_SYSTEM;
+	int err = 0;
+
+	if (mb_svc_handle == NULL) {
+		mb_svc_debug("media service handle is NULL");
+		return MB_SVC_ERROR_INVALID_PARAMETER;
+	}
+
+	if (file_url == NULL || mime_type == NULL) {
+		mb_svc_debug("File URL or mime type is NULL");
+		return MB_SVC_ERROR_INVALID_PARAMETER;
+	}
+
+	if (content_type == MINFO_ITEM_IMAGE)
+		media_type = MEDIA_SVC_MEDIA_TYPE_IMAGE;
+	else if (content_type == MINFO_ITEM_VIDEO)
+		media_type = MEDIA_SVC_MEDIA_TYPE_VIDEO;
+	else {
+		mb_svc_debug("invalid content type : %d", content_type);
+		return MB_SVC_ERROR_INVALID_PARAMETER;
+	}
+
+	store_type = _mb_svc_get_store_type_by_full(file_url);
+	if (store_type == MINFO_PHONE)
+		storage_type = MEDIA_SVC_STORAGE_INTERNAL;
+	else if (store_type == MINFO_MMC)
+		storage_type = MEDIA_SVC_STORAGE_EXTERNAL;
+	else {
+		mb_svc_debug("invalid store type : %d", store_type);
+		return MB_SVC_ERROR_INVALID_PARAMETER;
+	}
+
+	mb_svc_debug("file_full_path is %s\n", file_url);
+
+	memset(&content_info, 0, sizeof(media_svc_content_info_s));
+	_media_svc_probe_init(&probe, file_url);
+
+	/* the file is parsed once, both visual and media tables are filled from its content info */
+	err = _media_svc_make_content_info(mb_svc_handle, &probe, storage_type, file_url, mime_type, media_type, &content_info);
+	if (err != MEDIA_INFO_ERROR_NONE) {
+		mb_svc_debug("_media_svc_make_content_info failed : %d", err);
+		return MB_SVC_ERROR_INTERNAL;
+	}
+
+	err = __minfo_add_media_batch_by_content_info(mb_svc_handle, &content_info);
+	if (err < 0) {
+		mb_svc_debug("__minfo_add_media_batch_by_content_info failed : %d", err);
+		_media_svc_destroy_content_info(&content_info);
+		return err;
+	}
+
+	if (_media_svc_insert_content_info_bulk(mb_svc_handle, &content_info) != MEDIA_INFO_ERROR_NONE) {
+		mb_svc_debug("_media_svc_insert_content_info_bulk failed");
+		err = MB_SVC_ERROR_DB_INTERNAL;
+	}
+
+	_media_svc_destroy_content_info(&content_info);
 
 	return err;
 }
@@ -1539,6 +1827,8 @@ minfo_add_web_media_with_type(MediaSvcHandle *mb_svc_handle,
 EXPORT_API int
 minfo_move_media_start(MediaSvcHandle *mb_svc_handle, int trans_count)
 {
+	media_svc_batch_s *batch = NULL;
+
 	mb_svc_debug("Transaction count : %d", trans_count);
 
 	if (mb_svc_handle == NULL) {
@@ -1551,8 +1841,12 @@ minfo_move_media_start(MediaSvcHandle *mb_svc_handle, int trans_count)
 		return MB_SVC_ERROR_INVALID_PARAMETER;
 	}
 
-	g_trans_move_cnt = trans_count;
-	g_cur_trans_move_cnt = 0;
+	batch = mb_svc_get_batch(mb_svc_handle, MEDIA_SVC_QUERY_MOVE_ITEM);
+	if (batch == NULL)
+		return MB_SVC_ERROR_INVALID_PARAMETER;
+
+	batch->data_cnt = trans_count;
+	batch->cur_data_cnt = 0;
 
 	return MB_SVC_ERROR_NONE;
 }
@@ -1560,17 +1854,23 @@ minfo_move_media_start(MediaSvcHandle *mb_svc_handle, int trans_count)
 EXPORT_API int
 minfo_move_media_end(MediaSvcHandle *mb_svc_handle)
 {
+	media_svc_batch_s *batch = NULL;
+
 	mb_svc_debug("");
 
-	if (g_cur_trans_move_cnt > 0) {
+	batch = mb_svc_get_batch(mb_svc_handle, MEDIA_SVC_QUERY_MOVE_ITEM);
+	if (batch == NULL)
+		return MB_SVC_ERROR_INVALID_PARAMETER;
+
+	if (batch->cur_data_cnt > 0) {
 		int ret = -1;
 
 		ret = mb_svc_sqlite3_begin_trans(mb_svc_handle);
 		if (ret < 0) {
 			mb_svc_debug("mb_svc_sqlite3_begin_trans failed\n");
 
-			g_cur_trans_move_cnt = 0;
-			g_trans_move_cnt = 1;
+			batch->cur_data_cnt = 0;
+			batch->data_cnt = 1;
 
 			return ret;
 		}
@@ -1587,15 +1887,15 @@ minfo_move_media_end(MediaSvcHandle *mb_svc_handle)
 				("mb_svc_sqlite3_commit_trans failed.. Now start to rollback\n");
 			mb_svc_sqlite3_rollback_trans(mb_svc_handle);
 
-			g_cur_trans_move_cnt = 0;
-			g_trans_move_cnt = 1;
+			batch->cur_data_cnt = 0;
+			batch->data_cnt = 1;
 
 			return ret;
 		}
 	}
 
-	g_cur_trans_move_cnt = 0;
-	g_trans_move_cnt = 1;
+	batch->cur_data_cnt = 0;
+	batch->data_cnt = 1;
 
 	return MB_SVC_ERROR_NONE;
 }
@@ -1606,6 +1906,8 @@ minfo_move_media(MediaSvcHandle *mb_svc_handle,
 			const char *new_file_url,
 			minfo_file_type content_type)
 {
+	media_svc_batch_s *batch = NULL;
+
 	mb_svc_debug("");
 
 	int ret = -1;
@@ -1656,7 +1958,11 @@ minfo_move_media(MediaSvcHandle *mb_svc_handle,
 		}
 	}
 
-	if (g_trans_move_cnt == 1) {
+	batch = mb_svc_get_batch(mb_svc_handle, MEDIA_SVC_QUERY_MOVE_ITEM);
+	if (batch == NULL)
+		return MB_SVC_ERROR_INVALID_PARAMETER;
+
+	if (batch->data_cnt == 1) {
 		if (is_renamed) {
 			ret = mb_svc_sqlite3_begin_trans(mb_svc_handle);
 			if (ret < 0) {
@@ -1698,29 +2004,29 @@ minfo_move_media(MediaSvcHandle *mb_svc_handle,
 		}
 	}
 
-	if (g_trans_move_cnt == 1 && is_renamed) {
+	if (batch->data_cnt == 1 && is_renamed) {
 		mb_svc_debug("Move batch job doesn't support renaming file");
 		return MB_SVC_ERROR_INVALID_PARAMETER;
 	}
 
-	if (g_cur_trans_move_cnt < g_trans_move_cnt) {
+	if (batch->cur_data_cnt < batch->data_cnt) {
 		ret = mb_svc_move_file_batch(mb_svc_handle, old_file_url, new_file_url, content_type, thumb_path);
 		if (ret < 0) {
 			mb_svc_debug("mb_svc_move_file_batch failed : %d\n", ret);
 			return ret;
 		}
 
-		g_cur_trans_move_cnt++;
+		batch->cur_data_cnt++;
 	}
 
-	if (g_cur_trans_move_cnt == g_trans_move_cnt) {
+	if (batch->cur_data_cnt == batch->data_cnt) {
 		ret = mb_svc_move_file_batch(mb_svc_handle, old_file_url, new_file_url, content_type, thumb_path);
 		if (ret < 0) {
 			mb_svc_debug("mb_svc_move_file_batch failed : %d\n", ret);
 			return ret;
 		}
 
-		g_cur_trans_move_cnt = 0;
+		batch->cur_data_cnt = 0;
 
 		ret = mb_svc_sqlite3_begin_trans(mb_svc_handle);
 		if (ret < 0) {
@@ -2627,6 +2933,8 @@ EXPORT_API int minfo_destroy_mtype_item(void *item)
 		minfo_mstreaming_destroy((Mstreaming *) item);
 	} else if (IS_MINFO_MTAG(item)) {
 		minfo_media_tag_destroy((Mtag *) item);
+	} else if (IS_MINFO_MLIST(item)) {
+		minfo_mlist_destroy((Mlist *) item);
 	} else {
 		return MB_SVC_ERROR_INVALID_PARAMETER;
 	}
@@ -3026,14 +3334,20 @@ minfo_set_db_valid(MediaSvcHandle *mb_svc_handle, const minfo_store_type storage
 EXPORT_API int
 minfo_set_item_valid_start(MediaSvcHandle *mb_svc_handle, int trans_count)
 {
+	media_svc_batch_s *batch = NULL;
+
 	if (mb_svc_handle == NULL) {
 		mb_svc_debug("media service handle is NULL");
 		return MB_SVC_ERROR_INVALID_PARAMETER;
 	}
 
 	mb_svc_debug("Transaction count : %d", trans_count);
-	g_trans_valid_cnt = trans_count;
-	g_cur_trans_valid_cnt = 0;
+	batch = mb_svc_get_batch(mb_svc_handle, MEDIA_SVC_QUERY_SET_ITEM_VALIDITY);
+	if (batch == NULL)
+		return MB_SVC_ERROR_INVALID_PARAMETER;
+
+	batch->data_cnt = trans_count;
+	batch->cur_data_cnt = 0;
 
 	return MB_SVC_ERROR_NONE;
 }
@@ -3041,17 +3355,23 @@ minfo_set_item_valid_start(MediaSvcHandle *mb_svc_handle, int trans_count)
 EXPORT_API int
 minfo_set_item_valid_end(MediaSvcHandle *mb_svc_handle)
 {
+	media_svc_batch_s *batch = NULL;
+
 	mb_svc_debug("");
 
-	if (g_cur_trans_valid_cnt > 0) {
+	batch = mb_svc_get_batch(mb_svc_handle, MEDIA_SVC_QUERY_SET_ITEM_VALIDITY);
+	if (batch == NULL)
+		return MB_SVC_ERROR_INVALID_PARAMETER;
+
+	if (batch->cur_data_cnt > 0) {
 		int ret = -1;
 
 		ret = mb_svc_sqlite3_begin_trans(mb_svc_handle);
 		if (ret < 0) {
 			mb_svc_debug("mb_svc_sqlite3_begin_trans failed\n");
 
-			g_cur_trans_valid_cnt = 0;
-			g_trans_valid_cnt = 1;
+			batch->cur_data_cnt = 0;
+			batch->data_cnt = 1;
 
 			return ret;
 		}
@@ -3064,16 +3384,16 @@ minfo_set_item_valid_end(MediaSvcHandle *mb_svc_handle)
 				("mb_svc_sqlite3_commit_trans failed.. Now start to rollback\n");
 			mb_svc_sqlite3_rollback_trans(mb_svc_handle);
 
-			g_cur_trans_valid_cnt = 0;
-			g_trans_valid_cnt = 1;
+			batch->cur_data_cnt = 0;
+			batch->data_cnt = 1;
 
 			return ret;
 		}
 	}
 
-	mb_svc_init_last_updated_folder_uuid();
-	g_cur_trans_valid_cnt = 0;
-	g_trans_valid_cnt = 1;
+	mb_svc_init_last_updated_folder_uuid(mb_svc_handle);
+	batch->cur_data_cnt = 0;
+	batch->data_cnt = 1;
 
 	return MB_SVC_ERROR_NONE;
 }
@@ -3084,6 +3404,8 @@ minfo_set_item_valid(MediaSvcHandle *mb_svc_handle,
 				const char *full_path,
 				int valid)
 {
+	media_svc_batch_s *batch = NULL;
+
 	mb_svc_debug("storage:%d", storage_type);
 	int ret;
 
@@ -3097,26 +3419,30 @@ minfo_set_item_valid(MediaSvcHandle *mb_svc_handle,
 		return MB_SVC_ERROR_INVALID_PARAMETER;
 	}
 
-	if (g_cur_trans_valid_cnt < g_trans_valid_cnt) {
+	batch = mb_svc_get_batch(mb_svc_handle, MEDIA_SVC_QUERY_SET_ITEM_VALIDITY);
+	if (batch == NULL)
+		return MB_SVC_ERROR_INVALID_PARAMETER;
+
+	if (batch->cur_data_cnt < batch->data_cnt) {
 		ret = mb_svc_set_item_as_valid_sql_add(mb_svc_handle, full_path, valid);
 		if (ret < 0) {
 			mb_svc_debug("mb_svc_set_item_as_valid_sql_add failed\n");
 			return ret;
 		}
 
-		g_cur_trans_valid_cnt++;
+		batch->cur_data_cnt++;
 
 		return MB_SVC_ERROR_NONE;
 	}
 
-	if (g_cur_trans_valid_cnt == g_trans_valid_cnt) {
+	if (batch->cur_data_cnt == batch->data_cnt) {
 		ret = mb_svc_set_item_as_valid_sql_add(mb_svc_handle, full_path, valid);
 		if (ret < 0) {
 			mb_svc_debug("mb_svc_set_item_as_valid_sql_add failed\n");
 			return ret;
 		}
 
-		g_cur_trans_valid_cnt = 0;
+		batch->cur_data_cnt = 0;
 
 		ret = mb_svc_sqlite3_begin_trans(mb_svc_handle);
 		if (ret < 0) {
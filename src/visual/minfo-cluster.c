@@ -20,6 +20,7 @@
  */
 
 #include "minfo-cluster.h"
+#include "minfo-list.h"
 #include "media-svc-api.h"
 #include "visual-svc-util.h"
 #include "visual-svc-error.h"
@@ -103,6 +104,10 @@ Mcluster *minfo_mcluster_new(MediaSvcHandle *mb_svc_handle, const char *uuid)
 void minfo_mcluster_destroy(Mcluster *mcluster)
 {
 	if (mcluster != NULL) {
+		if (MINFO_OWNED_BY_MLIST(mcluster)) {
+			/* freed with its Mlist */
+			return;
+		}
 		if (mcluster->uuid) {
 			free(mcluster->uuid);
 		}
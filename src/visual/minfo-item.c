@@ -21,6 +21,7 @@
 
 #include "minfo-item.h"
 #include "minfo-meta.h"
+#include "minfo-list.h"
 #include "media-svc-api.h"
 #include "visual-svc-util.h"
 #include "visual-svc-debug.h"
@@ -137,6 +138,10 @@ Mitem *minfo_media_item_new(MediaSvcHandle *mb_svc_handle, const char *uuid, mb_
 void minfo_mitem_destroy(Mitem *mitem)
 {
 	if (mitem != NULL && IS_MINFO_MITEM(mitem)) {
+		if (MINFO_OWNED_BY_MLIST(mitem)) {
+			/* freed with its Mlist */
+			return;
+		}
 		mb_svc_debug("do free resource %s\n", mitem->file_url);
 		if (mitem->uuid) {
 			free(mitem->uuid);
@@ -0,0 +1,285 @@
+/*
+ * libmedia-service
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Hyunjun Ko <zzoon.ko@samsung.com>, Haejeong Kim <backto.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "minfo-list.h"
+#include "minfo-item.h"
+#include "minfo-meta.h"
+#include "minfo-cluster.h"
+#include "minfo-bookmark.h"
+#include "visual-svc.h"
+#include "visual-svc-util.h"
+#include "visual-svc-debug.h"
+#include "visual-svc-error.h"
+#include "media-svc-util.h"
+#include <string.h>
+
+#define MINFO_MLIST_GROW_SIZE	64
+
+/* Mlist is the first member, so the list handed to the user is the whole object */
+typedef struct {
+	Mlist list;
+	media_svc_arena_s arena;
+	int alloc_cnt;
+} minfo_mlist_s;
+
+static int _minfo_bm_ite_fn(Mbookmark *bookmark, void *user_data)
+{
+	GList **list = (GList **) user_data;
+	*list = g_list_append(*list, bookmark);
+
+	return 0;
+}
+
+static int _minfo_mlist_push(minfo_mlist_s *mlist, void *item)
+{
+	void **items = NULL;
+
+	if (mlist->list.count == mlist->alloc_cnt) {
+		items = realloc(mlist->list.items, (mlist->alloc_cnt + MINFO_MLIST_GROW_SIZE) * sizeof(void *));
+		if (items == NULL) {
+			return MB_SVC_ERROR_OUT_OF_MEMORY;
+		}
+		mlist->list.items = items;
+		mlist->alloc_cnt += MINFO_MLIST_GROW_SIZE;
+	}
+
+	mlist->list.items[mlist->list.count++] = item;
+
+	return 0;
+}
+
+static Mvideo *_minfo_mlist_new_video(MediaSvcHandle *mb_svc_handle, minfo_mlist_s *mlist, const char *media_uuid, mb_svc_video_meta_record_s *video_meta_record)
+{
+	media_svc_arena_s *arena = &mlist->arena;
+	Mvideo *mvideo = NULL;
+	GList *tmp_list = NULL;
+
+	mvideo = _media_svc_arena_alloc(arena, sizeof(Mvideo));
+	if (mvideo == NULL) {
+		return NULL;
+	}
+
+	mvideo->gtype = MINFO_TYPE_MVIDEO;
+	mvideo->album_name = _media_svc_arena_strdup(arena, video_meta_record->album);
+	mvideo->artist_name = _media_svc_arena_strdup(arena, video_meta_record->artist);
+	mvideo->title = _media_svc_arena_strdup(arena, video_meta_record->title);
+	mvideo->genre = _media_svc_arena_strdup(arena, video_meta_record->genre);
+	mvideo->last_played_pos = video_meta_record->last_played_time;
+	mvideo->duration = video_meta_record->duration;
+	mvideo->web_category = _media_svc_arena_strdup(arena, video_meta_record->youtube_category);
+
+	/* bookmarks are few and malloced, they are freed by minfo_mlist_destroy */
+	minfo_get_bookmark_list(mb_svc_handle, media_uuid, _minfo_bm_ite_fn, &tmp_list);
+	mvideo->bookmarks = tmp_list;
+	mvideo->_reserved = mlist;
+
+	return mvideo;
+}
+
+static Mmeta *_minfo_mlist_new_meta(MediaSvcHandle *mb_svc_handle, minfo_mlist_s *mlist, const char *media_uuid, mb_svc_media_record_s *p_md_record)
+{
+	media_svc_arena_s *arena = &mlist->arena;
+	mb_svc_image_meta_record_s image_meta_record = {0,};
+	mb_svc_video_meta_record_s video_meta_record = {0,};
+	Mmeta *mmeta = NULL;
+	int ret = 0;
+
+	mmeta = _media_svc_arena_alloc(arena, sizeof(Mmeta));
+	if (mmeta == NULL) {
+		return NULL;
+	}
+
+	memset(mmeta, 0x00, sizeof(Mmeta));
+	mmeta->gtype = MINFO_TYPE_MMETA;
+	mmeta->media_uuid = (char *)media_uuid;
+	mmeta->_reserved = mlist;
+
+	if (p_md_record->content_type == MINFO_ITEM_IMAGE) {
+		ret = mb_svc_get_image_record_by_media_id(mb_svc_handle, media_uuid, &image_meta_record);
+		if (ret < 0) {
+			return NULL;
+		}
+
+		mmeta->type = p_md_record->content_type;
+		mmeta->longitude = image_meta_record.longitude;
+		mmeta->latitude = image_meta_record.latitude;
+		mmeta->width = image_meta_record.width;
+		mmeta->height = image_meta_record.height;
+		mmeta->datetaken = image_meta_record.datetaken;
+
+		mmeta->image_info = _media_svc_arena_alloc(arena, sizeof(Mimage));
+		if (mmeta->image_info == NULL) {
+			return NULL;
+		}
+		mmeta->image_info->gtype = MINFO_TYPE_MIMAGE;
+		mmeta->image_info->orientation = image_meta_record.orientation;
+		mmeta->image_info->_reserved = mlist;
+	} else if (p_md_record->content_type == MINFO_ITEM_VIDEO) {
+		ret = mb_svc_get_video_record_by_media_id(mb_svc_handle, media_uuid, &video_meta_record);
+		if (ret < 0) {
+			return NULL;
+		}
+
+		mmeta->type = p_md_record->content_type;
+		mmeta->longitude = video_meta_record.longitude;
+		mmeta->latitude = video_meta_record.latitude;
+		mmeta->width = video_meta_record.width;
+		mmeta->height = video_meta_record.height;
+		mmeta->datetaken = video_meta_record.datetaken;
+
+		/* one query of video meta for both of mmeta and mvideo */
+		mmeta->video_info = _minfo_mlist_new_video(mb_svc_handle, mlist, media_uuid, &video_meta_record);
+		if (mmeta->video_info == NULL) {
+			return NULL;
+		}
+	}
+
+	return mmeta;
+}
+
+Mlist *minfo_mlist_new(void)
+{
+	minfo_mlist_s *mlist = NULL;
+
+	mlist = (minfo_mlist_s *) malloc(sizeof(minfo_mlist_s));
+	if (mlist == NULL) {
+		return NULL;
+	}
+
+	memset(mlist, 0x00, sizeof(minfo_mlist_s));
+	mlist->list.gtype = MINFO_TYPE_MLIST;
+
+	return &mlist->list;
+}
+
+int minfo_mlist_append_item(MediaSvcHandle *mb_svc_handle, Mlist *list, mb_svc_media_record_s *p_md_record, bool with_meta)
+{
+	minfo_mlist_s *mlist = (minfo_mlist_s *)list;
+	media_svc_arena_s *arena = &mlist->arena;
+	char ext[MB_SVC_FILE_EXT_LEN_MAX + 1] = {0,};
+	Mitem *mitem = NULL;
+
+	mitem = _media_svc_arena_alloc(arena, sizeof(Mitem));
+	if (mitem == NULL) {
+		return MB_SVC_ERROR_OUT_OF_MEMORY;
+	}
+
+	mitem->gtype = MINFO_TYPE_MITEM;
+	mitem->uuid = _media_svc_arena_strdup(arena, p_md_record->media_uuid);
+	mitem->cluster_uuid = _media_svc_arena_strdup(arena, p_md_record->folder_uuid);
+
+	if (strlen(p_md_record->http_url) != 0) {
+		mitem->file_url = _media_svc_arena_strdup(arena, p_md_record->http_url);
+	} else {
+		mitem->file_url = _media_svc_arena_strdup(arena, p_md_record->path);
+	}
+
+	mitem->thumb_url = _media_svc_arena_strdup(arena, p_md_record->thumbnail_path);
+	mitem->mtime = (time_t) p_md_record->modified_date;
+
+	_mb_svc_get_file_ext(p_md_record->display_name, ext);
+	mitem->ext = _media_svc_arena_strdup(arena, ext);
+
+	mitem->type = p_md_record->content_type;
+	mitem->display_name = _media_svc_arena_strdup(arena, p_md_record->display_name);
+	mitem->rate = p_md_record->rate;
+	mitem->size = p_md_record->size;
+	mitem->meta_info = NULL;
+	mitem->_reserved = mlist;
+
+	if (mitem->uuid == NULL || mitem->cluster_uuid == NULL || mitem->file_url == NULL ||
+		mitem->thumb_url == NULL || mitem->ext == NULL || mitem->display_name == NULL) {
+		return MB_SVC_ERROR_OUT_OF_MEMORY;
+	}
+
+	if (with_meta) {
+		mitem->meta_info = _minfo_mlist_new_meta(mb_svc_handle, mlist, mitem->uuid, p_md_record);
+	}
+
+	return _minfo_mlist_push(mlist, mitem);
+}
+
+int minfo_mlist_append_cluster(MediaSvcHandle *mb_svc_handle, Mlist *list, mb_svc_folder_record_s *p_fd_record)
+{
+	minfo_mlist_s *mlist = (minfo_mlist_s *)list;
+	media_svc_arena_s *arena = &mlist->arena;
+	Mcluster *mcluster = NULL;
+
+	mcluster = _media_svc_arena_alloc(arena, sizeof(Mcluster));
+	if (mcluster == NULL) {
+		return MB_SVC_ERROR_OUT_OF_MEMORY;
+	}
+
+	/* the folder record got from iterator is used as is, no need to query it again by uuid */
+	mcluster->gtype = MINFO_TYPE_MCLUSTER;
+	mcluster->uuid = _media_svc_arena_strdup(arena, p_fd_record->uuid);
+	mcluster->thumb_url = NULL;
+	mcluster->mtime = (time_t) p_fd_record->modified_date;
+	mcluster->type = p_fd_record->storage_type;
+	mcluster->display_name = _media_svc_arena_strdup(arena, p_fd_record->display_name);
+	mcluster->count = mb_svc_get_folder_content_count_by_folder_id(mb_svc_handle, p_fd_record->uuid);
+	mcluster->sns_type = p_fd_record->sns_type;
+	mcluster->account_id = _media_svc_arena_strdup(arena, p_fd_record->web_account_id);
+	mcluster->lock_status = p_fd_record->lock_status;
+	mcluster->web_album_id = _media_svc_arena_strdup(arena, p_fd_record->web_album_id);
+	mcluster->_reserved = mlist;
+
+	if (mcluster->uuid == NULL || mcluster->display_name == NULL ||
+		mcluster->account_id == NULL || mcluster->web_album_id == NULL) {
+		return MB_SVC_ERROR_OUT_OF_MEMORY;
+	}
+
+	return _minfo_mlist_push(mlist, mcluster);
+}
+
+void minfo_mlist_destroy(Mlist *list)
+{
+	minfo_mlist_s *mlist = (minfo_mlist_s *)list;
+	Mitem *mitem = NULL;
+	Mvideo *mvideo = NULL;
+	GList *iter = NULL;
+	int i = 0;
+
+	if (list == NULL || !IS_MINFO_MLIST(list)) {
+		return;
+	}
+
+	for (i = 0; i < list->count; i++) {
+		mitem = (Mitem *)list->items[i];
+		if (!IS_MINFO_MITEM(mitem) || mitem->meta_info == NULL) {
+			continue;
+		}
+		if (mitem->meta_info->type != MINFO_ITEM_VIDEO || mitem->meta_info->video_info == NULL) {
+			continue;
+		}
+
+		mvideo = mitem->meta_info->video_info;
+		for (iter = mvideo->bookmarks; iter != NULL; iter = iter->next) {
+			minfo_mbookmark_destroy((Mbookmark *)iter->data);
+		}
+		g_list_free(mvideo->bookmarks);
+	}
+
+	_media_svc_arena_destroy(&mlist->arena);
+	SAFE_FREE(list->items);
+	list->gtype = 0;
+	free(mlist);
+}
@@ -22,6 +22,7 @@
 #include "minfo-meta.h"
 #include "visual-svc.h"
 #include "minfo-bookmark.h"
+#include "minfo-list.h"
 #include "media-svc-api.h"
 #include "visual-svc-util.h"
 #include "visual-svc-debug.h"
@@ -151,6 +152,10 @@ Mmeta *minfo_mmeta_new(MediaSvcHandle *mb_svc_handle, const char *media_uuid, mb
 void minfo_mmeta_destroy(Mmeta *mmeta)
 {
 	if (mmeta != NULL && IS_MINFO_MMETA(mmeta)) {
+		if (MINFO_OWNED_BY_MLIST(mmeta)) {
+			/* freed with its Mlist */
+			return;
+		}
 		if (mmeta->type == MINFO_ITEM_IMAGE && mmeta->image_info) {
 			minfo_mimage_destroy(mmeta->image_info);
 		}
@@ -286,6 +291,10 @@ void minfo_mvideo_destroy(Mvideo *mvideo)
 	int i = 0;
 	Mbookmark *bookmark;
 	if (mvideo != NULL && IS_MINFO_MVIDEO(mvideo)) {
+		if (MINFO_OWNED_BY_MLIST(mvideo)) {
+			/* freed with its Mlist */
+			return;
+		}
 		if (mvideo->album_name) {
 			free(mvideo->album_name);
 		}
@@ -362,6 +371,10 @@ Mimage *minfo_mimage_new(MediaSvcHandle *mb_svc_handle, const char *id)
 void minfo_mimage_destroy(Mimage *mimage)
 {
 	if (mimage != NULL && IS_MINFO_MIMAGE(mimage)) {
+		if (MINFO_OWNED_BY_MLIST(mimage)) {
+			/* freed with its Mlist */
+			return;
+		}
 		free(mimage);
 		mimage = NULL;
 	}
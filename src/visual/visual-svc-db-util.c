@@ -25,10 +25,13 @@
 
 #include <sqlite3.h>
 #include "media-svc-util.h"
+#include "media-svc-db-utils.h"
 #include "visual-svc-util.h"
 #include "visual-svc-db-util.h"
 #include "visual-svc-debug.h"
 #include "visual-svc-error.h"
+#include "visual-svc-db.h"
+#include "media-svc-error.h"
 
 int mb_svc_query_sql_gstring(MediaSvcHandle *mb_svc_handle, GString *query_string)
 {
@@ -103,7 +106,7 @@ int mb_svc_sqlite3_begin_trans(MediaSvcHandle *mb_svc_handle)
 
 	mb_svc_debug("mb_svc_sqlite3_begin_trans enter\n");
 	if (SQLITE_OK !=
-	    sqlite3_exec(handle, "BEGIN IMMEDIATE;", NULL, NULL, &err_msg)) {
+	    _media_svc_sql_trans(handle, MEDIA_SVC_TRANS_BEGIN, &err_msg)) {
 		mb_svc_debug("Error:failed to begin transaction: error=%s\n",
 			     err_msg);
 		sqlite3_free(err_msg);
@@ -125,7 +128,7 @@ int mb_svc_sqlite3_commit_trans(MediaSvcHandle *mb_svc_handle)
 	}
 
 	mb_svc_debug("mb_svc_sqlite3_commit_trans enter\n");
-	if (SQLITE_OK != sqlite3_exec(handle, "COMMIT;", NULL, NULL, &err_msg)) {
+	if (SQLITE_OK != _media_svc_sql_trans(handle, MEDIA_SVC_TRANS_COMMIT, &err_msg)) {
 		mb_svc_debug("Error:failed to end transaction: error=%s\n",
 			     err_msg);
 		sqlite3_free(err_msg);
@@ -148,7 +151,7 @@ int mb_svc_sqlite3_rollback_trans(MediaSvcHandle *mb_svc_handle)
 
 	mb_svc_debug("mb_svc_sqlite3_rollback_trans enter\n");
 	if (SQLITE_OK !=
-	    sqlite3_exec(handle, "ROLLBACK;", NULL, NULL, &err_msg)) {
+	    _media_svc_sql_trans(handle, MEDIA_SVC_TRANS_ROLLBACK, &err_msg)) {
 		mb_svc_debug("Error:failed to rollback transaction: error=%s\n",
 			     err_msg);
 		sqlite3_free(err_msg);
@@ -167,15 +170,40 @@ void mb_svc_sql_list_add(GList **list, char **sql)
 void mb_svc_sql_list_release(GList **sql_list)
 {
 	if (*sql_list) {
-		int i = 0;
-		char *sql = NULL;
-		for (i = 0; i < g_list_length(*sql_list); i++) {
-			sql = (char*)g_list_nth_data(*sql_list, i);
-			if (sql) sqlite3_free(sql);
-			sql = NULL;
+		GList *iter = NULL;
+		for (iter = *sql_list; iter != NULL; iter = g_list_next(iter)) {
+			if (iter->data) sqlite3_free(iter->data);
+			iter->data = NULL;
 		}
 
 		g_list_free(*sql_list);
 		*sql_list = NULL;
 	}
 }
+
+media_svc_batch_s *mb_svc_get_batch(MediaSvcHandle *mb_svc_handle, media_svc_query_type_e query_type)
+{
+	if (mb_svc_handle == NULL) {
+		mb_svc_debug("handle is NULL");
+		return NULL;
+	}
+
+	return _media_svc_db_ctx_get_batch((sqlite3 *)mb_svc_handle, MEDIA_SVC_BATCH_OWNER_VISUAL, query_type);
+}
+
+int mb_svc_sql_list_query_do(MediaSvcHandle *mb_svc_handle, media_svc_query_type_e query_type)
+{
+	media_svc_batch_s *batch = NULL;
+	GList *iter = NULL;
+
+	batch = mb_svc_get_batch(mb_svc_handle, query_type);
+	if (batch == NULL)
+		return MB_SVC_ERROR_INVALID_PARAMETER;
+
+	for (iter = batch->query_list; iter != NULL; iter = g_list_next(iter))
+		mb_svc_query_sql(mb_svc_handle, (char *)iter->data);
+
+	mb_svc_sql_list_release(&batch->query_list);
+
+	return 0;
+}
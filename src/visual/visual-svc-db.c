@@ -24,6 +24,7 @@
 #include <sys/stat.h>
 #include "media-svc-env.h"
 #include "media-svc-util.h"
+#include "media-svc-error.h"
 #include "visual-svc-db.h"
 #include "visual-svc-debug.h"
 #include "visual-svc-db-util.h"
@@ -380,26 +381,33 @@ int field_num_max[MB_SVC_TABLE_CNT_MAX] = { MB_SVC_BOOKMARK_NUM,
 	MB_SVC_TAG_NUM
 };
 
-static __thread GList *g_sql_list = NULL;
-static __thread char g_last_updated_folder_uuid[MB_SVC_UUID_LEN_MAX + 1] = {0,};
-
 static int __mb_svc_delete_record(MediaSvcHandle *mb_svc_handle, int id, mb_svc_tbl_name_e tbl_name);
 static int __mb_svc_delete_record_by_uuid(MediaSvcHandle *mb_svc_handle, const char *id, mb_svc_tbl_name_e tbl_name);
 static int __mb_svc_db_get_next_id(MediaSvcHandle *mb_svc_handle, int table_id);
 
 
-void mb_svc_init_last_updated_folder_uuid()
+void mb_svc_init_last_updated_folder_uuid(MediaSvcHandle *mb_svc_handle)
 {
-	/* Initialize g_last_updated_folder_uuid */
-	memset(g_last_updated_folder_uuid, 0x00, sizeof(g_last_updated_folder_uuid));
+	media_svc_db_ctx_s *ctx = NULL;
+
+	ctx = _media_svc_db_ctx_get((sqlite3 *)mb_svc_handle);
+	if (ctx == NULL)
+		return;
+
+	memset(ctx->last_updated_folder_uuid, 0x00, sizeof(ctx->last_updated_folder_uuid));
 
 	return;
 }
 
-int mb_svc_set_folder_as_valid_sql_add(const char *folder_id, int valid)
+int mb_svc_set_folder_as_valid_sql_add(MediaSvcHandle *mb_svc_handle, const char *folder_id, int valid)
 {
 	mb_svc_debug("Folder ID:%s, valid:%d", folder_id, valid);
 	char *sql = NULL;
+	media_svc_batch_s *batch = NULL;
+
+	batch = mb_svc_get_batch(mb_svc_handle, MEDIA_SVC_QUERY_SET_ITEM_VALIDITY);
+	if (batch == NULL)
+		return MB_SVC_ERROR_INVALID_PARAMETER;
 
 	mb_svc_tbl_name_e field_seq = MB_SVC_TABLE_FOLDER;
 
@@ -414,7 +422,7 @@ int mb_svc_set_folder_as_valid_sql_add(const char *folder_id, int valid)
 										valid,
 										folder_id);
 
-	mb_svc_sql_list_add(&g_sql_list, &sql);
+	mb_svc_sql_list_add(&batch->query_list, &sql);
 
 	return 0;
 }
@@ -424,6 +432,8 @@ int mb_svc_set_item_as_valid_sql_add(MediaSvcHandle *mb_svc_handle, const char *
 	mb_svc_debug("full path: %s, valid:%d", full_path, valid);
 
 	mb_svc_media_record_s media_record = {"",};
+	media_svc_batch_s *batch = NULL;
+	media_svc_db_ctx_s *ctx = NULL;
 	int ret = -1;
 
 	if (full_path == NULL) {
@@ -431,6 +441,14 @@ int mb_svc_set_item_as_valid_sql_add(MediaSvcHandle *mb_svc_handle, const char *
 		return MB_SVC_ERROR_INVALID_PARAMETER;
 	}
 
+	batch = mb_svc_get_batch(mb_svc_handle, MEDIA_SVC_QUERY_SET_ITEM_VALIDITY);
+	if (batch == NULL)
+		return MB_SVC_ERROR_INVALID_PARAMETER;
+
+	ctx = _media_svc_db_ctx_get((sqlite3 *)mb_svc_handle);
+	if (ctx == NULL)
+		return MB_SVC_ERROR_INVALID_PARAMETER;
+
 	ret = mb_svc_get_media_record_by_full_path(mb_svc_handle, full_path, &media_record);
 	if (ret < 0) {
 		mb_svc_debug(" mb_svc_get_media_record_by_full_path fails (%d)", ret);
@@ -451,13 +469,13 @@ int mb_svc_set_item_as_valid_sql_add(MediaSvcHandle *mb_svc_handle, const char *
 	    sqlite3_mprintf(MB_SVC_UPDATE_MEDIA_VALID_BY_UUID, table_name, valid,
 			    media_record.media_uuid);
 
-	mb_svc_sql_list_add(&g_sql_list, &sql);
+	mb_svc_sql_list_add(&batch->query_list, &sql);
 
-	if ((valid == 1) && (strcmp(g_last_updated_folder_uuid, media_record.folder_uuid) != 0)) {
-		strncpy(g_last_updated_folder_uuid, media_record.folder_uuid, MB_SVC_UUID_LEN_MAX + 1);
+	if ((valid == 1) && (strcmp(ctx->last_updated_folder_uuid, media_record.folder_uuid) != 0)) {
+		strncpy(ctx->last_updated_folder_uuid, media_record.folder_uuid, sizeof(ctx->last_updated_folder_uuid) - 1);
 
 		ret =
-		    mb_svc_set_folder_as_valid_sql_add(media_record.folder_uuid, valid);
+		    mb_svc_set_folder_as_valid_sql_add(mb_svc_handle, media_record.folder_uuid, valid);
 		if (ret < 0) {
 			mb_svc_debug
 			    ("mb_svc_update_folder_valid_sql_add fail:%d\n", ret);
@@ -471,17 +489,8 @@ int mb_svc_set_item_as_valid_sql_add(MediaSvcHandle *mb_svc_handle, const char *
 int mb_svc_set_item_as_valid(MediaSvcHandle *mb_svc_handle)
 {
 	mb_svc_debug("");
-	int i = 0;
-	int length = g_list_length(g_sql_list);
-
-	for (i = 0; i < length; i++) {
-		char *sql = (char*)g_list_nth_data(g_sql_list, i);
-		mb_svc_query_sql(mb_svc_handle, sql);
-	}
 
-	mb_svc_sql_list_release(&g_sql_list);
-
-	return 0;
+	return mb_svc_sql_list_query_do(mb_svc_handle, MEDIA_SVC_QUERY_SET_ITEM_VALIDITY);
 }
 
 mb_svc_tbl_s *mb_svc_search_matched_svc_tbl(mb_svc_tbl_name_e tbl_name)
@@ -819,7 +828,10 @@ int mb_svc_insert_record_folder(MediaSvcHandle *mb_svc_handle, mb_svc_folder_rec
 	mb_svc_tbl_name_e field_seq = MB_SVC_TABLE_FOLDER;
 	mb_svc_field = mb_svc_tbl[field_seq].mb_svc_field;
 
-	strncpy(record->uuid, _media_info_generate_uuid(), MB_SVC_UUID_LEN_MAX + 1);
+	if (_media_svc_generate_uuid(record->uuid, MB_SVC_UUID_LEN_MAX + 1) != MEDIA_INFO_ERROR_NONE) {
+		mb_svc_debug("_media_svc_generate_uuid failed");
+		return MB_SVC_ERROR_INTERNAL;
+	}
 
 	query_string =
 	    sqlite3_mprintf(MB_SVC_INSERT_FOLDER_TABLE,
@@ -871,7 +883,10 @@ int mb_svc_insert_record_folder_sql(mb_svc_folder_record_s *record, char **sql)
 	mb_svc_tbl_name_e field_seq = MB_SVC_TABLE_FOLDER;
 	mb_svc_field = mb_svc_tbl[field_seq].mb_svc_field;
 
-	strncpy(record->uuid, _media_info_generate_uuid(), MB_SVC_UUID_LEN_MAX + 1);
+	if (_media_svc_generate_uuid(record->uuid, MB_SVC_UUID_LEN_MAX + 1) != MEDIA_INFO_ERROR_NONE) {
+		mb_svc_debug("_media_svc_generate_uuid failed");
+		return MB_SVC_ERROR_INTERNAL;
+	}
 
 	*sql =
 	    sqlite3_mprintf(MB_SVC_INSERT_FOLDER_TABLE,
@@ -969,7 +984,10 @@ int mb_svc_insert_record_media(MediaSvcHandle *mb_svc_handle, mb_svc_media_recor
 	mb_svc_tbl_name_e field_seq = MB_SVC_TABLE_MEDIA;
 	mb_svc_field = mb_svc_tbl[field_seq].mb_svc_field;
 
-	strncpy(record->media_uuid, _media_info_generate_uuid(), MB_SVC_UUID_LEN_MAX + 1);
+	if (_media_svc_generate_uuid(record->media_uuid, MB_SVC_UUID_LEN_MAX + 1) != MEDIA_INFO_ERROR_NONE) {
+		mb_svc_debug("_media_svc_generate_uuid failed");
+		return MB_SVC_ERROR_INTERNAL;
+	}
 
 	query_string =
 	    sqlite3_mprintf(MB_SVC_INSERT_MEDIA_TABLE,
@@ -1021,7 +1039,10 @@ int mb_svc_insert_record_media_sql(mb_svc_media_record_s *record,
 	mb_svc_tbl_name_e field_seq = MB_SVC_TABLE_MEDIA;
 	mb_svc_field = mb_svc_tbl[field_seq].mb_svc_field;
 
-	strncpy(record->media_uuid, _media_info_generate_uuid(), MB_SVC_UUID_LEN_MAX + 1);
+	if (_media_svc_generate_uuid(record->media_uuid, MB_SVC_UUID_LEN_MAX + 1) != MEDIA_INFO_ERROR_NONE) {
+		mb_svc_debug("_media_svc_generate_uuid failed");
+		return MB_SVC_ERROR_INTERNAL;
+	}
 
 	*sql =
 	    sqlite3_mprintf(MB_SVC_INSERT_MEDIA_TABLE,
@@ -2342,8 +2363,8 @@ mb_svc_set_media_records_as_valid(MediaSvcHandle *mb_svc_handle, const minfo_sto
 
 	int err;
 	char *sql =
-	    sqlite3_mprintf("update %s set valid = %d where storage_type = %d;",
-			    table_name, valid, storage_type);
+	    sqlite3_mprintf("update %s set valid = %d where storage_type = %d and valid != %d;",
+			    table_name, valid, storage_type, valid);
 	err = mb_svc_query_sql(mb_svc_handle, sql);
 	sqlite3_free(sql);
 	if (err != SQLITE_OK) {
@@ -2386,8 +2407,8 @@ mb_svc_set_media_records_as_valid(MediaSvcHandle *mb_svc_handle, const minfo_sto
 		/* 3. then set every reords as valid/invalid in 'media' table */
 		sql =
 		    sqlite3_mprintf
-		    ("update %s set valid = %d where folder_uuid = '%s';",
-		     table_name, valid, folder_uuid);
+		    ("update %s set valid = %d where folder_uuid = '%s' and valid != %d;",
+		     table_name, valid, folder_uuid, valid);
 		err = mb_svc_query_sql(mb_svc_handle, sql);
 		sqlite3_free(sql);
 		if (err != SQLITE_OK) {
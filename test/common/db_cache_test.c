@@ -0,0 +1,296 @@
+/*
+ * libmedia-service
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Hyunjun Ko <zzoon.ko@samsung.com>, Haejeong Kim <backto.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * Checks statement cache, count cache, change log and scan session of a handle, on a database made in a temporary file.
+ * Usage : db_cache_test [db path]
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sqlite3.h>
+#include "media-svc-error.h"
+#include "media-svc-env.h"
+#include "media-svc-db-ctx.h"
+#include "media-svc-db-utils.h"
+#include "media-svc-media.h"
+
+#define DEFAULT_DB_PATH	"/tmp/.media_svc_db_cache_test.db"
+
+static int g_failed = 0;
+
+#define CHECK(cond) do { \
+		if (!(cond)) { \
+			fprintf(stderr, "%s:%d: check failed: %s\n", __FUNCTION__, __LINE__, #cond); \
+			g_failed++; \
+		} \
+	} while (0)
+
+/* a statement is alive until it is finalized */
+static int __stmt_alive(sqlite3 *db, sqlite3_stmt *stmt)
+{
+	sqlite3_stmt *iter = NULL;
+
+	while ((iter = sqlite3_next_stmt(db, iter)) != NULL) {
+		if (iter == stmt)
+			return 1;
+	}
+
+	return 0;
+}
+
+static void __test_stmt_cache(sqlite3 *db)
+{
+	sqlite3_stmt *first = NULL;
+	sqlite3_stmt *stmt = NULL;
+	sqlite3_stmt *busy = NULL;
+	sqlite3_stmt *lru = NULL;
+	char sql[64] = {0, };
+	int i = 0;
+
+	/* released statement is reused */
+	CHECK(_media_svc_db_ctx_prepare_stmt(db, "SELECT 0", &first) == SQLITE_OK);
+	CHECK(_media_svc_db_ctx_release_stmt(first) == SQLITE_OK);
+	CHECK(_media_svc_db_ctx_prepare_stmt(db, "SELECT 0", &stmt) == SQLITE_OK);
+	CHECK(stmt == first);
+
+	/* statement in use is not shared, and the other one is finalized by release */
+	CHECK(_media_svc_db_ctx_prepare_stmt(db, "SELECT 0", &busy) == SQLITE_OK);
+	CHECK(busy != first);
+	CHECK(_media_svc_db_ctx_release_stmt(busy) == SQLITE_OK);
+	CHECK(!__stmt_alive(db, busy));
+	CHECK(_media_svc_db_ctx_release_stmt(stmt) == SQLITE_OK);
+	CHECK(__stmt_alive(db, first));
+
+	/* fill the cache. "SELECT 1" is the least recently used after "SELECT 0" is used again */
+	for (i = 1; i < MEDIA_SVC_STMT_CACHE_MAX; i++) {
+		snprintf(sql, sizeof(sql), "SELECT %d", i);
+		CHECK(_media_svc_db_ctx_prepare_stmt(db, sql, &stmt) == SQLITE_OK);
+		if (i == 1)
+			lru = stmt;
+		_media_svc_db_ctx_release_stmt(stmt);
+	}
+
+	CHECK(_media_svc_db_ctx_prepare_stmt(db, "SELECT 0", &stmt) == SQLITE_OK);
+	CHECK(stmt == first);
+	_media_svc_db_ctx_release_stmt(stmt);
+
+	/* new statement evicts the least recently used one */
+	CHECK(_media_svc_db_ctx_prepare_stmt(db, "SELECT 'new'", &stmt) == SQLITE_OK);
+	_media_svc_db_ctx_release_stmt(stmt);
+	CHECK(__stmt_alive(db, stmt));
+	CHECK(!__stmt_alive(db, lru));
+	CHECK(__stmt_alive(db, first));
+}
+
+static void __test_count_cache(sqlite3 *db, sqlite3 *other)
+{
+	int count = 0;
+
+	CHECK(sqlite3_exec(db, "CREATE TABLE IF NOT EXISTS count_test (x)", NULL, NULL, NULL) == SQLITE_OK);
+
+	CHECK(!_media_svc_db_ctx_get_count(db, "key", &count));
+	_media_svc_db_ctx_set_count(db, "key", 7);
+	CHECK(_media_svc_db_ctx_get_count(db, "key", &count));
+	CHECK(count == 7);
+
+	/* change of this connection */
+	CHECK(sqlite3_exec(db, "INSERT INTO count_test VALUES (1)", NULL, NULL, NULL) == SQLITE_OK);
+	CHECK(!_media_svc_db_ctx_get_count(db, "key", &count));
+
+	/* change of other connection */
+	_media_svc_db_ctx_set_count(db, "key", 8);
+	CHECK(_media_svc_db_ctx_get_count(db, "key", &count));
+	CHECK(sqlite3_exec(other, "INSERT INTO count_test VALUES (2)", NULL, NULL, NULL) == SQLITE_OK);
+	CHECK(!_media_svc_db_ctx_get_count(db, "key", &count));
+
+	/* count cached in a savepoint which is rolled back */
+	CHECK(sqlite3_exec(db, "BEGIN", NULL, NULL, NULL) == SQLITE_OK);
+	CHECK(_media_svc_sql_trans(db, MEDIA_SVC_TRANS_BEGIN, NULL) == SQLITE_OK);
+	CHECK(sqlite3_exec(db, "INSERT INTO count_test VALUES (3)", NULL, NULL, NULL) == SQLITE_OK);
+	CHECK(!_media_svc_db_ctx_get_count(db, "key", &count));
+	_media_svc_db_ctx_set_count(db, "key", 3);
+	CHECK(_media_svc_sql_trans(db, MEDIA_SVC_TRANS_ROLLBACK, NULL) == SQLITE_OK);
+	CHECK(!_media_svc_db_ctx_get_count(db, "key", &count));
+	CHECK(sqlite3_exec(db, "COMMIT", NULL, NULL, NULL) == SQLITE_OK);
+}
+
+static void __test_changes(sqlite3 *db)
+{
+	media_svc_change_s changes[16];
+	long long version = 0;
+	int count = 0;
+	int i = 0;
+
+	CHECK(_media_svc_create_storage_table(db) == MEDIA_INFO_ERROR_NONE);
+	CHECK(_media_svc_create_folder_table(db) == MEDIA_INFO_ERROR_NONE);
+	CHECK(_media_svc_create_media_table(db) == MEDIA_INFO_ERROR_NONE);
+	CHECK(_media_svc_create_change_log_table(db) == MEDIA_INFO_ERROR_NONE);
+
+	CHECK(_media_svc_get_change_version(db, &version) == MEDIA_INFO_ERROR_NONE);
+	CHECK(version == 0);
+
+	CHECK(sqlite3_exec(db, "INSERT INTO "MEDIA_SVC_DB_TABLE_FOLDER" (folder_uuid, path, name, storage_type) VALUES ('f', '/f', 'f', 0);"
+			"INSERT INTO "MEDIA_SVC_DB_TABLE_MEDIA" (media_uuid, path, file_name, folder_uuid, storage_type) VALUES ('m', '/f/m', 'm', 'f', 0);",
+			NULL, NULL, NULL) == SQLITE_OK);
+
+	CHECK(_media_svc_get_change_version(db, &version) == MEDIA_INFO_ERROR_NONE);
+	CHECK(_media_svc_get_changes(db, version - 1, changes, 16, &count) == MEDIA_INFO_ERROR_NONE);
+	CHECK(count == 1);
+	CHECK(changes[0].version == version);
+	CHECK(changes[0].change_type == MEDIA_SVC_CHANGE_INSERT);
+	CHECK(changes[0].source == MEDIA_SVC_CHANGE_SOURCE_MEDIA);
+	CHECK(strcmp(changes[0].media_uuid, "m") == 0);
+
+	/* up to date, and newer than database */
+	CHECK(_media_svc_get_changes(db, version, changes, 16, &count) == MEDIA_INFO_ERROR_NONE);
+	CHECK(count == 0);
+	CHECK(_media_svc_get_changes(db, version + 1, changes, 16, &count) == MEDIA_INFO_ERROR_DATABASE_INVALID);
+
+	/* update setting the same value is not logged */
+	CHECK(sqlite3_exec(db, "UPDATE "MEDIA_SVC_DB_TABLE_MEDIA" SET title=title, path=path WHERE media_uuid='m'", NULL, NULL, NULL) == SQLITE_OK);
+	CHECK(_media_svc_get_changes(db, version, changes, 16, &count) == MEDIA_INFO_ERROR_NONE);
+	CHECK(count == 0);
+
+	/* legacy audio table */
+	CHECK(sqlite3_exec(db, "CREATE TABLE audio_media_data (audio_uuid PRIMARY KEY, path, thumbnail_path, title, album_dict_id, \
+			artist_dict_id, genre_dict_id, author_dict_id, year_dict_id, copyright, description, format, bitrate, track_num, duration, \
+			rating, played_count, last_played_time, rated_time, album_rating, modified_date, size, category, valid, folder_uuid, \
+			storage_type, favourite)", NULL, NULL, NULL) == SQLITE_OK);
+	CHECK(_media_svc_create_legacy_change_log_table(db, "audio_media_data") == MEDIA_INFO_ERROR_NONE);
+	CHECK(sqlite3_exec(db, "INSERT INTO audio_media_data (audio_uuid, path, valid, storage_type) VALUES ('a', '/f/a', 1, 1);"
+			"UPDATE audio_media_data SET album_dict_id=1 WHERE audio_uuid='a';"
+			"UPDATE audio_media_data SET album_dict_id=1 WHERE audio_uuid='a';"
+			"UPDATE audio_media_data SET valid=0 WHERE audio_uuid='a';"
+			"DELETE FROM audio_media_data WHERE audio_uuid='a';", NULL, NULL, NULL) == SQLITE_OK);
+	CHECK(_media_svc_get_changes(db, version, changes, 16, &count) == MEDIA_INFO_ERROR_NONE);
+	CHECK(count == 4);
+	CHECK(changes[0].change_type == MEDIA_SVC_CHANGE_INSERT);
+	CHECK(changes[0].source == MEDIA_SVC_CHANGE_SOURCE_AUDIO);
+	CHECK(changes[0].storage_type == 1);
+	CHECK(strcmp(changes[0].media_uuid, "a") == 0);
+	CHECK(changes[1].change_type == MEDIA_SVC_CHANGE_UPDATE);
+	CHECK(changes[2].change_type == MEDIA_SVC_CHANGE_UPDATE);
+	CHECK(changes[3].change_type == MEDIA_SVC_CHANGE_DELETE);
+	CHECK(changes[3].source == MEDIA_SVC_CHANGE_SOURCE_AUDIO);
+
+	/* log more changes than kept, so the oldest ones are truncated */
+	CHECK(sqlite3_exec(db, "BEGIN", NULL, NULL, NULL) == SQLITE_OK);
+	for (i = 0; i < MEDIA_SVC_CHANGE_LOG_MAX + MEDIA_SVC_CHANGE_LOG_TRUNCATE_STEP; i++)
+		sqlite3_exec(db, "UPDATE "MEDIA_SVC_DB_TABLE_MEDIA" SET title=ifnull(title, '') || 'x' WHERE media_uuid='m'", NULL, NULL, NULL);
+	CHECK(sqlite3_exec(db, "COMMIT", NULL, NULL, NULL) == SQLITE_OK);
+
+	CHECK(_media_svc_get_changes(db, 0, changes, 16, &count) == MEDIA_INFO_ERROR_DATABASE_INVALID);
+	CHECK(count == 0);
+
+	CHECK(_media_svc_get_change_version(db, &version) == MEDIA_INFO_ERROR_NONE);
+	CHECK(_media_svc_get_changes(db, version - MEDIA_SVC_CHANGE_LOG_MAX, changes, 16, &count) == MEDIA_INFO_ERROR_NONE);
+	CHECK(count == 16);
+	CHECK(changes[0].version == version - MEDIA_SVC_CHANGE_LOG_MAX + 1);
+	CHECK(changes[0].change_type == MEDIA_SVC_CHANGE_UPDATE);
+}
+
+static void __test_scan_session(sqlite3 *db, sqlite3 *other)
+{
+	media_svc_db_ctx_s *ctx = _media_svc_db_ctx_get(db);
+	media_svc_db_ctx_s *other_ctx = _media_svc_db_ctx_create(other);
+
+	CHECK(other_ctx != NULL);
+	if (other_ctx == NULL)
+		return;
+
+	/* requested session is held by the first handle entered on this thread only */
+	_media_svc_scan_update_begin();
+	CHECK(_media_svc_scan_session_enter(db) == MEDIA_INFO_ERROR_NONE);
+	CHECK(ctx->scan_session && ctx->scan_open);
+	CHECK(_media_svc_scan_session_enter(other) == MEDIA_INFO_ERROR_NONE);
+	CHECK(!other_ctx->scan_session);
+
+	/* lock is kept by leave until it is held longer than target */
+	ctx->max_lock_hold_usec = 1000000000;
+	CHECK(sqlite3_exec(db, "INSERT INTO count_test VALUES (10)", NULL, NULL, NULL) == SQLITE_OK);
+	CHECK(_media_svc_scan_session_leave(db) == MEDIA_INFO_ERROR_NONE);
+	CHECK(!sqlite3_get_autocommit(db));
+
+	ctx->max_lock_hold_usec = 0;
+	CHECK(_media_svc_scan_session_leave(db) == MEDIA_INFO_ERROR_NONE);
+	CHECK(sqlite3_get_autocommit(db));
+	CHECK(!ctx->scan_open);
+	CHECK(sqlite3_exec(other, "INSERT INTO count_test VALUES (11)", NULL, NULL, NULL) == SQLITE_OK);
+
+	CHECK(_media_svc_scan_session_enter(db) == MEDIA_INFO_ERROR_NONE);
+	CHECK(ctx->scan_open && !sqlite3_get_autocommit(db));
+
+	/* transaction rolled back underneath is reported once, and the session goes on */
+	CHECK(sqlite3_exec(db, "ROLLBACK", NULL, NULL, NULL) == SQLITE_OK);
+	CHECK(_media_svc_scan_session_enter(db) == MEDIA_INFO_ERROR_DATABASE_INTERNAL);
+	CHECK(_media_svc_scan_session_enter(db) == MEDIA_INFO_ERROR_NONE);
+	CHECK(ctx->scan_open);
+
+	/* update end does not end sessions begun by other callers, and reports the lost work */
+	CHECK(sqlite3_exec(db, "ROLLBACK", NULL, NULL, NULL) == SQLITE_OK);
+	CHECK(_media_svc_scan_session_begin(other) == MEDIA_INFO_ERROR_NONE);
+	CHECK(sqlite3_exec(other, "ROLLBACK", NULL, NULL, NULL) == SQLITE_OK);
+	CHECK(_media_svc_scan_update_end() == MEDIA_INFO_ERROR_DATABASE_INTERNAL);
+	CHECK(!ctx->scan_session && !ctx->scan_open);
+	CHECK(other_ctx->scan_session);
+	CHECK(_media_svc_scan_session_end(other) == MEDIA_INFO_ERROR_DATABASE_INTERNAL);
+	CHECK(!other_ctx->scan_session);
+
+	/* no session is begun after update end */
+	CHECK(_media_svc_scan_session_enter(db) == MEDIA_INFO_ERROR_NONE);
+	CHECK(!ctx->scan_session && sqlite3_get_autocommit(db));
+
+	_media_svc_db_ctx_destroy(other);
+}
+
+int main(int argc, char *argv[])
+{
+	const char *path = (argc > 1) ? argv[1] : DEFAULT_DB_PATH;
+	sqlite3 *db = NULL;
+	sqlite3 *other = NULL;
+
+	remove(path);
+
+	if (sqlite3_open(path, &db) != SQLITE_OK || sqlite3_open(path, &other) != SQLITE_OK) {
+		fprintf(stderr, "failed to open [%s]\n", path);
+		return 1;
+	}
+
+	if (_media_svc_db_ctx_create(db) == NULL) {
+		fprintf(stderr, "failed to create context\n");
+		return 1;
+	}
+
+	__test_stmt_cache(db);
+	__test_count_cache(db, other);
+	__test_changes(db);
+	__test_scan_session(db, other);
+
+	_media_svc_db_ctx_destroy(db);
+	sqlite3_close(other);
+	sqlite3_close(db);
+	remove(path);
+
+	printf("db cache test : %d failed\n", g_failed);
+
+	return (g_failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,204 @@
+/*
+ * libmedia-service
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Hyunjun Ko <zzoon.ko@samsung.com>, Haejeong Kim <backto.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * Migrates a database of old version, of which playlist_map, tag_map and media refer unknown media or folder,
+ * visual tables without folder_id, and change log without source.
+ * Usage : db_migrate_test [db path]
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sqlite3.h>
+#include "media-svc-error.h"
+#include "media-svc-env.h"
+#include "media-svc-db-ctx.h"
+#include "media-svc-db-utils.h"
+
+#define DEFAULT_DB_PATH	"/tmp/.media_svc_db_migrate_test.db"
+
+static int g_failed = 0;
+
+#define CHECK(cond) do { \
+		if (!(cond)) { \
+			fprintf(stderr, "%s:%d: check failed: %s\n", __FUNCTION__, __LINE__, #cond); \
+			g_failed++; \
+		} \
+	} while (0)
+
+/* tables of old version, where media and maps refer media_uuid and folder_uuid */
+static const char *g_old_schema =
+	"CREATE TABLE folder (folder_uuid TEXT PRIMARY KEY, path TEXT NOT NULL UNIQUE, name TEXT NOT NULL, "
+	"modified_time INTEGER DEFAULT 0, storage_type INTEGER, unique(path, name));"
+	"CREATE TABLE media (media_uuid TEXT PRIMARY KEY, path TEXT NOT NULL UNIQUE, file_name TEXT NOT NULL, media_type INTEGER, "
+	"mime_type TEXT, size INTEGER DEFAULT 0, added_time INTEGER DEFAULT 0, modified_time INTEGER DEFAULT 0, folder_uuid TEXT NOT NULL, "
+	"thumbnail_path TEXT, title TEXT, album_id INTEGER DEFAULT 0, album TEXT, artist TEXT, genre TEXT, composer TEXT, year TEXT, "
+	"recorded_date TEXT, copyright TEXT, track_num TEXT, description TEXT, bitrate INTEGER DEFAULT -1, samplerate INTEGER DEFAULT -1, "
+	"channel INTEGER DEFAULT -1, duration INTEGER DEFAULT -1, longitude DOUBLE DEFAULT 0, latitude DOUBLE DEFAULT 0, "
+	"altitude DOUBLE DEFAULT 0, width INTEGER DEFAULT -1, height INTEGER DEFAULT -1, datetaken TEXT, orientation INTEGER DEFAULT -1, "
+	"played_count INTEGER DEFAULT 0, last_played_time INTEGER DEFAULT 0, last_played_position INTEGER DEFAULT 0, "
+	"rating INTEGER DEFAULT 0, favourite INTEGER DEFAULT 0, author TEXT, provider TEXT, content_name TEXT, category TEXT, "
+	"location_tag TEXT, age_rating TEXT, keyword TEXT, is_drm INTEGER DEFAULT 0, storage_type INTEGER, "
+	"validity INTEGER DEFAULT 1, unique(path, file_name));"
+	"CREATE TABLE playlist (playlist_id INTEGER PRIMARY KEY AUTOINCREMENT, name TEXT NOT NULL UNIQUE);"
+	"CREATE TABLE playlist_map (_id INTEGER PRIMARY KEY AUTOINCREMENT, playlist_id INTEGER NOT NULL, "
+	"media_uuid TEXT NOT NULL, play_order INTEGER NOT NULL);"
+	"CREATE TABLE tag (tag_id INTEGER PRIMARY KEY AUTOINCREMENT, name TEXT NOT NULL UNIQUE);"
+	"CREATE TABLE tag_map (_id INTEGER PRIMARY KEY AUTOINCREMENT, tag_id INTEGER NOT NULL, media_uuid TEXT NOT NULL, "
+	"unique(tag_id, media_uuid));";
+
+/* "m2" is in a folder which is made again from its path. "m3" is in an unknown folder whose directory is the one of another
+ * folder, and "m4" is in an unknown folder of a directory which has no folder name. "gone" is not in media at all */
+static const char *g_old_rows =
+	"INSERT INTO folder VALUES ('f1', '/opt/media', 'media', 0, 0);"
+	"INSERT INTO media (media_uuid, path, file_name, folder_uuid, album, storage_type) VALUES "
+	"('m1', '/opt/media/a.mp3', 'a.mp3', 'f1', 'kept', 0), "
+	"('m2', '/opt/media/sub/b.mp3', 'b.mp3', 'f2', 'kept', 0), "
+	"('m3', '/opt/media/c.mp3', 'c.mp3', 'f3', 'kept', 0), "
+	"('m4', 'd.mp3', 'd.mp3', 'f4', 'orphan', 0);"
+	"INSERT INTO playlist (name) VALUES ('p');"
+	"INSERT INTO playlist_map (playlist_id, media_uuid, play_order) VALUES (1, 'm1', 0), (1, 'gone', 1), (1, 'm4', 2), (1, 'm2', 3);"
+	"INSERT INTO tag (name) VALUES ('t');"
+	"INSERT INTO tag_map (tag_id, media_uuid) VALUES (1, 'gone'), (1, 'm3');";
+
+static int __count(sqlite3 *db, const char *sql)
+{
+	sqlite3_stmt *stmt = NULL;
+	int count = -1;
+
+	if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK)
+		return -1;
+
+	if (sqlite3_step(stmt) == SQLITE_ROW)
+		count = sqlite3_column_int(stmt, 0);
+
+	sqlite3_finalize(stmt);
+
+	return count;
+}
+
+static void __test_migrate(sqlite3 *db)
+{
+	CHECK(sqlite3_exec(db, g_old_schema, NULL, NULL, NULL) == SQLITE_OK);
+	CHECK(sqlite3_exec(db, g_old_rows, NULL, NULL, NULL) == SQLITE_OK);
+
+	CHECK(_media_svc_create_storage_table(db) == MEDIA_INFO_ERROR_NONE);
+	CHECK(_media_svc_create_folder_table(db) == MEDIA_INFO_ERROR_NONE);
+	CHECK(_media_svc_create_media_table(db) == MEDIA_INFO_ERROR_NONE);
+	CHECK(_media_svc_create_playlist_table(db) == MEDIA_INFO_ERROR_NONE);
+	CHECK(_media_svc_create_tag_table(db) == MEDIA_INFO_ERROR_NONE);
+
+	/* tables of old version are views now */
+	CHECK(__count(db, "SELECT count(*) FROM sqlite_master WHERE type='table' \
+			AND name IN ('"MEDIA_SVC_DB_TABLE_FOLDER"', '"MEDIA_SVC_DB_TABLE_MEDIA"', \
+			'"MEDIA_SVC_DB_TABLE_PLAYLIST_MAP"', '"MEDIA_SVC_DB_TABLE_TAG_MAP"')") == 0);
+
+	/* media of unknown folder is dropped, and the others are kept with their folder */
+	CHECK(__count(db, "SELECT count(*) FROM "MEDIA_SVC_DB_TABLE_MEDIA_DATA) == 3);
+	CHECK(__count(db, "SELECT count(*) FROM "MEDIA_SVC_DB_TABLE_MEDIA" WHERE media_uuid IN ('m1', 'm2', 'm3')") == 3);
+	CHECK(__count(db, "SELECT count(*) FROM "MEDIA_SVC_DB_TABLE_MEDIA" AS m INNER JOIN "MEDIA_SVC_DB_TABLE_FOLDER" AS f \
+			ON f.folder_uuid=m.folder_uuid WHERE m.media_uuid='m3' AND f.path='/opt/media'") == 1);
+	CHECK(__count(db, "SELECT count(*) FROM "MEDIA_SVC_DB_TABLE_FOLDER" WHERE path='/opt/media/sub'") == 1);
+
+	/* value of dropped media is not kept */
+	CHECK(__count(db, "SELECT count(*) FROM "MEDIA_SVC_DB_TABLE_META_DICT) == 1);
+
+	/* rows of unknown or dropped media are dropped from the maps */
+	CHECK(__count(db, "SELECT count(*) FROM "MEDIA_SVC_DB_TABLE_PLAYLIST_MAP_DATA) == 2);
+	CHECK(__count(db, "SELECT count(*) FROM "MEDIA_SVC_DB_TABLE_PLAYLIST_MAP" WHERE media_uuid IN ('m1', 'm2')") == 2);
+	CHECK(__count(db, "SELECT count(*) FROM "MEDIA_SVC_DB_TABLE_TAG_MAP_DATA) == 1);
+	CHECK(__count(db, "SELECT count(*) FROM "MEDIA_SVC_DB_TABLE_TAG_MAP" WHERE media_uuid='m3'") == 1);
+
+	/* migrated database opens again without migration */
+	CHECK(_media_svc_create_folder_table(db) == MEDIA_INFO_ERROR_NONE);
+	CHECK(_media_svc_create_media_table(db) == MEDIA_INFO_ERROR_NONE);
+	CHECK(_media_svc_create_playlist_table(db) == MEDIA_INFO_ERROR_NONE);
+	CHECK(_media_svc_create_tag_table(db) == MEDIA_INFO_ERROR_NONE);
+	CHECK(__count(db, "SELECT count(*) FROM "MEDIA_SVC_DB_TABLE_MEDIA_DATA) == 3);
+}
+
+static void __test_change_log_source(sqlite3 *db)
+{
+	CHECK(sqlite3_exec(db, "CREATE TABLE "MEDIA_SVC_DB_TABLE_CHANGE_LOG" (version INTEGER PRIMARY KEY AUTOINCREMENT, "
+			"change_type INTEGER NOT NULL, storage_type INTEGER, media_uuid TEXT);"
+			"INSERT INTO "MEDIA_SVC_DB_TABLE_CHANGE_LOG" (change_type, storage_type, media_uuid) VALUES (0, 0, 'a1'), (0, 0, 'm1');",
+			NULL, NULL, NULL) == SQLITE_OK);
+
+	CHECK(_media_svc_create_change_log_table(db) == MEDIA_INFO_ERROR_NONE);
+
+	/* log without source is dropped, and version goes on */
+	CHECK(__count(db, "SELECT count(*) FROM "MEDIA_SVC_DB_TABLE_CHANGE_LOG) == 0);
+	CHECK(sqlite3_exec(db, "UPDATE "MEDIA_SVC_DB_TABLE_MEDIA" SET title='x' WHERE media_uuid='m1'", NULL, NULL, NULL) == SQLITE_OK);
+	CHECK(__count(db, "SELECT version FROM "MEDIA_SVC_DB_TABLE_CHANGE_LOG" WHERE source=0 AND media_uuid='m1'") == 3);
+
+	/* done once */
+	CHECK(_media_svc_create_change_log_table(db) == MEDIA_INFO_ERROR_NONE);
+	CHECK(__count(db, "SELECT count(*) FROM "MEDIA_SVC_DB_TABLE_CHANGE_LOG) == 1);
+}
+
+static void __test_visual_folder_id(sqlite3 *db)
+{
+	CHECK(sqlite3_exec(db, "CREATE TABLE visual_folder (folder_uuid, path, storage_type);"
+			"CREATE TABLE visual_media (visual_uuid, path, folder_uuid);"
+			"INSERT INTO visual_folder VALUES ('f1', '/a', 0);"
+			"INSERT INTO visual_media VALUES ('v1', '/a/1.jpg', 'f1');", NULL, NULL, NULL) == SQLITE_OK);
+
+	CHECK(_media_svc_create_visual_folder_id(db) == MEDIA_INFO_ERROR_NONE);
+	CHECK(__count(db, "SELECT count(*) FROM visual_media AS m INNER JOIN visual_folder AS f ON f.folder_id=m.folder_id") == 1);
+
+	/* writers which set folder_uuid only get folder_id by triggers */
+	CHECK(sqlite3_exec(db, "INSERT INTO visual_media (visual_uuid, path, folder_uuid) VALUES ('v2', '/b/2.jpg', 'f2');"
+			"INSERT INTO visual_folder (folder_uuid, path, storage_type) VALUES ('f2', '/b', 0);", NULL, NULL, NULL) == SQLITE_OK);
+	CHECK(__count(db, "SELECT count(*) FROM visual_media AS m INNER JOIN visual_folder AS f ON f.folder_id=m.folder_id") == 2);
+
+	/* done once */
+	CHECK(_media_svc_create_visual_folder_id(db) == MEDIA_INFO_ERROR_NONE);
+}
+
+int main(int argc, char *argv[])
+{
+	const char *path = (argc > 1) ? argv[1] : DEFAULT_DB_PATH;
+	sqlite3 *db = NULL;
+
+	remove(path);
+
+	if (sqlite3_open(path, &db) != SQLITE_OK) {
+		fprintf(stderr, "failed to open [%s]\n", path);
+		return 1;
+	}
+
+	if (_media_svc_db_ctx_create(db) == NULL) {
+		fprintf(stderr, "failed to create context\n");
+		return 1;
+	}
+
+	__test_migrate(db);
+	__test_change_log_source(db);
+	__test_visual_folder_id(db);
+
+	_media_svc_db_ctx_destroy(db);
+	sqlite3_close(db);
+	remove(path);
+
+	printf("db migrate test : %d failed\n", g_failed);
+
+	return (g_failed == 0) ? 0 : 1;
+}
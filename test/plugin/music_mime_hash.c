@@ -0,0 +1,108 @@
+/*
+ * libmedia-service
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Hyunjun Ko <zzoon.ko@samsung.com>, Haejeong Kim <backto.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * Checks that the music mime list of the plugins has no collision in MUSIC_MIME_HASH,
+ * that _media_svc_plugin_music_mime_table holds every listed mime at its slot and nothing else, and that every listed mime is found.
+ * Usage : music_mime_hash
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "../../plugin/media-svc-plugin-common.h"
+
+static const char *not_music_mime[] = {
+	"x-smaf",
+	"wav",
+	"x-wav",
+	"amr",
+	"mpeg3",
+	"mp",
+	NULL
+};
+
+static int __check_table(void)
+{
+	const char *table[MUSIC_MIME_HASH_SIZE] = { NULL, };
+	const char *mime = NULL;
+	int failed = 0;
+	int slot = 0;
+	int i = 0;
+
+	for (i = 0; _media_svc_plugin_music_mime_list[i] != NULL; i++) {
+		mime = _media_svc_plugin_music_mime_list[i];
+		slot = MUSIC_MIME_HASH(mime, strlen(mime));
+
+		if (table[slot] != NULL) {
+			fprintf(stderr, "[%s] collides with [%s] at slot %d. change MUSIC_MIME_HASH weights\n", mime, table[slot], slot);
+			failed++;
+			continue;
+		}
+
+		table[slot] = mime;
+	}
+
+	for (slot = 0; slot < MUSIC_MIME_HASH_SIZE; slot++) {
+		if (table[slot] == NULL && _media_svc_plugin_music_mime_table[slot] == NULL)
+			continue;
+
+		if (table[slot] == NULL || _media_svc_plugin_music_mime_table[slot] == NULL
+			|| strcmp(table[slot], _media_svc_plugin_music_mime_table[slot]) != 0) {
+			fprintf(stderr, "slot %d of music mime table must be [%s]\n", slot, table[slot] ? table[slot] : "NULL");
+			failed++;
+		}
+	}
+
+	return failed;
+}
+
+int main(int argc, char *argv[])
+{
+	int failed = 0;
+	int count = 0;
+	int i = 0;
+
+	failed += __check_table();
+
+	for (i = 0; _media_svc_plugin_music_mime_list[i] != NULL; i++) {
+		if (!_media_svc_plugin_is_music_mime(_media_svc_plugin_music_mime_list[i])) {
+			fprintf(stderr, "[%s] is not found\n", _media_svc_plugin_music_mime_list[i]);
+			failed++;
+		}
+	}
+	count = i;
+
+	for (i = 0; not_music_mime[i] != NULL; i++) {
+		if (_media_svc_plugin_is_music_mime(not_music_mime[i])) {
+			fprintf(stderr, "[%s] is found as music\n", not_music_mime[i]);
+			failed++;
+		}
+	}
+
+	if (_media_svc_plugin_is_music_mime("")) {
+		fprintf(stderr, "empty mime is found as music\n");
+		failed++;
+	}
+
+	printf("music mime hash : %d mimes, %d failed\n", count, failed);
+
+	return (failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,151 @@
+/*
+ * libmedia-service
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Hyunjun Ko <zzoon.ko@samsung.com>, Haejeong Kim <backto.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * Compares the bundled libuuid path (uuid_generate + uuid_unparse) with _media_svc_generate_uuid.
+ * Usage : uuid-bench [count] [threads]
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+#define UUID_STR_SIZE	37
+
+typedef unsigned char uuid_t[16];
+void uuid_generate(uuid_t out);
+void uuid_unparse(const uuid_t uu, char *out);
+int _media_svc_generate_uuid(char *uuid, int max_length);
+
+typedef struct {
+	int legacy;
+	int count;
+} bench_arg_s;
+
+static long long __now_usec(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+static void *__bench_thread(void *data)
+{
+	bench_arg_s *arg = (bench_arg_s *)data;
+	char uuid_str[UUID_STR_SIZE] = {0,};
+	uuid_t uuid_value;
+	int i = 0;
+
+	for (i = 0; i < arg->count; i++) {
+		if (arg->legacy) {
+			uuid_generate(uuid_value);
+			uuid_unparse(uuid_value, uuid_str);
+		} else {
+			_media_svc_generate_uuid(uuid_str, sizeof(uuid_str));
+		}
+	}
+
+	return NULL;
+}
+
+static void __run(const char *name, int legacy, int count, int thread_cnt)
+{
+	pthread_t *threads = NULL;
+	bench_arg_s arg;
+	long long start = 0;
+	long long elapsed = 0;
+	int i = 0;
+
+	threads = malloc(sizeof(pthread_t) * thread_cnt);
+	if (threads == NULL) {
+		printf("malloc failed\n");
+		return;
+	}
+
+	arg.legacy = legacy;
+	arg.count = count;
+
+	start = __now_usec();
+	for (i = 0; i < thread_cnt; i++)
+		pthread_create(&threads[i], NULL, __bench_thread, &arg);
+	for (i = 0; i < thread_cnt; i++)
+		pthread_join(threads[i], NULL);
+	elapsed = __now_usec() - start;
+
+	printf("%-8s threads=%-2d uuids=%-9lld %8lld usec  %8.3f usec/uuid\n",
+		name, thread_cnt, (long long)count * thread_cnt, elapsed,
+		(double)elapsed / ((double)count * thread_cnt));
+
+	free(threads);
+}
+
+static int __check_format(void)
+{
+	char uuid_str[UUID_STR_SIZE] = {0,};
+	char prev[UUID_STR_SIZE] = {0,};
+	int i = 0;
+
+	for (i = 0; i < 1000; i++) {
+		if (_media_svc_generate_uuid(uuid_str, sizeof(uuid_str)) != 0)
+			return -1;
+		if (strlen(uuid_str) != UUID_STR_SIZE - 1 || uuid_str[14] != '4')
+			return -1;
+		if (strchr("89ab", uuid_str[19]) == NULL)
+			return -1;
+		if (strcmp(prev, uuid_str) == 0)
+			return -1;
+		strncpy(prev, uuid_str, sizeof(prev));
+	}
+
+	printf("sample : %s\n", uuid_str);
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	int count = 100000;
+	int thread_cnt = 4;
+
+	if (argc > 1)
+		count = atoi(argv[1]);
+	if (argc > 2)
+		thread_cnt = atoi(argv[2]);
+
+	if (count <= 0 || thread_cnt <= 0) {
+		printf("Usage : %s [count] [threads]\n", argv[0]);
+		return -1;
+	}
+
+	if (__check_format() < 0) {
+		printf("invalid uuid generated\n");
+		return -1;
+	}
+
+	__run("libuuid", 1, count, 1);
+	__run("media", 0, count, 1);
+	__run("libuuid", 1, count, thread_cnt);
+	__run("media", 0, count, thread_cnt);
+
+	return 0;
+}